@@ -0,0 +1,14 @@
+# Writes OUTPUT, a header defining a hash of the contents of the files in SOURCES.
+# Persistent translation caches written by a build with different translation sources are discarded.
+
+set(contents "")
+foreach(source IN LISTS SOURCES)
+    file(SHA256 "${source}" source_hash)
+    string(APPEND contents "${source} ${source_hash}\n")
+endforeach()
+string(SHA256 hash "${contents}")
+string(SUBSTRING "${hash}" 0 16 hash)
+
+file(WRITE "${OUTPUT}.tmp" "// Generated by GenerateTranslationSourceHash.cmake\n#pragma once\n\n#define DYNARMIC_TRANSLATION_SOURCE_HASH 0x${hash}ull\n")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT}.tmp" "${OUTPUT}")
+file(REMOVE "${OUTPUT}.tmp")
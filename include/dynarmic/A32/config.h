@@ -11,6 +11,7 @@
 #include <memory>
 
 #include <dynarmic/A32/arch_version.h>
+#include <dynarmic/host_feature.h>
 #include <dynarmic/optimization_flags.h>
 
 namespace Dynarmic {
@@ -106,6 +107,14 @@ struct UserConfig {
     size_t processor_id = 0;
     ExclusiveMonitor* global_monitor = nullptr;
 
+    /// When set and page_table is provided, exclusive loads and stores are emitted inline.
+    /// The reservation (address and loaded value) is kept in the JIT state: exclusive stores
+    /// become a host compare-and-exchange against the loaded value. global_monitor, if provided,
+    /// also tracks the reservation so that exclusive stores and ClearAddress calls from other
+    /// processors break it.
+    /// Accesses that miss the page table use the MemoryRead* and MemoryWriteExclusive* callbacks.
+    bool inline_exclusive_access = false;
+
     /// Select the architecture version to use.
     /// There are minor behavioural differences between versions.
     ArchVersion arch_version = ArchVersion::v8;
@@ -131,6 +140,11 @@ struct UserConfig {
     /// The prefered and tested mode for this library is with unsafe optimizations disabled.
     bool unsafe_optimizations = false;
 
+    /// Host CPU features that are not used even when the host supports them. This selects the
+    /// code sequences used on hosts without them, and is intended for testing and debugging.
+    /// Features that imply a disabled feature (e.g. SSE41 for SSSE3) should be disabled as well.
+    HostFeature disabled_host_features = no_host_features;
+
     // Page Table
     // The page table is used for faster memory access. If an entry in the table is nullptr,
     // the JIT will fallback to calling the MemoryRead*/MemoryWrite* callbacks.
@@ -154,6 +168,9 @@ struct UserConfig {
     /// memory callback.
     /// This value should be the required access sizes this applies to ORed together.
     /// To detect any access, use: 8 | 16 | 32 | 64.
+    /// Consecutive words transferred by load/store multiple instructions may be combined into
+    /// a single 64-bit access. This applies to the individual word accesses, and a combined
+    /// access that straddles a page boundary is performed as those word accesses.
     std::uint8_t detect_misaligned_access_via_page_table = 0;
     /// Determines if the above option only triggers when the misalignment straddles a
     /// page boundary.
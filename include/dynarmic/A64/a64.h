@@ -17,6 +17,39 @@ namespace Dynarmic::A64 {
 
 struct Context;
 
+/**
+ * Compiled code shared between several Jit instances, such as the cores of a multi-core
+ * system running the same guest. Code compiled by any attached Jit is available to all.
+ *
+ * A Jit attaches to the cache by setting UserConfig::shared_code_cache. Its configuration
+ * must be identical to the configuration the cache was constructed with, except for:
+ * - callbacks, which must be of the same dynamic type;
+ * - processor_id;
+ * - tpidr_el0 and tpidrro_el0, which must be null exactly when the cache's are.
+ * Fastmem is not supported, nor are shared caches in builds with
+ * DYNARMIC_ENABLE_NO_EXECUTE_SUPPORT.
+ *
+ * Guest code is read through the callbacks of the configuration the cache was constructed
+ * with, which must outlive the cache. All attached Jits must be destroyed before the cache.
+ *
+ * Invalidation requested through any attached Jit (ClearCache, InvalidateCacheRange) applies
+ * to all of them. It is deferred until none of them are executing, and executing Jits are
+ * requested to halt as with HaltExecution.
+ */
+class SharedCodeCache final {
+public:
+    explicit SharedCodeCache(UserConfig conf);
+    ~SharedCodeCache();
+
+    SharedCodeCache(const SharedCodeCache&) = delete;
+    SharedCodeCache& operator=(const SharedCodeCache&) = delete;
+
+private:
+    friend class Jit;
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
 class Jit final {
 public:
     explicit Jit(UserConfig conf);
@@ -47,6 +80,15 @@ public:
      */
     void InvalidateCacheRange(std::uint64_t start_address, std::size_t length);
 
+    /**
+     * Invalidate the software TLB entries for a range of addresses (See: UserConfig::tlb_entry_count).
+     * This must be called whenever the result of UserCallbacks::TranslatePage changes for a page.
+     * May be called from within callbacks, but not from another thread while this Jit is running.
+     * @param start_address The starting address of the range to invalidate.
+     * @param length The length (in bytes) of the range to invalidate.
+     */
+    void InvalidateTLB(std::uint64_t start_address, std::size_t length);
+
     /**
      * Reset CPU state to state at startup. Does not clear code cache.
      * Cannot be called from a callback.
@@ -9,7 +9,9 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
 
+#include <dynarmic/host_feature.h>
 #include <dynarmic/optimization_flags.h>
 
 namespace Dynarmic {
@@ -18,6 +20,8 @@ class ExclusiveMonitor;
 
 namespace Dynarmic::A64 {
 
+class SharedCodeCache;
+
 using VAddr = std::uint64_t;
 
 using Vector = std::array<std::uint64_t, 2>;
@@ -110,6 +114,11 @@ struct UserCallbacks {
     // A conservative implementation that always returns false is safe.
     virtual bool IsReadOnlyMemory(VAddr /*vaddr*/) { return false; }
 
+    // Used to refill the software TLB (See: UserConfig::tlb_entry_count).
+    // Returns the host memory backing the page-aligned guest page at vaddr, or nullptr if
+    // accesses to that page should hit the MemoryRead*/MemoryWrite* callbacks.
+    virtual void* TranslatePage(VAddr /*vaddr*/) { return nullptr; }
+
     /// The interpreter must execute exactly num_instructions starting from PC.
     virtual void InterpreterFallback(VAddr pc, size_t num_instructions) = 0;
 
@@ -136,6 +145,13 @@ struct UserConfig {
     size_t processor_id = 0;
     ExclusiveMonitor* global_monitor = nullptr;
 
+    /// When set and page_table or tlb_entry_count is provided, exclusive loads and stores are
+    /// emitted inline. The reservation (address and loaded value) is kept in the JIT state:
+    /// exclusive stores become a host compare-and-exchange against the loaded value.
+    /// global_monitor, if provided, also tracks the reservation so that exclusive stores and
+    /// ClearAddress calls from other processors break it. Accesses that miss the page table use the MemoryRead* and MemoryWriteExclusive* callbacks.
+    bool inline_exclusive_access = false;
+
     /// This selects other optimizations than can't otherwise be disabled by setting other
     /// configuration options. This includes:
     /// - IR optimizations
@@ -144,6 +160,46 @@ struct UserConfig {
     /// This is intended to be used for debugging.
     OptimizationFlag optimizations = all_safe_optimizations;
 
+    /// When non-zero, blocks are first compiled quickly without IR optimizations and count
+    /// their executions. Once a block has executed this many times it is recompiled with all
+    /// enabled optimizations, and existing links to it are repointed to the new code.
+    /// When zero, every block is compiled with all enabled optimizations the first time.
+    std::size_t tiered_compilation_threshold = 0;
+
+    /// When non-zero, this many worker threads translate and optimize the predicted successors
+    /// (direct branch targets) of newly compiled blocks ahead of time. Only emission of host
+    /// code is then left to the thread running the guest.
+    /// UserCallbacks::MemoryReadCode must be safe to call concurrently from these threads.
+    /// Once ClearCache or InvalidateCacheRange has been called while the Jit is not executing,
+    /// these threads do not read code until execution resumes, so code may then be modified.
+    std::size_t background_translation_threads = 0;
+
+    /// When non-empty, the path of a file used as a persistent cache of translated and
+    /// optimized blocks. Blocks are appended to it as they are compiled, and on subsequent
+    /// runs blocks whose guest instructions are unchanged are loaded from it instead of being
+    /// decoded, translated and optimized again. Host code is always emitted afresh.
+    /// The file is discarded if it was written by a build of dynarmic with different translation
+    /// sources, and entries written with a different translation configuration are ignored.
+    /// Several processes may share the file.
+    std::string translation_cache_path{};
+
+    /// Blocks are no longer appended to the translation cache file once it reaches this size
+    /// in bytes. The next Jit that opens a full file starts it afresh. The entries a Jit keeps
+    /// in memory are limited to about the same size, oldest first being discarded.
+    std::size_t translation_cache_size_limit = 64 * 1024 * 1024;
+
+    /// Size in bytes of the host code cache. Code that is rarely executed is placed at
+    /// far_code_offset within it. Unless the cache is shared, both parts are divided into eight
+    /// regions, and once one fills the code in the oldest region is discarded. Both parts must
+    /// be at least 16 MiB.
+    std::size_t code_cache_size = 128 * 1024 * 1024;
+    std::size_t far_code_offset = 100 * 1024 * 1024;
+
+    /// When non-null, this Jit compiles into and executes code from the given cache, which
+    /// is shared with all other Jits attached to it. The cache's own configuration is then
+    /// used for compilation; see SharedCodeCache for the requirements on this configuration.
+    SharedCodeCache* shared_code_cache = nullptr;
+
     bool HasOptimization(OptimizationFlag f) const {
         if (!unsafe_optimizations) {
             f &= all_safe_optimizations;
@@ -157,6 +213,11 @@ struct UserConfig {
     /// The prefered and tested mode for this library is with unsafe optimizations disabled.
     bool unsafe_optimizations = false;
 
+    /// Host CPU features that are not used even when the host supports them. This selects the
+    /// code sequences used on hosts without them, and is intended for testing and debugging.
+    /// Features that imply a disabled feature (e.g. SSE41 for SSSE3) should be disabled as well.
+    HostFeature disabled_host_features = no_host_features;
+
     /// When set to true, UserCallbacks::DataCacheOperationRaised will be called when any
     /// data cache instruction is executed. Notably DC ZVA will not implicitly do anything.
     /// When set to false, UserCallbacks::DataCacheOperationRaised will never be called.
@@ -203,10 +264,25 @@ struct UserConfig {
     /// Determines the size of page_table. Valid values are between 12 and 64 inclusive.
     /// This is only used if page_table is not nullptr.
     size_t page_table_address_space_bits = 36;
+    /// Number of levels of page_table. With one level, page_table is a flat array of
+    /// 2^(page_table_address_space_bits - 12) page pointers. With more levels, it is a radix
+    /// tree: every level below the top is a table of 512 entries indexed by 9 bits of the
+    /// address, the leaves are page pointers, and the top level is indexed by the remaining
+    /// bits. A null entry at any level causes the relevant memory callback to be called.
+    /// For example, three levels with 39 address bits index tables with bits [38:30], [29:21]
+    /// and [20:12]. Valid values are 1 to 4, with more than 9 * (levels - 1) + 12 address bits.
+    size_t page_table_levels = 1;
+    /// When set, an entry of the level above the leaves of a multi-level page_table with bit 0
+    /// set is a huge page: the entry, with bit 0 cleared, points to 2 MiB of host memory that
+    /// backs the 2 MiB-aligned region of the address space it covers. Other entries point to
+    /// tables as usual.
+    /// This is only used if page_table_levels is greater than 1.
+    bool page_table_huge_pages = false;
     /// Masks out the first N bits in host pointers from the page table.
     /// The intention behind this is to allow users of Dynarmic to pack attributes in the
     /// same integer and update the pointer attribute pair atomically.
     /// If the configured value is 3, all pointers will be forcefully aligned to 8 bytes.
+    /// With a multi-level page_table, this only applies to the leaves.
     int page_table_pointer_mask_bits = 0;
     /// Determines what happens if the guest accesses an entry that is off the end of the
     /// page table. If true, Dynarmic will silently mirror page_table's address space. If
@@ -226,11 +302,58 @@ struct UserConfig {
     /// memory callback.
     /// This value should be the required access sizes this applies to ORed together.
     /// To detect any access, use: 8 | 16 | 32 | 64 | 128.
+    /// Load/store pair and multiple structure instructions may be performed as a single wider
+    /// access. This applies to their individual register or element accesses, and a wider
+    /// access that straddles a page boundary is performed as those individual accesses.
     std::uint8_t detect_misaligned_access_via_page_table = 0;
     /// Determines if the above option only triggers when the misalignment straddles a
     /// page boundary.
     bool only_detect_misalignment_via_page_table_on_page_boundary = false;
 
+    /// Number of entries of a direct-mapped software TLB that is checked inline by memory
+    /// accesses, as an alternative to page_table. Must be zero (disabled) or a power of two
+    /// no greater than 65536, and page_table must be nullptr if it is enabled.
+    /// Misses are refilled from UserCallbacks::TranslatePage; pages for which it returns
+    /// nullptr are accessed through the memory callbacks and are not cached.
+    /// Entries remain valid until Jit::InvalidateTLB is called for them.
+    /// detect_misaligned_access_via_page_table and the option above also apply to the TLB.
+    size_t tlb_entry_count = 0;
+
+    // Fastmem Pointer
+    // This should point to the beginning of a 2^fastmem_address_space_bits bytes
+    // address space which is in arranged just like what you wish for emulated memory to
+    // be. If the host page faults on an address, the JIT will fallback to calling the
+    // MemoryRead*/MemoryWrite* callbacks.
+    void* fastmem_pointer = nullptr;
+    /// Determines if instructions that pagefault should cause recompilation of that block
+    /// with fastmem disabled.
+    bool recompile_on_fastmem_failure = true;
+    /// Declares how many valid address bits are there in virtual addresses.
+    /// Determines the size of fastmem arena. Valid values are between 12 and 64 inclusive.
+    /// This is only used if fastmem_pointer is not nullptr.
+    size_t fastmem_address_space_bits = 36;
+    /// Determines what happens if the guest accesses an entry that is off the end of the
+    /// fastmem arena. If true, Dynarmic will silently mirror fastmem's address space. If
+    /// false, accessing memory outside of fastmem bounds will result in a call to the
+    /// relevant memory callback.
+    /// This is only used if fastmem_pointer is not nullptr.
+    bool silently_mirror_fastmem = true;
+
+    /// When set, writes to guest code are detected without calls to Jit::InvalidateCacheRange.
+    /// The host pages that back translated guest code through fastmem_pointer, page_table or
+    /// TranslatePage are made read-only. The first write to such a page makes it writable again,
+    /// and invalidates the code on the guest pages it backs as InvalidateCacheRange would. A page
+    /// is protected again when code on it is next translated. Written code is discarded no
+    /// later than the next return to the dispatcher (which an ISB causes) or the end of Run.
+    /// Host memory backing guest code must be page-aligned and readable and writable, and must
+    /// not be unmapped while the Jit exists, other than after a call to ClearCache. The Jit
+    /// changes the protection of these pages between read-only and read-write, so the embedder
+    /// must not protect them itself; they are left read-write. Code that is only accessible
+    /// through the memory callbacks is not tracked.
+    /// This requires page_table, tlb_entry_count or fastmem_pointer, and is only supported on
+    /// POSIX hosts other than macOS.
+    bool detect_self_modifying_code = false;
+
     /// This option relates to translation. Generally when we run into an unpredictable
     /// instruction the ExceptionRaised callback is called. If this is true, we define
     /// definite behaviour for some unpredictable instructions.
@@ -10,6 +10,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace Dynarmic {
@@ -32,12 +34,15 @@ public:
     T ReadAndMark(size_t processor_id, VAddr address, Function op) {
         static_assert(std::is_trivially_copyable_v<T>);
         const VAddr masked_address = address & RESERVATION_GRANULE_MASK;
+        ProcessorSlot& slot = slots[processor_id];
+        Granule& granule = GetGranule(masked_address);
 
-        Lock();
-        exclusive_addresses[processor_id] = masked_address;
+        Lock(granule);
+        slot.generation = granule.generation;
+        slot.address.store(masked_address, std::memory_order_relaxed);
         const T value = op();
-        std::memcpy(exclusive_values[processor_id].data(), &value, sizeof(T));
-        Unlock();
+        std::memcpy(slot.value.data(), &value, sizeof(T));
+        Unlock(granule);
         return value;
     }
 
@@ -48,15 +53,21 @@ public:
     template <typename T, typename Function>
     bool DoExclusiveOperation(size_t processor_id, VAddr address, Function op) {
         static_assert(std::is_trivially_copyable_v<T>);
-        if (!CheckAndClear(processor_id, address)) {
+        const VAddr masked_address = address & RESERVATION_GRANULE_MASK;
+        ProcessorSlot& slot = slots[processor_id];
+        Granule& granule = GetGranule(masked_address);
+
+        Lock(granule);
+        if (!CheckAndClear(slot, granule, masked_address)) {
+            Unlock(granule);
             return false;
         }
 
         T saved_value;
-        std::memcpy(&saved_value, exclusive_values[processor_id].data(), sizeof(T));
+        std::memcpy(&saved_value, slot.value.data(), sizeof(T));
         const bool result = op(saved_value);
 
-        Unlock();
+        Unlock(granule);
         return result;
     }
 
@@ -64,18 +75,55 @@ public:
     void Clear();
     /// Unmark processor id
     void ClearProcessor(size_t processor_id);
+    /// Unmark the region containing address for all processors.
+    void ClearAddress(VAddr address);
+
+    static constexpr VAddr RESERVATION_GRANULE_MASK = 0xFFFF'FFFF'FFFF'FFFFull;
+    static constexpr VAddr INVALID_EXCLUSIVE_ADDRESS = 0xDEAD'DEAD'DEAD'DEADull;
+
+    /// Reservation address of processor processor_id, for exclusive accesses emitted inline.
+    /// The owning processor stores the masked address here on an exclusive load and exchanges
+    /// it with INVALID_EXCLUSIVE_ADDRESS on an exclusive store. ClearAddress and successful
+    /// exclusive stores by other processors invalidate it.
+    /// Until this is first called, reservations are only invalidated through the granule
+    /// generations, and exclusive stores do not need to look at other processors' slots.
+    std::atomic<VAddr>* GetReservationAddress(size_t processor_id);
 
 private:
-    bool CheckAndClear(size_t processor_id, VAddr address);
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t GRANULE_TABLE_BITS = 10;
+
+    /// Reservation state owned by a single processor. Only the owning processor
+    /// writes generation and value; address may be invalidated by anyone.
+    struct alignas(CACHE_LINE_SIZE) ProcessorSlot {
+        std::atomic<VAddr> address{INVALID_EXCLUSIVE_ADDRESS};
+        std::uint64_t generation = 0;
+        Vector value{};
+    };
+
+    /// A bucket of the reservation granule table. A successful exclusive store
+    /// to any address hashing to this bucket bumps generation, which invalidates
+    /// every reservation taken against an older generation of this bucket.
+    struct alignas(CACHE_LINE_SIZE) Granule {
+        std::atomic<bool> is_locked{false};
+        std::uint64_t generation = 0;
+    };
+
+    Granule& GetGranule(VAddr masked_address) {
+        const VAddr hash = (masked_address >> 3) * 0x9E37'79B9'7F4A'7C15ull;
+        return granules[hash >> (64 - GRANULE_TABLE_BITS)];
+    }
 
-    void Lock();
-    void Unlock();
+    bool CheckAndClear(ProcessorSlot& slot, Granule& granule, VAddr masked_address);
+    void InvalidateReservations(VAddr masked_address);
 
-    static constexpr VAddr RESERVATION_GRANULE_MASK = 0xFFFF'FFFF'FFFF'FFFFull;
-    static constexpr VAddr INVALID_EXCLUSIVE_ADDRESS = 0xDEAD'DEAD'DEAD'DEADull;
-    std::atomic_flag is_locked;
-    std::vector<VAddr> exclusive_addresses;
-    std::vector<Vector> exclusive_values;
+    static void Lock(Granule& granule);
+    static void Unlock(Granule& granule);
+
+    std::unique_ptr<ProcessorSlot[]> slots;
+    std::unique_ptr<Granule[]> granules;
+    size_t processor_count;
+    std::atomic<bool> has_inline_reservations{false};
 };
 
 } // namespace Dynarmic
@@ -0,0 +1,58 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace Dynarmic {
+
+/// Host CPU features the x64 backend selects code sequences by.
+enum class HostFeature : std::uint32_t {
+    SSSE3                   = 0x00000001,
+    SSE41                   = 0x00000002,
+    SSE42                   = 0x00000004,
+    PCLMULQDQ               = 0x00000008,
+    AVX                     = 0x00000010,
+    F16C                    = 0x00000020,
+    AESNI                   = 0x00000040,
+    SHA                     = 0x00000080,
+    GFNI                    = 0x00000100,
+    LZCNT                   = 0x00000200,
+    BMI1                    = 0x00000400,
+    BMI2                    = 0x00000800,
+    FMA                     = 0x00001000,
+    AVX2                    = 0x00002000,
+    /// All AVX-512 subsets.
+    AVX512                  = 0x00004000,
+};
+
+constexpr HostFeature no_host_features = static_cast<HostFeature>(0);
+
+constexpr HostFeature operator~(HostFeature f) {
+    return static_cast<HostFeature>(~static_cast<std::uint32_t>(f));
+}
+
+constexpr HostFeature operator|(HostFeature f1, HostFeature f2) {
+    return static_cast<HostFeature>(static_cast<std::uint32_t>(f1) | static_cast<std::uint32_t>(f2));
+}
+
+constexpr HostFeature operator&(HostFeature f1, HostFeature f2) {
+    return static_cast<HostFeature>(static_cast<std::uint32_t>(f1) & static_cast<std::uint32_t>(f2));
+}
+
+constexpr HostFeature operator|=(HostFeature& result, HostFeature f) {
+    return result = (result | f);
+}
+
+constexpr HostFeature operator&=(HostFeature& result, HostFeature f) {
+    return result = (result & f);
+}
+
+constexpr bool operator!(HostFeature f) {
+    return f == no_host_features;
+}
+
+} // namespace Dynarmic
@@ -42,6 +42,23 @@ enum class OptimizationFlag : std::uint32_t {
     /// This is an UNSAFE optimization that causes floating-point instructions to not produce correct NaNs.
     /// This may also result in inaccurate results when instructions are given certain special values.
     Unsafe_InaccurateNaN    = 0x00040000,
+    /// This is an UNSAFE optimization that skips updating NZCV at the end of a block when the code
+    /// directly following it overwrites NZCV before it is read. The guest cannot observe this, but
+    /// NZCV may be stale when Run returns between two such blocks, e.g. when ticks run out there.
+    Unsafe_ElideExitFlags   = 0x00080000,
+    /// This is an UNSAFE optimization that continues translation at the target of unconditional
+    /// direct branches, so that IR optimizations and register allocation can operate across them.
+    /// Guest code is emulated correctly, but blocks become larger: MemoryReadCode is called for
+    /// branch targets before they are reached, and ticks and halts are accounted per larger block.
+    /// Conditional branches still end the block, and a branch back into code already in the block
+    /// (i.e. a loop) is never followed, so every block keeps a single exit.
+    Unsafe_BranchFollowing  = 0x00100000,
+    /// This is an UNSAFE optimization in which memory accesses at constant offsets less than a page
+    /// apart from the same base address share a single page table or software TLB lookup. Accesses
+    /// that turn out to be on another page than that lookup look up their own page.
+    /// This assumes that memory callbacks do not change the mapping of pages accessed earlier in
+    /// the same basic block. Mappings may still change in supervisor calls and exceptions.
+    Unsafe_PageLookupReuse  = 0x00200000,
 };
 
 constexpr OptimizationFlag no_optimizations = static_cast<OptimizationFlag>(0);
@@ -4,6 +4,7 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <optional>
 #include <utility>
 
@@ -78,7 +79,7 @@ FP::FPCR A32EmitContext::FPCR(bool fpcr_controlled) const {
 
 A32EmitX64::A32EmitX64(BlockOfCode& code, A32::UserConfig conf, A32::Jit* jit_interface)
         : EmitX64(code), conf(std::move(conf)), jit_interface(jit_interface) {
-    GenFastmemFallbacks();
+    code.ReserveLazyCode(fallback_code_size);
     GenTerminalHandlers();
     code.PreludeComplete();
     ClearFastDispatchTable();
@@ -94,7 +95,7 @@ A32EmitX64::BlockDescriptor A32EmitX64::Emit(IR::Block& block) {
     code.EnableWriting();
     SCOPE_EXIT { code.DisableWriting(); };
 
-    static const std::vector<HostLoc> gpr_order = [this]{
+    const std::vector<HostLoc> gpr_order = [this]{
         std::vector<HostLoc> gprs{any_gpr};
         if (conf.page_table) {
             gprs.erase(std::find(gprs.begin(), gprs.end(), HostLoc::R14));
@@ -155,6 +156,10 @@ A32EmitX64::BlockDescriptor A32EmitX64::Emit(IR::Block& block) {
 
     const auto range = boost::icl::discrete_interval<u32>::closed(descriptor.PC(), end_location.PC() - 1);
     block_ranges.AddRange(range, descriptor);
+    for (const auto& [begin, end] : block.FollowedRanges()) {
+        const auto followed_range = boost::icl::discrete_interval<u32>::closed(A32::LocationDescriptor{begin}.PC(), A32::LocationDescriptor{end}.PC() - 1);
+        block_ranges.AddRange(followed_range, descriptor);
+    }
 
     return RegisterBlock(descriptor, entrypoint, size);
 }
@@ -190,65 +195,97 @@ void A32EmitX64::ClearFastDispatchTable() {
     }
 }
 
-void A32EmitX64::GenFastmemFallbacks() {
-    const std::initializer_list<int> idxes{0, 1, 2, 3, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14};
-    const std::array<std::pair<size_t, ArgCallback>, 4> read_callbacks{{
-        {8, Devirtualize<&A32::UserCallbacks::MemoryRead8>(conf.callbacks)},
-        {16, Devirtualize<&A32::UserCallbacks::MemoryRead16>(conf.callbacks)},
-        {32, Devirtualize<&A32::UserCallbacks::MemoryRead32>(conf.callbacks)},
-        {64, Devirtualize<&A32::UserCallbacks::MemoryRead64>(conf.callbacks)},
-    }};
-    const std::array<std::pair<size_t, ArgCallback>, 4> write_callbacks{{
-        {8, Devirtualize<&A32::UserCallbacks::MemoryWrite8>(conf.callbacks)},
-        {16, Devirtualize<&A32::UserCallbacks::MemoryWrite16>(conf.callbacks)},
-        {32, Devirtualize<&A32::UserCallbacks::MemoryWrite32>(conf.callbacks)},
-        {64, Devirtualize<&A32::UserCallbacks::MemoryWrite64>(conf.callbacks)},
-    }};
-
-    for (int vaddr_idx : idxes) {
-        for (int value_idx : idxes) {
-            for (const auto& [bitsize, callback] : read_callbacks) {
-                code.align();
-                read_fallbacks[std::make_tuple(bitsize, vaddr_idx, value_idx)] = code.getCurr<void(*)()>();
-                ABI_PushCallerSaveRegistersAndAdjustStackExcept(code, HostLocRegIdx(value_idx));
-                if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
-                    code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
-                }
-                callback.EmitCall(code);
-                if (value_idx != code.ABI_RETURN.getIdx()) {
-                    code.mov(Xbyak::Reg64{value_idx}, code.ABI_RETURN);
-                }
-                ABI_PopCallerSaveRegistersAndAdjustStackExcept(code, HostLocRegIdx(value_idx));
-                code.ret();
-                PerfMapRegister(read_fallbacks[std::make_tuple(bitsize, vaddr_idx, value_idx)], code.getCurr(), fmt::format("a32_read_fallback_{}", bitsize));
-            }
+size_t A32EmitX64::FallbackIndex(size_t bitsize, int vaddr_idx, int value_idx) {
+    return static_cast<size_t>(Common::HighestSetBit(bitsize) - 3) * 256 + vaddr_idx * 16 + value_idx;
+}
 
-            for (const auto& [bitsize, callback] : write_callbacks) {
-                code.align();
-                write_fallbacks[std::make_tuple(bitsize, vaddr_idx, value_idx)] = code.getCurr<void(*)()>();
-                ABI_PushCallerSaveRegistersAndAdjustStack(code);
-                if (vaddr_idx == code.ABI_PARAM3.getIdx() && value_idx == code.ABI_PARAM2.getIdx()) {
-                    code.xchg(code.ABI_PARAM2, code.ABI_PARAM3);
-                } else if (vaddr_idx == code.ABI_PARAM3.getIdx()) {
-                    code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
-                    if (value_idx != code.ABI_PARAM3.getIdx()) {
-                        code.mov(code.ABI_PARAM3, Xbyak::Reg64{value_idx});
-                    }
-                } else {
-                    if (value_idx != code.ABI_PARAM3.getIdx()) {
-                        code.mov(code.ABI_PARAM3, Xbyak::Reg64{value_idx});
-                    }
-                    if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
-                        code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
-                    }
-                }
-                callback.EmitCall(code);
-                ABI_PopCallerSaveRegistersAndAdjustStack(code);
-                code.ret();
-                PerfMapRegister(write_fallbacks[std::make_tuple(bitsize, vaddr_idx, value_idx)], code.getCurr(), fmt::format("a32_write_fallback_{}", bitsize));
-            }
+A32EmitX64::FallbackFn A32EmitX64::GetReadFallback(size_t bitsize, int vaddr_idx, int value_idx) {
+    FallbackFn& fallback = read_fallbacks[FallbackIndex(bitsize, vaddr_idx, value_idx)];
+    if (fallback) {
+        return fallback;
+    }
+
+    code.SwitchToLazyCode();
+    code.align();
+    fallback = code.getCurr<FallbackFn>();
+    ABI_PushRegistersAndAdjustStack(code, 0, {});
+    if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
+        code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
+    }
+    switch (bitsize) {
+    case 8:
+        Devirtualize<&A32::UserCallbacks::MemoryRead8>(conf.callbacks).EmitCall(code);
+        break;
+    case 16:
+        Devirtualize<&A32::UserCallbacks::MemoryRead16>(conf.callbacks).EmitCall(code);
+        break;
+    case 32:
+        Devirtualize<&A32::UserCallbacks::MemoryRead32>(conf.callbacks).EmitCall(code);
+        break;
+    case 64:
+        Devirtualize<&A32::UserCallbacks::MemoryRead64>(conf.callbacks).EmitCall(code);
+        break;
+    default:
+        UNREACHABLE();
+    }
+    if (value_idx != code.ABI_RETURN.getIdx()) {
+        code.mov(Xbyak::Reg64{value_idx}, code.ABI_RETURN);
+    }
+    ABI_PopRegistersAndAdjustStack(code, 0, {});
+    code.ret();
+    PerfMapRegister(fallback, code.getCurr(), fmt::format("a32_read_fallback_{}", bitsize));
+    code.SwitchFromLazyCode();
+
+    return fallback;
+}
+
+A32EmitX64::FallbackFn A32EmitX64::GetWriteFallback(size_t bitsize, int vaddr_idx, int value_idx) {
+    FallbackFn& fallback = write_fallbacks[FallbackIndex(bitsize, vaddr_idx, value_idx)];
+    if (fallback) {
+        return fallback;
+    }
+
+    code.SwitchToLazyCode();
+    code.align();
+    fallback = code.getCurr<FallbackFn>();
+    ABI_PushRegistersAndAdjustStack(code, 0, {});
+    if (vaddr_idx == code.ABI_PARAM3.getIdx() && value_idx == code.ABI_PARAM2.getIdx()) {
+        code.xchg(code.ABI_PARAM2, code.ABI_PARAM3);
+    } else if (vaddr_idx == code.ABI_PARAM3.getIdx()) {
+        code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
+        if (value_idx != code.ABI_PARAM3.getIdx()) {
+            code.mov(code.ABI_PARAM3, Xbyak::Reg64{value_idx});
         }
+    } else {
+        if (value_idx != code.ABI_PARAM3.getIdx()) {
+            code.mov(code.ABI_PARAM3, Xbyak::Reg64{value_idx});
+        }
+        if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
+            code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
+        }
+    }
+    switch (bitsize) {
+    case 8:
+        Devirtualize<&A32::UserCallbacks::MemoryWrite8>(conf.callbacks).EmitCall(code);
+        break;
+    case 16:
+        Devirtualize<&A32::UserCallbacks::MemoryWrite16>(conf.callbacks).EmitCall(code);
+        break;
+    case 32:
+        Devirtualize<&A32::UserCallbacks::MemoryWrite32>(conf.callbacks).EmitCall(code);
+        break;
+    case 64:
+        Devirtualize<&A32::UserCallbacks::MemoryWrite64>(conf.callbacks).EmitCall(code);
+        break;
+    default:
+        UNREACHABLE();
     }
+    ABI_PopRegistersAndAdjustStack(code, 0, {});
+    code.ret();
+    PerfMapRegister(fallback, code.getCurr(), fmt::format("a32_write_fallback_{}", bitsize));
+    code.SwitchFromLazyCode();
+
+    return fallback;
 }
 
 void A32EmitX64::GenTerminalHandlers() {
@@ -926,6 +963,79 @@ void EmitDetectMisaignedVAddr(BlockOfCode& code, A32EmitContext& ctx, size_t bit
     code.SwitchToNearCode();
 }
 
+bool IsWideMemoryAccess(const IR::Inst* inst) {
+    switch (inst->GetOpcode()) {
+    case IR::Opcode::A32ReadMemoryWide64:
+    case IR::Opcode::A32WriteMemoryWide64:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// A wide access is a pair of words and is only word-aligned. It is performed inline only if it
+/// stays within a page and, where detection is enabled for words, is word-aligned. Otherwise the
+/// fallback performs the two word accesses.
+void EmitDetectWideAccessFallback(BlockOfCode& code, A32EmitContext& ctx, Xbyak::Label& abort, Xbyak::Reg32 vaddr, Xbyak::Reg32 tmp) {
+    if ((ctx.conf.detect_misaligned_access_via_page_table & 32) != 0) {
+        code.test(vaddr, 0b11);
+        code.jnz(abort, code.T_NEAR);
+    }
+
+    code.mov(tmp, vaddr);
+    code.and_(tmp, static_cast<u32>(page_mask));
+    code.cmp(tmp, static_cast<u32>(page_size - 8));
+    code.ja(abort, code.T_NEAR);
+}
+
+/// Host address of a word of a wide access, or nullptr if the access of that word on its own
+/// would have used the memory callbacks.
+u8* LookupWideWordHostAddress(const A32::UserConfig& conf, u32 vaddr) {
+    if (!conf.page_table) {
+        return nullptr;
+    }
+
+    if ((conf.detect_misaligned_access_via_page_table & 32) != 0 && (vaddr & 0b11) != 0) {
+        const u32 page_align_mask = static_cast<u32>(page_mask) & ~u32(0b11);
+        if (!conf.only_detect_misalignment_via_page_table_on_page_boundary || (vaddr & page_align_mask) == page_align_mask) {
+            return nullptr;
+        }
+    }
+
+    const u64 page = reinterpret_cast<u64>((*conf.page_table)[vaddr >> page_bits]) & (~u64(0) << conf.page_table_pointer_mask_bits);
+    if (page == 0) {
+        return nullptr;
+    }
+    return reinterpret_cast<u8*>(page) + (conf.absolute_offset_page_table ? vaddr : vaddr & page_mask);
+}
+
+u64 ReadMemoryWideFallback(const A32::UserConfig& conf, u32 vaddr) {
+    u64 result = 0;
+    for (u32 i = 0; i < 2; i++) {
+        const u32 word_vaddr = vaddr + i * 4;
+        u32 word;
+        if (const u8* host = LookupWideWordHostAddress(conf, word_vaddr)) {
+            std::memcpy(&word, host, sizeof(word));
+        } else {
+            word = conf.callbacks->MemoryRead32(word_vaddr);
+        }
+        result |= u64(word) << (i * 32);
+    }
+    return result;
+}
+
+void WriteMemoryWideFallback(const A32::UserConfig& conf, u32 vaddr, u64 value) {
+    for (u32 i = 0; i < 2; i++) {
+        const u32 word_vaddr = vaddr + i * 4;
+        const u32 word = static_cast<u32>(value >> (i * 32));
+        if (u8* host = LookupWideWordHostAddress(conf, word_vaddr)) {
+            std::memcpy(host, &word, sizeof(word));
+        } else {
+            conf.callbacks->MemoryWrite32(word_vaddr, word);
+        }
+    }
+}
+
 Xbyak::RegExp EmitVAddrLookup(BlockOfCode& code, A32EmitContext& ctx, size_t bitsize, Xbyak::Label& abort, Xbyak::Reg64 vaddr) {
     const Xbyak::Reg64 page = ctx.reg_alloc.ScratchGpr();
     const Xbyak::Reg32 tmp = ctx.conf.absolute_offset_page_table ? page.cvt32() : ctx.reg_alloc.ScratchGpr().cvt32();
@@ -991,27 +1101,119 @@ void EmitWriteMemoryMov(BlockOfCode& code, const Xbyak::RegExp& addr, const Xbya
     }
 }
 
+Xbyak::Address SizedMemoryOperand(size_t bitsize, const Xbyak::RegExp& addr) {
+    switch (bitsize) {
+    case 8:
+        return Xbyak::util::byte[addr];
+    case 16:
+        return word[addr];
+    case 32:
+        return dword[addr];
+    case 64:
+        return qword[addr];
+    default:
+        ASSERT_FALSE("Invalid bitsize");
+    }
+}
+
+void EmitReservationGranule(BlockOfCode& code, Xbyak::Reg32 dest, Xbyak::Reg32 vaddr) {
+    code.mov(dest, vaddr);
+    if constexpr (static_cast<u32>(ExclusiveMonitor::RESERVATION_GRANULE_MASK) != 0xFFFFFFFF) {
+        code.and_(dest, static_cast<u32>(ExclusiveMonitor::RESERVATION_GRANULE_MASK));
+    }
+}
+
 } // anonymous namespace
 
+A32EmitX64::FallbackFn A32EmitX64::GetWideReadFallback(int vaddr_idx, int value_idx) {
+    FallbackFn& fallback = wide_read_fallbacks[vaddr_idx * 16 + value_idx];
+    if (fallback) {
+        return fallback;
+    }
+
+    code.SwitchToLazyCode();
+    code.align();
+    fallback = code.getCurr<FallbackFn>();
+    ABI_PushRegistersAndAdjustStack(code, 0, {});
+    if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
+        code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
+    }
+    code.mov(code.ABI_PARAM1, reinterpret_cast<u64>(&conf));
+    code.CallFunction(&ReadMemoryWideFallback);
+    if (value_idx != code.ABI_RETURN.getIdx()) {
+        code.mov(Xbyak::Reg64{value_idx}, code.ABI_RETURN);
+    }
+    ABI_PopRegistersAndAdjustStack(code, 0, {});
+    code.ret();
+    PerfMapRegister(fallback, code.getCurr(), "a32_wide_read_fallback");
+    code.SwitchFromLazyCode();
+
+    return fallback;
+}
+
+A32EmitX64::FallbackFn A32EmitX64::GetWideWriteFallback(int vaddr_idx, int value_idx) {
+    FallbackFn& fallback = wide_write_fallbacks[vaddr_idx * 16 + value_idx];
+    if (fallback) {
+        return fallback;
+    }
+
+    code.SwitchToLazyCode();
+    code.align();
+    fallback = code.getCurr<FallbackFn>();
+    ABI_PushRegistersAndAdjustStack(code, 0, {});
+    if (vaddr_idx == code.ABI_PARAM3.getIdx() && value_idx == code.ABI_PARAM2.getIdx()) {
+        code.xchg(code.ABI_PARAM2, code.ABI_PARAM3);
+    } else if (vaddr_idx == code.ABI_PARAM3.getIdx()) {
+        code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
+        if (value_idx != code.ABI_PARAM3.getIdx()) {
+            code.mov(code.ABI_PARAM3, Xbyak::Reg64{value_idx});
+        }
+    } else {
+        if (value_idx != code.ABI_PARAM3.getIdx()) {
+            code.mov(code.ABI_PARAM3, Xbyak::Reg64{value_idx});
+        }
+        if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
+            code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
+        }
+    }
+    code.mov(code.ABI_PARAM1, reinterpret_cast<u64>(&conf));
+    code.CallFunction(&WriteMemoryWideFallback);
+    ABI_PopRegistersAndAdjustStack(code, 0, {});
+    code.ret();
+    PerfMapRegister(fallback, code.getCurr(), "a32_wide_write_fallback");
+    code.SwitchFromLazyCode();
+
+    return fallback;
+}
+
 template<std::size_t bitsize, auto callback>
 void A32EmitX64::ReadMemory(A32EmitContext& ctx, IR::Inst* inst) {
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+    const bool is_wide = IsWideMemoryAccess(inst);
 
     if (!conf.page_table) {
         ctx.reg_alloc.HostCall(inst, {}, args[0]);
-        Devirtualize<callback>(conf.callbacks).EmitCall(code);
+        if (is_wide) {
+            code.mov(code.ABI_PARAM1, reinterpret_cast<u64>(&conf));
+            code.CallFunction(&ReadMemoryWideFallback);
+        } else {
+            Devirtualize<callback>(conf.callbacks).EmitCall(code);
+        }
         return;
     }
 
     const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
     const Xbyak::Reg64 value = ctx.reg_alloc.ScratchGpr();
-
-    const auto wrapped_fn = read_fallbacks[std::make_tuple(bitsize, vaddr.getIdx(), value.getIdx())];
+    const auto get_fallback = [&] {
+        const FallbackFn fallback = is_wide ? GetWideReadFallback(vaddr.getIdx(), value.getIdx()) : GetReadFallback(bitsize, vaddr.getIdx(), value.getIdx());
+        return WrapFallback(fallback, ctx.reg_alloc.LiveCallerSaveRegisters());
+    };
 
     if (const auto marker = ShouldFastmem(ctx, inst)) {
         const auto location = code.getCurr();
         EmitReadMemoryMov<bitsize>(code, value, r13 + vaddr);
 
+        const auto wrapped_fn = get_fallback();
         fastmem_patch_info.emplace(
             Common::BitCast<u64>(location),
             FastmemPatchInfo{
@@ -1027,10 +1229,15 @@ void A32EmitX64::ReadMemory(A32EmitContext& ctx, IR::Inst* inst) {
 
     Xbyak::Label abort, end;
 
-    const auto src_ptr = EmitVAddrLookup(code, ctx, bitsize, abort, vaddr);
+    if (is_wide) {
+        EmitDetectWideAccessFallback(code, ctx, abort, vaddr.cvt32(), ctx.reg_alloc.ScratchGpr().cvt32());
+    }
+    const auto src_ptr = EmitVAddrLookup(code, ctx, is_wide ? 8 : bitsize, abort, vaddr);
     EmitReadMemoryMov<bitsize>(code, value, src_ptr);
     code.L(end);
 
+    const auto wrapped_fn = get_fallback();
+
     code.SwitchToFarCode();
     code.L(abort);
     code.call(wrapped_fn);
@@ -1043,22 +1250,31 @@ void A32EmitX64::ReadMemory(A32EmitContext& ctx, IR::Inst* inst) {
 template<std::size_t bitsize, auto callback>
 void A32EmitX64::WriteMemory(A32EmitContext& ctx, IR::Inst* inst) {
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+    const bool is_wide = IsWideMemoryAccess(inst);
 
     if (!conf.page_table) {
         ctx.reg_alloc.HostCall(nullptr, {}, args[0], args[1]);
-        Devirtualize<callback>(conf.callbacks).EmitCall(code);
+        if (is_wide) {
+            code.mov(code.ABI_PARAM1, reinterpret_cast<u64>(&conf));
+            code.CallFunction(&WriteMemoryWideFallback);
+        } else {
+            Devirtualize<callback>(conf.callbacks).EmitCall(code);
+        }
         return;
     }
 
     const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
     const Xbyak::Reg64 value = ctx.reg_alloc.UseGpr(args[1]);
-
-    const auto wrapped_fn = write_fallbacks[std::make_tuple(bitsize, vaddr.getIdx(), value.getIdx())];
+    const auto get_fallback = [&] {
+        const FallbackFn fallback = is_wide ? GetWideWriteFallback(vaddr.getIdx(), value.getIdx()) : GetWriteFallback(bitsize, vaddr.getIdx(), value.getIdx());
+        return WrapFallback(fallback, ctx.reg_alloc.LiveCallerSaveRegisters());
+    };
 
     if (const auto marker = ShouldFastmem(ctx, inst)) {
         const auto location = code.getCurr();
         EmitWriteMemoryMov<bitsize>(code, r13 + vaddr, value);
 
+        const auto wrapped_fn = get_fallback();
         fastmem_patch_info.emplace(
             Common::BitCast<u64>(location),
             FastmemPatchInfo{
@@ -1073,10 +1289,15 @@ void A32EmitX64::WriteMemory(A32EmitContext& ctx, IR::Inst* inst) {
 
     Xbyak::Label abort, end;
 
-    const auto dest_ptr = EmitVAddrLookup(code, ctx, bitsize, abort, vaddr);
+    if (is_wide) {
+        EmitDetectWideAccessFallback(code, ctx, abort, vaddr.cvt32(), ctx.reg_alloc.ScratchGpr().cvt32());
+    }
+    const auto dest_ptr = EmitVAddrLookup(code, ctx, is_wide ? 8 : bitsize, abort, vaddr);
     EmitWriteMemoryMov<bitsize>(code, dest_ptr, value);
     code.L(end);
 
+    const auto wrapped_fn = get_fallback();
+
     code.SwitchToFarCode();
     code.L(abort);
     code.call(wrapped_fn);
@@ -1100,6 +1321,10 @@ void A32EmitX64::EmitA32ReadMemory64(A32EmitContext& ctx, IR::Inst* inst) {
     ReadMemory<64, &A32::UserCallbacks::MemoryRead64>(ctx, inst);
 }
 
+void A32EmitX64::EmitA32ReadMemoryWide64(A32EmitContext& ctx, IR::Inst* inst) {
+    ReadMemory<64, &A32::UserCallbacks::MemoryRead64>(ctx, inst);
+}
+
 void A32EmitX64::EmitA32WriteMemory8(A32EmitContext& ctx, IR::Inst* inst) {
     WriteMemory<8, &A32::UserCallbacks::MemoryWrite8>(ctx, inst);
 }
@@ -1116,10 +1341,151 @@ void A32EmitX64::EmitA32WriteMemory64(A32EmitContext& ctx, IR::Inst* inst) {
     WriteMemory<64, &A32::UserCallbacks::MemoryWrite64>(ctx, inst);
 }
 
+void A32EmitX64::EmitA32WriteMemoryWide64(A32EmitContext& ctx, IR::Inst* inst) {
+    WriteMemory<64, &A32::UserCallbacks::MemoryWrite64>(ctx, inst);
+}
+
+template<std::size_t bitsize>
+void A32EmitX64::ExclusiveReadMemoryInline(A32EmitContext& ctx, IR::Inst* inst) {
+    ASSERT(conf.page_table);
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+    const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
+    const Xbyak::Reg64 value = ctx.reg_alloc.ScratchGpr();
+
+    Xbyak::Label abort, end;
+
+    code.mov(code.byte[r15 + offsetof(A32JitState, exclusive_state)], u8(1));
+    EmitReservationGranule(code, value.cvt32(), vaddr.cvt32());
+    code.mov(dword[r15 + offsetof(A32JitState, exclusive_address)], value.cvt32());
+    if (conf.global_monitor) {
+        const Xbyak::Reg64 reservation_ptr = ctx.reg_alloc.ScratchGpr();
+        code.mov(reservation_ptr, reinterpret_cast<u64>(conf.global_monitor->GetReservationAddress(conf.processor_id)));
+        code.mov(qword[reservation_ptr], value);
+    }
+    const auto src_ptr = EmitVAddrLookup(code, ctx, bitsize, abort, vaddr);
+    EmitReadMemoryMov<bitsize>(code, value, src_ptr);
+    code.L(end);
+    code.mov(qword[r15 + offsetof(A32JitState, exclusive_value)], value);
+
+    const auto wrapped_fn = WrapFallback(GetReadFallback(bitsize, vaddr.getIdx(), value.getIdx()), ctx.reg_alloc.LiveCallerSaveRegisters());
+
+    code.SwitchToFarCode();
+    code.L(abort);
+    code.call(wrapped_fn);
+    code.jmp(end, code.T_NEAR);
+    code.SwitchToNearCode();
+
+    ctx.reg_alloc.DefineValue(inst, value);
+}
+
+template<std::size_t bitsize, auto callback>
+void A32EmitX64::ExclusiveWriteMemoryInline(A32EmitContext& ctx, IR::Inst* inst) {
+    using T = mp::unsigned_integer_of_size<bitsize>;
+
+    ASSERT(conf.page_table);
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+    ctx.reg_alloc.ScratchGpr(HostLoc::RAX);
+    const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
+    const Xbyak::Reg64 value = ctx.reg_alloc.UseGpr(args[1]);
+    const Xbyak::Reg32 status = ctx.reg_alloc.ScratchGpr().cvt32();
+    const Xbyak::Reg64 reservation = ctx.reg_alloc.ScratchGpr();
+    const Xbyak::Reg64 reservation_ptr = conf.global_monitor ? ctx.reg_alloc.ScratchGpr() : Xbyak::Reg64{};
+
+    Xbyak::Label abort, end, fallback, clear_monitor;
+
+    const auto emit_check_reservation = [&] {
+        code.cmp(code.byte[r15 + offsetof(A32JitState, exclusive_state)], u8(0));
+        code.je(end, code.T_NEAR);
+        code.mov(code.byte[r15 + offsetof(A32JitState, exclusive_state)], u8(0));
+        EmitReservationGranule(code, reservation.cvt32(), vaddr.cvt32());
+        code.cmp(dword[r15 + offsetof(A32JitState, exclusive_address)], reservation.cvt32());
+        code.jne(end, code.T_NEAR);
+        if (conf.global_monitor) {
+            // Exclusive stores and ClearAddress calls from other processors invalidate this through the monitor.
+            code.mov(reservation_ptr, reinterpret_cast<u64>(conf.global_monitor->GetReservationAddress(conf.processor_id)));
+            code.mov(rax, ExclusiveMonitor::INVALID_EXCLUSIVE_ADDRESS);
+            code.xchg(qword[reservation_ptr], rax);
+            code.cmp(rax, reservation);
+            code.jne(end, code.T_NEAR);
+        }
+    };
+
+    code.mov(status, u32(1));
+    const auto dest_ptr = EmitVAddrLookup(code, ctx, bitsize, abort, vaddr);
+    emit_check_reservation();
+    code.mov(rax, qword[r15 + offsetof(A32JitState, exclusive_value)]);
+    code.lock();
+    code.cmpxchg(SizedMemoryOperand(bitsize, dest_ptr), value.changeBit(bitsize));
+    code.setnz(status.cvt8());
+    if (conf.global_monitor) {
+        code.jnz(end);
+        code.call(clear_monitor);
+    }
+    code.L(end);
+
+    const std::vector<HostLoc> live = ctx.reg_alloc.LiveCallerSaveRegisters();
+
+    code.SwitchToFarCode();
+    if (conf.global_monitor) {
+        std::vector<HostLoc> live_and_status = live;
+        live_and_status.emplace_back(HostLocRegIdx(status.getIdx()));
+
+        code.L(clear_monitor);
+        ABI_PushRegistersAndAdjustStack(code, 0, live_and_status);
+        code.mov(code.ABI_PARAM2.cvt32(), vaddr.cvt32());
+        code.mov(code.ABI_PARAM1, reinterpret_cast<u64>(conf.global_monitor));
+        code.CallLambda(
+            [](ExclusiveMonitor& monitor, u32 vaddr) {
+                monitor.ClearAddress(vaddr);
+            }
+        );
+        ABI_PopRegistersAndAdjustStack(code, 0, live_and_status);
+        code.ret();
+    }
+
+    code.L(fallback);
+    ABI_PushRegistersAndAdjustStack(code, 0, live);
+    code.push(vaddr);
+    code.push(value);
+    code.pop(code.ABI_PARAM3);
+    code.pop(code.ABI_PARAM2);
+    code.mov(code.ABI_PARAM4, qword[r15 + offsetof(A32JitState, exclusive_value)]);
+    code.mov(code.ABI_PARAM1, reinterpret_cast<u64>(&conf));
+    code.CallLambda(
+        [](A32::UserConfig& conf, u32 vaddr, T value, T expected) -> u32 {
+            if (!(conf.callbacks->*callback)(vaddr, value, expected)) {
+                return 1;
+            }
+            if (conf.global_monitor) {
+                conf.global_monitor->ClearAddress(vaddr);
+            }
+            return 0;
+        }
+    );
+    code.mov(status, code.ABI_RETURN.cvt32());
+    ABI_PopRegistersAndAdjustStack(code, 0, live);
+    code.ret();
+
+    code.L(abort);
+    emit_check_reservation();
+    code.call(fallback);
+    code.jmp(end, code.T_NEAR);
+    code.SwitchToNearCode();
+
+    ctx.reg_alloc.DefineValue(inst, status);
+}
+
 template <size_t bitsize, auto callback>
 void A32EmitX64::ExclusiveReadMemory(A32EmitContext& ctx, IR::Inst* inst) {
     using T = mp::unsigned_integer_of_size<bitsize>;
 
+    if (conf.inline_exclusive_access && conf.page_table) {
+        ExclusiveReadMemoryInline<bitsize>(ctx, inst);
+        return;
+    }
+
     ASSERT(conf.global_monitor != nullptr);
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
 
@@ -1140,6 +1506,11 @@ template <size_t bitsize, auto callback>
 void A32EmitX64::ExclusiveWriteMemory(A32EmitContext& ctx, IR::Inst* inst) {
     using T = mp::unsigned_integer_of_size<bitsize>;
 
+    if (conf.inline_exclusive_access && conf.page_table) {
+        ExclusiveWriteMemoryInline<bitsize, callback>(ctx, inst);
+        return;
+    }
+
     ASSERT(conf.global_monitor != nullptr);
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
 
@@ -1620,7 +1991,7 @@ void A32EmitX64::EmitPatchJmp(const IR::LocationDescriptor& target_desc, CodePtr
     code.EnsurePatchLocationSize(patch_location, 13);
 }
 
-void A32EmitX64::EmitPatchMovRcx(CodePtr target_code_ptr) {
+void A32EmitX64::EmitPatchMovRcx(const IR::LocationDescriptor&, CodePtr target_code_ptr) {
     if (!target_code_ptr) {
         target_code_ptr = code.GetReturnFromRunCodeAddress();
     }
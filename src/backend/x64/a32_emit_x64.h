@@ -75,9 +75,19 @@ protected:
     std::array<FastDispatchEntry, fast_dispatch_table_size> fast_dispatch_table;
     void ClearFastDispatchTable();
 
-    std::map<std::tuple<size_t, int, int>, void(*)()> read_fallbacks;
-    std::map<std::tuple<size_t, int, int>, void(*)()> write_fallbacks;
-    void GenFastmemFallbacks();
+    // Memory fallback thunks are generated into lazy code on first use. They only align the stack:
+    // call sites preserve the caller-saved registers that are live (see WrapFallback).
+    static constexpr size_t fallback_code_size = 128 * 1024;
+    static size_t FallbackIndex(size_t bitsize, int vaddr_idx, int value_idx);
+    std::array<FallbackFn, 4 * 16 * 16> read_fallbacks{};
+    std::array<FallbackFn, 4 * 16 * 16> write_fallbacks{};
+    FallbackFn GetReadFallback(size_t bitsize, int vaddr_idx, int value_idx);
+    FallbackFn GetWriteFallback(size_t bitsize, int vaddr_idx, int value_idx);
+    // Wide accesses fall back to one access per word.
+    std::array<FallbackFn, 16 * 16> wide_read_fallbacks{};
+    std::array<FallbackFn, 16 * 16> wide_write_fallbacks{};
+    FallbackFn GetWideReadFallback(int vaddr_idx, int value_idx);
+    FallbackFn GetWideWriteFallback(int vaddr_idx, int value_idx);
 
     const void* terminal_handler_pop_rsb_hint;
     const void* terminal_handler_fast_dispatch_hint = nullptr;
@@ -117,6 +127,10 @@ protected:
     void ExclusiveReadMemory(A32EmitContext& ctx, IR::Inst* inst);
     template<std::size_t bitsize, auto callback>
     void ExclusiveWriteMemory(A32EmitContext& ctx, IR::Inst* inst);
+    template<std::size_t bitsize>
+    void ExclusiveReadMemoryInline(A32EmitContext& ctx, IR::Inst* inst);
+    template<std::size_t bitsize, auto callback>
+    void ExclusiveWriteMemoryInline(A32EmitContext& ctx, IR::Inst* inst);
 
     // Terminal instruction emitters
     void EmitSetUpperLocationDescriptor(IR::LocationDescriptor new_location, IR::LocationDescriptor old_location);
@@ -134,7 +148,7 @@ protected:
     void Unpatch(const IR::LocationDescriptor& target_desc) override;
     void EmitPatchJg(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr = nullptr) override;
     void EmitPatchJmp(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr = nullptr) override;
-    void EmitPatchMovRcx(CodePtr target_code_ptr = nullptr) override;
+    void EmitPatchMovRcx(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr = nullptr) override;
 };
 
 } // namespace Dynarmic::Backend::X64
@@ -52,7 +52,8 @@ static std::function<void(BlockOfCode&)> GenRCP(const A32::UserConfig& conf) {
 
 struct Jit::Impl {
     Impl(Jit* jit, A32::UserConfig conf)
-            : block_of_code(GenRunCodeCallbacks(conf.callbacks, &GetCurrentBlockThunk, this), JitStateInfo{jit_state}, GenRCP(conf))
+            : block_of_code(GenRunCodeCallbacks(conf.callbacks, &GetCurrentBlockThunk, this), JitStateInfo{jit_state}, GenRCP(conf),
+                            BlockOfCode::DEFAULT_TOTAL_CODE_SIZE, BlockOfCode::DEFAULT_FAR_CODE_OFFSET, conf.disabled_host_features)
             , emitter(block_of_code, conf, jit)
             , conf(std::move(conf))
             , jit_interface(jit)
@@ -178,7 +179,7 @@ private:
         MemoryReadCodeFuncType memory_read_code = [this](u32 vaddr, bool thumb) {
             return thumb ? conf.callbacks->MemoryReadThumbCode(vaddr) : conf.callbacks->MemoryReadCode(vaddr);
         };
-        IR::Block ir_block = A32::Translate(A32::LocationDescriptor{descriptor}, memory_read_code, {conf.arch_version, conf.define_unpredictable_behaviour, conf.hook_hint_instructions});
+        IR::Block ir_block = A32::Translate(A32::LocationDescriptor{descriptor}, memory_read_code, {conf.arch_version, conf.define_unpredictable_behaviour, conf.hook_hint_instructions, conf.HasOptimization(OptimizationFlag::Unsafe_BranchFollowing)});
         if (conf.HasOptimization(OptimizationFlag::GetSetElimination)) {
             Optimization::A32GetSetElimination(ir_block);
             Optimization::DeadCodeElimination(ir_block);
@@ -188,6 +189,18 @@ private:
             Optimization::ConstantPropagation(ir_block);
             Optimization::DeadCodeElimination(ir_block);
         }
+        if (conf.HasOptimization(OptimizationFlag::GetSetElimination)) {
+            // Without a way to translate following code, only writes to flags that are dead within the block are removed.
+            Optimization::TranslateInstructionFunc translate_instruction;
+            if (conf.HasOptimization(OptimizationFlag::Unsafe_ElideExitFlags) && !A32::LocationDescriptor{descriptor}.SingleStepping()) {
+                translate_instruction = [&](IR::LocationDescriptor next) {
+                    return A32::Translate(A32::LocationDescriptor{next}.SetSingleStepping(true), memory_read_code,
+                                          {conf.arch_version, conf.define_unpredictable_behaviour, conf.hook_hint_instructions, false});
+                };
+            }
+            Optimization::A32FlagLivenessPass(ir_block, translate_instruction);
+            Optimization::DeadCodeElimination(ir_block);
+        }
         Optimization::VerificationPass(ir_block);
         return emitter.Emit(ir_block);
     }
@@ -57,6 +57,8 @@ struct A32JitState {
 
     // Exclusive state
     u32 exclusive_state = 0;
+    u32 exclusive_address = 0;
+    u64 exclusive_value = 0;
 
     static constexpr size_t RSBSize = 8; // MUST be a power of 2.
     static constexpr size_t RSBPtrMask = RSBSize - 1;
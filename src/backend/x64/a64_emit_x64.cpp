@@ -3,7 +3,12 @@
  * SPDX-License-Identifier: 0BSD
  */
 
+#include <algorithm>
+#include <cstring>
 #include <initializer_list>
+#include <optional>
+#include <type_traits>
+#include <vector>
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
@@ -21,10 +26,12 @@
 #include "backend/x64/perf_map.h"
 #include "common/assert.h"
 #include "common/bit_util.h"
+#include "common/cast_util.h"
 #include "common/common_types.h"
 #include "common/scope_exit.h"
 #include "frontend/A64/location_descriptor.h"
 #include "frontend/A64/types.h"
+#include "frontend/ir/atomic_op.h"
 #include "frontend/ir/basic_block.h"
 #include "frontend/ir/cond.h"
 #include "frontend/ir/microinstruction.h"
@@ -54,24 +61,47 @@ FP::FPCR A64EmitContext::FPCR(bool fpcr_controlled) const {
 
 A64EmitX64::A64EmitX64(BlockOfCode& code, A64::UserConfig conf, A64::Jit* jit_interface)
         : EmitX64(code), conf(conf), jit_interface{jit_interface} {
+    ASSERT_MSG(!IsSharedCodeCache() || !conf.fastmem_pointer, "Fastmem is not supported with a shared code cache");
+    if (conf.HasOptimization(OptimizationFlag::FastDispatch) && !IsSharedCodeCache()) {
+        fast_dispatch_tables.emplace_back(std::make_unique<FastDispatchTable>());
+    }
+
     GenMemory128Accessors();
-    GenFastmemFallbacks();
+    code.ReserveLazyCode(fallback_code_size);
     GenTerminalHandlers();
-    code.PreludeComplete();
+    // Other threads may execute shared code at any time, so it is only ever cleared as a whole.
+    code.PreludeComplete(IsSharedCodeCache() ? 1 : code_region_count);
     ClearFastDispatchTable();
+
+    exception_handler.SetFastmemCallback([this](u64 rip_){
+        return FastmemCallback(rip_);
+    });
 }
 
 A64EmitX64::~A64EmitX64() = default;
 
-A64EmitX64::BlockDescriptor A64EmitX64::Emit(IR::Block& block) {
+template<auto mfp>
+ArgCallback A64EmitX64::DevirtualizeCallback() const {
+    const ArgCallback callback = Devirtualize<mfp>(conf.callbacks);
+    if (!IsSharedCodeCache()) {
+        return callback;
+    }
+    // Callbacks of all Jits sharing code are of the same type, so only the object differs.
+    return callback.WithArgumentLoadedFrom(qword[r15 + offsetof(A64JitState, user_callbacks)], reinterpret_cast<u64>(conf.callbacks));
+}
+
+A64EmitX64::BlockDescriptor A64EmitX64::Emit(IR::Block& block, bool count_executions) {
     code.EnableWriting();
     SCOPE_EXIT { code.DisableWriting(); };
 
-    static const std::vector<HostLoc> gpr_order = [this]{
+    const std::vector<HostLoc> gpr_order = [this]{
         std::vector<HostLoc> gprs{any_gpr};
-        if (conf.page_table) {
+        if (HasInlinePageLookup()) {
             gprs.erase(std::find(gprs.begin(), gprs.end(), HostLoc::R14));
         }
+        if (conf.fastmem_pointer) {
+            gprs.erase(std::find(gprs.begin(), gprs.end(), HostLoc::R13));
+        }
         return gprs;
     }();
 
@@ -84,6 +114,35 @@ A64EmitX64::BlockDescriptor A64EmitX64::Emit(IR::Block& block) {
 
     ASSERT(block.GetCondition() == IR::Cond::AL);
 
+    if (count_executions) {
+        ASSERT(conf.tiered_compilation_threshold != 0);
+        s32* counter;
+        if (!free_execution_counters.empty()) {
+            counter = free_execution_counters.back();
+            free_execution_counters.pop_back();
+            *counter = static_cast<s32>(conf.tiered_compilation_threshold);
+        } else {
+            counter = &execution_counter_storage.emplace_back(static_cast<s32>(conf.tiered_compilation_threshold));
+        }
+        execution_counter_users.emplace_back(entrypoint, counter);
+        execution_counters.insert_or_assign(block.Location().Value(), counter);
+
+        Xbyak::Label hot;
+
+        code.mov(rax, reinterpret_cast<u64>(counter));
+        code.sub(dword[rax], 1);
+        code.jz(hot, code.T_NEAR);
+
+        code.SwitchToFarCode();
+        code.L(hot);
+        code.mov(rax, A64::LocationDescriptor{block.Location()}.PC());
+        code.mov(qword[r15 + offsetof(A64JitState, pc)], rax);
+        code.ReturnFromRunCode();
+        code.SwitchToNearCode();
+    } else {
+        execution_counters.erase(block.Location().Value());
+    }
+
     for (auto iter = block.begin(); iter != block.end(); ++iter) {
         IR::Inst* inst = &*iter;
 
@@ -125,23 +184,118 @@ A64EmitX64::BlockDescriptor A64EmitX64::Emit(IR::Block& block) {
 
     const auto range = boost::icl::discrete_interval<u64>::closed(descriptor.PC(), end_location.PC() - 1);
     block_ranges.AddRange(range, descriptor);
+    for (const auto& [begin, end] : block.FollowedRanges()) {
+        const auto followed_range = boost::icl::discrete_interval<u64>::closed(A64::LocationDescriptor{begin}.PC(), A64::LocationDescriptor{end}.PC() - 1);
+        block_ranges.AddRange(followed_range, descriptor);
+    }
 
     return RegisterBlock(descriptor, entrypoint, size);
 }
 
+bool A64EmitX64::IsHotTierZeroBlock(IR::LocationDescriptor descriptor) const {
+    const auto iter = execution_counters.find(descriptor.Value());
+    return iter != execution_counters.end() && *iter->second <= 0;
+}
+
 void A64EmitX64::ClearCache() {
     EmitX64::ClearCache();
+    execution_counters.clear();
+    execution_counter_storage.clear();
+    execution_counter_users.clear();
+    free_execution_counters.clear();
     block_ranges.ClearCache();
     ClearFastDispatchTable();
+    fastmem_patch_info.clear();
+    link_slot_map.clear();
+    link_slots.clear();
 }
 
 void A64EmitX64::InvalidateCacheRanges(const boost::icl::interval_set<u64>& ranges) {
     InvalidateBasicBlocks(block_ranges.InvalidateRanges(ranges));
 }
 
+void A64EmitX64::EvictOldestCodeRegion() {
+    ASSERT(!IsSharedCodeCache());
+
+    const size_t region = code.AdvanceRegion();
+
+    tsl::robin_set<IR::LocationDescriptor> evicted;
+    for (const auto& [location, block] : block_descriptors) {
+        if (code.IsInRegion(block.entrypoint, region)) {
+            evicted.insert(location);
+        }
+    }
+    InvalidateBasicBlocks(evicted);
+    for (const auto& location : evicted) {
+        execution_counters.erase(location.Value());
+        block_ranges.RemoveBlock(location);
+    }
+
+    // Code in the region is about to be overwritten, so its links must no longer be patched.
+    const auto in_region = [this, region](CodePtr ptr) { return code.IsInRegion(ptr, region); };
+
+    // Nothing references the counters of code in the region anymore, so they can be reused.
+    const size_t first_freed = free_execution_counters.size();
+    const auto counter_users_end = std::remove_if(execution_counter_users.begin(), execution_counter_users.end(), [&](const auto& user) {
+        if (!in_region(user.first)) {
+            return false;
+        }
+        free_execution_counters.emplace_back(user.second);
+        return true;
+    });
+    execution_counter_users.erase(counter_users_end, execution_counter_users.end());
+    if (first_freed != free_execution_counters.size()) {
+        const tsl::robin_set<s32*> freed{free_execution_counters.begin() + first_freed, free_execution_counters.end()};
+        for (auto iter = execution_counters.begin(); iter != execution_counters.end();) {
+            if (freed.count(iter->second)) {
+                iter = execution_counters.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+    for (auto iter = patch_information.begin(); iter != patch_information.end(); ++iter) {
+        PatchInformation& patch_info = iter.value();
+        for (std::vector<CodePtr>* locations : {&patch_info.jg, &patch_info.jmp, &patch_info.mov_rcx}) {
+            locations->erase(std::remove_if(locations->begin(), locations->end(), in_region), locations->end());
+        }
+    }
+    for (auto iter = fastmem_patch_info.begin(); iter != fastmem_patch_info.end();) {
+        if (in_region(reinterpret_cast<CodePtr>(iter->first))) {
+            iter = fastmem_patch_info.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
 void A64EmitX64::ClearFastDispatchTable() {
-    if (conf.HasOptimization(OptimizationFlag::FastDispatch)) {
-        fast_dispatch_table.fill({});
+    for (auto& table : fast_dispatch_tables) {
+        table->fill({});
+    }
+}
+
+void* A64EmitX64::AllocateFastDispatchTable() {
+    if (!conf.HasOptimization(OptimizationFlag::FastDispatch)) {
+        return nullptr;
+    }
+    return fast_dispatch_tables.emplace_back(std::make_unique<FastDispatchTable>())->data();
+}
+
+void A64EmitX64::FreeFastDispatchTable(void* table) {
+    const auto iter = std::find_if(fast_dispatch_tables.begin(), fast_dispatch_tables.end(), [table](const auto& t) {
+        return t->data() == table;
+    });
+    if (iter != fast_dispatch_tables.end()) {
+        fast_dispatch_tables.erase(iter);
+    }
+}
+
+void A64EmitX64::EmitPerJitPointer(Xbyak::Reg64 reg, size_t jit_state_offset, const void* pointer) {
+    if (IsSharedCodeCache()) {
+        code.mov(reg, qword[r15 + jit_state_offset]);
+    } else {
+        code.mov(reg, reinterpret_cast<u64>(pointer));
     }
 }
 
@@ -149,7 +303,7 @@ void A64EmitX64::GenMemory128Accessors() {
     code.align();
     memory_read_128 = code.getCurr<void(*)()>();
 #ifdef _WIN32
-    Devirtualize<&A64::UserCallbacks::MemoryRead128>(conf.callbacks).EmitCallWithReturnPointer(code,
+    DevirtualizeCallback<&A64::UserCallbacks::MemoryRead128>().EmitCallWithReturnPointer(code,
         [&](Xbyak::Reg64 return_value_ptr, [[maybe_unused]] RegList args) {
             code.mov(code.ABI_PARAM3, code.ABI_PARAM2);
             code.sub(rsp, 8 + 16 + ABI_SHADOW_SPACE);
@@ -159,7 +313,7 @@ void A64EmitX64::GenMemory128Accessors() {
     code.add(rsp, 8 + 16 + ABI_SHADOW_SPACE);
 #else
     code.sub(rsp, 8);
-    Devirtualize<&A64::UserCallbacks::MemoryRead128>(conf.callbacks).EmitCall(code);
+    DevirtualizeCallback<&A64::UserCallbacks::MemoryRead128>().EmitCall(code);
     if (code.HasSSE41()) {
         code.movq(xmm1, code.ABI_RETURN);
         code.pinsrq(xmm1, code.ABI_RETURN2, 1);
@@ -179,7 +333,7 @@ void A64EmitX64::GenMemory128Accessors() {
     code.sub(rsp, 8 + 16 + ABI_SHADOW_SPACE);
     code.lea(code.ABI_PARAM3, ptr[rsp + ABI_SHADOW_SPACE]);
     code.movaps(xword[code.ABI_PARAM3], xmm1);
-    Devirtualize<&A64::UserCallbacks::MemoryWrite128>(conf.callbacks).EmitCall(code);
+    DevirtualizeCallback<&A64::UserCallbacks::MemoryWrite128>().EmitCall(code);
     code.add(rsp, 8 + 16 + ABI_SHADOW_SPACE);
 #else
     code.sub(rsp, 8);
@@ -191,108 +345,121 @@ void A64EmitX64::GenMemory128Accessors() {
         code.punpckhqdq(xmm1, xmm1);
         code.movq(code.ABI_PARAM4, xmm1);
     }
-    Devirtualize<&A64::UserCallbacks::MemoryWrite128>(conf.callbacks).EmitCall(code);
+    DevirtualizeCallback<&A64::UserCallbacks::MemoryWrite128>().EmitCall(code);
     code.add(rsp, 8);
 #endif
     code.ret();
     PerfMapRegister(memory_read_128, code.getCurr(), "a64_memory_write_128");
 }
 
-void A64EmitX64::GenFastmemFallbacks() {
-    const std::initializer_list<int> idxes{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
-    const std::array<std::pair<size_t, ArgCallback>, 4> read_callbacks{{
-        {8, Devirtualize<&A64::UserCallbacks::MemoryRead8>(conf.callbacks)},
-        {16, Devirtualize<&A64::UserCallbacks::MemoryRead16>(conf.callbacks)},
-        {32, Devirtualize<&A64::UserCallbacks::MemoryRead32>(conf.callbacks)},
-        {64, Devirtualize<&A64::UserCallbacks::MemoryRead64>(conf.callbacks)},
-    }};
-    const std::array<std::pair<size_t, ArgCallback>, 4> write_callbacks{{
-        {8, Devirtualize<&A64::UserCallbacks::MemoryWrite8>(conf.callbacks)},
-        {16, Devirtualize<&A64::UserCallbacks::MemoryWrite16>(conf.callbacks)},
-        {32, Devirtualize<&A64::UserCallbacks::MemoryWrite32>(conf.callbacks)},
-        {64, Devirtualize<&A64::UserCallbacks::MemoryWrite64>(conf.callbacks)},
-    }};
-
-    for (int vaddr_idx : idxes) {
-        if (vaddr_idx == 4 || vaddr_idx == 15) {
-            continue;
-        }
+size_t A64EmitX64::FallbackIndex(size_t bitsize, int vaddr_idx, int value_idx) {
+    return static_cast<size_t>(Common::HighestSetBit(bitsize) - 3) * 256 + vaddr_idx * 16 + value_idx;
+}
 
-        for (int value_idx : idxes) {
-            code.align();
-            read_fallbacks[std::make_tuple(128, vaddr_idx, value_idx)] = code.getCurr<void(*)()>();
-            ABI_PushCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(value_idx));
-            if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
-                code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
-            }
-            code.call(memory_read_128);
-            if (value_idx != 1) {
-                code.movaps(Xbyak::Xmm{value_idx}, xmm1);
-            }
-            ABI_PopCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(value_idx));
-            code.ret();
-            PerfMapRegister(read_fallbacks[std::make_tuple(128, vaddr_idx, value_idx)], code.getCurr(), "a64_read_fallback_128");
-
-            code.align();
-            write_fallbacks[std::make_tuple(128, vaddr_idx, value_idx)] = code.getCurr<void(*)()>();
-            ABI_PushCallerSaveRegistersAndAdjustStack(code);
-            if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
-                code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
-            }
-            if (value_idx != 1) {
-                code.movaps(xmm1, Xbyak::Xmm{value_idx});
-            }
-            code.call(memory_write_128);
-            ABI_PopCallerSaveRegistersAndAdjustStack(code);
-            code.ret();
-            PerfMapRegister(write_fallbacks[std::make_tuple(128, vaddr_idx, value_idx)], code.getCurr(), "a64_write_fallback_128");
+A64EmitX64::FallbackFn A64EmitX64::GetReadFallback(size_t bitsize, int vaddr_idx, int value_idx) {
+    FallbackFn& fallback = read_fallbacks[FallbackIndex(bitsize, vaddr_idx, value_idx)];
+    if (fallback) {
+        return fallback;
+    }
 
-            if (value_idx == 4 || value_idx == 15) {
-                continue;
-            }
+    code.SwitchToLazyCode();
+    code.align();
+    fallback = code.getCurr<FallbackFn>();
+    ABI_PushRegistersAndAdjustStack(code, 0, {});
+    if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
+        code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
+    }
+    switch (bitsize) {
+    case 8:
+        DevirtualizeCallback<&A64::UserCallbacks::MemoryRead8>().EmitCall(code);
+        break;
+    case 16:
+        DevirtualizeCallback<&A64::UserCallbacks::MemoryRead16>().EmitCall(code);
+        break;
+    case 32:
+        DevirtualizeCallback<&A64::UserCallbacks::MemoryRead32>().EmitCall(code);
+        break;
+    case 64:
+        DevirtualizeCallback<&A64::UserCallbacks::MemoryRead64>().EmitCall(code);
+        break;
+    case 128:
+        code.call(memory_read_128);
+        break;
+    default:
+        UNREACHABLE();
+    }
+    if (bitsize == 128) {
+        if (value_idx != 1) {
+            code.movaps(Xbyak::Xmm{value_idx}, xmm1);
+        }
+    } else if (value_idx != code.ABI_RETURN.getIdx()) {
+        code.mov(Xbyak::Reg64{value_idx}, code.ABI_RETURN);
+    }
+    ABI_PopRegistersAndAdjustStack(code, 0, {});
+    code.ret();
+    PerfMapRegister(fallback, code.getCurr(), fmt::format("a64_read_fallback_{}", bitsize));
+    code.SwitchFromLazyCode();
 
-            for (const auto& [bitsize, callback] : read_callbacks) {
-                code.align();
-                read_fallbacks[std::make_tuple(bitsize, vaddr_idx, value_idx)] = code.getCurr<void(*)()>();
-                ABI_PushCallerSaveRegistersAndAdjustStackExcept(code, HostLocRegIdx(value_idx));
-                if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
-                    code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
-                }
-                callback.EmitCall(code);
-                if (value_idx != code.ABI_RETURN.getIdx()) {
-                    code.mov(Xbyak::Reg64{value_idx}, code.ABI_RETURN);
-                }
-                ABI_PopCallerSaveRegistersAndAdjustStackExcept(code, HostLocRegIdx(value_idx));
-                code.ret();
-                PerfMapRegister(read_fallbacks[std::make_tuple(bitsize, vaddr_idx, value_idx)], code.getCurr(), fmt::format("a64_read_fallback_{}", bitsize));
-            }
+    return fallback;
+}
 
-            for (const auto& [bitsize, callback] : write_callbacks) {
-                code.align();
-                write_fallbacks[std::make_tuple(bitsize, vaddr_idx, value_idx)] = code.getCurr<void(*)()>();
-                ABI_PushCallerSaveRegistersAndAdjustStack(code);
-                if (vaddr_idx == code.ABI_PARAM3.getIdx() && value_idx == code.ABI_PARAM2.getIdx()) {
-                    code.xchg(code.ABI_PARAM2, code.ABI_PARAM3);
-                } else if (vaddr_idx == code.ABI_PARAM3.getIdx()) {
-                    code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
-                    if (value_idx != code.ABI_PARAM3.getIdx()) {
-                        code.mov(code.ABI_PARAM3, Xbyak::Reg64{value_idx});
-                    }
-                } else {
-                    if (value_idx != code.ABI_PARAM3.getIdx()) {
-                        code.mov(code.ABI_PARAM3, Xbyak::Reg64{value_idx});
-                    }
-                    if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
-                        code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
-                    }
-                }
-                callback.EmitCall(code);
-                ABI_PopCallerSaveRegistersAndAdjustStack(code);
-                code.ret();
-                PerfMapRegister(write_fallbacks[std::make_tuple(bitsize, vaddr_idx, value_idx)], code.getCurr(), fmt::format("a64_write_fallback_{}", bitsize));
-            }
+A64EmitX64::FallbackFn A64EmitX64::GetWriteFallback(size_t bitsize, int vaddr_idx, int value_idx) {
+    FallbackFn& fallback = write_fallbacks[FallbackIndex(bitsize, vaddr_idx, value_idx)];
+    if (fallback) {
+        return fallback;
+    }
+
+    code.SwitchToLazyCode();
+    code.align();
+    fallback = code.getCurr<FallbackFn>();
+    ABI_PushRegistersAndAdjustStack(code, 0, {});
+    if (bitsize == 128) {
+        if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
+            code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
         }
+        if (value_idx != 1) {
+            code.movaps(xmm1, Xbyak::Xmm{value_idx});
+        }
+    } else if (vaddr_idx == code.ABI_PARAM3.getIdx() && value_idx == code.ABI_PARAM2.getIdx()) {
+        code.xchg(code.ABI_PARAM2, code.ABI_PARAM3);
+    } else if (vaddr_idx == code.ABI_PARAM3.getIdx()) {
+        code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
+        if (value_idx != code.ABI_PARAM3.getIdx()) {
+            code.mov(code.ABI_PARAM3, Xbyak::Reg64{value_idx});
+        }
+    } else {
+        if (value_idx != code.ABI_PARAM3.getIdx()) {
+            code.mov(code.ABI_PARAM3, Xbyak::Reg64{value_idx});
+        }
+        if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
+            code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
+        }
+    }
+    switch (bitsize) {
+    case 8:
+        DevirtualizeCallback<&A64::UserCallbacks::MemoryWrite8>().EmitCall(code);
+        break;
+    case 16:
+        DevirtualizeCallback<&A64::UserCallbacks::MemoryWrite16>().EmitCall(code);
+        break;
+    case 32:
+        DevirtualizeCallback<&A64::UserCallbacks::MemoryWrite32>().EmitCall(code);
+        break;
+    case 64:
+        DevirtualizeCallback<&A64::UserCallbacks::MemoryWrite64>().EmitCall(code);
+        break;
+    case 128:
+        code.call(memory_write_128);
+        break;
+    default:
+        UNREACHABLE();
     }
+    ABI_PopRegistersAndAdjustStack(code, 0, {});
+    code.ret();
+    PerfMapRegister(fallback, code.getCurr(), fmt::format("a64_write_fallback_{}", bitsize));
+    code.SwitchFromLazyCode();
+
+    return fallback;
 }
 
 void A64EmitX64::GenTerminalHandlers() {
@@ -333,9 +500,15 @@ void A64EmitX64::GenTerminalHandlers() {
         terminal_handler_fast_dispatch_hint = code.getCurr<const void*>();
         calculate_location_descriptor();
         code.L(rsb_cache_miss);
-        code.mov(r12, reinterpret_cast<u64>(fast_dispatch_table.data()));
+        if (IsSharedCodeCache()) {
+            code.mov(r12, qword[r15 + offsetof(A64JitState, fast_dispatch_table)]);
+        } else {
+            code.mov(r12, reinterpret_cast<u64>(fast_dispatch_tables.front()->data()));
+        }
+        // The index must be computed as in fast_dispatch_table_lookup, which is used to clear entries.
+        code.mov(rbp, rbx);
         if (code.HasSSE42()) {
-            code.crc32(rbx, r12d);
+            code.crc32(rbp, r12);
         }
         code.and_(ebp, fast_dispatch_table_mask);
         code.lea(rbp, ptr[r12 + rbp]);
@@ -350,8 +523,10 @@ void A64EmitX64::GenTerminalHandlers() {
         PerfMapRegister(terminal_handler_fast_dispatch_hint, code.getCurr(), "a64_terminal_handler_fast_dispatch_hint");
 
         code.align();
-        fast_dispatch_table_lookup = code.getCurr<FastDispatchEntry&(*)(u64)>();
-        code.mov(code.ABI_PARAM2, reinterpret_cast<u64>(fast_dispatch_table.data()));
+        fast_dispatch_table_lookup = code.getCurr<FastDispatchEntry&(*)(u64, FastDispatchTable*)>();
+        if (!IsSharedCodeCache()) {
+            code.mov(code.ABI_PARAM2, reinterpret_cast<u64>(fast_dispatch_tables.front()->data()));
+        }
         if (code.HasSSE42()) {
             code.crc32(code.ABI_PARAM1, code.ABI_PARAM2);
         }
@@ -624,7 +799,7 @@ void A64EmitX64::EmitA64CallSupervisor(A64EmitContext& ctx, IR::Inst* inst) {
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
     ASSERT(args[0].IsImmediate());
     const u32 imm = args[0].GetImmediateU32();
-    Devirtualize<&A64::UserCallbacks::CallSVC>(conf.callbacks).EmitCall(code,
+    DevirtualizeCallback<&A64::UserCallbacks::CallSVC>().EmitCall(code,
         [&](RegList param) {
             code.mov(param[0], imm);
         });
@@ -638,7 +813,7 @@ void A64EmitX64::EmitA64ExceptionRaised(A64EmitContext& ctx, IR::Inst* inst) {
     ASSERT(args[0].IsImmediate() && args[1].IsImmediate());
     const u64 pc = args[0].GetImmediateU64();
     const u64 exception = args[1].GetImmediateU64();
-    Devirtualize<&A64::UserCallbacks::ExceptionRaised>(conf.callbacks).EmitCall(code,
+    DevirtualizeCallback<&A64::UserCallbacks::ExceptionRaised>().EmitCall(code,
         [&](RegList param) {
             code.mov(param[0], pc);
             code.mov(param[1], exception);
@@ -648,13 +823,13 @@ void A64EmitX64::EmitA64ExceptionRaised(A64EmitContext& ctx, IR::Inst* inst) {
 void A64EmitX64::EmitA64DataCacheOperationRaised(A64EmitContext& ctx, IR::Inst* inst) {
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
     ctx.reg_alloc.HostCall(nullptr, {}, args[0], args[1]);
-    Devirtualize<&A64::UserCallbacks::DataCacheOperationRaised>(conf.callbacks).EmitCall(code);
+    DevirtualizeCallback<&A64::UserCallbacks::DataCacheOperationRaised>().EmitCall(code);
 }
 
 void A64EmitX64::EmitA64InstructionCacheOperationRaised(A64EmitContext& ctx, IR::Inst* inst) {
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
     ctx.reg_alloc.HostCall(nullptr, {}, args[0], args[1]);
-    Devirtualize<&A64::UserCallbacks::InstructionCacheOperationRaised>(conf.callbacks).EmitCall(code);
+    DevirtualizeCallback<&A64::UserCallbacks::InstructionCacheOperationRaised>().EmitCall(code);
 }
 
 void A64EmitX64::EmitA64DataSynchronizationBarrier(A64EmitContext&, IR::Inst*) {
@@ -671,7 +846,7 @@ void A64EmitX64::EmitA64InstructionSynchronizationBarrier(A64EmitContext& ctx, I
     }
 
     ctx.reg_alloc.HostCall(nullptr);
-    Devirtualize<&A64::UserCallbacks::InstructionSynchronizationBarrierRaised>(conf.callbacks).EmitCall(code);
+    DevirtualizeCallback<&A64::UserCallbacks::InstructionSynchronizationBarrierRaised>().EmitCall(code);
 }
 
 void A64EmitX64::EmitA64GetCNTFRQ(A64EmitContext& ctx, IR::Inst* inst) {
@@ -685,7 +860,7 @@ void A64EmitX64::EmitA64GetCNTPCT(A64EmitContext& ctx, IR::Inst* inst) {
     if (!conf.wall_clock_cntpct) {
         code.UpdateTicks();
     }
-    Devirtualize<&A64::UserCallbacks::GetCNTPCT>(conf.callbacks).EmitCall(code);
+    DevirtualizeCallback<&A64::UserCallbacks::GetCNTPCT>().EmitCall(code);
 }
 
 void A64EmitX64::EmitA64GetCTR(A64EmitContext& ctx, IR::Inst* inst) {
@@ -703,7 +878,7 @@ void A64EmitX64::EmitA64GetDCZID(A64EmitContext& ctx, IR::Inst* inst) {
 void A64EmitX64::EmitA64GetTPIDR(A64EmitContext& ctx, IR::Inst* inst) {
     const Xbyak::Reg64 result = ctx.reg_alloc.ScratchGpr();
     if (conf.tpidr_el0) {
-        code.mov(result, u64(conf.tpidr_el0));
+        EmitPerJitPointer(result, offsetof(A64JitState, tpidr_el0), conf.tpidr_el0);
         code.mov(result, qword[result]);
     } else {
         code.xor_(result.cvt32(), result.cvt32());
@@ -714,7 +889,7 @@ void A64EmitX64::EmitA64GetTPIDR(A64EmitContext& ctx, IR::Inst* inst) {
 void A64EmitX64::EmitA64GetTPIDRRO(A64EmitContext& ctx, IR::Inst* inst) {
     const Xbyak::Reg64 result = ctx.reg_alloc.ScratchGpr();
     if (conf.tpidrro_el0) {
-        code.mov(result, u64(conf.tpidrro_el0));
+        EmitPerJitPointer(result, offsetof(A64JitState, tpidrro_el0), conf.tpidrro_el0);
         code.mov(result, qword[result]);
     } else {
         code.xor_(result.cvt32(), result.cvt32());
@@ -727,7 +902,7 @@ void A64EmitX64::EmitA64SetTPIDR(A64EmitContext& ctx, IR::Inst* inst) {
     const Xbyak::Reg64 value = ctx.reg_alloc.UseGpr(args[0]);
     const Xbyak::Reg64 addr = ctx.reg_alloc.ScratchGpr();
     if (conf.tpidr_el0) {
-        code.mov(addr, u64(conf.tpidr_el0));
+        EmitPerJitPointer(addr, offsetof(A64JitState, tpidr_el0), conf.tpidr_el0);
         code.mov(qword[addr], value);
     }
 }
@@ -741,6 +916,8 @@ namespace {
 constexpr size_t page_bits = 12;
 constexpr size_t page_size = 1 << page_bits;
 constexpr size_t page_mask = (1 << page_bits) - 1;
+constexpr size_t page_table_level_bits = 9;
+constexpr size_t huge_page_mask = (1 << (page_bits + page_table_level_bits)) - 1;
 
 void EmitDetectMisaignedVAddr(BlockOfCode& code, A64EmitContext& ctx, size_t bitsize, Xbyak::Label& abort, Xbyak::Reg64 vaddr, Xbyak::Reg64 tmp) {
     if (bitsize == 8 || (ctx.conf.detect_misaligned_access_via_page_table & bitsize) == 0) {
@@ -785,7 +962,195 @@ void EmitDetectMisaignedVAddr(BlockOfCode& code, A64EmitContext& ctx, size_t bit
     code.SwitchToNearCode();
 }
 
+bool IsWideMemoryAccess(const IR::Inst* inst) {
+    switch (inst->GetOpcode()) {
+    case IR::Opcode::A64ReadMemoryWide64:
+    case IR::Opcode::A64ReadMemoryWide128:
+    case IR::Opcode::A64WriteMemoryWide64:
+    case IR::Opcode::A64WriteMemoryWide128:
+    case IR::Opcode::A64ReadMemoryWideInPage64:
+    case IR::Opcode::A64ReadMemoryWideInPage128:
+    case IR::Opcode::A64WriteMemoryWideInPage64:
+    case IR::Opcode::A64WriteMemoryWideInPage128:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// A wide access combines contiguous accesses of esize bits each and is only aligned to esize.
+/// It is performed inline only if it stays within a page and, where detection is enabled for esize,
+/// is aligned to esize. Otherwise the fallback performs the accesses it combines one by one.
+void EmitDetectWideAccessFallback(BlockOfCode& code, A64EmitContext& ctx, size_t bitsize, size_t esize, Xbyak::Label& abort, Xbyak::Reg64 vaddr, Xbyak::Reg64 tmp) {
+    if (esize != 8 && (ctx.conf.detect_misaligned_access_via_page_table & esize) != 0) {
+        code.test(vaddr, static_cast<u32>(esize / 8 - 1));
+        code.jnz(abort, code.T_NEAR);
+    }
+
+    code.mov(tmp.cvt32(), vaddr.cvt32());
+    code.and_(tmp.cvt32(), static_cast<u32>(page_mask));
+    code.cmp(tmp.cvt32(), static_cast<u32>(page_size - bitsize / 8));
+    code.ja(abort, code.T_NEAR);
+}
+
+} // anonymous namespace
+
+u8* LookupPageTable(const A64::UserConfig& conf, u64 vaddr) {
+    const size_t unused_top_bits = 64 - conf.page_table_address_space_bits;
+    const u64 index_vaddr = (vaddr << unused_top_bits) >> unused_top_bits;
+    if (index_vaddr != vaddr && !conf.silently_mirror_page_table) {
+        return nullptr;
+    }
+
+    const size_t levels = conf.page_table_levels;
+    size_t shift = page_bits + page_table_level_bits * (levels - 1);
+    u64 entry = reinterpret_cast<u64>(conf.page_table[index_vaddr >> shift]);
+    for (size_t level = 1; level < levels && entry != 0; level++) {
+        if (conf.page_table_huge_pages && level == levels - 1 && (entry & 1) != 0) {
+            return reinterpret_cast<u8*>(entry & ~u64(1)) + (conf.absolute_offset_page_table ? vaddr : vaddr & huge_page_mask);
+        }
+        shift -= page_table_level_bits;
+        const auto table = reinterpret_cast<void* const*>(entry);
+        entry = reinterpret_cast<u64>(table[(index_vaddr >> shift) & ((1 << page_table_level_bits) - 1)]);
+    }
+    entry &= ~u64(0) << conf.page_table_pointer_mask_bits;
+    if (entry == 0) {
+        return nullptr;
+    }
+    return reinterpret_cast<u8*>(entry) + (conf.absolute_offset_page_table ? vaddr : vaddr & page_mask);
+}
+
+namespace {
+
+bool RefillTLB(A64JitState* jit_state, u64 vaddr) {
+    const u64 page = vaddr >> page_bits;
+    void* const host = jit_state->user_callbacks->TranslatePage(page << page_bits);
+    if (!host) {
+        return false;
+    }
+    A64JitState::TLBEntry& entry = jit_state->tlb[page & (jit_state->user_config->tlb_entry_count - 1)];
+    entry.tag = page;
+    entry.host_offset = reinterpret_cast<u64>(host) - (page << page_bits);
+    return true;
+}
+
+Xbyak::RegExp EmitTLBLookup(BlockOfCode& code, A64EmitContext& ctx, size_t bitsize, Xbyak::Label& abort, Xbyak::Reg64 vaddr) {
+    static_assert(sizeof(A64JitState::TLBEntry) == 16);
+
+    const Xbyak::Reg64 entry = ctx.reg_alloc.ScratchGpr();
+    const Xbyak::Reg64 tag = ctx.reg_alloc.ScratchGpr();
+
+    EmitDetectMisaignedVAddr(code, ctx, bitsize, abort, vaddr, tag);
+
+    Xbyak::Label retry, miss;
+
+    code.L(retry);
+    code.mov(tag, vaddr);
+    code.shr(tag, int(page_bits));
+    code.mov(entry.cvt32(), vaddr.cvt32());
+    code.shr(entry.cvt32(), int(page_bits - 4));
+    code.and_(entry.cvt32(), static_cast<u32>((ctx.conf.tlb_entry_count - 1) << 4));
+    code.cmp(tag, qword[r14 + entry + offsetof(A64JitState::TLBEntry, tag)]);
+    code.jne(miss, code.T_NEAR);
+    code.mov(entry, qword[r14 + entry + offsetof(A64JitState::TLBEntry, host_offset)]);
+
+    // Refill the entry and retry, or give up if the page has no host memory.
+    // Registers other than `tag` may hold values of the current instruction, so all are preserved.
+    code.SwitchToFarCode();
+    code.L(miss);
+    code.sub(rsp, 8);
+    const std::vector<HostLoc> occupied = ctx.reg_alloc.OccupiedCallerSaveRegistersExcept(HostLocRegIdx(tag.getIdx()));
+    ABI_PushRegistersAndAdjustStack(code, 0, occupied);
+    code.mov(code.ABI_PARAM2, vaddr);
+    code.mov(code.ABI_PARAM1, r15);
+    code.CallFunction(&RefillTLB);
+    code.movzx(tag.cvt32(), code.ABI_RETURN.cvt8());
+    ABI_PopRegistersAndAdjustStack(code, 0, occupied);
+    code.add(rsp, 8);
+    code.test(tag.cvt32(), tag.cvt32());
+    code.jz(abort, code.T_NEAR);
+    code.jmp(retry, code.T_NEAR);
+    code.SwitchToNearCode();
+
+    return entry + vaddr;
+}
+
+Xbyak::RegExp EmitMultiLevelVAddrLookup(BlockOfCode& code, A64EmitContext& ctx, size_t bitsize, Xbyak::Label& abort, Xbyak::Reg64 vaddr) {
+    const size_t levels = ctx.conf.page_table_levels;
+    const size_t unused_top_bits = 64 - ctx.conf.page_table_address_space_bits;
+    const size_t top_shift = page_bits + page_table_level_bits * (levels - 1);
+
+    const Xbyak::Reg64 page = ctx.reg_alloc.ScratchGpr();
+    const Xbyak::Reg64 tmp = ctx.reg_alloc.ScratchGpr();
+
+    EmitDetectMisaignedVAddr(code, ctx, bitsize, abort, vaddr, tmp);
+
+    code.mov(tmp, vaddr);
+    if (unused_top_bits == 0) {
+        code.shr(tmp, int(top_shift));
+    } else if (ctx.conf.silently_mirror_page_table) {
+        code.shl(tmp, int(unused_top_bits));
+        code.shr(tmp, int(unused_top_bits + top_shift));
+    } else {
+        code.shr(tmp, int(ctx.conf.page_table_address_space_bits));
+        code.jnz(abort, code.T_NEAR);
+        code.mov(tmp, vaddr);
+        code.shr(tmp, int(top_shift));
+    }
+    code.mov(page, qword[r14 + tmp * sizeof(void*)]);
+
+    Xbyak::Label huge_page, end;
+
+    for (size_t level = 1; level < levels; level++) {
+        code.test(page, page);
+        code.jz(abort, code.T_NEAR);
+        if (ctx.conf.page_table_huge_pages && level == levels - 1) {
+            code.test(page.cvt8(), 1);
+            code.jnz(huge_page, code.T_NEAR);
+        }
+        code.mov(tmp, vaddr);
+        code.shr(tmp, int(page_bits + page_table_level_bits * (levels - 1 - level)));
+        code.and_(tmp.cvt32(), u32((1 << page_table_level_bits) - 1));
+        code.mov(page, qword[page + tmp * sizeof(void*)]);
+    }
+    if (ctx.conf.page_table_pointer_mask_bits == 0) {
+        code.test(page, page);
+    } else {
+        code.and_(page, ~u32(0) << ctx.conf.page_table_pointer_mask_bits);
+    }
+    code.jz(abort, code.T_NEAR);
+    if (!ctx.conf.absolute_offset_page_table) {
+        code.mov(tmp, vaddr);
+        code.and_(tmp, static_cast<u32>(page_mask));
+    }
+    code.L(end);
+
+    if (ctx.conf.page_table_huge_pages) {
+        code.SwitchToFarCode();
+        code.L(huge_page);
+        code.and_(page, ~u32(1));
+        if (!ctx.conf.absolute_offset_page_table) {
+            code.mov(tmp, vaddr);
+            code.and_(tmp, static_cast<u32>(huge_page_mask));
+        }
+        code.jmp(end, code.T_NEAR);
+        code.SwitchToNearCode();
+    }
+
+    if (ctx.conf.absolute_offset_page_table) {
+        return page + vaddr;
+    }
+    return page + tmp;
+}
+
 Xbyak::RegExp EmitVAddrLookup(BlockOfCode& code, A64EmitContext& ctx, size_t bitsize, Xbyak::Label& abort, Xbyak::Reg64 vaddr) {
+    if (ctx.conf.tlb_entry_count) {
+        return EmitTLBLookup(code, ctx, bitsize, abort, vaddr);
+    }
+    if (ctx.conf.page_table_levels > 1) {
+        return EmitMultiLevelVAddrLookup(code, ctx, bitsize, abort, vaddr);
+    }
+
     const size_t valid_page_index_bits = ctx.conf.page_table_address_space_bits - page_bits;
     const size_t unused_top_bits = 64 - ctx.conf.page_table_address_space_bits;
 
@@ -815,12 +1180,17 @@ Xbyak::RegExp EmitVAddrLookup(BlockOfCode& code, A64EmitContext& ctx, size_t bit
             code.shr(tmp, int(page_bits));
             code.and_(tmp, u32((1 << valid_page_index_bits) - 1));
         }
-    } else {
-        ASSERT(valid_page_index_bits < 32);
+    } else if (valid_page_index_bits < 32) {
         code.mov(tmp, vaddr);
         code.shr(tmp, int(page_bits));
         code.test(tmp, u32(-(1 << valid_page_index_bits)));
         code.jnz(abort, code.T_NEAR);
+    } else {
+        code.mov(tmp, vaddr);
+        code.shr(tmp, int(ctx.conf.page_table_address_space_bits));
+        code.jnz(abort, code.T_NEAR);
+        code.mov(tmp, vaddr);
+        code.shr(tmp, int(page_bits));
     }
     code.mov(page, qword[r14 + tmp * sizeof(void*)]);
     if (ctx.conf.page_table_pointer_mask_bits == 0) {
@@ -837,240 +1207,871 @@ Xbyak::RegExp EmitVAddrLookup(BlockOfCode& code, A64EmitContext& ctx, size_t bit
     return page + tmp;
 }
 
-template<std::size_t bitsize>
-void EmitReadMemoryMov(BlockOfCode& code, const Xbyak::Reg64& value, const Xbyak::RegExp& addr) {
-    switch (bitsize) {
-    case 8:
-        code.movzx(value.cvt32(), code.byte[addr]);
-        return;
-    case 16:
-        code.movzx(value.cvt32(), word[addr]);
-        return;
-    case 32:
-        code.mov(value.cvt32(), dword[addr]);
-        return;
-    case 64:
-        code.mov(value, qword[addr]);
-        return;
-    default:
-        ASSERT_FALSE("Invalid bitsize");
+Xbyak::RegExp EmitFastmemVAddr(BlockOfCode& code, A64EmitContext& ctx, Xbyak::Label& abort, Xbyak::Reg64 vaddr, bool& require_abort_handling) {
+    const size_t unused_top_bits = 64 - ctx.conf.fastmem_address_space_bits;
+
+    if (unused_top_bits == 0) {
+        return r13 + vaddr;
+    } else if (ctx.conf.silently_mirror_fastmem) {
+        const Xbyak::Reg64 tmp = ctx.reg_alloc.ScratchGpr();
+        if (unused_top_bits < 32) {
+            code.mov(tmp, vaddr);
+            code.shl(tmp, int(unused_top_bits));
+            code.shr(tmp, int(unused_top_bits));
+        } else if (unused_top_bits == 32) {
+            code.mov(tmp.cvt32(), vaddr.cvt32());
+        } else {
+            code.mov(tmp.cvt32(), vaddr.cvt32());
+            code.and_(tmp, u32((u64{1} << ctx.conf.fastmem_address_space_bits) - 1));
+        }
+        return r13 + tmp;
+    } else {
+        if (ctx.conf.fastmem_address_space_bits < 32) {
+            code.test(vaddr, u32(-(u64{1} << ctx.conf.fastmem_address_space_bits)));
+            code.jnz(abort, code.T_NEAR);
+            require_abort_handling = true;
+        } else {
+            // TODO: Consider having TEST as above but coalesce 64-bit constant in register allocator
+            const Xbyak::Reg64 tmp = ctx.reg_alloc.ScratchGpr();
+            code.mov(tmp, vaddr);
+            code.shr(tmp, int(ctx.conf.fastmem_address_space_bits));
+            code.jnz(abort, code.T_NEAR);
+            require_abort_handling = true;
+        }
+        return r13 + vaddr;
     }
 }
 
-template<std::size_t bitsize>
-void EmitWriteMemoryMov(BlockOfCode& code, const Xbyak::RegExp& addr, const Xbyak::Reg64& value) {
-    switch (bitsize) {
-    case 8:
-        code.mov(code.byte[addr], value.cvt8());
-        return;
-    case 16:
-        code.mov(word[addr], value.cvt16());
-        return;
-    case 32:
-        code.mov(dword[addr], value.cvt32());
-        return;
-    case 64:
-        code.mov(qword[addr], value);
-        return;
-    default:
-        ASSERT_FALSE("Invalid bitsize");
+u8* LookupHostAddress(A64JitState* jit_state, u64 vaddr) {
+    const A64::UserConfig& conf = *jit_state->user_config;
+    if (conf.tlb_entry_count) {
+        const u64 page = vaddr >> page_bits;
+        const A64JitState::TLBEntry& entry = jit_state->tlb[page & (conf.tlb_entry_count - 1)];
+        if (entry.tag != page && !RefillTLB(jit_state, vaddr)) {
+            return nullptr;
+        }
+        return reinterpret_cast<u8*>(vaddr + entry.host_offset);
     }
+    return LookupPageTable(conf, vaddr);
 }
 
-} // anonymous namepsace
+/// Host address of an element of a wide access, or nullptr if the access of that element on its own
+/// would have used the memory callbacks.
+u8* LookupWideElementHostAddress(A64JitState* jit_state, u64 vaddr, size_t esize) {
+    const A64::UserConfig& conf = *jit_state->user_config;
+    if (!conf.page_table && !conf.tlb_entry_count) {
+        return nullptr;
+    }
 
-template<std::size_t bitsize>
-void A64EmitX64::EmitDirectPageTableMemoryRead(A64EmitContext& ctx, IR::Inst* inst) {
-    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+    const u64 align_mask = esize / 8 - 1;
+    if (esize != 8 && (conf.detect_misaligned_access_via_page_table & esize) != 0 && (vaddr & align_mask) != 0) {
+        const u64 page_align_mask = page_mask & ~align_mask;
+        if (!conf.only_detect_misalignment_via_page_table_on_page_boundary || (vaddr & page_align_mask) == page_align_mask) {
+            return nullptr;
+        }
+    }
 
-    const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
-    const Xbyak::Reg64 value = ctx.reg_alloc.ScratchGpr();
+    return LookupHostAddress(jit_state, vaddr);
+}
 
-    const auto wrapped_fn = read_fallbacks[std::make_tuple(bitsize, vaddr.getIdx(), value.getIdx())];
+template<size_t bitsize>
+void ReadMemoryWideFallback(A64JitState* jit_state, u64 vaddr, u8* buffer, size_t esize) {
+    const size_t ebytes = esize / 8;
+    for (size_t offset = 0; offset < bitsize / 8; offset += ebytes) {
+        const u64 element_vaddr = vaddr + offset;
+        if (const u8* host = LookupWideElementHostAddress(jit_state, element_vaddr, esize)) {
+            std::memcpy(buffer + offset, host, ebytes);
+            continue;
+        }
 
-    Xbyak::Label abort, end;
+        A64::UserCallbacks& cb = *jit_state->user_callbacks;
+        u64 value;
+        switch (esize) {
+        case 8:
+            value = cb.MemoryRead8(element_vaddr);
+            break;
+        case 16:
+            value = cb.MemoryRead16(element_vaddr);
+            break;
+        case 32:
+            value = cb.MemoryRead32(element_vaddr);
+            break;
+        case 64:
+            value = cb.MemoryRead64(element_vaddr);
+            break;
+        default:
+            UNREACHABLE();
+        }
+        std::memcpy(buffer + offset, &value, ebytes);
+    }
+}
 
-    const auto src_ptr = EmitVAddrLookup(code, ctx, bitsize, abort, vaddr);
-    EmitReadMemoryMov<bitsize>(code, value, src_ptr);
-    code.L(end);
+template<size_t bitsize>
+void WriteMemoryWideFallback(A64JitState* jit_state, u64 vaddr, const u8* buffer, size_t esize) {
+    const size_t ebytes = esize / 8;
+    for (size_t offset = 0; offset < bitsize / 8; offset += ebytes) {
+        const u64 element_vaddr = vaddr + offset;
+        if (u8* host = LookupWideElementHostAddress(jit_state, element_vaddr, esize)) {
+            std::memcpy(host, buffer + offset, ebytes);
+            continue;
+        }
+
+        A64::UserCallbacks& cb = *jit_state->user_callbacks;
+        u64 value = 0;
+        std::memcpy(&value, buffer + offset, ebytes);
+        switch (esize) {
+        case 8:
+            cb.MemoryWrite8(element_vaddr, static_cast<u8>(value));
+            break;
+        case 16:
+            cb.MemoryWrite16(element_vaddr, static_cast<u16>(value));
+            break;
+        case 32:
+            cb.MemoryWrite32(element_vaddr, static_cast<u32>(value));
+            break;
+        case 64:
+            cb.MemoryWrite64(element_vaddr, value);
+            break;
+        default:
+            UNREACHABLE();
+        }
+    }
+}
+
+/// Addresses vaddr through `page`, the host address of a page looked up by A64LookupPage at an
+/// address `delta` bytes below vaddr. Otherwise, or if that page was unmapped, vaddr is looked up itself.
+Xbyak::RegExp EmitVAddrInPage(BlockOfCode& code, A64EmitContext& ctx, size_t bitsize, Xbyak::Label& abort, Xbyak::Reg64 vaddr, Xbyak::Reg64 page, u16 delta) {
+    const Xbyak::Reg64 offset = ctx.reg_alloc.ScratchGpr();
+
+    EmitDetectMisaignedVAddr(code, ctx, bitsize, abort, vaddr, offset);
+
+    Xbyak::Label lookup, resume;
+
+    code.test(page, page);
+    code.jz(lookup, code.T_NEAR);
+    code.mov(offset.cvt32(), vaddr.cvt32());
+    code.and_(offset.cvt32(), static_cast<u32>(page_mask));
+    if (delta != 0) {
+        // vaddr is on the looked up page only if it did not cross into the next one.
+        code.cmp(offset.cvt32(), delta);
+        code.jb(lookup, code.T_NEAR);
+    }
+    code.L(resume);
 
     code.SwitchToFarCode();
-    code.L(abort);
-    code.call(wrapped_fn);
-    code.jmp(end, code.T_NEAR);
+    code.L(lookup);
+    code.sub(rsp, 8);
+    const std::vector<HostLoc> occupied = ctx.reg_alloc.OccupiedCallerSaveRegistersExcept(HostLocRegIdx(offset.getIdx()));
+    ABI_PushRegistersAndAdjustStack(code, 0, occupied);
+    code.mov(code.ABI_PARAM2, vaddr);
+    code.mov(code.ABI_PARAM1, r15);
+    code.CallFunction(&LookupHostAddress);
+    code.mov(offset, code.ABI_RETURN);
+    ABI_PopRegistersAndAdjustStack(code, 0, occupied);
+    code.add(rsp, 8);
+    code.test(offset, offset);
+    code.jz(abort, code.T_NEAR);
+    code.sub(offset, page);
+    code.jmp(resume, code.T_NEAR);
     code.SwitchToNearCode();
 
-    ctx.reg_alloc.DefineValue(inst, value);
+    return page + offset;
 }
 
 template<std::size_t bitsize>
-void A64EmitX64::EmitDirectPageTableMemoryWrite(A64EmitContext& ctx, IR::Inst* inst) {
-    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-
-    const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
-    const Xbyak::Reg64 value = ctx.reg_alloc.UseGpr(args[1]);
+const void* EmitReadMemoryMov(BlockOfCode& code, int value_idx, const Xbyak::RegExp& addr) {
+    const void* fastmem_location = code.getCurr();
+    switch (bitsize) {
+    case 8:
+        code.movzx(Xbyak::Reg32{value_idx}, code.byte[addr]);
+        break;
+    case 16:
+        code.movzx(Xbyak::Reg32{value_idx}, word[addr]);
+        break;
+    case 32:
+        code.mov(Xbyak::Reg32{value_idx}, dword[addr]);
+        break;
+    case 64:
+        code.mov(Xbyak::Reg64{value_idx}, qword[addr]);
+        break;
+    case 128:
+        code.movups(Xbyak::Xmm{value_idx}, xword[addr]);
+        break;
+    default:
+        ASSERT_FALSE("Invalid bitsize");
+    }
+    return fastmem_location;
+}
 
-    const auto wrapped_fn = write_fallbacks[std::make_tuple(bitsize, vaddr.getIdx(), value.getIdx())];
+template<std::size_t bitsize>
+const void* EmitWriteMemoryMov(BlockOfCode& code, const Xbyak::RegExp& addr, int value_idx) {
+    const void* fastmem_location = code.getCurr();
+    switch (bitsize) {
+    case 8:
+        code.mov(code.byte[addr], Xbyak::Reg64{value_idx}.cvt8());
+        break;
+    case 16:
+        code.mov(word[addr], Xbyak::Reg16{value_idx});
+        break;
+    case 32:
+        code.mov(dword[addr], Xbyak::Reg32{value_idx});
+        break;
+    case 64:
+        code.mov(qword[addr], Xbyak::Reg64{value_idx});
+        break;
+    case 128:
+        code.movups(xword[addr], Xbyak::Xmm{value_idx});
+        break;
+    default:
+        ASSERT_FALSE("Invalid bitsize");
+    }
+    return fastmem_location;
+}
 
-    Xbyak::Label abort, end;
+Xbyak::Address SizedMemoryOperand(size_t bitsize, const Xbyak::RegExp& addr) {
+    switch (bitsize) {
+    case 8:
+        return Xbyak::util::byte[addr];
+    case 16:
+        return word[addr];
+    case 32:
+        return dword[addr];
+    case 64:
+        return qword[addr];
+    default:
+        ASSERT_FALSE("Invalid bitsize");
+    }
+}
 
-    const auto dest_ptr = EmitVAddrLookup(code, ctx, bitsize, abort, vaddr);
-    EmitWriteMemoryMov<bitsize>(code, dest_ptr, value);
-    code.L(end);
+} // anonymous namepsace
 
-    code.SwitchToFarCode();
-    code.L(abort);
-    code.call(wrapped_fn);
-    code.jmp(end, code.T_NEAR);
-    code.SwitchToNearCode();
+size_t A64EmitX64::WideFallbackIndex(size_t bitsize, size_t esize, int vaddr_idx, int value_idx) {
+    return (static_cast<size_t>(bitsize == 128) * 4 + static_cast<size_t>(Common::HighestSetBit(esize) - 3)) * 256 + vaddr_idx * 16 + value_idx;
 }
 
-void A64EmitX64::EmitA64ReadMemory8(A64EmitContext& ctx, IR::Inst* inst) {
-    if (conf.page_table) {
-        EmitDirectPageTableMemoryRead<8>(ctx, inst);
-        return;
+A64EmitX64::FallbackFn A64EmitX64::GetWideReadFallback(size_t bitsize, size_t esize, int vaddr_idx, int value_idx) {
+    FallbackFn& fallback = wide_read_fallbacks[WideFallbackIndex(bitsize, esize, vaddr_idx, value_idx)];
+    if (fallback) {
+        return fallback;
     }
 
-    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-    ctx.reg_alloc.HostCall(inst, {}, args[0]);
-    Devirtualize<&A64::UserCallbacks::MemoryRead8>(conf.callbacks).EmitCall(code);
+    code.SwitchToLazyCode();
+    code.align();
+    fallback = code.getCurr<FallbackFn>();
+    ABI_PushRegistersAndAdjustStack(code, 16, {});
+    if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
+        code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
+    }
+    code.mov(code.ABI_PARAM1, r15);
+    code.lea(code.ABI_PARAM3, ptr[rsp + ABI_SHADOW_SPACE]);
+    code.mov(code.ABI_PARAM4.cvt32(), static_cast<u32>(esize));
+    if (bitsize == 128) {
+        code.CallFunction(&ReadMemoryWideFallback<128>);
+        code.movups(Xbyak::Xmm{value_idx}, xword[rsp + ABI_SHADOW_SPACE]);
+    } else {
+        code.CallFunction(&ReadMemoryWideFallback<64>);
+        code.mov(Xbyak::Reg64{value_idx}, qword[rsp + ABI_SHADOW_SPACE]);
+    }
+    ABI_PopRegistersAndAdjustStack(code, 16, {});
+    code.ret();
+    PerfMapRegister(fallback, code.getCurr(), fmt::format("a64_wide_read_fallback_{}_{}", bitsize, esize));
+    code.SwitchFromLazyCode();
+
+    return fallback;
 }
 
-void A64EmitX64::EmitA64ReadMemory16(A64EmitContext& ctx, IR::Inst* inst) {
-    if (conf.page_table) {
-        EmitDirectPageTableMemoryRead<16>(ctx, inst);
-        return;
+A64EmitX64::FallbackFn A64EmitX64::GetWideWriteFallback(size_t bitsize, size_t esize, int vaddr_idx, int value_idx) {
+    FallbackFn& fallback = wide_write_fallbacks[WideFallbackIndex(bitsize, esize, vaddr_idx, value_idx)];
+    if (fallback) {
+        return fallback;
     }
 
-    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-    ctx.reg_alloc.HostCall(inst, {}, args[0]);
-    Devirtualize<&A64::UserCallbacks::MemoryRead16>(conf.callbacks).EmitCall(code);
+    code.SwitchToLazyCode();
+    code.align();
+    fallback = code.getCurr<FallbackFn>();
+    ABI_PushRegistersAndAdjustStack(code, 16, {});
+    if (bitsize == 128) {
+        code.movups(xword[rsp + ABI_SHADOW_SPACE], Xbyak::Xmm{value_idx});
+    } else {
+        code.mov(qword[rsp + ABI_SHADOW_SPACE], Xbyak::Reg64{value_idx});
+    }
+    if (vaddr_idx != code.ABI_PARAM2.getIdx()) {
+        code.mov(code.ABI_PARAM2, Xbyak::Reg64{vaddr_idx});
+    }
+    code.mov(code.ABI_PARAM1, r15);
+    code.lea(code.ABI_PARAM3, ptr[rsp + ABI_SHADOW_SPACE]);
+    code.mov(code.ABI_PARAM4.cvt32(), static_cast<u32>(esize));
+    if (bitsize == 128) {
+        code.CallFunction(&WriteMemoryWideFallback<128>);
+    } else {
+        code.CallFunction(&WriteMemoryWideFallback<64>);
+    }
+    ABI_PopRegistersAndAdjustStack(code, 16, {});
+    code.ret();
+    PerfMapRegister(fallback, code.getCurr(), fmt::format("a64_wide_write_fallback_{}_{}", bitsize, esize));
+    code.SwitchFromLazyCode();
+
+    return fallback;
 }
 
-void A64EmitX64::EmitA64ReadMemory32(A64EmitContext& ctx, IR::Inst* inst) {
-    if (conf.page_table) {
-        EmitDirectPageTableMemoryRead<32>(ctx, inst);
-        return;
+std::optional<A64EmitX64::DoNotFastmemMarker> A64EmitX64::ShouldFastmem(A64EmitContext& ctx, IR::Inst* inst) const {
+    if (!conf.fastmem_pointer || !exception_handler.SupportsFastmem()) {
+        return std::nullopt;
     }
 
-    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-    ctx.reg_alloc.HostCall(inst, {}, args[0]);
-    Devirtualize<&A64::UserCallbacks::MemoryRead32>(conf.callbacks).EmitCall(code);
+    const auto marker = std::make_tuple(ctx.Location(), ctx.GetInstOffset(inst));
+    if (do_not_fastmem.count(marker) > 0) {
+        return std::nullopt;
+    }
+    return marker;
 }
 
-void A64EmitX64::EmitA64ReadMemory64(A64EmitContext& ctx, IR::Inst* inst) {
-    if (conf.page_table) {
-        EmitDirectPageTableMemoryRead<64>(ctx, inst);
-        return;
+FakeCall A64EmitX64::FastmemCallback(u64 rip_) {
+    const auto iter = fastmem_patch_info.find(rip_);
+    ASSERT(iter != fastmem_patch_info.end());
+    if (conf.recompile_on_fastmem_failure) {
+        const auto marker = iter->second.marker;
+        do_not_fastmem.emplace(marker);
+        InvalidateBasicBlocks({std::get<0>(marker)});
     }
+    FakeCall ret;
+    ret.call_rip = iter->second.callback;
+    ret.ret_rip = iter->second.resume_rip;
+    return ret;
+}
 
+template<std::size_t bitsize, auto callback>
+void A64EmitX64::EmitMemoryRead(A64EmitContext& ctx, IR::Inst* inst) {
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-    ctx.reg_alloc.HostCall(inst, {}, args[0]);
-    Devirtualize<&A64::UserCallbacks::MemoryRead64>(conf.callbacks).EmitCall(code);
-}
+    const auto fastmem_marker = ShouldFastmem(ctx, inst);
+    const bool is_wide = IsWideMemoryAccess(inst);
+
+    if (!HasInlinePageLookup() && !fastmem_marker && !is_wide) {
+        // Neither fastmem nor page table: Use callbacks
+        if constexpr (bitsize == 128) {
+            ctx.reg_alloc.HostCall(nullptr, {}, args[0]);
+            code.CallFunction(memory_read_128);
+            ctx.reg_alloc.DefineValue(inst, xmm1);
+        } else {
+            ctx.reg_alloc.HostCall(inst, {}, args[0]);
+            DevirtualizeCallback<callback>().EmitCall(code);
+        }
+        return;
+    }
 
-void A64EmitX64::EmitA64ReadMemory128(A64EmitContext& ctx, IR::Inst* inst) {
-    if (conf.page_table) {
-        Xbyak::Label abort, end;
+    const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
+    const int value_idx = bitsize == 128 ? ctx.reg_alloc.ScratchXmm().getIdx() : ctx.reg_alloc.ScratchGpr().getIdx();
+    const size_t esize = is_wide ? args[inst->NumArgs() - 1].GetImmediateU8() : bitsize;
+    const auto get_fallback = [&] {
+        const FallbackFn fallback = is_wide ? GetWideReadFallback(bitsize, esize, vaddr.getIdx(), value_idx) : GetReadFallback(bitsize, vaddr.getIdx(), value_idx);
+        return WrapFallback(fallback, ctx.reg_alloc.LiveCallerSaveRegisters());
+    };
 
-        auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-        const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
-        const Xbyak::Xmm value = ctx.reg_alloc.ScratchXmm();
+    if (!HasInlinePageLookup() && !fastmem_marker) {
+        // Wide access with neither fastmem nor page table: Use a callback per element
+        code.call(get_fallback());
+        if constexpr (bitsize == 128) {
+            ctx.reg_alloc.DefineValue(inst, Xbyak::Xmm{value_idx});
+        } else {
+            ctx.reg_alloc.DefineValue(inst, Xbyak::Reg64{value_idx});
+        }
+        return;
+    }
 
-        const auto src_ptr = EmitVAddrLookup(code, ctx, 128, abort, vaddr);
-        code.movups(value, xword[src_ptr]);
-        code.L(end);
+    Xbyak::Label abort, end;
+    bool require_abort_handling = false;
+    const void* location = nullptr;
+
+    if (fastmem_marker) {
+        // Use fastmem
+        const auto src_ptr = EmitFastmemVAddr(code, ctx, abort, vaddr, require_abort_handling);
+        location = EmitReadMemoryMov<bitsize>(code, value_idx, src_ptr);
+    } else if (inst->NumArgs() > (is_wide ? 2 : 1)) {
+        // A64ReadMemory{Wide,}InPage*: Use the page looked up for nearby accesses
+        const Xbyak::Reg64 page = ctx.reg_alloc.UseGpr(args[1]);
+        if (is_wide) {
+            EmitDetectWideAccessFallback(code, ctx, bitsize, esize, abort, vaddr, ctx.reg_alloc.ScratchGpr());
+        }
+        const auto src_ptr = EmitVAddrInPage(code, ctx, is_wide ? 8 : bitsize, abort, vaddr, page, args[2].GetImmediateU16());
+        require_abort_handling = true;
+        EmitReadMemoryMov<bitsize>(code, value_idx, src_ptr);
+    } else {
+        // Use page table
+        ASSERT(HasInlinePageLookup());
+        if (is_wide) {
+            EmitDetectWideAccessFallback(code, ctx, bitsize, esize, abort, vaddr, ctx.reg_alloc.ScratchGpr());
+        }
+        const auto src_ptr = EmitVAddrLookup(code, ctx, is_wide ? 8 : bitsize, abort, vaddr);
+        require_abort_handling = true;
+        EmitReadMemoryMov<bitsize>(code, value_idx, src_ptr);
+    }
+    code.L(end);
+
+    const auto wrapped_fn = get_fallback();
+
+    if (fastmem_marker) {
+        fastmem_patch_info.emplace(
+            Common::BitCast<u64>(location),
+            FastmemPatchInfo{
+                Common::BitCast<u64>(end.getAddress()),
+                Common::BitCast<u64>(wrapped_fn),
+                *fastmem_marker,
+            }
+        );
+    }
 
+    if (require_abort_handling) {
         code.SwitchToFarCode();
         code.L(abort);
-        code.call(read_fallbacks[std::make_tuple(128, vaddr.getIdx(), value.getIdx())]);
+        code.call(wrapped_fn);
         code.jmp(end, code.T_NEAR);
         code.SwitchToNearCode();
+    }
 
-        ctx.reg_alloc.DefineValue(inst, value);
-        return;
+    if constexpr (bitsize == 128) {
+        ctx.reg_alloc.DefineValue(inst, Xbyak::Xmm{value_idx});
+    } else {
+        ctx.reg_alloc.DefineValue(inst, Xbyak::Reg64{value_idx});
     }
+}
 
+template<std::size_t bitsize, auto callback>
+void A64EmitX64::EmitMemoryWrite(A64EmitContext& ctx, IR::Inst* inst) {
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-    ctx.reg_alloc.HostCall(nullptr, {}, args[0]);
-    code.CallFunction(memory_read_128);
-    ctx.reg_alloc.DefineValue(inst, xmm1);
-}
+    const auto fastmem_marker = ShouldFastmem(ctx, inst);
+    const bool is_wide = IsWideMemoryAccess(inst);
+
+    if (!HasInlinePageLookup() && !fastmem_marker && !is_wide) {
+        // Neither fastmem nor page table: Use callbacks
+        if constexpr (bitsize == 128) {
+            ctx.reg_alloc.Use(args[0], ABI_PARAM2);
+            ctx.reg_alloc.Use(args[1], HostLoc::XMM1);
+            ctx.reg_alloc.EndOfAllocScope();
+            ctx.reg_alloc.HostCall(nullptr);
+            code.CallFunction(memory_write_128);
+        } else {
+            ctx.reg_alloc.HostCall(nullptr, {}, args[0], args[1]);
+            DevirtualizeCallback<callback>().EmitCall(code);
+        }
+        return;
+    }
 
-void A64EmitX64::EmitA64WriteMemory8(A64EmitContext& ctx, IR::Inst* inst) {
-    if (conf.page_table) {
-        EmitDirectPageTableMemoryWrite<8>(ctx, inst);
+    const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
+    const int value_idx = bitsize == 128 ? ctx.reg_alloc.UseXmm(args[1]).getIdx() : ctx.reg_alloc.UseGpr(args[1]).getIdx();
+    const size_t esize = is_wide ? args[inst->NumArgs() - 1].GetImmediateU8() : bitsize;
+    const auto get_fallback = [&] {
+        const FallbackFn fallback = is_wide ? GetWideWriteFallback(bitsize, esize, vaddr.getIdx(), value_idx) : GetWriteFallback(bitsize, vaddr.getIdx(), value_idx);
+        return WrapFallback(fallback, ctx.reg_alloc.LiveCallerSaveRegisters());
+    };
+
+    if (!HasInlinePageLookup() && !fastmem_marker) {
+        // Wide access with neither fastmem nor page table: Use a callback per element
+        code.call(get_fallback());
         return;
     }
 
-    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-    ctx.reg_alloc.HostCall(nullptr, {}, args[0], args[1]);
-    Devirtualize<&A64::UserCallbacks::MemoryWrite8>(conf.callbacks).EmitCall(code);
+    Xbyak::Label abort, end;
+    bool require_abort_handling = false;
+    const void* location = nullptr;
+
+    if (fastmem_marker) {
+        // Use fastmem
+        const auto dest_ptr = EmitFastmemVAddr(code, ctx, abort, vaddr, require_abort_handling);
+        location = EmitWriteMemoryMov<bitsize>(code, dest_ptr, value_idx);
+    } else if (inst->NumArgs() > (is_wide ? 3 : 2)) {
+        // A64WriteMemory{Wide,}InPage*: Use the page looked up for nearby accesses
+        const Xbyak::Reg64 page = ctx.reg_alloc.UseGpr(args[2]);
+        if (is_wide) {
+            EmitDetectWideAccessFallback(code, ctx, bitsize, esize, abort, vaddr, ctx.reg_alloc.ScratchGpr());
+        }
+        const auto dest_ptr = EmitVAddrInPage(code, ctx, is_wide ? 8 : bitsize, abort, vaddr, page, args[3].GetImmediateU16());
+        require_abort_handling = true;
+        EmitWriteMemoryMov<bitsize>(code, dest_ptr, value_idx);
+    } else {
+        // Use page table
+        ASSERT(HasInlinePageLookup());
+        if (is_wide) {
+            EmitDetectWideAccessFallback(code, ctx, bitsize, esize, abort, vaddr, ctx.reg_alloc.ScratchGpr());
+        }
+        const auto dest_ptr = EmitVAddrLookup(code, ctx, is_wide ? 8 : bitsize, abort, vaddr);
+        require_abort_handling = true;
+        EmitWriteMemoryMov<bitsize>(code, dest_ptr, value_idx);
+    }
+    code.L(end);
+
+    const auto wrapped_fn = get_fallback();
+
+    if (fastmem_marker) {
+        fastmem_patch_info.emplace(
+            Common::BitCast<u64>(location),
+            FastmemPatchInfo{
+                Common::BitCast<u64>(end.getAddress()),
+                Common::BitCast<u64>(wrapped_fn),
+                *fastmem_marker,
+            }
+        );
+    }
+
+    if (require_abort_handling) {
+        code.SwitchToFarCode();
+        code.L(abort);
+        code.call(wrapped_fn);
+        code.jmp(end, code.T_NEAR);
+        code.SwitchToNearCode();
+    }
+}
+
+void A64EmitX64::EmitA64ReadMemory8(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<8, &A64::UserCallbacks::MemoryRead8>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64ReadMemory16(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<16, &A64::UserCallbacks::MemoryRead16>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64ReadMemory32(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<32, &A64::UserCallbacks::MemoryRead32>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64ReadMemory64(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<64, &A64::UserCallbacks::MemoryRead64>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64ReadMemory128(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<128, &A64::UserCallbacks::MemoryRead128>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64WriteMemory8(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryWrite<8, &A64::UserCallbacks::MemoryWrite8>(ctx, inst);
 }
 
 void A64EmitX64::EmitA64WriteMemory16(A64EmitContext& ctx, IR::Inst* inst) {
-    if (conf.page_table) {
-        EmitDirectPageTableMemoryWrite<16>(ctx, inst);
+    EmitMemoryWrite<16, &A64::UserCallbacks::MemoryWrite16>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64WriteMemory32(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryWrite<32, &A64::UserCallbacks::MemoryWrite32>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64WriteMemory64(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryWrite<64, &A64::UserCallbacks::MemoryWrite64>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64WriteMemory128(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryWrite<128, &A64::UserCallbacks::MemoryWrite128>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64ReadMemoryWide64(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<64, &A64::UserCallbacks::MemoryRead64>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64ReadMemoryWide128(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<128, &A64::UserCallbacks::MemoryRead128>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64WriteMemoryWide64(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryWrite<64, &A64::UserCallbacks::MemoryWrite64>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64WriteMemoryWide128(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryWrite<128, &A64::UserCallbacks::MemoryWrite128>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64LookupPage(A64EmitContext& ctx, IR::Inst* inst) {
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+    const Xbyak::Reg64 result = ctx.reg_alloc.ScratchGpr();
+
+    if (!HasInlinePageLookup()) {
+        code.xor_(result.cvt32(), result.cvt32());
+        ctx.reg_alloc.DefineValue(inst, result);
         return;
     }
 
-    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-    ctx.reg_alloc.HostCall(nullptr, {}, args[0], args[1]);
-    Devirtualize<&A64::UserCallbacks::MemoryWrite16>(conf.callbacks).EmitCall(code);
-}
+    const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseScratchGpr(args[0]);
+
+    Xbyak::Label abort, end;
+
+    code.and_(vaddr, ~static_cast<u32>(page_mask));
+    const auto page_ptr = EmitVAddrLookup(code, ctx, 8, abort, vaddr);
+    code.lea(result, ptr[page_ptr]);
+    code.L(end);
+
+    code.SwitchToFarCode();
+    code.L(abort);
+    code.xor_(result.cvt32(), result.cvt32());
+    code.jmp(end, code.T_NEAR);
+    code.SwitchToNearCode();
+
+    ctx.reg_alloc.DefineValue(inst, result);
+}
+
+void A64EmitX64::EmitA64ReadMemoryInPage8(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<8, &A64::UserCallbacks::MemoryRead8>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64ReadMemoryInPage16(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<16, &A64::UserCallbacks::MemoryRead16>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64ReadMemoryInPage32(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<32, &A64::UserCallbacks::MemoryRead32>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64ReadMemoryInPage64(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<64, &A64::UserCallbacks::MemoryRead64>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64ReadMemoryInPage128(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<128, &A64::UserCallbacks::MemoryRead128>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64WriteMemoryInPage8(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryWrite<8, &A64::UserCallbacks::MemoryWrite8>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64WriteMemoryInPage16(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryWrite<16, &A64::UserCallbacks::MemoryWrite16>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64WriteMemoryInPage32(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryWrite<32, &A64::UserCallbacks::MemoryWrite32>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64WriteMemoryInPage64(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryWrite<64, &A64::UserCallbacks::MemoryWrite64>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64WriteMemoryInPage128(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryWrite<128, &A64::UserCallbacks::MemoryWrite128>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64ReadMemoryWideInPage64(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<64, &A64::UserCallbacks::MemoryRead64>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64ReadMemoryWideInPage128(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryRead<128, &A64::UserCallbacks::MemoryRead128>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64WriteMemoryWideInPage64(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryWrite<64, &A64::UserCallbacks::MemoryWrite64>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64WriteMemoryWideInPage128(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitMemoryWrite<128, &A64::UserCallbacks::MemoryWrite128>(ctx, inst);
+}
+
+namespace {
+
+void EmitReservationGranule(BlockOfCode& code, Xbyak::Reg64 dest, Xbyak::Reg64 vaddr) {
+    static_assert(static_cast<s64>(ExclusiveMonitor::RESERVATION_GRANULE_MASK) >= -0x8000'0000ll, "Mask must be encodable as a sign-extended imm32");
+
+    code.mov(dest, vaddr);
+    if constexpr (ExclusiveMonitor::RESERVATION_GRANULE_MASK != ~VAddr{0}) {
+        code.and_(dest, static_cast<u32>(ExclusiveMonitor::RESERVATION_GRANULE_MASK));
+    }
+}
+
+} // anonymous namespace
+
+template<std::size_t bitsize>
+void A64EmitX64::EmitExclusiveReadMemoryInline(A64EmitContext& ctx, IR::Inst* inst) {
+    ASSERT(HasInlinePageLookup());
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+    const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
+    const int value_idx = bitsize == 128 ? ctx.reg_alloc.ScratchXmm().getIdx() : ctx.reg_alloc.ScratchGpr().getIdx();
+    const Xbyak::Reg64 reservation = ctx.reg_alloc.ScratchGpr();
+
+    Xbyak::Label abort, end;
+
+    code.mov(code.byte[r15 + offsetof(A64JitState, exclusive_state)], u8(1));
+    EmitReservationGranule(code, reservation, vaddr);
+    code.mov(qword[r15 + offsetof(A64JitState, exclusive_address)], reservation);
+    if (conf.global_monitor) {
+        const Xbyak::Reg64 reservation_ptr = ctx.reg_alloc.ScratchGpr();
+        EmitPerJitPointer(reservation_ptr, offsetof(A64JitState, exclusive_reservation), conf.global_monitor->GetReservationAddress(conf.processor_id));
+        code.mov(qword[reservation_ptr], reservation);
+    }
+    const auto src_ptr = EmitVAddrLookup(code, ctx, bitsize, abort, vaddr);
+    EmitReadMemoryMov<bitsize>(code, value_idx, src_ptr);
+    code.L(end);
+    if constexpr (bitsize == 128) {
+        code.movaps(xword[r15 + offsetof(A64JitState, exclusive_value)], Xbyak::Xmm{value_idx});
+    } else {
+        code.mov(qword[r15 + offsetof(A64JitState, exclusive_value)], Xbyak::Reg64{value_idx});
+    }
+
+    const auto wrapped_fn = WrapFallback(GetReadFallback(bitsize, vaddr.getIdx(), value_idx), ctx.reg_alloc.LiveCallerSaveRegisters());
 
-void A64EmitX64::EmitA64WriteMemory32(A64EmitContext& ctx, IR::Inst* inst) {
-    if (conf.page_table) {
-        EmitDirectPageTableMemoryWrite<32>(ctx, inst);
-        return;
+    code.SwitchToFarCode();
+    code.L(abort);
+    code.call(wrapped_fn);
+    code.jmp(end, code.T_NEAR);
+    code.SwitchToNearCode();
+
+    if constexpr (bitsize == 128) {
+        ctx.reg_alloc.DefineValue(inst, Xbyak::Xmm{value_idx});
+    } else {
+        ctx.reg_alloc.DefineValue(inst, Xbyak::Reg64{value_idx});
     }
+}
 
+template<std::size_t bitsize, auto callback>
+void A64EmitX64::EmitExclusiveWriteMemoryInline(A64EmitContext& ctx, IR::Inst* inst) {
+    ASSERT(HasInlinePageLookup());
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-    ctx.reg_alloc.HostCall(nullptr, {}, args[0], args[1]);
-    Devirtualize<&A64::UserCallbacks::MemoryWrite32>(conf.callbacks).EmitCall(code);
-}
 
-void A64EmitX64::EmitA64WriteMemory64(A64EmitContext& ctx, IR::Inst* inst) {
-    if (conf.page_table) {
-        EmitDirectPageTableMemoryWrite<64>(ctx, inst);
-        return;
+    if constexpr (bitsize == 128) {
+        ctx.reg_alloc.ScratchGpr(HostLoc::RAX);
+        ctx.reg_alloc.ScratchGpr(HostLoc::RBX);
+        ctx.reg_alloc.ScratchGpr(HostLoc::RCX);
+        ctx.reg_alloc.ScratchGpr(HostLoc::RDX);
+    } else {
+        ctx.reg_alloc.ScratchGpr(HostLoc::RAX);
     }
+    const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
+    const int value_idx = bitsize == 128 ? ctx.reg_alloc.UseXmm(args[1]).getIdx() : ctx.reg_alloc.UseGpr(args[1]).getIdx();
+    const Xbyak::Reg32 status = ctx.reg_alloc.ScratchGpr().cvt32();
+    const Xbyak::Reg64 reservation = ctx.reg_alloc.ScratchGpr();
+    const Xbyak::Reg64 reservation_ptr = conf.global_monitor ? ctx.reg_alloc.ScratchGpr() : Xbyak::Reg64{};
+
+    const Xbyak::Xmm tmp = bitsize == 128 && !code.HasSSE41() ? ctx.reg_alloc.ScratchXmm() : Xbyak::Xmm{0};
+
+    Xbyak::Label abort, end, fallback, clear_monitor;
+
+    const auto emit_check_reservation = [&] {
+        code.cmp(code.byte[r15 + offsetof(A64JitState, exclusive_state)], u8(0));
+        code.je(end, code.T_NEAR);
+        code.mov(code.byte[r15 + offsetof(A64JitState, exclusive_state)], u8(0));
+        EmitReservationGranule(code, reservation, vaddr);
+        code.cmp(qword[r15 + offsetof(A64JitState, exclusive_address)], reservation);
+        code.jne(end, code.T_NEAR);
+        if (conf.global_monitor) {
+            // Exclusive stores and ClearAddress calls from other processors invalidate this through the monitor.
+            EmitPerJitPointer(reservation_ptr, offsetof(A64JitState, exclusive_reservation), conf.global_monitor->GetReservationAddress(conf.processor_id));
+            code.mov(rax, ExclusiveMonitor::INVALID_EXCLUSIVE_ADDRESS);
+            code.xchg(qword[reservation_ptr], rax);
+            code.cmp(rax, reservation);
+            code.jne(end, code.T_NEAR);
+        }
+    };
 
-    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-    ctx.reg_alloc.HostCall(nullptr, {}, args[0], args[1]);
-    Devirtualize<&A64::UserCallbacks::MemoryWrite64>(conf.callbacks).EmitCall(code);
-}
+    code.mov(status, u32(1));
+    if constexpr (bitsize == 128) {
+        // CMPXCHG16B requires a 16-byte aligned operand
+        code.test(vaddr, 0b1111);
+        code.jnz(abort, code.T_NEAR);
+    }
+    const auto dest_ptr = EmitVAddrLookup(code, ctx, bitsize, abort, vaddr);
+    emit_check_reservation();
+    if constexpr (bitsize == 128) {
+        const Xbyak::Xmm value{value_idx};
+        code.mov(rax, qword[r15 + offsetof(A64JitState, exclusive_value)]);
+        code.mov(rdx, qword[r15 + offsetof(A64JitState, exclusive_value) + 8]);
+        code.movq(rbx, value);
+        if (code.HasSSE41()) {
+            code.pextrq(rcx, value, 1);
+        } else {
+            code.movhlps(tmp, value);
+            code.movq(rcx, tmp);
+        }
+        code.lock();
+        code.cmpxchg16b(xword[dest_ptr]);
+    } else {
+        code.mov(rax, qword[r15 + offsetof(A64JitState, exclusive_value)]);
+        code.lock();
+        code.cmpxchg(SizedMemoryOperand(bitsize, dest_ptr), Xbyak::Reg64{value_idx}.changeBit(bitsize));
+    }
+    code.setnz(status.cvt8());
+    if (conf.global_monitor) {
+        code.jnz(end);
+        code.call(clear_monitor);
+    }
+    code.L(end);
 
-void A64EmitX64::EmitA64WriteMemory128(A64EmitContext& ctx, IR::Inst* inst) {
-    if (conf.page_table) {
-        Xbyak::Label abort, end;
+    const std::vector<HostLoc> live = ctx.reg_alloc.LiveCallerSaveRegisters();
 
-        auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-        const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
-        const Xbyak::Xmm value = ctx.reg_alloc.UseXmm(args[1]);
+    code.SwitchToFarCode();
+    if (conf.global_monitor) {
+        std::vector<HostLoc> live_and_status = live;
+        live_and_status.emplace_back(HostLocRegIdx(status.getIdx()));
+
+        code.L(clear_monitor);
+        ABI_PushRegistersAndAdjustStack(code, 0, live_and_status);
+        code.mov(code.ABI_PARAM2, vaddr);
+        code.mov(code.ABI_PARAM1, Common::BitCast<u64>(conf.global_monitor));
+        code.CallLambda(
+            [](ExclusiveMonitor& monitor, u64 vaddr) {
+                monitor.ClearAddress(vaddr);
+            }
+        );
+        ABI_PopRegistersAndAdjustStack(code, 0, live_and_status);
+        code.ret();
+    }
 
-        const auto dest_ptr = EmitVAddrLookup(code, ctx, 128, abort, vaddr);
-        code.movups(xword[dest_ptr], value);
-        code.L(end);
+    code.L(fallback);
+    ABI_PushRegistersAndAdjustStack(code, 0, live);
+    if constexpr (bitsize == 128) {
+        code.mov(code.ABI_PARAM2, vaddr);
+        code.lea(code.ABI_PARAM4, ptr[r15 + offsetof(A64JitState, exclusive_value)]);
+        code.sub(rsp, 16 + ABI_SHADOW_SPACE);
+        code.lea(code.ABI_PARAM3, ptr[rsp + ABI_SHADOW_SPACE]);
+        code.movaps(xword[code.ABI_PARAM3], Xbyak::Xmm{value_idx});
+        EmitPerJitPointer(code.ABI_PARAM1, offsetof(A64JitState, user_config), &conf);
+        code.CallLambda(
+            [](A64::UserConfig& conf, u64 vaddr, A64::Vector& value, const A64::Vector& expected) -> u32 {
+                if (!(conf.callbacks->*callback)(vaddr, value, expected)) {
+                    return 1;
+                }
+                if (conf.global_monitor) {
+                    conf.global_monitor->ClearAddress(vaddr);
+                }
+                return 0;
+            }
+        );
+        code.add(rsp, 16 + ABI_SHADOW_SPACE);
+    } else {
+        using T = mp::unsigned_integer_of_size<bitsize>;
 
-        code.SwitchToFarCode();
-        code.L(abort);
-        code.call(write_fallbacks[std::make_tuple(128, vaddr.getIdx(), value.getIdx())]);
-        code.jmp(end, code.T_NEAR);
-        code.SwitchToNearCode();
-        return;
+        code.push(vaddr);
+        code.push(Xbyak::Reg64{value_idx});
+        code.pop(code.ABI_PARAM3);
+        code.pop(code.ABI_PARAM2);
+        code.lea(code.ABI_PARAM4, ptr[r15 + offsetof(A64JitState, exclusive_value)]);
+        EmitPerJitPointer(code.ABI_PARAM1, offsetof(A64JitState, user_config), &conf);
+        code.CallLambda(
+            [](A64::UserConfig& conf, u64 vaddr, u64 value, const u64* expected) -> u32 {
+                if (!(conf.callbacks->*callback)(vaddr, static_cast<T>(value), static_cast<T>(*expected))) {
+                    return 1;
+                }
+                if (conf.global_monitor) {
+                    conf.global_monitor->ClearAddress(vaddr);
+                }
+                return 0;
+            }
+        );
     }
+    code.mov(status, code.ABI_RETURN.cvt32());
+    ABI_PopRegistersAndAdjustStack(code, 0, live);
+    code.ret();
 
-    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-    ctx.reg_alloc.Use(args[0], ABI_PARAM2);
-    ctx.reg_alloc.Use(args[1], HostLoc::XMM1);
-    ctx.reg_alloc.EndOfAllocScope();
-    ctx.reg_alloc.HostCall(nullptr);
-    code.CallFunction(memory_write_128);
+    code.L(abort);
+    emit_check_reservation();
+    code.call(fallback);
+    code.jmp(end, code.T_NEAR);
+    code.SwitchToNearCode();
+
+    ctx.reg_alloc.DefineValue(inst, status);
 }
 
 template<std::size_t bitsize, auto callback>
 void A64EmitX64::EmitExclusiveReadMemory(A64EmitContext& ctx, IR::Inst* inst) {
+    if (conf.inline_exclusive_access && HasInlinePageLookup()) {
+        EmitExclusiveReadMemoryInline<bitsize>(ctx, inst);
+        return;
+    }
+
     ASSERT(conf.global_monitor != nullptr);
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
 
@@ -1080,7 +2081,7 @@ void A64EmitX64::EmitExclusiveReadMemory(A64EmitContext& ctx, IR::Inst* inst) {
         ctx.reg_alloc.HostCall(inst, {}, args[0]);
 
         code.mov(code.byte[r15 + offsetof(A64JitState, exclusive_state)], u8(1));
-        code.mov(code.ABI_PARAM1, reinterpret_cast<u64>(&conf));
+        EmitPerJitPointer(code.ABI_PARAM1, offsetof(A64JitState, user_config), &conf);
         code.CallLambda(
             [](A64::UserConfig& conf, u64 vaddr) -> T {
                 return conf.global_monitor->ReadAndMark<T>(conf.processor_id, vaddr, [&]() -> T {
@@ -1095,7 +2096,7 @@ void A64EmitX64::EmitExclusiveReadMemory(A64EmitContext& ctx, IR::Inst* inst) {
         ctx.reg_alloc.HostCall(nullptr);
 
         code.mov(code.byte[r15 + offsetof(A64JitState, exclusive_state)], u8(1));
-        code.mov(code.ABI_PARAM1, reinterpret_cast<u64>(&conf));
+        EmitPerJitPointer(code.ABI_PARAM1, offsetof(A64JitState, user_config), &conf);
         code.sub(rsp, 16 + ABI_SHADOW_SPACE);
         code.lea(code.ABI_PARAM3, ptr[rsp + ABI_SHADOW_SPACE]);
         code.CallLambda(
@@ -1134,6 +2135,11 @@ void A64EmitX64::EmitA64ExclusiveReadMemory128(A64EmitContext& ctx, IR::Inst* in
 
 template<std::size_t bitsize, auto callback>
 void A64EmitX64::EmitExclusiveWriteMemory(A64EmitContext& ctx, IR::Inst* inst) {
+    if (conf.inline_exclusive_access && HasInlinePageLookup()) {
+        EmitExclusiveWriteMemoryInline<bitsize, callback>(ctx, inst);
+        return;
+    }
+
     ASSERT(conf.global_monitor != nullptr);
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
 
@@ -1152,7 +2158,7 @@ void A64EmitX64::EmitExclusiveWriteMemory(A64EmitContext& ctx, IR::Inst* inst) {
     code.cmp(code.byte[r15 + offsetof(A64JitState, exclusive_state)], u8(0));
     code.je(end);
     code.mov(code.byte[r15 + offsetof(A64JitState, exclusive_state)], u8(0));
-    code.mov(code.ABI_PARAM1, reinterpret_cast<u64>(&conf));
+    EmitPerJitPointer(code.ABI_PARAM1, offsetof(A64JitState, user_config), &conf);
     if constexpr (bitsize != 128) {
         using T = mp::unsigned_integer_of_size<bitsize>;
 
@@ -1201,6 +2207,465 @@ void A64EmitX64::EmitA64ExclusiveWriteMemory128(A64EmitContext& ctx, IR::Inst* i
     EmitExclusiveWriteMemory<128, &A64::UserCallbacks::MemoryWriteExclusive128>(ctx, inst);
 }
 
+namespace {
+
+void EmitZeroExtendResult(BlockOfCode& code, size_t bitsize, Xbyak::Reg64 result) {
+    switch (bitsize) {
+    case 8:
+        code.movzx(result.cvt32(), result.cvt8());
+        break;
+    case 16:
+        code.movzx(result.cvt32(), result.cvt16());
+        break;
+    case 32:
+        code.mov(result.cvt32(), result.cvt32());
+        break;
+    case 64:
+        break;
+    default:
+        ASSERT_FALSE("Invalid bitsize");
+    }
+}
+
+template<typename T>
+T AtomicOperation(IR::AtomicOp op, T old_value, T value) {
+    using S = std::make_signed_t<T>;
+
+    switch (op) {
+    case IR::AtomicOp::Add:
+        return static_cast<T>(old_value + value);
+    case IR::AtomicOp::Clear:
+        return static_cast<T>(old_value & ~value);
+    case IR::AtomicOp::Eor:
+        return static_cast<T>(old_value ^ value);
+    case IR::AtomicOp::Set:
+        return static_cast<T>(old_value | value);
+    case IR::AtomicOp::SignedMax:
+        return static_cast<S>(old_value) > static_cast<S>(value) ? old_value : value;
+    case IR::AtomicOp::SignedMin:
+        return static_cast<S>(old_value) < static_cast<S>(value) ? old_value : value;
+    case IR::AtomicOp::UnsignedMax:
+        return old_value > value ? old_value : value;
+    case IR::AtomicOp::UnsignedMin:
+        return old_value < value ? old_value : value;
+    case IR::AtomicOp::Swap:
+        return value;
+    }
+    UNREACHABLE();
+}
+
+/// Performs an atomic operation through the memory callbacks. `op` returns the value to store, if any.
+template<typename T, auto read_callback, auto write_callback, auto exclusive_write_callback, typename Operation>
+T AtomicFallback(A64::UserConfig& conf, u64 vaddr, Operation op) {
+    if (!conf.global_monitor) {
+        const T old_value = (conf.callbacks->*read_callback)(vaddr);
+        if (const std::optional<T> new_value = op(old_value)) {
+            (conf.callbacks->*write_callback)(vaddr, *new_value);
+        }
+        return old_value;
+    }
+
+    // Other processors may be accessing this location: use the exclusive write callback as a compare-and-swap.
+    while (true) {
+        const T old_value = (conf.callbacks->*read_callback)(vaddr);
+        const std::optional<T> new_value = op(old_value);
+        if (!new_value || (conf.callbacks->*exclusive_write_callback)(vaddr, *new_value, old_value)) {
+            return old_value;
+        }
+    }
+}
+
+} // anonymous namespace
+
+template<std::size_t bitsize, auto read_callback, auto write_callback, auto exclusive_write_callback>
+void A64EmitX64::EmitAtomicCompareAndSwap(A64EmitContext& ctx, IR::Inst* inst) {
+    using T = std::conditional_t<bitsize == 128, A64::Vector, mp::unsigned_integer_of_size<std::min<size_t>(bitsize, 64)>>;
+
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+    const auto fastmem_marker = ShouldFastmem(ctx, inst);
+
+    if constexpr (bitsize != 128) {
+        constexpr auto fallback_fn = [](A64::UserConfig& conf, u64 vaddr, u64 expected, u64 desired) -> u64 {
+            return AtomicFallback<T, read_callback, write_callback, exclusive_write_callback>(conf, vaddr, [&](T old_value) -> std::optional<T> {
+                if (old_value != static_cast<T>(expected)) {
+                    return std::nullopt;
+                }
+                return static_cast<T>(desired);
+            });
+        };
+
+        if (!HasInlinePageLookup() && !fastmem_marker) {
+            // Neither fastmem nor page table: Use callbacks
+            ctx.reg_alloc.HostCall(inst, {}, args[0], args[1], args[2]);
+            EmitPerJitPointer(code.ABI_PARAM1, offsetof(A64JitState, user_config), &conf);
+            code.CallLambda(fallback_fn);
+            return;
+        }
+
+        const Xbyak::Reg64 result = ctx.reg_alloc.ScratchGpr(HostLoc::RAX);
+        const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
+        const Xbyak::Reg64 expected = ctx.reg_alloc.UseGpr(args[1]);
+        const Xbyak::Reg64 desired = ctx.reg_alloc.UseGpr(args[2]);
+
+        Xbyak::Label abort, end, fallback;
+        bool require_abort_handling = false;
+
+        const auto addr = fastmem_marker ? EmitFastmemVAddr(code, ctx, abort, vaddr, require_abort_handling)
+                                         : EmitVAddrLookup(code, ctx, bitsize, abort, vaddr);
+        require_abort_handling |= !fastmem_marker;
+
+        code.mov(result, expected);
+        const void* location = code.getCurr();
+        code.lock();
+        code.cmpxchg(SizedMemoryOperand(bitsize, addr), desired.changeBit(bitsize));
+        EmitZeroExtendResult(code, bitsize, result);
+        code.L(end);
+
+        const std::vector<HostLoc> live = ctx.reg_alloc.LiveCallerSaveRegisters();
+
+        code.SwitchToFarCode();
+        code.L(fallback);
+        ABI_PushRegistersAndAdjustStack(code, 0, live);
+        code.push(vaddr);
+        code.push(expected);
+        code.push(desired);
+        code.pop(code.ABI_PARAM4);
+        code.pop(code.ABI_PARAM3);
+        code.pop(code.ABI_PARAM2);
+        EmitPerJitPointer(code.ABI_PARAM1, offsetof(A64JitState, user_config), &conf);
+        code.CallLambda(fallback_fn);
+        ABI_PopRegistersAndAdjustStack(code, 0, live);
+        code.ret();
+        if (require_abort_handling) {
+            code.L(abort);
+            code.call(fallback);
+            code.jmp(end, code.T_NEAR);
+        }
+        code.SwitchToNearCode();
+
+        if (fastmem_marker) {
+            fastmem_patch_info.emplace(
+                Common::BitCast<u64>(location),
+                FastmemPatchInfo{
+                    Common::BitCast<u64>(end.getAddress()),
+                    Common::BitCast<u64>(fallback.getAddress()),
+                    *fastmem_marker,
+                }
+            );
+        }
+
+        ctx.reg_alloc.DefineValue(inst, result);
+    } else {
+        constexpr auto fallback_fn = [](A64::UserConfig& conf, u64 vaddr, A64::Vector* buffer) {
+            // buffer[0]: expected, buffer[1]: desired, buffer[2]: result
+            buffer[2] = AtomicFallback<T, read_callback, write_callback, exclusive_write_callback>(conf, vaddr, [&](T old_value) -> std::optional<T> {
+                if (old_value != buffer[0]) {
+                    return std::nullopt;
+                }
+                return buffer[1];
+            });
+        };
+        constexpr size_t buffer_size = 3 * sizeof(A64::Vector);
+
+        if (!HasInlinePageLookup() && !fastmem_marker) {
+            // Neither fastmem nor page table: Use callbacks
+            const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
+            ctx.reg_alloc.Use(args[0], ABI_PARAM2);
+            ctx.reg_alloc.Use(args[1], HostLoc::XMM1);
+            ctx.reg_alloc.Use(args[2], HostLoc::XMM2);
+            ctx.reg_alloc.EndOfAllocScope();
+            ctx.reg_alloc.HostCall(nullptr);
+
+            EmitPerJitPointer(code.ABI_PARAM1, offsetof(A64JitState, user_config), &conf);
+            code.sub(rsp, buffer_size + ABI_SHADOW_SPACE);
+            code.lea(code.ABI_PARAM3, ptr[rsp + ABI_SHADOW_SPACE]);
+            code.movaps(xword[code.ABI_PARAM3], xmm1);
+            code.movaps(xword[code.ABI_PARAM3 + 16], xmm2);
+            code.CallLambda(fallback_fn);
+            code.movups(result, xword[rsp + ABI_SHADOW_SPACE + 32]);
+            code.add(rsp, buffer_size + ABI_SHADOW_SPACE);
+
+            ctx.reg_alloc.DefineValue(inst, result);
+            return;
+        }
+
+        const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
+        ctx.reg_alloc.ScratchGpr(HostLoc::RAX);
+        ctx.reg_alloc.ScratchGpr(HostLoc::RBX);
+        ctx.reg_alloc.ScratchGpr(HostLoc::RCX);
+        ctx.reg_alloc.ScratchGpr(HostLoc::RDX);
+        const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
+        const Xbyak::Xmm expected = ctx.reg_alloc.UseXmm(args[1]);
+        const Xbyak::Xmm desired = ctx.reg_alloc.UseXmm(args[2]);
+
+        Xbyak::Label abort, end, fallback;
+        bool require_abort_handling = true;
+
+        // CMPXCHG16B requires a 16-byte aligned operand
+        code.test(vaddr, 0b1111);
+        code.jnz(abort, code.T_NEAR);
+
+        const auto addr = fastmem_marker ? EmitFastmemVAddr(code, ctx, abort, vaddr, require_abort_handling)
+                                         : EmitVAddrLookup(code, ctx, bitsize, abort, vaddr);
+
+        if (code.HasSSE41()) {
+            code.movq(rax, expected);
+            code.pextrq(rdx, expected, 1);
+            code.movq(rbx, desired);
+            code.pextrq(rcx, desired, 1);
+        } else {
+            code.movq(rax, expected);
+            code.movhlps(result, expected);
+            code.movq(rdx, result);
+            code.movq(rbx, desired);
+            code.movhlps(result, desired);
+            code.movq(rcx, result);
+        }
+        const void* location = code.getCurr();
+        code.lock();
+        code.cmpxchg16b(xword[addr]);
+        code.movq(result, rax);
+        if (code.HasSSE41()) {
+            code.pinsrq(result, rdx, 1);
+        } else {
+            const Xbyak::Xmm tmp = ctx.reg_alloc.ScratchXmm();
+            code.movq(tmp, rdx);
+            code.punpcklqdq(result, tmp);
+        }
+        code.L(end);
+
+        const std::vector<HostLoc> live = ctx.reg_alloc.LiveCallerSaveRegisters();
+
+        code.SwitchToFarCode();
+        code.L(fallback);
+        ABI_PushRegistersAndAdjustStack(code, 0, live);
+        code.sub(rsp, buffer_size + ABI_SHADOW_SPACE);
+        code.movaps(xword[rsp + ABI_SHADOW_SPACE], expected);
+        code.movaps(xword[rsp + ABI_SHADOW_SPACE + 16], desired);
+        code.mov(code.ABI_PARAM2, vaddr);
+        code.lea(code.ABI_PARAM3, ptr[rsp + ABI_SHADOW_SPACE]);
+        EmitPerJitPointer(code.ABI_PARAM1, offsetof(A64JitState, user_config), &conf);
+        code.CallLambda(fallback_fn);
+        code.movups(result, xword[rsp + ABI_SHADOW_SPACE + 32]);
+        code.add(rsp, buffer_size + ABI_SHADOW_SPACE);
+        ABI_PopRegistersAndAdjustStack(code, 0, live);
+        code.ret();
+        code.L(abort);
+        code.call(fallback);
+        code.jmp(end, code.T_NEAR);
+        code.SwitchToNearCode();
+
+        if (fastmem_marker) {
+            fastmem_patch_info.emplace(
+                Common::BitCast<u64>(location),
+                FastmemPatchInfo{
+                    Common::BitCast<u64>(end.getAddress()),
+                    Common::BitCast<u64>(fallback.getAddress()),
+                    *fastmem_marker,
+                }
+            );
+        }
+
+        ctx.reg_alloc.DefineValue(inst, result);
+    }
+}
+
+void A64EmitX64::EmitA64AtomicCompareAndSwap8(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitAtomicCompareAndSwap<8, &A64::UserCallbacks::MemoryRead8, &A64::UserCallbacks::MemoryWrite8, &A64::UserCallbacks::MemoryWriteExclusive8>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64AtomicCompareAndSwap16(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitAtomicCompareAndSwap<16, &A64::UserCallbacks::MemoryRead16, &A64::UserCallbacks::MemoryWrite16, &A64::UserCallbacks::MemoryWriteExclusive16>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64AtomicCompareAndSwap32(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitAtomicCompareAndSwap<32, &A64::UserCallbacks::MemoryRead32, &A64::UserCallbacks::MemoryWrite32, &A64::UserCallbacks::MemoryWriteExclusive32>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64AtomicCompareAndSwap64(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitAtomicCompareAndSwap<64, &A64::UserCallbacks::MemoryRead64, &A64::UserCallbacks::MemoryWrite64, &A64::UserCallbacks::MemoryWriteExclusive64>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64AtomicCompareAndSwap128(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitAtomicCompareAndSwap<128, &A64::UserCallbacks::MemoryRead128, &A64::UserCallbacks::MemoryWrite128, &A64::UserCallbacks::MemoryWriteExclusive128>(ctx, inst);
+}
+
+template<std::size_t bitsize, auto read_callback, auto write_callback, auto exclusive_write_callback>
+void A64EmitX64::EmitAtomicReadModifyWrite(A64EmitContext& ctx, IR::Inst* inst) {
+    using T = mp::unsigned_integer_of_size<bitsize>;
+
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+    const auto op = static_cast<IR::AtomicOp>(args[2].GetImmediateU8());
+    const auto fastmem_marker = ShouldFastmem(ctx, inst);
+
+    constexpr auto fallback_fn = [](A64::UserConfig& conf, u64 vaddr, u64 value, u64 raw_op) -> u64 {
+        return AtomicFallback<T, read_callback, write_callback, exclusive_write_callback>(conf, vaddr, [&](T old_value) -> std::optional<T> {
+            return AtomicOperation<T>(static_cast<IR::AtomicOp>(raw_op), old_value, static_cast<T>(value));
+        });
+    };
+
+    if (!HasInlinePageLookup() && !fastmem_marker) {
+        // Neither fastmem nor page table: Use callbacks
+        ctx.reg_alloc.HostCall(inst, {}, args[0], args[1]);
+        EmitPerJitPointer(code.ABI_PARAM1, offsetof(A64JitState, user_config), &conf);
+        code.mov(code.ABI_PARAM4.cvt32(), static_cast<u32>(op));
+        code.CallLambda(fallback_fn);
+        return;
+    }
+
+    const Xbyak::Reg64 result = ctx.reg_alloc.ScratchGpr(HostLoc::RAX);
+    const Xbyak::Reg64 vaddr = ctx.reg_alloc.UseGpr(args[0]);
+    const Xbyak::Reg64 value = ctx.reg_alloc.UseGpr(args[1]);
+
+    Xbyak::Label abort, end, fallback;
+    bool require_abort_handling = false;
+
+    const auto addr = fastmem_marker ? EmitFastmemVAddr(code, ctx, abort, vaddr, require_abort_handling)
+                                     : EmitVAddrLookup(code, ctx, bitsize, abort, vaddr);
+    require_abort_handling |= !fastmem_marker;
+
+    std::vector<const void*> locations;
+
+    switch (op) {
+    case IR::AtomicOp::Add:
+        code.mov(result, value);
+        locations.emplace_back(code.getCurr());
+        code.lock();
+        code.xadd(SizedMemoryOperand(bitsize, addr), result.changeBit(bitsize));
+        break;
+    case IR::AtomicOp::Swap:
+        code.mov(result, value);
+        locations.emplace_back(code.getCurr());
+        code.xchg(SizedMemoryOperand(bitsize, addr), result.changeBit(bitsize));
+        break;
+    default: {
+        const Xbyak::Reg64 tmp = ctx.reg_alloc.ScratchGpr();
+
+        // Signed and unsigned comparisons of narrow values are performed on sign- or zero-extended copies.
+        const bool is_signed = op == IR::AtomicOp::SignedMax || op == IR::AtomicOp::SignedMin;
+        const bool is_minmax = is_signed || op == IR::AtomicOp::UnsignedMax || op == IR::AtomicOp::UnsignedMin;
+        Xbyak::Reg64 operand = value;
+        if (is_minmax && bitsize < 32) {
+            operand = ctx.reg_alloc.ScratchGpr();
+            if (is_signed) {
+                code.movsx(operand.cvt32(), value.changeBit(bitsize));
+            } else {
+                code.movzx(operand.cvt32(), value.changeBit(bitsize));
+            }
+        }
+        const size_t opsize = std::max<size_t>(bitsize, 32);
+
+        locations.emplace_back(EmitReadMemoryMov<bitsize>(code, result.getIdx(), addr));
+
+        Xbyak::Label loop;
+        code.L(loop);
+        switch (op) {
+        case IR::AtomicOp::Clear:
+            code.mov(tmp, value);
+            code.not_(tmp);
+            code.and_(tmp, result);
+            break;
+        case IR::AtomicOp::Eor:
+            code.mov(tmp, result);
+            code.xor_(tmp, value);
+            break;
+        case IR::AtomicOp::Set:
+            code.mov(tmp, result);
+            code.or_(tmp, value);
+            break;
+        case IR::AtomicOp::SignedMax:
+        case IR::AtomicOp::SignedMin:
+        case IR::AtomicOp::UnsignedMax:
+        case IR::AtomicOp::UnsignedMin:
+            if (bitsize < 32 && is_signed) {
+                code.movsx(tmp.cvt32(), result.changeBit(bitsize));
+            } else {
+                code.mov(tmp, result);
+            }
+            code.cmp(tmp.changeBit(opsize), operand.changeBit(opsize));
+            switch (op) {
+            case IR::AtomicOp::SignedMax:
+                code.cmovl(tmp, operand);
+                break;
+            case IR::AtomicOp::SignedMin:
+                code.cmovg(tmp, operand);
+                break;
+            case IR::AtomicOp::UnsignedMax:
+                code.cmovb(tmp, operand);
+                break;
+            case IR::AtomicOp::UnsignedMin:
+                code.cmova(tmp, operand);
+                break;
+            default:
+                UNREACHABLE();
+            }
+            break;
+        default:
+            ASSERT_FALSE("Invalid atomic operation {}", static_cast<int>(op));
+        }
+        locations.emplace_back(code.getCurr());
+        code.lock();
+        code.cmpxchg(SizedMemoryOperand(bitsize, addr), tmp.changeBit(bitsize));
+        code.jnz(loop);
+        break;
+    }
+    }
+    EmitZeroExtendResult(code, bitsize, result);
+    code.L(end);
+
+    const std::vector<HostLoc> live = ctx.reg_alloc.LiveCallerSaveRegisters();
+
+    code.SwitchToFarCode();
+    code.L(fallback);
+    ABI_PushRegistersAndAdjustStack(code, 0, live);
+    code.push(vaddr);
+    code.push(value);
+    code.pop(code.ABI_PARAM3);
+    code.pop(code.ABI_PARAM2);
+    code.mov(code.ABI_PARAM4.cvt32(), static_cast<u32>(op));
+    EmitPerJitPointer(code.ABI_PARAM1, offsetof(A64JitState, user_config), &conf);
+    code.CallLambda(fallback_fn);
+    ABI_PopRegistersAndAdjustStack(code, 0, live);
+    code.ret();
+    if (require_abort_handling) {
+        code.L(abort);
+        code.call(fallback);
+        code.jmp(end, code.T_NEAR);
+    }
+    code.SwitchToNearCode();
+
+    if (fastmem_marker) {
+        for (const void* location : locations) {
+            fastmem_patch_info.emplace(
+                Common::BitCast<u64>(location),
+                FastmemPatchInfo{
+                    Common::BitCast<u64>(end.getAddress()),
+                    Common::BitCast<u64>(fallback.getAddress()),
+                    *fastmem_marker,
+                }
+            );
+        }
+    }
+
+    ctx.reg_alloc.DefineValue(inst, result);
+}
+
+void A64EmitX64::EmitA64AtomicReadModifyWrite8(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitAtomicReadModifyWrite<8, &A64::UserCallbacks::MemoryRead8, &A64::UserCallbacks::MemoryWrite8, &A64::UserCallbacks::MemoryWriteExclusive8>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64AtomicReadModifyWrite16(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitAtomicReadModifyWrite<16, &A64::UserCallbacks::MemoryRead16, &A64::UserCallbacks::MemoryWrite16, &A64::UserCallbacks::MemoryWriteExclusive16>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64AtomicReadModifyWrite32(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitAtomicReadModifyWrite<32, &A64::UserCallbacks::MemoryRead32, &A64::UserCallbacks::MemoryWrite32, &A64::UserCallbacks::MemoryWriteExclusive32>(ctx, inst);
+}
+
+void A64EmitX64::EmitA64AtomicReadModifyWrite64(A64EmitContext& ctx, IR::Inst* inst) {
+    EmitAtomicReadModifyWrite<64, &A64::UserCallbacks::MemoryRead64, &A64::UserCallbacks::MemoryWrite64, &A64::UserCallbacks::MemoryWriteExclusive64>(ctx, inst);
+}
+
 std::string A64EmitX64::LocationDescriptorToFriendlyName(const IR::LocationDescriptor& ir_descriptor) const {
     const A64::LocationDescriptor descriptor{ir_descriptor};
     return fmt::format("a64_{:016X}_fpcr{:08X}",
@@ -1210,7 +2675,7 @@ std::string A64EmitX64::LocationDescriptorToFriendlyName(const IR::LocationDescr
 
 void A64EmitX64::EmitTerminalImpl(IR::Term::Interpret terminal, IR::LocationDescriptor, bool) {
     code.SwitchMxcsrOnExit();
-    Devirtualize<&A64::UserCallbacks::InterpreterFallback>(conf.callbacks).EmitCall(code,
+    DevirtualizeCallback<&A64::UserCallbacks::InterpreterFallback>().EmitCall(code,
         [&](RegList param) {
             code.mov(param[0], A64::LocationDescriptor{terminal.next}.PC());
             code.mov(qword[r15 + offsetof(A64JitState, pc)], param[0]);
@@ -1309,6 +2774,15 @@ void A64EmitX64::EmitTerminalImpl(IR::Term::CheckHalt terminal, IR::LocationDesc
 }
 
 void A64EmitX64::EmitPatchJg(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr) {
+    if (IsSharedCodeCache()) {
+        Xbyak::Label skip;
+        code.jle(skip);
+        code.mov(rax, reinterpret_cast<u64>(&GetLinkSlot(target_desc).target));
+        code.jmp(qword[rax]);
+        code.L(skip);
+        return;
+    }
+
     const CodePtr patch_location = code.getCurr();
     if (target_code_ptr) {
         code.jg(target_code_ptr);
@@ -1321,6 +2795,12 @@ void A64EmitX64::EmitPatchJg(const IR::LocationDescriptor& target_desc, CodePtr
 }
 
 void A64EmitX64::EmitPatchJmp(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr) {
+    if (IsSharedCodeCache()) {
+        code.mov(rax, reinterpret_cast<u64>(&GetLinkSlot(target_desc).target));
+        code.jmp(qword[rax]);
+        return;
+    }
+
     const CodePtr patch_location = code.getCurr();
     if (target_code_ptr) {
         code.jmp(target_code_ptr);
@@ -1332,7 +2812,13 @@ void A64EmitX64::EmitPatchJmp(const IR::LocationDescriptor& target_desc, CodePtr
     code.EnsurePatchLocationSize(patch_location, 22);
 }
 
-void A64EmitX64::EmitPatchMovRcx(CodePtr target_code_ptr) {
+void A64EmitX64::EmitPatchMovRcx(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr) {
+    if (IsSharedCodeCache()) {
+        code.mov(code.rcx, reinterpret_cast<u64>(&GetLinkSlot(target_desc).target));
+        code.mov(code.rcx, qword[code.rcx]);
+        return;
+    }
+
     if (!target_code_ptr) {
         target_code_ptr = code.GetReturnFromRunCodeAddress();
     }
@@ -1341,11 +2827,45 @@ void A64EmitX64::EmitPatchMovRcx(CodePtr target_code_ptr) {
     code.EnsurePatchLocationSize(patch_location, 10);
 }
 
+void A64EmitX64::Patch(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr) {
+    if (!IsSharedCodeCache()) {
+        EmitX64::Patch(target_desc, target_code_ptr);
+        return;
+    }
+
+    const auto iter = link_slot_map.find(target_desc.Value());
+    if (iter != link_slot_map.end()) {
+        LinkSlot& slot = *iter->second;
+        slot.target.store(target_code_ptr ? target_code_ptr : slot.exit_stub, std::memory_order_release);
+    }
+}
+
 void A64EmitX64::Unpatch(const IR::LocationDescriptor& location) {
     EmitX64::Unpatch(location);
-    if (conf.HasOptimization(OptimizationFlag::FastDispatch)) {
-        (*fast_dispatch_table_lookup)(location.Value()) = {};
+    for (auto& table : fast_dispatch_tables) {
+        // Only the tag is reset: with a shared code cache the owning Jit may be executing concurrently.
+        (*fast_dispatch_table_lookup)(location.Value(), table.get()).location_descriptor = FastDispatchEntry{}.location_descriptor;
+    }
+}
+
+A64EmitX64::LinkSlot& A64EmitX64::GetLinkSlot(const IR::LocationDescriptor& target_desc) {
+    if (const auto iter = link_slot_map.find(target_desc.Value()); iter != link_slot_map.end()) {
+        return *iter->second;
     }
+
+    LinkSlot& slot = link_slots.emplace_back();
+
+    code.SwitchToFarCode();
+    slot.exit_stub = code.getCurr();
+    code.mov(rax, A64::LocationDescriptor{target_desc}.PC());
+    code.mov(qword[r15 + offsetof(A64JitState, pc)], rax);
+    code.ReturnFromRunCode();
+    code.SwitchToNearCode();
+
+    const auto block = GetBasicBlock(target_desc);
+    slot.target.store(block ? block->entrypoint : slot.exit_stub, std::memory_order_release);
+    link_slot_map.emplace(target_desc.Value(), &slot);
+    return slot;
 }
 
 } // namespace Dynarmic::Backend::X64
@@ -6,14 +6,22 @@
 #pragma once
 
 #include <array>
-#include <map>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <set>
 #include <tuple>
+#include <vector>
+
+#include <tsl/robin_map.h>
 
 #include <dynarmic/A64/a64.h>
 #include <dynarmic/A64/config.h>
 
 #include "backend/x64/a64_jitstate.h"
 #include "backend/x64/block_range_information.h"
+#include "backend/x64/callback.h"
 #include "backend/x64/emit_x64.h"
 #include "frontend/A64/location_descriptor.h"
 #include "frontend/ir/terminal.h"
@@ -22,6 +30,10 @@ namespace Dynarmic::Backend::X64 {
 
 class RegAlloc;
 
+/// Returns the host address of `vaddr` found by walking conf.page_table as emitted code does,
+/// or nullptr if accesses to it use the memory callbacks.
+u8* LookupPageTable(const A64::UserConfig& conf, u64 vaddr);
+
 struct A64EmitContext final : public EmitContext {
     A64EmitContext(const A64::UserConfig& conf, RegAlloc& reg_alloc, IR::Block& block);
 
@@ -43,23 +55,56 @@ public:
 
     /**
      * Emit host machine code for a basic block with intermediate representation `block`.
+     * If `count_executions` is set, the emitted code returns to the dispatcher once it has
+     * been executed conf.tiered_compilation_threshold times; see IsHotTierZeroBlock.
      * @note block is modified.
      */
-    BlockDescriptor Emit(IR::Block& block);
+    BlockDescriptor Emit(IR::Block& block, bool count_executions = false);
+
+    /// Returns true if the block at `descriptor` was emitted with execution counting and
+    /// has reached its execution threshold, and so should be recompiled.
+    bool IsHotTierZeroBlock(IR::LocationDescriptor descriptor) const;
 
     void ClearCache() override;
 
     void InvalidateCacheRanges(const boost::icl::interval_set<u64>& ranges);
 
+    /// Makes room for new code by discarding the oldest region of code (see
+    /// BlockOfCode::AdvanceRegion). Blocks in it are invalidated, and links to them unpatched.
+    /// Not available with a shared code cache, which only has one region.
+    void EvictOldestCodeRegion();
+
     void ChangeProcessorID(size_t value) {
         conf.processor_id = value;
     }
 
+    /// With a shared code cache, each attached Jit has its own fast dispatch table, which
+    /// emitted code finds through A64JitState::fast_dispatch_table. Returns null if fast
+    /// dispatch is disabled.
+    void* AllocateFastDispatchTable();
+    void FreeFastDispatchTable(void* table);
+
 protected:
     A64::UserConfig conf;
     A64::Jit* jit_interface;
     BlockRangeInformation<u64> block_ranges;
 
+    /// True if the emitted code is shared between Jits, and so must not embed per-Jit state.
+    bool IsSharedCodeCache() const {
+        return conf.shared_code_cache != nullptr;
+    }
+
+    /// True if memory accesses look up host pages inline, through r14 (page_table or the software TLB).
+    bool HasInlinePageLookup() const {
+        return conf.page_table != nullptr || conf.tlb_entry_count != 0;
+    }
+
+    /// Loads `pointer`, which differs between Jits sharing a code cache. With a shared code
+    /// cache it is loaded from the A64JitState field at `jit_state_offset` instead.
+    void EmitPerJitPointer(Xbyak::Reg64 reg, size_t jit_state_offset, const void* pointer);
+    template<auto mfp>
+    ArgCallback DevirtualizeCallback() const;
+
     struct FastDispatchEntry {
         u64 location_descriptor = 0xFFFF'FFFF'FFFF'FFFFull;
         const void* code_ptr = nullptr;
@@ -67,30 +112,74 @@ protected:
     static_assert(sizeof(FastDispatchEntry) == 0x10);
     static constexpr u64 fast_dispatch_table_mask = 0xFFFFF0;
     static constexpr size_t fast_dispatch_table_size = 0x100000;
-    std::array<FastDispatchEntry, fast_dispatch_table_size> fast_dispatch_table;
+    using FastDispatchTable = std::array<FastDispatchEntry, fast_dispatch_table_size>;
+    std::vector<std::unique_ptr<FastDispatchTable>> fast_dispatch_tables;
     void ClearFastDispatchTable();
 
+    /// Code space is divided into this many regions, which are discarded oldest first when full.
+    static constexpr size_t code_region_count = 8;
+
     void (*memory_read_128)();
     void (*memory_write_128)();
     void GenMemory128Accessors();
 
-    std::map<std::tuple<size_t, int, int>, void(*)()> read_fallbacks;
-    std::map<std::tuple<size_t, int, int>, void(*)()> write_fallbacks;
-    void GenFastmemFallbacks();
+    // Tiered compilation: execution counters of blocks emitted with count_executions.
+    // A counter slot may still be referenced by stale code after its block is invalidated, so slots
+    // are only reused once the code that references them is evicted (see EvictOldestCodeRegion).
+    std::deque<s32> execution_counter_storage;
+    std::vector<std::pair<CodePtr, s32*>> execution_counter_users;
+    std::vector<s32*> free_execution_counters;
+    tsl::robin_map<u64, s32*> execution_counters;
+
+    // Memory fallback thunks are generated into lazy code on first use. They only align the stack:
+    // call sites preserve the caller-saved registers that are live (see WrapFallback).
+    static constexpr size_t fallback_code_size = 256 * 1024;
+    static size_t FallbackIndex(size_t bitsize, int vaddr_idx, int value_idx);
+    std::array<FallbackFn, 5 * 16 * 16> read_fallbacks{};
+    std::array<FallbackFn, 5 * 16 * 16> write_fallbacks{};
+    FallbackFn GetReadFallback(size_t bitsize, int vaddr_idx, int value_idx);
+    FallbackFn GetWriteFallback(size_t bitsize, int vaddr_idx, int value_idx);
+    // Wide accesses fall back to one access per element of esize bits.
+    static size_t WideFallbackIndex(size_t bitsize, size_t esize, int vaddr_idx, int value_idx);
+    std::array<FallbackFn, 2 * 4 * 16 * 16> wide_read_fallbacks{};
+    std::array<FallbackFn, 2 * 4 * 16 * 16> wide_write_fallbacks{};
+    FallbackFn GetWideReadFallback(size_t bitsize, size_t esize, int vaddr_idx, int value_idx);
+    FallbackFn GetWideWriteFallback(size_t bitsize, size_t esize, int vaddr_idx, int value_idx);
 
     const void* terminal_handler_pop_rsb_hint;
     const void* terminal_handler_fast_dispatch_hint = nullptr;
-    FastDispatchEntry& (*fast_dispatch_table_lookup)(u64) = nullptr;
+    FastDispatchEntry& (*fast_dispatch_table_lookup)(u64, FastDispatchTable*) = nullptr;
     void GenTerminalHandlers();
 
-    template<std::size_t bitsize>
-    void EmitDirectPageTableMemoryRead(A64EmitContext& ctx, IR::Inst* inst);
-    template<std::size_t bitsize>
-    void EmitDirectPageTableMemoryWrite(A64EmitContext& ctx, IR::Inst* inst);
+    // Fastmem information
+    using DoNotFastmemMarker = std::tuple<IR::LocationDescriptor, std::ptrdiff_t>;
+    struct FastmemPatchInfo {
+        u64 resume_rip;
+        u64 callback;
+        DoNotFastmemMarker marker;
+    };
+    tsl::robin_map<u64, FastmemPatchInfo> fastmem_patch_info;
+    std::set<DoNotFastmemMarker> do_not_fastmem;
+    std::optional<DoNotFastmemMarker> ShouldFastmem(A64EmitContext& ctx, IR::Inst* inst) const;
+    FakeCall FastmemCallback(u64 rip);
+
+    // Memory access helpers
+    template<std::size_t bitsize, auto callback>
+    void EmitMemoryRead(A64EmitContext& ctx, IR::Inst* inst);
+    template<std::size_t bitsize, auto callback>
+    void EmitMemoryWrite(A64EmitContext& ctx, IR::Inst* inst);
     template<std::size_t bitsize, auto callback>
     void EmitExclusiveReadMemory(A64EmitContext& ctx, IR::Inst* inst);
     template<std::size_t bitsize, auto callback>
     void EmitExclusiveWriteMemory(A64EmitContext& ctx, IR::Inst* inst);
+    template<std::size_t bitsize>
+    void EmitExclusiveReadMemoryInline(A64EmitContext& ctx, IR::Inst* inst);
+    template<std::size_t bitsize, auto callback>
+    void EmitExclusiveWriteMemoryInline(A64EmitContext& ctx, IR::Inst* inst);
+    template<std::size_t bitsize, auto read_callback, auto write_callback, auto exclusive_write_callback>
+    void EmitAtomicCompareAndSwap(A64EmitContext& ctx, IR::Inst* inst);
+    template<std::size_t bitsize, auto read_callback, auto write_callback, auto exclusive_write_callback>
+    void EmitAtomicReadModifyWrite(A64EmitContext& ctx, IR::Inst* inst);
 
     // Microinstruction emitters
     void EmitPushRSB(EmitContext& ctx, IR::Inst* inst);
@@ -117,10 +206,22 @@ protected:
     void EmitTerminalImpl(IR::Term::CheckHalt terminal, IR::LocationDescriptor initial_location, bool is_single_step) override;
 
     // Patching
+    void Patch(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr) override;
     void Unpatch(const IR::LocationDescriptor& target_desc) override;
     void EmitPatchJg(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr = nullptr) override;
     void EmitPatchJmp(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr = nullptr) override;
-    void EmitPatchMovRcx(CodePtr target_code_ptr = nullptr) override;
+    void EmitPatchMovRcx(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr = nullptr) override;
+
+    // With a shared code cache, code cannot be patched while other threads may be executing
+    // it. Links instead jump indirectly through a slot per target, which is updated atomically.
+    struct LinkSlot {
+        std::atomic<CodePtr> target{nullptr};
+        /// Far code that exits to the dispatcher with the PC set to the target.
+        CodePtr exit_stub = nullptr;
+    };
+    std::deque<LinkSlot> link_slots;
+    tsl::robin_map<u64, LinkSlot*> link_slot_map;
+    LinkSlot& GetLinkSlot(const IR::LocationDescriptor& target_desc);
 };
 
 } // namespace Dynarmic::Backend::X64
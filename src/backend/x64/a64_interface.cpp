@@ -3,20 +3,33 @@
  * SPDX-License-Identifier: 0BSD
  */
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <typeinfo>
+#include <utility>
+#include <vector>
 
 #include <boost/icl/interval_set.hpp>
+#include <boost/variant/get.hpp>
 #include <dynarmic/A64/a64.h>
+#include <dynarmic/exclusive_monitor.h>
 
 #include "backend/x64/a64_emit_x64.h"
 #include "backend/x64/a64_jitstate.h"
+#include "backend/x64/background_translator.h"
 #include "backend/x64/block_of_code.h"
+#include "backend/x64/code_page_protector.h"
 #include "backend/x64/devirtualize.h"
 #include "backend/x64/jitstate_info.h"
+#include "backend/x64/translation_cache.h"
 #include "common/assert.h"
+#include "common/bit_util.h"
 #include "common/llvm_disassemble.h"
 #include "common/scope_exit.h"
+#include "common/variant_util.h"
 #include "frontend/A64/translate/translate.h"
 #include "frontend/ir/basic_block.h"
 #include "ir_opt/passes.h"
@@ -25,11 +38,41 @@ namespace Dynarmic::A64 {
 
 using namespace Backend::X64;
 
-static RunCodeCallbacks GenRunCodeCallbacks(A64::UserCallbacks* cb, CodePtr (*LookupBlock)(void* lookup_block_arg), void* arg) {
+namespace {
+
+/// Implemented by Jit::Impl, so that compiled code can look up blocks on behalf of the Jit running it.
+class CodeCacheUser {
+public:
+    virtual CodePtr GetCurrentBlock() = 0;
+
+protected:
+    ~CodeCacheUser() = default;
+};
+
+} // anonymous namespace
+
+static CodePtr GetCurrentBlockThunk(void* user) {
+    return static_cast<CodeCacheUser*>(user)->GetCurrentBlock();
+}
+
+static RunCodeCallbacks GenRunCodeCallbacks(const A64::UserConfig& conf, CodeCacheUser* user) {
+    if (!conf.shared_code_cache) {
+        return RunCodeCallbacks{
+            std::make_unique<ArgCallback>(&GetCurrentBlockThunk, reinterpret_cast<u64>(user)),
+            std::make_unique<ArgCallback>(Devirtualize<&A64::UserCallbacks::AddTicks>(conf.callbacks)),
+            std::make_unique<ArgCallback>(Devirtualize<&A64::UserCallbacks::GetTicksRemaining>(conf.callbacks)),
+        };
+    }
+
+    // Code shared between Jits finds the running Jit and its callbacks through its JIT state.
+    using namespace Xbyak::util;
+    const Xbyak::Address jit_instance = qword[r15 + offsetof(A64JitState, jit_instance)];
+    const Xbyak::Address callbacks = qword[r15 + offsetof(A64JitState, user_callbacks)];
+    const u64 callbacks_base = reinterpret_cast<u64>(conf.callbacks);
     return RunCodeCallbacks{
-        std::make_unique<ArgCallback>(LookupBlock, reinterpret_cast<u64>(arg)),
-        std::make_unique<ArgCallback>(Devirtualize<&A64::UserCallbacks::AddTicks>(cb)),
-        std::make_unique<ArgCallback>(Devirtualize<&A64::UserCallbacks::GetTicksRemaining>(cb)),
+        std::make_unique<ArgCallback>(ArgCallback{&GetCurrentBlockThunk, 0}.WithArgumentLoadedFrom(jit_instance, 0)),
+        std::make_unique<ArgCallback>(Devirtualize<&A64::UserCallbacks::AddTicks>(conf.callbacks).WithArgumentLoadedFrom(callbacks, callbacks_base)),
+        std::make_unique<ArgCallback>(Devirtualize<&A64::UserCallbacks::GetTicksRemaining>(conf.callbacks).WithArgumentLoadedFrom(callbacks, callbacks_base)),
     };
 }
 
@@ -38,26 +81,501 @@ static std::function<void(BlockOfCode&)> GenRCP(const A64::UserConfig& conf) {
         if (conf.page_table) {
             code.mov(code.r14, Common::BitCast<u64>(conf.page_table));
         }
+        if (conf.tlb_entry_count) {
+            code.mov(code.r14, code.qword[code.r15 + offsetof(A64JitState, tlb)]);
+        }
+        if (conf.fastmem_pointer) {
+            code.mov(code.r13, Common::BitCast<u64>(conf.fastmem_pointer));
+        }
     };
 }
 
-struct Jit::Impl final {
+/// Sharing lookups only pays off when accesses walk a page table or TLB inline.
+static bool UsesPageLookupReuse(const UserConfig& conf) {
+    return conf.HasOptimization(OptimizationFlag::Unsafe_PageLookupReuse)
+        && (conf.page_table || conf.tlb_entry_count)
+        && !conf.fastmem_pointer;
+}
+
+/// Describes the configuration options that affect the result of TranslateBlock.
+static u64 TranslationCacheKey(const UserConfig& conf) {
+    u64 key = 0;
+    key |= static_cast<u64>(conf.HasOptimization(OptimizationFlag::GetSetElimination)) << 0;
+    key |= static_cast<u64>(conf.HasOptimization(OptimizationFlag::ConstProp)) << 1;
+    key |= static_cast<u64>(conf.HasOptimization(OptimizationFlag::MiscIROpt)) << 2;
+    key |= static_cast<u64>(conf.HasOptimization(OptimizationFlag::Unsafe_BranchFollowing)) << 3;
+    key |= static_cast<u64>(conf.define_unpredictable_behaviour) << 4;
+    key |= static_cast<u64>(conf.wall_clock_cntpct) << 5;
+    key |= static_cast<u64>(conf.hook_data_cache_operations) << 6;
+    key |= static_cast<u64>(UsesPageLookupReuse(conf)) << 7;
+    key |= static_cast<u64>(conf.HasOptimization(OptimizationFlag::Unsafe_ElideExitFlags)) << 8;
+    key |= static_cast<u64>(conf.dczid_el0) << 32;
+    return key;
+}
+
+/// Checks that code compiled with `cache_conf` behaves as if it had been compiled with `conf`.
+static bool IsCompatibleWithSharedCodeCache(const UserConfig& conf, const UserConfig& cache_conf) {
+    return typeid(*conf.callbacks) == typeid(*cache_conf.callbacks)
+        && conf.global_monitor == cache_conf.global_monitor
+        && conf.inline_exclusive_access == cache_conf.inline_exclusive_access
+        && conf.optimizations == cache_conf.optimizations
+        && conf.unsafe_optimizations == cache_conf.unsafe_optimizations
+        && conf.hook_data_cache_operations == cache_conf.hook_data_cache_operations
+        && conf.hook_isb == cache_conf.hook_isb
+        && conf.hook_hint_instructions == cache_conf.hook_hint_instructions
+        && conf.cntfrq_el0 == cache_conf.cntfrq_el0
+        && conf.ctr_el0 == cache_conf.ctr_el0
+        && conf.dczid_el0 == cache_conf.dczid_el0
+        && (conf.tpidrro_el0 == nullptr) == (cache_conf.tpidrro_el0 == nullptr)
+        && (conf.tpidr_el0 == nullptr) == (cache_conf.tpidr_el0 == nullptr)
+        && conf.page_table == cache_conf.page_table
+        && conf.page_table_address_space_bits == cache_conf.page_table_address_space_bits
+        && conf.page_table_levels == cache_conf.page_table_levels
+        && conf.page_table_huge_pages == cache_conf.page_table_huge_pages
+        && conf.page_table_pointer_mask_bits == cache_conf.page_table_pointer_mask_bits
+        && conf.silently_mirror_page_table == cache_conf.silently_mirror_page_table
+        && conf.absolute_offset_page_table == cache_conf.absolute_offset_page_table
+        && conf.detect_misaligned_access_via_page_table == cache_conf.detect_misaligned_access_via_page_table
+        && conf.only_detect_misalignment_via_page_table_on_page_boundary == cache_conf.only_detect_misalignment_via_page_table_on_page_boundary
+        && conf.tlb_entry_count == cache_conf.tlb_entry_count
+        && conf.fastmem_pointer == nullptr
+        && conf.detect_self_modifying_code == cache_conf.detect_self_modifying_code
+        && conf.define_unpredictable_behaviour == cache_conf.define_unpredictable_behaviour
+        && conf.wall_clock_cntpct == cache_conf.wall_clock_cntpct;
+}
+
+static void CollectLinkTargets(const IR::Terminal& terminal, std::vector<IR::LocationDescriptor>& targets) {
+    Common::VisitVariant<void>(terminal, [&targets](const auto& term) {
+        using T = std::decay_t<decltype(term)>;
+        if constexpr (std::is_same_v<T, IR::Term::LinkBlock> || std::is_same_v<T, IR::Term::LinkBlockFast>) {
+            targets.emplace_back(term.next);
+        } else if constexpr (std::is_same_v<T, IR::Term::If> || std::is_same_v<T, IR::Term::CheckBit>) {
+            CollectLinkTargets(term.then_, targets);
+            CollectLinkTargets(term.else_, targets);
+        } else if constexpr (std::is_same_v<T, IR::Term::CheckHalt>) {
+            CollectLinkTargets(term.else_, targets);
+        }
+    });
+}
+
+/**
+ * Compiled code, and everything required to compile and invalidate it. Each Jit owns one,
+ * unless it is attached to a SharedCodeCache, in which case all attached Jits use the same one.
+ * Compilation and invalidation are serialized by the cache's mutex. Invalidation is deferred
+ * until no attached Jit is executing.
+ */
+class CodeCache final {
 public:
-    Impl(Jit* jit, UserConfig conf)
+    CodeCache(UserConfig conf, CodeCacheUser* user, Jit* jit)
         : conf(conf)
-        , block_of_code(GenRunCodeCallbacks(conf.callbacks, &GetCurrentBlockThunk, this), JitStateInfo{jit_state}, GenRCP(conf))
+        , block_of_code(GenRunCodeCallbacks(conf, user), JitStateInfo{A64JitState{}}, GenRCP(conf), conf.code_cache_size, conf.far_code_offset, conf.disabled_host_features)
         , emitter(block_of_code, conf, jit)
     {
         ASSERT(conf.page_table_address_space_bits >= 12 && conf.page_table_address_space_bits <= 64);
+        ASSERT(conf.page_table_levels >= 1 && conf.page_table_levels <= 4);
+        ASSERT(conf.page_table_levels == 1 || conf.page_table_address_space_bits > 12 + 9 * (conf.page_table_levels - 1));
+        ASSERT(conf.fastmem_address_space_bits >= 12 && conf.fastmem_address_space_bits <= 64);
+        ASSERT(Common::BitCount(conf.tlb_entry_count) <= 1 && conf.tlb_entry_count <= 65536);
+        ASSERT_MSG(!conf.page_table || !conf.tlb_entry_count, "page_table and the software TLB cannot both be used");
+
+        if (conf.detect_self_modifying_code) {
+            ASSERT_MSG(conf.page_table || conf.tlb_entry_count || conf.fastmem_pointer, "Detection of self-modifying code requires page_table, tlb_entry_count or fastmem_pointer");
+            ASSERT_MSG(CodePageProtector::IsSupported(), "Detection of self-modifying code is unsupported on this host");
+            code_page_protector.emplace();
+        }
+        if (!conf.translation_cache_path.empty()) {
+            translation_cache.emplace(conf.translation_cache_path, TranslationCacheKey(conf), conf.translation_cache_size_limit);
+        }
+        if (conf.background_translation_threads != 0) {
+            background_translator.emplace(conf.background_translation_threads, [this](IR::LocationDescriptor location) {
+                return TranslateBlock(location, this->conf.tiered_compilation_threshold != 0);
+            });
+        }
+    }
+
+    ~CodeCache() {
+        ASSERT(attached_states.empty());
+    }
+
+    const UserConfig& Config() const {
+        return conf;
+    }
+
+    bool IsShared() const {
+        return conf.shared_code_cache != nullptr;
+    }
+
+    std::unique_lock<std::recursive_mutex> Lock() {
+        return std::unique_lock{mutex};
+    }
+
+    /// Registers the JIT state of an attached Jit. Returns its fast dispatch table if the cache is shared.
+    void* Attach(A64JitState& jit_state) {
+        std::lock_guard lock{mutex};
+        attached_states.emplace_back(&jit_state);
+        return IsShared() ? emitter.AllocateFastDispatchTable() : nullptr;
+    }
+
+    void Detach(A64JitState& jit_state, void* fast_dispatch_table) {
+        std::lock_guard lock{mutex};
+        attached_states.erase(std::find(attached_states.begin(), attached_states.end(), &jit_state));
+        if (fast_dispatch_table) {
+            emitter.FreeFastDispatchTable(fast_dispatch_table);
+        }
+    }
+
+    /// Must be called before an attached Jit executes code.
+    void BeginExecution(A64JitState& jit_state) {
+        std::lock_guard lock{mutex};
+        executing_count++;
+        CollectWrittenCodePages();
+        if (!IsCacheInvalidationPending()) {
+            return;
+        }
+        if (executing_count == 1) {
+            PerformRequestedCacheInvalidation();
+        } else {
+            jit_state.halt_requested = true;
+        }
+    }
+
+    /// Must be called once an attached Jit has stopped executing code.
+    void EndExecution() {
+        std::lock_guard lock{mutex};
+        executing_count--;
+        if (executing_count == 0) {
+            CollectWrittenCodePages();
+            PerformRequestedCacheInvalidation();
+        }
+    }
+
+    void ClearCache() {
+        std::lock_guard lock{mutex};
+        invalidate_entire_cache = true;
+        RequestCacheInvalidation();
+    }
+
+    void InvalidateCacheRange(u64 start_address, size_t length) {
+        std::lock_guard lock{mutex};
+        const auto end_address = static_cast<u64>(start_address + length - 1);
+        const auto range = boost::icl::discrete_interval<u64>::closed(start_address, end_address);
+        invalid_cache_ranges.add(range);
+        RequestCacheInvalidation();
+    }
+
+    std::string Disassemble() {
+        std::lock_guard lock{mutex};
+        return Common::DisassembleX64(block_of_code.GetCodeBegin(), block_of_code.getCurr());
+    }
+
+    CodePtr GetBlock(IR::LocationDescriptor current_location) {
+        std::lock_guard lock{mutex};
+
+        if (CollectWrittenCodePages()) {
+            // No block is executing on this thread between blocks, so stale code can be
+            // discarded immediately unless other Jits may be executing it.
+            if (executing_count == 1) {
+                PerformRequestedCacheInvalidation();
+            } else {
+                RequestCacheInvalidation();
+            }
+        }
+
+        bool is_hot = false;
+        if (auto block = emitter.GetBasicBlock(current_location)) {
+            if (!emitter.IsHotTierZeroBlock(current_location)) {
+                return block->entrypoint;
+            }
+
+            // This block was compiled without optimizations and has since become hot.
+            // Recompile it; registering the new code repoints existing links to it.
+            is_hot = true;
+            emitter.InvalidateBasicBlocks({current_location});
+            // Return stack buffer entries may point to the tier-0 code, which no longer returns to the dispatcher.
+            // Jits executing from a shared cache concurrently keep theirs; that code is stale but still correct.
+            if (!IsShared() || executing_count == 1) {
+                for (A64JitState* jit_state : attached_states) {
+                    jit_state->ResetRSB();
+                }
+            }
+        }
+
+        bool is_tier_zero = conf.tiered_compilation_threshold != 0 && !is_hot && !A64::LocationDescriptor{current_location}.SingleStepping();
+
+        constexpr size_t MINIMUM_REMAINING_CODESIZE = 1 * 1024 * 1024;
+        if (block_of_code.SpaceRemaining() < MINIMUM_REMAINING_CODESIZE) {
+            if (!IsShared()) {
+                // Discard only the oldest code; recently compiled blocks survive.
+                for (A64JitState* jit_state : attached_states) {
+                    jit_state->ResetRSB();
+                }
+                emitter.EvictOldestCodeRegion();
+            } else if (executing_count > 1) {
+                // Other Jits may be executing code from this cache: halt them, and clear once all have returned.
+                invalidate_entire_cache = true;
+                RequestCacheInvalidation();
+                return block_of_code.GetForceReturnFromRunCodeAddress();
+            } else {
+                // Immediately evacuate cache
+                invalidate_entire_cache = true;
+                PerformRequestedCacheInvalidation();
+            }
+        }
+
+        // JIT Compile
+        std::optional<IR::Block> ir_block;
+        if (translation_cache) {
+            // Cached blocks are fully optimized, so there is no need to count their executions.
+            ir_block = translation_cache->Load(current_location, [this](u64 vaddr) { return ReadCode(vaddr); });
+            if (ir_block) {
+                is_tier_zero = false;
+            }
+        }
+        if (!ir_block && background_translator && !is_hot) {
+            ir_block = background_translator->Take(current_location);
+        }
+        if (!ir_block) {
+            ir_block = TranslateBlock(current_location, is_tier_zero);
+        }
+        const CodePtr entrypoint = emitter.Emit(*ir_block, is_tier_zero).entrypoint;
+
+        if (background_translator && !A64::LocationDescriptor{current_location}.SingleStepping()) {
+            std::vector<IR::LocationDescriptor> targets;
+            CollectLinkTargets(ir_block->GetTerminal(), targets);
+            for (const auto& target : targets) {
+                if (!emitter.GetBasicBlock(target)) {
+                    background_translator->Enqueue(target);
+                }
+            }
+        }
+
+        return entrypoint;
+    }
+
+    void RunCode(A64JitState& jit_state, CodePtr code_ptr) {
+        block_of_code.RunCode(&jit_state, code_ptr);
+    }
+
+    void StepCode(A64JitState& jit_state, CodePtr code_ptr) {
+        block_of_code.StepCode(&jit_state, code_ptr);
+    }
+
+    void ChangeProcessorID(size_t value) {
+        // Shared code reads the processor ID from the configuration of the running Jit.
+        if (!IsShared()) {
+            emitter.ChangeProcessorID(value);
+        }
+    }
+
+private:
+    /// Translates and optimizes the block at `location`. This may be called from background
+    /// translation threads, and so must not touch emitter or JIT state.
+    IR::Block TranslateBlock(IR::LocationDescriptor location, bool is_tier_zero) {
+        // Guest code read during translation is recorded for validation of translation cache entries.
+        const bool record_code = translation_cache && !is_tier_zero;
+        TranslationCache::GuestCode code;
+        const auto get_code = [this, record_code, &code](u64 vaddr) {
+            const u32 instruction = ReadCode(vaddr);
+            if (record_code) {
+                code.emplace_back(vaddr, instruction);
+            }
+            return instruction;
+        };
+        const bool follow_branches = !is_tier_zero && conf.HasOptimization(OptimizationFlag::Unsafe_BranchFollowing);
+        IR::Block ir_block = A64::Translate(A64::LocationDescriptor{location}, get_code,
+                                                {conf.define_unpredictable_behaviour, conf.wall_clock_cntpct, follow_branches});
+        Optimization::A64CallbackConfigPass(ir_block, conf);
+        if (!is_tier_zero) {
+            if (conf.HasOptimization(OptimizationFlag::GetSetElimination)) {
+                Optimization::A64GetSetElimination(ir_block);
+                Optimization::DeadCodeElimination(ir_block);
+            }
+            if (conf.HasOptimization(OptimizationFlag::ConstProp)) {
+                Optimization::ConstantPropagation(ir_block);
+                Optimization::DeadCodeElimination(ir_block);
+            }
+            if (conf.HasOptimization(OptimizationFlag::MiscIROpt)) {
+                Optimization::A64MergeInterpretBlocksPass(ir_block, conf.callbacks);
+            }
+            if (conf.HasOptimization(OptimizationFlag::GetSetElimination)) {
+                // Without a way to translate following code, only writes to NZCV that are dead within the block are removed.
+                Optimization::TranslateInstructionFunc translate_instruction;
+                if (conf.HasOptimization(OptimizationFlag::Unsafe_ElideExitFlags) && !A64::LocationDescriptor{location}.SingleStepping()) {
+                    translate_instruction = [&](IR::LocationDescriptor next) {
+                        return A64::Translate(A64::LocationDescriptor{next}.SetSingleStepping(true), get_code,
+                                              {conf.define_unpredictable_behaviour, conf.wall_clock_cntpct, false});
+                    };
+                }
+                Optimization::A64FlagLivenessPass(ir_block, translate_instruction);
+                Optimization::DeadCodeElimination(ir_block);
+            }
+            if (UsesPageLookupReuse(conf)) {
+                Optimization::A64PageLookupReusePass(ir_block);
+            }
+        }
+        Optimization::VerificationPass(ir_block);
+
+        if (record_code) {
+            // Instructions merged into an Interpret terminal are read by the optimization pass.
+            const IR::Terminal terminal = ir_block.GetTerminal();
+            if (const auto term = boost::get<IR::Term::Interpret>(&terminal)) {
+                const u64 pc = A64::LocationDescriptor{term->next}.PC();
+                for (size_t i = 0; i < term->num_instructions; i++) {
+                    get_code(pc + i * 4);
+                }
+            }
+            translation_cache->Store(ir_block, std::move(code));
+        }
+
+        return ir_block;
+    }
+
+    /// Reads guest code for translation. Its page is first protected if writes to code are detected.
+    u32 ReadCode(u64 vaddr) {
+        if (code_page_protector) {
+            ProtectCodePage(vaddr & ~(CodePageProtector::page_size - 1));
+        }
+        return conf.callbacks->MemoryReadCode(vaddr);
+    }
+
+    /// Protects the host pages through which compiled code accesses the guest page at `page`.
+    void ProtectCodePage(u64 page) {
+        if (conf.fastmem_pointer) {
+            const size_t unused_top_bits = 64 - conf.fastmem_address_space_bits;
+            const u64 offset = (page << unused_top_bits) >> unused_top_bits;
+            if (offset == page || conf.silently_mirror_fastmem) {
+                code_page_protector->Protect(page, static_cast<u8*>(conf.fastmem_pointer) + offset);
+            }
+        }
+        if (conf.page_table) {
+            if (u8* const host = LookupPageTable(conf, page)) {
+                code_page_protector->Protect(page, host);
+            }
+        }
+        if (conf.tlb_entry_count) {
+            if (void* const host = conf.callbacks->TranslatePage(page)) {
+                code_page_protector->Protect(page, host);
+            }
+        }
+    }
+
+    /// Queues the invalidation of guest code pages that have been written to. Returns true if there were any.
+    bool CollectWrittenCodePages() {
+        if (!code_page_protector || !code_page_protector->HasWrittenPages()) {
+            return false;
+        }
+        for (const u64 page : code_page_protector->TakeWrittenPages()) {
+            invalid_cache_ranges.add(boost::icl::discrete_interval<u64>::closed(page, page + CodePageProtector::page_size - 1));
+        }
+        return true;
     }
 
-    ~Impl() = default;
+    bool IsCacheInvalidationPending() const {
+        return invalidate_entire_cache || !invalid_cache_ranges.empty();
+    }
+
+    void RequestCacheInvalidation() {
+        if (executing_count == 0) {
+            PerformRequestedCacheInvalidation();
+            return;
+        }
+
+        if (IsShared()) {
+            // Attached Jits may otherwise continue executing indefinitely.
+            for (A64JitState* jit_state : attached_states) {
+                jit_state->halt_requested = true;
+            }
+        }
+    }
+
+    void PerformRequestedCacheInvalidation() {
+        if (!IsCacheInvalidationPending()) {
+            return;
+        }
+
+        for (A64JitState* jit_state : attached_states) {
+            jit_state->ResetRSB();
+        }
+        if (background_translator) {
+            background_translator->Clear();
+        }
+        if (invalidate_entire_cache) {
+            block_of_code.ClearCache();
+            emitter.ClearCache();
+            if (code_page_protector) {
+                code_page_protector->Reset();
+            }
+        } else {
+            emitter.InvalidateCacheRanges(invalid_cache_ranges);
+        }
+        invalid_cache_ranges.clear();
+        invalidate_entire_cache = false;
+    }
+
+    UserConfig conf;
+    BlockOfCode block_of_code;
+    A64EmitX64 emitter;
+
+    std::recursive_mutex mutex;
+    std::vector<A64JitState*> attached_states;
+    size_t executing_count = 0;
+
+    bool invalidate_entire_cache = false;
+    boost::icl::interval_set<u64> invalid_cache_ranges;
+
+    std::optional<TranslationCache> translation_cache;
+    std::optional<CodePageProtector> code_page_protector;
+
+    // Declared last so that worker threads are stopped before anything they use is destroyed.
+    std::optional<BackgroundTranslator> background_translator;
+};
+
+struct SharedCodeCache::Impl final {
+    explicit Impl(UserConfig conf)
+        : code_cache(conf, nullptr, nullptr) {}
+
+    CodeCache code_cache;
+};
+
+SharedCodeCache::SharedCodeCache(UserConfig conf) {
+#ifdef DYNARMIC_ENABLE_NO_EXECUTE_SUPPORT
+    // Code is made non-executable while any Jit emits into it, which would fault other Jits
+    // executing from the cache at the time.
+    ASSERT_FALSE("Shared code caches are unsupported when built with DYNARMIC_ENABLE_NO_EXECUTE_SUPPORT");
+#endif
+    conf.shared_code_cache = this;
+    impl = std::make_unique<Impl>(conf);
+}
+
+SharedCodeCache::~SharedCodeCache() = default;
+
+struct Jit::Impl final : public CodeCacheUser {
+public:
+    Impl(Jit* jit, UserConfig conf, CodeCache* shared_code_cache)
+        : conf(conf)
+        , owned_code_cache(shared_code_cache ? nullptr : std::make_unique<CodeCache>(conf, this, jit))
+        , code_cache(shared_code_cache ? *shared_code_cache : *owned_code_cache)
+    {
+        ASSERT_MSG(!shared_code_cache || IsCompatibleWithSharedCodeCache(conf, code_cache.Config()),
+                   "Configuration is incompatible with that of the shared code cache");
+
+        fast_dispatch_table = code_cache.Attach(jit_state);
+        if (conf.tlb_entry_count) {
+            tlb = std::make_unique<A64JitState::TLBEntry[]>(conf.tlb_entry_count);
+        }
+        InitializeJitState();
+    }
+
+    ~Impl() {
+        code_cache.Detach(jit_state, fast_dispatch_table);
+    }
 
     void Run() {
         ASSERT(!is_executing);
         is_executing = true;
         SCOPE_EXIT { this->is_executing = false; };
         jit_state.halt_requested = false;
+        code_cache.BeginExecution(jit_state);
 
         // TODO: Check code alignment
 
@@ -71,9 +589,9 @@ public:
 
             return GetCurrentBlock();
         }();
-        block_of_code.RunCode(&jit_state, current_code_ptr);
+        code_cache.RunCode(jit_state, current_code_ptr);
 
-        PerformRequestedCacheInvalidation();
+        code_cache.EndExecution();
     }
 
     void Step() {
@@ -81,10 +599,11 @@ public:
         is_executing = true;
         SCOPE_EXIT { this->is_executing = false; };
         jit_state.halt_requested = true;
+        code_cache.BeginExecution(jit_state);
 
-        block_of_code.StepCode(&jit_state, GetCurrentSingleStep());
+        code_cache.StepCode(jit_state, GetCurrentSingleStep());
 
-        PerformRequestedCacheInvalidation();
+        code_cache.EndExecution();
     }
 
     void ExceptionalExit() {
@@ -92,30 +611,46 @@ public:
             const s64 ticks = jit_state.cycles_to_run - jit_state.cycles_remaining;
             conf.callbacks->AddTicks(ticks);
         }
-        PerformRequestedCacheInvalidation();
+        code_cache.EndExecution();
         is_executing = false;
     }
 
     void ChangeProcessorID(size_t value) {
         conf.processor_id = value;
-        emitter.ChangeProcessorID(value);
+        code_cache.ChangeProcessorID(value);
     }
 
     void ClearCache() {
-        invalidate_entire_cache = true;
-        RequestCacheInvalidation();
+        code_cache.ClearCache();
     }
 
     void InvalidateCacheRange(u64 start_address, size_t length) {
-        const auto end_address = static_cast<u64>(start_address + length - 1);
-        const auto range = boost::icl::discrete_interval<u64>::closed(start_address, end_address);
-        invalid_cache_ranges.add(range);
-        RequestCacheInvalidation();
+        code_cache.InvalidateCacheRange(start_address, length);
+    }
+
+    void InvalidateTLB(u64 start_address, size_t length) {
+        if (!tlb || length == 0) {
+            return;
+        }
+        const u64 first_page = start_address >> 12;
+        const u64 last_page = (start_address + length - 1) >> 12;
+        if (last_page < first_page || last_page - first_page >= conf.tlb_entry_count - 1) {
+            std::fill_n(tlb.get(), conf.tlb_entry_count, A64JitState::TLBEntry{});
+            return;
+        }
+        for (u64 page = first_page; page <= last_page; page++) {
+            A64JitState::TLBEntry& entry = tlb[page & (conf.tlb_entry_count - 1)];
+            if (entry.tag == page) {
+                entry = {};
+            }
+        }
     }
 
     void Reset() {
         ASSERT(!is_executing);
+        const auto lock = code_cache.Lock();
         jit_state = {};
+        InitializeJitState();
     }
 
     void HaltExecution() {
@@ -212,96 +747,47 @@ public:
     }
 
     std::string Disassemble() const {
-        return Common::DisassembleX64(block_of_code.GetCodeBegin(), block_of_code.getCurr());
+        return code_cache.Disassemble();
     }
 
-private:
-    static CodePtr GetCurrentBlockThunk(void* thisptr) {
-        Jit::Impl* this_ = static_cast<Jit::Impl*>(thisptr);
-        return this_->GetCurrentBlock();
+    CodePtr GetCurrentBlock() override {
+        return code_cache.GetBlock(GetCurrentLocation());
     }
 
+private:
     IR::LocationDescriptor GetCurrentLocation() const {
         return IR::LocationDescriptor{jit_state.GetUniqueHash()};
     }
 
-    CodePtr GetCurrentBlock() {
-        return GetBlock(GetCurrentLocation());
-    }
-
     CodePtr GetCurrentSingleStep() {
-        return GetBlock(A64::LocationDescriptor{GetCurrentLocation()}.SetSingleStepping(true));
-    }
-
-    CodePtr GetBlock(IR::LocationDescriptor current_location) {
-        if (auto block = emitter.GetBasicBlock(current_location))
-            return block->entrypoint;
-
-        constexpr size_t MINIMUM_REMAINING_CODESIZE = 1 * 1024 * 1024;
-        if (block_of_code.SpaceRemaining() < MINIMUM_REMAINING_CODESIZE) {
-            // Immediately evacuate cache
-            invalidate_entire_cache = true;
-            PerformRequestedCacheInvalidation();
-        }
-
-        // JIT Compile
-        const auto get_code = [this](u64 vaddr) { return conf.callbacks->MemoryReadCode(vaddr); };
-        IR::Block ir_block = A64::Translate(A64::LocationDescriptor{current_location}, get_code,
-                                                {conf.define_unpredictable_behaviour, conf.wall_clock_cntpct});
-        Optimization::A64CallbackConfigPass(ir_block, conf);
-        if (conf.HasOptimization(OptimizationFlag::GetSetElimination)) {
-            Optimization::A64GetSetElimination(ir_block);
-            Optimization::DeadCodeElimination(ir_block);
+        return code_cache.GetBlock(A64::LocationDescriptor{GetCurrentLocation()}.SetSingleStepping(true));
+    }
+
+    void InitializeJitState() {
+        jit_state.user_config = &conf;
+        jit_state.user_callbacks = conf.callbacks;
+        jit_state.tpidr_el0 = conf.tpidr_el0;
+        jit_state.tpidrro_el0 = conf.tpidrro_el0;
+        jit_state.fast_dispatch_table = fast_dispatch_table;
+        jit_state.jit_instance = static_cast<CodeCacheUser*>(this);
+        jit_state.tlb = tlb.get();
+        if (conf.global_monitor) {
+            jit_state.exclusive_reservation = conf.global_monitor->GetReservationAddress(conf.processor_id);
         }
-        if (conf.HasOptimization(OptimizationFlag::ConstProp)) {
-            Optimization::ConstantPropagation(ir_block);
-            Optimization::DeadCodeElimination(ir_block);
-        }
-        if (conf.HasOptimization(OptimizationFlag::MiscIROpt)) {
-            Optimization::A64MergeInterpretBlocksPass(ir_block, conf.callbacks);
-        }
-        Optimization::VerificationPass(ir_block);
-        return emitter.Emit(ir_block).entrypoint;
-    }
-
-    void RequestCacheInvalidation() {
-        if (is_executing) {
-//            jit_state.halt_requested = true;
-            return;
-        }
-
-        PerformRequestedCacheInvalidation();
-    }
-
-    void PerformRequestedCacheInvalidation() {
-        if (!invalidate_entire_cache && invalid_cache_ranges.empty()) {
-            return;
-        }
-
-        jit_state.ResetRSB();
-        if (invalidate_entire_cache) {
-            block_of_code.ClearCache();
-            emitter.ClearCache();
-        } else {
-            emitter.InvalidateCacheRanges(invalid_cache_ranges);
-        }
-        invalid_cache_ranges.clear();
-        invalidate_entire_cache = false;
     }
 
     bool is_executing = false;
 
     UserConfig conf;
     A64JitState jit_state;
-    BlockOfCode block_of_code;
-    A64EmitX64 emitter;
-
-    bool invalidate_entire_cache = false;
-    boost::icl::interval_set<u64> invalid_cache_ranges;
+    std::unique_ptr<CodeCache> owned_code_cache;
+    CodeCache& code_cache;
+    void* fast_dispatch_table = nullptr;
+    std::unique_ptr<A64JitState::TLBEntry[]> tlb;
 };
 
 Jit::Jit(UserConfig conf)
-    : impl(std::make_unique<Jit::Impl>(this, conf)) {}
+    : impl(std::make_unique<Jit::Impl>(this, conf, conf.shared_code_cache ? &conf.shared_code_cache->impl->code_cache : nullptr)) {}
 
 Jit::~Jit() = default;
 
@@ -321,6 +807,10 @@ void Jit::InvalidateCacheRange(u64 start_address, size_t length) {
     impl->InvalidateCacheRange(start_address, length);
 }
 
+void Jit::InvalidateTLB(u64 start_address, size_t length) {
+    impl->InvalidateTLB(start_address, length);
+}
+
 void Jit::Reset() {
     impl->Reset();
 }
@@ -9,6 +9,8 @@
 
 #include <xbyak.h>
 
+#include <dynarmic/A64/config.h>
+
 #include "backend/x64/nzcv_util.h"
 #include "common/common_types.h"
 #include "frontend/A64/location_descriptor.h"
@@ -61,6 +63,8 @@ struct A64JitState {
     // Exclusive state
     static constexpr u64 RESERVATION_GRANULE_MASK = 0xFFFF'FFFF'FFFF'FFF0ull;
     u8 exclusive_state = 0;
+    u64 exclusive_address = 0;
+    alignas(16) std::array<u64, 2> exclusive_value{};
 
     static constexpr size_t RSBSize = 8; // MUST be a power of 2.
     static constexpr size_t RSBPtrMask = RSBSize - 1;
@@ -85,6 +89,25 @@ struct A64JitState {
         const u64 pc_u64 = pc & A64::LocationDescriptor::pc_mask;
         return pc_u64 | fpcr_u64;
     }
+
+    // Per-Jit state referenced by code in a shared code cache (See: A64::SharedCodeCache)
+    A64::UserConfig* user_config = nullptr;
+    A64::UserCallbacks* user_callbacks = nullptr;
+    const u64* tpidr_el0 = nullptr;
+    const u64* tpidrro_el0 = nullptr;
+    void* fast_dispatch_table = nullptr;
+    void* jit_instance = nullptr;
+    void* exclusive_reservation = nullptr;
+
+    /// An entry of the software TLB (See: A64::UserConfig::tlb_entry_count).
+    /// The host address of vaddr is vaddr + host_offset if vaddr >> 12 == tag.
+    struct TLBEntry {
+        static constexpr u64 invalid_tag = ~u64(0);
+
+        u64 tag = invalid_tag;
+        u64 host_offset = 0;
+    };
+    TLBEntry* tlb = nullptr;
 };
 
 #ifdef _MSC_VER
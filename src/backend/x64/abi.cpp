@@ -40,7 +40,7 @@ static FrameInfo CalculateFrameInfo(size_t num_gprs, size_t num_xmms, size_t fra
 }
 
 template<typename RegisterArrayT>
-void ABI_PushRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size, const RegisterArrayT& regs) {
+static void ABI_PushRegistersAndAdjustStackImpl(BlockOfCode& code, size_t frame_size, const RegisterArrayT& regs) {
     using namespace Xbyak::util;
 
     const size_t num_gprs = std::count_if(regs.begin(), regs.end(), HostLocIsGPR);
@@ -72,7 +72,7 @@ void ABI_PushRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size, const
 }
 
 template<typename RegisterArrayT>
-void ABI_PopRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size, const RegisterArrayT& regs) {
+static void ABI_PopRegistersAndAdjustStackImpl(BlockOfCode& code, size_t frame_size, const RegisterArrayT& regs) {
     using namespace Xbyak::util;
 
     const size_t num_gprs = std::count_if(regs.begin(), regs.end(), HostLocIsGPR);
@@ -104,31 +104,39 @@ void ABI_PopRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size, const
 }
 
 void ABI_PushCalleeSaveRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size) {
-    ABI_PushRegistersAndAdjustStack(code, frame_size, ABI_ALL_CALLEE_SAVE);
+    ABI_PushRegistersAndAdjustStackImpl(code, frame_size, ABI_ALL_CALLEE_SAVE);
 }
 
 void ABI_PopCalleeSaveRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size) {
-    ABI_PopRegistersAndAdjustStack(code, frame_size, ABI_ALL_CALLEE_SAVE);
+    ABI_PopRegistersAndAdjustStackImpl(code, frame_size, ABI_ALL_CALLEE_SAVE);
 }
 
 void ABI_PushCallerSaveRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size) {
-    ABI_PushRegistersAndAdjustStack(code, frame_size, ABI_ALL_CALLER_SAVE);
+    ABI_PushRegistersAndAdjustStackImpl(code, frame_size, ABI_ALL_CALLER_SAVE);
 }
 
 void ABI_PopCallerSaveRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size) {
-    ABI_PopRegistersAndAdjustStack(code, frame_size, ABI_ALL_CALLER_SAVE);
+    ABI_PopRegistersAndAdjustStackImpl(code, frame_size, ABI_ALL_CALLER_SAVE);
+}
+
+void ABI_PushRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size, const std::vector<HostLoc>& regs) {
+    ABI_PushRegistersAndAdjustStackImpl(code, frame_size, regs);
+}
+
+void ABI_PopRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size, const std::vector<HostLoc>& regs) {
+    ABI_PopRegistersAndAdjustStackImpl(code, frame_size, regs);
 }
 
 void ABI_PushCallerSaveRegistersAndAdjustStackExcept(BlockOfCode& code, HostLoc exception) {
     std::vector<HostLoc> regs;
     std::remove_copy(ABI_ALL_CALLER_SAVE.begin(), ABI_ALL_CALLER_SAVE.end(), std::back_inserter(regs), exception);
-    ABI_PushRegistersAndAdjustStack(code, 0, regs);
+    ABI_PushRegistersAndAdjustStackImpl(code, 0, regs);
 }
 
 void ABI_PopCallerSaveRegistersAndAdjustStackExcept(BlockOfCode& code, HostLoc exception) {
     std::vector<HostLoc> regs;
     std::remove_copy(ABI_ALL_CALLER_SAVE.begin(), ABI_ALL_CALLER_SAVE.end(), std::back_inserter(regs), exception);
-    ABI_PopRegistersAndAdjustStack(code, 0, regs);
+    ABI_PopRegistersAndAdjustStackImpl(code, 0, regs);
 }
 
 } // namespace Dynarmic::Backend::X64
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <vector>
 
 #include "backend/x64/hostloc.h"
 
@@ -117,6 +118,9 @@ void ABI_PopCalleeSaveRegistersAndAdjustStack(BlockOfCode& code, size_t frame_si
 void ABI_PushCallerSaveRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size = 0);
 void ABI_PopCallerSaveRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size = 0);
 
+void ABI_PushRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size, const std::vector<HostLoc>& regs);
+void ABI_PopRegistersAndAdjustStack(BlockOfCode& code, size_t frame_size, const std::vector<HostLoc>& regs);
+
 void ABI_PushCallerSaveRegistersAndAdjustStackExcept(BlockOfCode& code, HostLoc exception);
 void ABI_PopCallerSaveRegistersAndAdjustStackExcept(BlockOfCode& code, HostLoc exception);
 
@@ -0,0 +1,136 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#include "backend/x64/background_translator.h"
+#include "common/assert.h"
+
+namespace Dynarmic::Backend::X64 {
+
+BackgroundTranslator::BackgroundTranslator(size_t thread_count, TranslateFunction translate)
+        : translate(std::move(translate)) {
+    ASSERT(thread_count != 0);
+    for (size_t i = 0; i < thread_count; i++) {
+        threads.emplace_back([this] { WorkerThread(); });
+    }
+}
+
+BackgroundTranslator::~BackgroundTranslator() {
+    {
+        std::lock_guard lock{mutex};
+        stop = true;
+    }
+    work_available.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void BackgroundTranslator::Enqueue(IR::LocationDescriptor location) {
+    {
+        std::lock_guard lock{mutex};
+        if (queue.size() >= max_queued_translations || entries.count(location.Value())) {
+            return;
+        }
+        entries.emplace(location.Value(), Entry{State::Queued, std::nullopt});
+        queue.emplace_back(location);
+    }
+    work_available.notify_one();
+}
+
+std::optional<IR::Block> BackgroundTranslator::Take(IR::LocationDescriptor location) {
+    std::unique_lock lock{mutex};
+
+    auto iter = entries.find(location.Value());
+    if (iter == entries.end()) {
+        return std::nullopt;
+    }
+
+    if (iter->second.state == State::Queued) {
+        // Not yet started: translating on the calling thread is no slower than waiting.
+        entries.erase(iter);
+        return std::nullopt;
+    }
+
+    work_done.wait(lock, [&] {
+        iter = entries.find(location.Value());
+        return iter == entries.end() || iter->second.state == State::Done;
+    });
+    if (iter == entries.end()) {
+        return std::nullopt;
+    }
+
+    std::optional<IR::Block> block = std::move(iter.value().block);
+    entries.erase(iter);
+    return block;
+}
+
+void BackgroundTranslator::Clear() {
+    std::unique_lock lock{mutex};
+    generation++;
+    queue.clear();
+    entries.clear();
+    completed.clear();
+    work_done.notify_all();
+
+    // Translations already started may still be reading guest code.
+    work_done.wait(lock, [this] { return in_flight_count == 0; });
+}
+
+void BackgroundTranslator::DiscardOldestCompleted() {
+    while (completed.size() > max_completed_translations) {
+        const auto [location, completion_index] = completed.front();
+        completed.pop_front();
+
+        const auto iter = entries.find(location);
+        if (iter != entries.end() && iter->second.state == State::Done && iter->second.completion_index == completion_index) {
+            entries.erase(iter);
+        }
+    }
+}
+
+void BackgroundTranslator::WorkerThread() {
+    while (true) {
+        IR::LocationDescriptor location{0};
+        u64 current_generation;
+
+        {
+            std::unique_lock lock{mutex};
+            work_available.wait(lock, [this] { return stop || !queue.empty(); });
+            if (stop) {
+                return;
+            }
+
+            location = queue.front();
+            queue.pop_front();
+
+            const auto iter = entries.find(location.Value());
+            if (iter == entries.end() || iter->second.state != State::Queued) {
+                // Cancelled by Take or Clear.
+                continue;
+            }
+            iter.value().state = State::InFlight;
+            current_generation = generation;
+            in_flight_count++;
+        }
+
+        IR::Block block = translate(location);
+
+        {
+            std::lock_guard lock{mutex};
+            in_flight_count--;
+            const auto iter = entries.find(location.Value());
+            if (current_generation == generation && iter != entries.end() && iter->second.state == State::InFlight) {
+                iter.value().state = State::Done;
+                iter.value().block = std::move(block);
+                iter.value().completion_index = ++completion_count;
+                completed.emplace_back(location.Value(), completion_count);
+                DiscardOldestCompleted();
+            }
+        }
+        work_done.notify_all();
+    }
+}
+
+} // namespace Dynarmic::Backend::X64
@@ -0,0 +1,93 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <tsl/robin_map.h>
+
+#include "common/common_types.h"
+#include "frontend/ir/basic_block.h"
+#include "frontend/ir/location_descriptor.h"
+
+namespace Dynarmic::Backend::X64 {
+
+/**
+ * Translates and optimizes blocks to IR on a pool of worker threads, ahead of them being
+ * required by the guest thread. Emission into the BlockOfCode remains on the guest thread.
+ */
+class BackgroundTranslator {
+public:
+    using TranslateFunction = std::function<IR::Block(IR::LocationDescriptor)>;
+
+    BackgroundTranslator(size_t thread_count, TranslateFunction translate);
+    ~BackgroundTranslator();
+
+    BackgroundTranslator(const BackgroundTranslator&) = delete;
+    BackgroundTranslator& operator=(const BackgroundTranslator&) = delete;
+
+    /// Queues `location` for translation, unless it is already queued or translated.
+    void Enqueue(IR::LocationDescriptor location);
+
+    /// Takes the translated block for `location`, waiting for it if it is being translated.
+    /// Returns std::nullopt if the location was never enqueued, its translation was discarded, or it
+    /// has not been started yet; in the latter case the request is cancelled and the caller should
+    /// translate it itself.
+    std::optional<IR::Block> Take(IR::LocationDescriptor location);
+
+    /// Discards all queued, in-flight and completed translations, and waits for in-flight
+    /// translations to finish. Once this returns, no worker reads guest code until the next Enqueue.
+    /// Must be called whenever guest code may have been modified.
+    void Clear();
+
+private:
+    void WorkerThread();
+    /// Must be called with `mutex` held.
+    void DiscardOldestCompleted();
+
+    enum class State {
+        Queued,
+        InFlight,
+        Done,
+    };
+
+    struct Entry {
+        State state;
+        std::optional<IR::Block> block;
+        u64 completion_index = 0;
+    };
+
+    static constexpr size_t max_queued_translations = 64;
+    /// Completed translations are discarded oldest first beyond this many, as translations of
+    /// branch targets that are never reached would otherwise be kept indefinitely.
+    static constexpr size_t max_completed_translations = 256;
+
+    TranslateFunction translate;
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_done;
+    std::deque<IR::LocationDescriptor> queue;
+    tsl::robin_map<u64, Entry> entries;
+    /// Completed translations in order of completion, as (location, completion_index) pairs.
+    /// Pairs whose entry has since been taken are skipped when discarding.
+    std::deque<std::pair<u64, u64>> completed;
+    u64 completion_count = 0;
+    u64 generation = 0;
+    size_t in_flight_count = 0;
+    bool stop = false;
+
+    std::vector<std::thread> threads;
+};
+
+} // namespace Dynarmic::Backend::X64
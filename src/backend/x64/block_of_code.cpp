@@ -43,8 +43,6 @@ const std::array<Xbyak::Reg64, 6> BlockOfCode::ABI_PARAMS = {BlockOfCode::ABI_PA
 
 namespace {
 
-constexpr size_t TOTAL_CODE_SIZE = 128 * 1024 * 1024;
-constexpr size_t FAR_CODE_OFFSET = 100 * 1024 * 1024;
 constexpr size_t CONSTANT_POOL_SIZE = 2 * 1024 * 1024;
 
 class CustomXbyakAllocator : public Xbyak::Allocator {
@@ -72,22 +70,80 @@ void ProtectMemory(const void* base, size_t size, bool is_executable) {
 }
 #endif
 
+#ifdef DYNARMIC_ENABLE_CPU_FEATURE_DETECTION
+HostFeature ToHostFeature(Xbyak::util::Cpu::Type type) {
+    using Cpu = Xbyak::util::Cpu;
+    switch (type) {
+    case Cpu::tSSSE3:
+        return HostFeature::SSSE3;
+    case Cpu::tSSE41:
+        return HostFeature::SSE41;
+    case Cpu::tSSE42:
+        return HostFeature::SSE42;
+    case Cpu::tPCLMULQDQ:
+    case Cpu::tVPCLMULQDQ:
+        return HostFeature::PCLMULQDQ;
+    case Cpu::tAVX:
+        return HostFeature::AVX;
+    case Cpu::tF16C:
+        return HostFeature::F16C;
+    case Cpu::tAESNI:
+    case Cpu::tVAES:
+        return HostFeature::AESNI;
+    case Cpu::tSHA:
+        return HostFeature::SHA;
+    case Cpu::tGFNI:
+        return HostFeature::GFNI;
+    case Cpu::tLZCNT:
+        return HostFeature::LZCNT;
+    case Cpu::tBMI1:
+        return HostFeature::BMI1;
+    case Cpu::tBMI2:
+        return HostFeature::BMI2;
+    case Cpu::tFMA:
+        return HostFeature::FMA;
+    case Cpu::tAVX2:
+        return HostFeature::AVX2;
+    case Cpu::tAVX512F:
+    case Cpu::tAVX512CD:
+    case Cpu::tAVX512BW:
+    case Cpu::tAVX512DQ:
+    case Cpu::tAVX512VL:
+    case Cpu::tAVX512_VPOPCNTDQ:
+    case Cpu::tAVX512_VNNI:
+    case Cpu::tAVX512_VBMI2:
+    case Cpu::tAVX512_BITALG:
+        return HostFeature::AVX512;
+    default:
+        return no_host_features;
+    }
+}
+#endif
+
 } // anonymous namespace
 
-BlockOfCode::BlockOfCode(RunCodeCallbacks cb, JitStateInfo jsi, std::function<void(BlockOfCode&)> rcp)
-        : Xbyak::CodeGenerator(TOTAL_CODE_SIZE, nullptr, &s_allocator)
+BlockOfCode::BlockOfCode(RunCodeCallbacks cb, JitStateInfo jsi, std::function<void(BlockOfCode&)> rcp, size_t total_code_size, size_t far_code_offset, HostFeature disabled_host_features)
+        : Xbyak::CodeGenerator(total_code_size, nullptr, &s_allocator)
         , cb(std::move(cb))
         , jsi(jsi)
+        , total_code_size(total_code_size)
+        , far_code_offset(far_code_offset)
         , constant_pool(*this, CONSTANT_POOL_SIZE)
+        , disabled_host_features(disabled_host_features)
 {
+    ASSERT(far_code_offset < total_code_size);
     EnableWriting();
     GenRunCode(rcp);
 }
 
-void BlockOfCode::PreludeComplete() {
+void BlockOfCode::PreludeComplete(size_t region_count_) {
+    ASSERT(region_count_ >= 1);
     prelude_complete = true;
     near_code_begin = getCurr();
-    far_code_begin = getCurr() + FAR_CODE_OFFSET;
+    far_code_begin = getCurr() + far_code_offset;
+    region_count = region_count_;
+    near_region_size = (far_code_offset - (getCurr() - getCode())) / region_count;
+    far_region_size = (total_code_size - far_code_offset - (getCurr() - getCode())) / region_count;
     ClearCache();
     DisableWriting();
 }
@@ -107,6 +163,7 @@ void BlockOfCode::DisableWriting() {
 void BlockOfCode::ClearCache() {
     ASSERT(prelude_complete);
     in_far_code = false;
+    current_region = 0;
     near_code_ptr = near_code_begin;
     far_code_ptr = far_code_begin;
     SetCodePtr(near_code_begin);
@@ -114,22 +171,38 @@ void BlockOfCode::ClearCache() {
 
 size_t BlockOfCode::SpaceRemaining() const {
     ASSERT(prelude_complete);
-    // This function provides an underestimate of near-code-size but that's okay.
-    // (Why? The maximum size of near code should be measured from near_code_begin, not top_.)
-    // These are offsets from Xbyak::CodeArray::top_.
-    std::size_t far_code_offset, near_code_offset;
-    if (in_far_code) {
-        near_code_offset = static_cast<const u8*>(near_code_ptr) - getCode();
-        far_code_offset = getCurr() - getCode();
-    } else {
-        near_code_offset = getCurr() - getCode();
-        far_code_offset = static_cast<const u8*>(far_code_ptr) - getCode();
-    }
-    if (far_code_offset > TOTAL_CODE_SIZE)
+    const u8* const near_ptr = static_cast<const u8*>(in_far_code ? near_code_ptr : getCurr());
+    const u8* const far_ptr = static_cast<const u8*>(in_far_code ? getCurr() : far_code_ptr);
+    const u8* const near_end = NearRegionBegin(current_region) + near_region_size;
+    const u8* const far_end = FarRegionBegin(current_region) + far_region_size;
+    if (near_ptr > near_end || far_ptr > far_end)
         return 0;
-    if (near_code_offset > FAR_CODE_OFFSET)
-        return 0;
-    return std::min(TOTAL_CODE_SIZE - far_code_offset, FAR_CODE_OFFSET - near_code_offset);
+    return std::min<size_t>(near_end - near_ptr, far_end - far_ptr);
+}
+
+size_t BlockOfCode::AdvanceRegion() {
+    ASSERT(prelude_complete);
+    ASSERT(!in_far_code);
+    current_region = (current_region + 1) % region_count;
+    near_code_ptr = NearRegionBegin(current_region);
+    far_code_ptr = FarRegionBegin(current_region);
+    SetCodePtr(near_code_ptr);
+    return current_region;
+}
+
+bool BlockOfCode::IsInRegion(CodePtr ptr, size_t region) const {
+    const u8* const p = static_cast<const u8*>(ptr);
+    const u8* const near_begin = NearRegionBegin(region);
+    const u8* const far_begin = FarRegionBegin(region);
+    return (p >= near_begin && p < near_begin + near_region_size) || (p >= far_begin && p < far_begin + far_region_size);
+}
+
+const u8* BlockOfCode::NearRegionBegin(size_t region) const {
+    return static_cast<const u8*>(near_code_begin) + region * near_region_size;
+}
+
+const u8* BlockOfCode::FarRegionBegin(size_t region) const {
+    return static_cast<const u8*>(far_code_begin) + region * far_region_size;
 }
 
 void BlockOfCode::RunCode(void* jit_state, CodePtr code_ptr) const {
@@ -292,6 +365,32 @@ void BlockOfCode::SwitchToNearCode() {
     SetCodePtr(near_code_ptr);
 }
 
+void BlockOfCode::ReserveLazyCode(size_t size) {
+    ASSERT(!prelude_complete);
+    ASSERT(!lazy_code_ptr);
+    lazy_code_ptr = getCurr();
+    lazy_code_end = getCurr() + size;
+    SetCodePtr(lazy_code_end);
+}
+
+void BlockOfCode::SwitchToLazyCode() {
+    ASSERT(prelude_complete);
+    ASSERT(!in_far_code && !in_lazy_code);
+    ASSERT(lazy_code_ptr);
+    in_lazy_code = true;
+    near_code_ptr = getCurr();
+    SetCodePtr(lazy_code_ptr);
+}
+
+void BlockOfCode::SwitchFromLazyCode() {
+    ASSERT(in_lazy_code);
+    in_lazy_code = false;
+    lazy_code_ptr = getCurr();
+    SetCodePtr(near_code_ptr);
+
+    ASSERT_MSG(lazy_code_ptr <= lazy_code_end, "Lazy code has overflowed its reserved space!");
+}
+
 CodePtr BlockOfCode::GetCodeBegin() const {
     return near_code_begin;
 }
@@ -351,6 +450,14 @@ bool BlockOfCode::HasAESNI() const {
     return DoesCpuSupport(Xbyak::util::Cpu::tAESNI);
 }
 
+bool BlockOfCode::HasSHA() const {
+    return DoesCpuSupport(Xbyak::util::Cpu::tSHA);
+}
+
+bool BlockOfCode::HasGFNI() const {
+    return DoesCpuSupport(Xbyak::util::Cpu::tGFNI);
+}
+
 bool BlockOfCode::HasLZCNT() const {
     return DoesCpuSupport(Xbyak::util::Cpu::tLZCNT);
 }
@@ -405,7 +512,7 @@ bool BlockOfCode::HasAVX512_BITALG() const {
 
 bool BlockOfCode::DoesCpuSupport([[maybe_unused]] Xbyak::util::Cpu::Type type) const {
 #ifdef DYNARMIC_ENABLE_CPU_FEATURE_DETECTION
-    return cpu_info.has(type);
+    return cpu_info.has(type) && !(disabled_host_features & ToHostFeature(type));
 #else
     return false;
 #endif
@@ -13,6 +13,8 @@
 #include <xbyak.h>
 #include <xbyak_util.h>
 
+#include <dynarmic/host_feature.h>
+
 #include "backend/x64/callback.h"
 #include "backend/x64/constant_pool.h"
 #include "backend/x64/jitstate_info.h"
@@ -31,11 +33,17 @@ struct RunCodeCallbacks {
 
 class BlockOfCode final : public Xbyak::CodeGenerator {
 public:
-    BlockOfCode(RunCodeCallbacks cb, JitStateInfo jsi, std::function<void(BlockOfCode&)> rcp);
+    static constexpr size_t DEFAULT_TOTAL_CODE_SIZE = 128 * 1024 * 1024;
+    static constexpr size_t DEFAULT_FAR_CODE_OFFSET = 100 * 1024 * 1024;
+
+    BlockOfCode(RunCodeCallbacks cb, JitStateInfo jsi, std::function<void(BlockOfCode&)> rcp,
+                size_t total_code_size = DEFAULT_TOTAL_CODE_SIZE, size_t far_code_offset = DEFAULT_FAR_CODE_OFFSET,
+                HostFeature disabled_host_features = no_host_features);
     BlockOfCode(const BlockOfCode&) = delete;
 
     /// Call when external emitters have finished emitting their preludes.
-    void PreludeComplete();
+    /// The remaining code space is divided into `region_count` regions; see AdvanceRegion.
+    void PreludeComplete(size_t region_count = 1);
 
     /// Change permissions to RW. This is required to support systems with W^X enforced.
     void EnableWriting();
@@ -44,9 +52,16 @@ public:
 
     /// Clears this block of code and resets code pointer to beginning.
     void ClearCache();
-    /// Calculates how much space is remaining to use. This is the minimum of near code and far code.
+    /// Calculates how much space is remaining to use in the current region. This is the minimum of near code and far code.
     size_t SpaceRemaining() const;
 
+    /// Regions have both near and far code, and are filled in turn.
+    /// Continues emission at the beginning of the next region, wrapping around to the first.
+    /// Code previously emitted into that region will be overwritten. Returns its index.
+    size_t AdvanceRegion();
+    /// Returns true if `ptr` is within the near or far code of `region`.
+    bool IsInRegion(CodePtr ptr, size_t region) const;
+
     /// Runs emulated code from code_ptr.
     void RunCode(void* jit_state, CodePtr code_ptr) const;
     /// Runs emulated code from code_ptr for a single cycle.
@@ -101,6 +116,13 @@ public:
     void SwitchToFarCode();
     void SwitchToNearCode();
 
+    /// Lazy code is emitted on demand while emitting blocks, but like the prelude is never cleared or evicted.
+    /// Reserves `size` bytes of code space for it. Must be called before PreludeComplete.
+    void ReserveLazyCode(size_t size);
+    /// Emission continues in lazy code until SwitchFromLazyCode. Must be called from near code.
+    void SwitchToLazyCode();
+    void SwitchFromLazyCode();
+
     CodePtr GetCodeBegin() const;
     size_t GetTotalCodeSize() const;
 
@@ -151,6 +173,8 @@ public:
     bool HasAVX() const;
     bool HasF16C() const;
     bool HasAESNI() const;
+    bool HasSHA() const;
+    bool HasGFNI() const;
     bool HasLZCNT() const;
     bool HasBMI1() const;
     bool HasBMI2() const;
@@ -165,16 +189,30 @@ private:
     RunCodeCallbacks cb;
     JitStateInfo jsi;
 
+    size_t total_code_size;
+    size_t far_code_offset;
+
     bool prelude_complete = false;
     CodePtr near_code_begin;
     CodePtr far_code_begin;
 
+    size_t region_count = 1;
+    size_t near_region_size = 0;
+    size_t far_region_size = 0;
+    size_t current_region = 0;
+    const u8* NearRegionBegin(size_t region) const;
+    const u8* FarRegionBegin(size_t region) const;
+
     ConstantPool constant_pool;
 
     bool in_far_code = false;
     CodePtr near_code_ptr;
     CodePtr far_code_ptr;
 
+    bool in_lazy_code = false;
+    CodePtr lazy_code_ptr = nullptr;
+    CodePtr lazy_code_end = nullptr;
+
     using RunCodeFuncType = void(*)(void*, CodePtr);
     RunCodeFuncType run_code = nullptr;
     RunCodeFuncType step_code = nullptr;
@@ -184,6 +222,7 @@ private:
     void GenRunCode(std::function<void(BlockOfCode&)> rcp);
 
     Xbyak::util::Cpu cpu_info;
+    HostFeature disabled_host_features;
     bool DoesCpuSupport(Xbyak::util::Cpu::Type type) const;
 };
 
@@ -3,7 +3,8 @@
  * SPDX-License-Identifier: 0BSD
  */
 
-#include <boost/icl/interval_map.hpp>
+#include <algorithm>
+
 #include <boost/icl/interval_set.hpp>
 #include <tsl/robin_set.h>
 
@@ -12,31 +13,130 @@
 
 namespace Dynarmic::Backend::X64 {
 
+template <typename ProgramCounterType>
+template <typename Fn>
+void BlockRangeInformation<ProgramCounterType>::ForEachPage(ProgramCounterType first, ProgramCounterType last, Fn fn) {
+    const ProgramCounterType first_page = first >> page_bits;
+    const ProgramCounterType last_page = last >> page_bits;
+    for (ProgramCounterType page = first_page;; page++) {
+        const u16 first_offset = page == first_page ? static_cast<u16>(first & page_mask) : 0;
+        const u16 last_offset = page == last_page ? static_cast<u16>(last & page_mask) : page_mask;
+        fn(page, first_offset, last_offset);
+        if (page == last_page) {
+            break;
+        }
+    }
+}
+
 template <typename ProgramCounterType>
 void BlockRangeInformation<ProgramCounterType>::AddRange(boost::icl::discrete_interval<ProgramCounterType> range, IR::LocationDescriptor location) {
-    block_ranges.add(std::make_pair(range, std::set<IR::LocationDescriptor>{location}));
+    const Range new_range{boost::icl::first(range), boost::icl::last(range)};
+
+    BlockId id;
+    if (const auto iter = block_ids.find(location); iter != block_ids.end()) {
+        id = iter->second;
+        const auto& ranges = blocks[id].ranges;
+        if (std::any_of(ranges.begin(), ranges.end(), [&](const Range& r) { return r.first == new_range.first && r.last == new_range.last; })) {
+            return;
+        }
+    } else {
+        if (free_block_ids.empty()) {
+            id = static_cast<BlockId>(blocks.size());
+            blocks.emplace_back();
+        } else {
+            id = free_block_ids.back();
+            free_block_ids.pop_back();
+        }
+        blocks[id].location = location;
+        block_ids.emplace(location, id);
+    }
+
+    blocks[id].ranges.emplace_back(new_range);
+    ForEachPage(new_range.first, new_range.last, [&](ProgramCounterType page, u16 first, u16 last) {
+        pages[page].push_back({id, first, last});
+    });
 }
 
 template <typename ProgramCounterType>
 void BlockRangeInformation<ProgramCounterType>::ClearCache() {
-    block_ranges.clear();
+    blocks.clear();
+    free_block_ids.clear();
+    block_ids.clear();
+    pages.clear();
 }
 
 template <typename ProgramCounterType>
 tsl::robin_set<IR::LocationDescriptor> BlockRangeInformation<ProgramCounterType>::InvalidateRanges(const boost::icl::interval_set<ProgramCounterType>& ranges) {
     tsl::robin_set<IR::LocationDescriptor> erase_locations;
-    for (auto invalidate_interval : ranges) {
-        auto pair = block_ranges.equal_range(invalidate_interval);
-        for (auto it = pair.first; it != pair.second; ++it) {
-            for (const auto &descriptor : it->second) {
-                erase_locations.insert(descriptor);
+    std::vector<BlockId> erase_ids;
+
+    const auto check_page = [&](const auto& page_entries, u16 first, u16 last) {
+        for (const PageEntry& entry : page_entries) {
+            if (entry.first <= last && first <= entry.last && erase_locations.insert(blocks[entry.id].location).second) {
+                erase_ids.emplace_back(entry.id);
+            }
+        }
+    };
+
+    for (const auto& invalidate_interval : ranges) {
+        const ProgramCounterType first = boost::icl::first(invalidate_interval);
+        const ProgramCounterType last = boost::icl::last(invalidate_interval);
+        const ProgramCounterType first_page = first >> page_bits;
+        const ProgramCounterType last_page = last >> page_bits;
+
+        if (last_page - first_page >= pages.size()) {
+            // Large ranges are cheaper to check against every page that has blocks.
+            for (const auto& [page, page_entries] : pages) {
+                if (page > first_page && page < last_page) {
+                    check_page(page_entries, 0, page_mask);
+                } else if (page == first_page || page == last_page) {
+                    check_page(page_entries, page == first_page ? static_cast<u16>(first & page_mask) : 0,
+                               page == last_page ? static_cast<u16>(last & page_mask) : page_mask);
+                }
             }
+        } else {
+            ForEachPage(first, last, [&](ProgramCounterType page, u16 first_offset, u16 last_offset) {
+                if (const auto iter = pages.find(page); iter != pages.end()) {
+                    check_page(iter->second, first_offset, last_offset);
+                }
+            });
         }
     }
-    // TODO: EFFICIENCY: Remove ranges that are to be erased.
+
+    for (const BlockId id : erase_ids) {
+        RemoveBlock(id);
+    }
     return erase_locations;
 }
 
+template <typename ProgramCounterType>
+void BlockRangeInformation<ProgramCounterType>::RemoveBlock(IR::LocationDescriptor location) {
+    if (const auto iter = block_ids.find(location); iter != block_ids.end()) {
+        RemoveBlock(iter->second);
+    }
+}
+
+template <typename ProgramCounterType>
+void BlockRangeInformation<ProgramCounterType>::RemoveBlock(BlockId id) {
+    Block& block = blocks[id];
+    for (const Range& range : block.ranges) {
+        ForEachPage(range.first, range.last, [&](ProgramCounterType page, u16, u16) {
+            const auto iter = pages.find(page);
+            if (iter == pages.end()) {
+                return;
+            }
+            auto& page_entries = iter.value();
+            page_entries.erase(std::remove_if(page_entries.begin(), page_entries.end(), [id](const PageEntry& entry) { return entry.id == id; }), page_entries.end());
+            if (page_entries.empty()) {
+                pages.erase(iter);
+            }
+        });
+    }
+    block_ids.erase(block.location);
+    block.ranges.clear();
+    free_block_ids.emplace_back(id);
+}
+
 template class BlockRangeInformation<u32>;
 template class BlockRangeInformation<u64>;
 
@@ -5,25 +5,67 @@
 
 #pragma once
 
-#include <set>
+#include <vector>
 
-#include <boost/icl/interval_map.hpp>
+#include <boost/container/small_vector.hpp>
 #include <boost/icl/interval_set.hpp>
+#include <tsl/robin_map.h>
 #include <tsl/robin_set.h>
 
+#include "common/common_types.h"
 #include "frontend/ir/location_descriptor.h"
 
 namespace Dynarmic::Backend::X64 {
 
+/**
+ * Records the guest code ranges that each block was translated from, so that the blocks
+ * affected by a write to guest code can be found. Blocks are indexed by the guest pages
+ * their ranges touch, and are removed once invalidated.
+ */
 template <typename ProgramCounterType>
 class BlockRangeInformation {
 public:
+    /// Records that the block at `location` depends on the code in `range`.
+    /// Adding a range that is already recorded for that block has no effect.
     void AddRange(boost::icl::discrete_interval<ProgramCounterType> range, IR::LocationDescriptor location);
     void ClearCache();
+    /// Returns the blocks that depend on code in `ranges`, and removes them.
     tsl::robin_set<IR::LocationDescriptor> InvalidateRanges(const boost::icl::interval_set<ProgramCounterType>& ranges);
+    /// Forgets the ranges of the block at `location`, e.g. when its code is discarded.
+    void RemoveBlock(IR::LocationDescriptor location);
 
 private:
-    boost::icl::interval_map<ProgramCounterType, std::set<IR::LocationDescriptor>> block_ranges;
+    using BlockId = u32;
+    static constexpr size_t page_bits = 12;
+    static constexpr u16 page_mask = (1 << page_bits) - 1;
+
+    struct Range {
+        ProgramCounterType first;
+        ProgramCounterType last;
+    };
+
+    struct Block {
+        IR::LocationDescriptor location{0};
+        boost::container::small_vector<Range, 2> ranges;
+    };
+
+    /// The part of a block's range within a page, as offsets into the page. Ranges are stored
+    /// with their pages, compactly, so that lookups need not touch unaffected blocks.
+    struct PageEntry {
+        BlockId id;
+        u16 first;
+        u16 last;
+    };
+
+    /// Calls fn(page, first_offset, last_offset) for each page that [first, last] touches.
+    template <typename Fn>
+    static void ForEachPage(ProgramCounterType first, ProgramCounterType last, Fn fn);
+    void RemoveBlock(BlockId id);
+
+    std::vector<Block> blocks;
+    std::vector<BlockId> free_block_ids;
+    tsl::robin_map<IR::LocationDescriptor, BlockId> block_ids;
+    tsl::robin_map<ProgramCounterType, boost::container::small_vector<PageEntry, 4>> pages;
 };
 
 } // namespace Dynarmic::Backend::X64
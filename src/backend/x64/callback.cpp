@@ -3,8 +3,11 @@
  * SPDX-License-Identifier: 0BSD
  */
 
+#include <limits>
+
 #include "backend/x64/callback.h"
 #include "backend/x64/block_of_code.h"
+#include "common/assert.h"
 
 namespace Dynarmic::Backend::X64 {
 
@@ -22,19 +25,41 @@ void SimpleCallback::EmitCallWithReturnPointer(BlockOfCode& code, std::function<
 
 void ArgCallback::EmitCall(BlockOfCode& code, std::function<void(RegList)> l) const {
     l({code.ABI_PARAM2, code.ABI_PARAM3, code.ABI_PARAM4});
-    code.mov(code.ABI_PARAM1, arg);
+    EmitLoadArgument(code, code.ABI_PARAM1);
     code.CallFunction(fn);
 }
 
 void ArgCallback::EmitCallWithReturnPointer(BlockOfCode& code, std::function<void(Xbyak::Reg64, RegList)> l) const {
 #if defined(WIN32) && !defined(__MINGW64__)
     l(code.ABI_PARAM2, {code.ABI_PARAM3, code.ABI_PARAM4});
-    code.mov(code.ABI_PARAM1, arg);
+    EmitLoadArgument(code, code.ABI_PARAM1);
 #else
     l(code.ABI_PARAM1, {code.ABI_PARAM3, code.ABI_PARAM4});
-    code.mov(code.ABI_PARAM2, arg);
+    EmitLoadArgument(code, code.ABI_PARAM2);
 #endif
     code.CallFunction(fn);
 }
 
+ArgCallback ArgCallback::WithArgumentLoadedFrom(const Xbyak::Address& address, u64 base) const {
+    const s64 offset = static_cast<s64>(arg - base);
+    ASSERT(offset >= std::numeric_limits<s32>::min() && offset <= std::numeric_limits<s32>::max());
+
+    ArgCallback result = *this;
+    result.arg = static_cast<u64>(offset);
+    result.arg_address = address;
+    return result;
+}
+
+void ArgCallback::EmitLoadArgument(BlockOfCode& code, Xbyak::Reg64 reg) const {
+    if (!arg_address) {
+        code.mov(reg, arg);
+        return;
+    }
+
+    code.mov(reg, *arg_address);
+    if (arg != 0) {
+        code.lea(reg, code.ptr[reg + static_cast<s32>(arg)]);
+    }
+}
+
 } // namespace Dynarmic::Backend::X64
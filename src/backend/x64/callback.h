@@ -6,6 +6,7 @@
 #pragma once
 
 #include <functional>
+#include <optional>
 #include <vector>
 
 #include <xbyak.h>
@@ -46,9 +47,19 @@ public:
     void EmitCall(BlockOfCode& code, std::function<void(RegList)> fn = [](RegList){}) const override;
     void EmitCallWithReturnPointer(BlockOfCode& code, std::function<void(Xbyak::Reg64, RegList)> fn) const override;
 
+    /**
+     * Returns a callback which, rather than passing a fixed argument, loads a pointer from
+     * `address` at call time and offsets it as this callback's argument is offset from `base`.
+     * `address` must not be relative to an argument register.
+     */
+    ArgCallback WithArgumentLoadedFrom(const Xbyak::Address& address, u64 base) const;
+
 private:
+    void EmitLoadArgument(BlockOfCode& code, Xbyak::Reg64 reg) const;
+
     void (*fn)();
     u64 arg;
+    std::optional<Xbyak::Address> arg_address;
 };
 
 } // namespace Dynarmic::Backend::X64
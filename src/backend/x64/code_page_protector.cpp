@@ -0,0 +1,178 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#include "backend/x64/code_page_protector.h"
+
+#include <algorithm>
+
+#include "common/assert.h"
+#include "common/bit_util.h"
+#include "common/cast_util.h"
+
+namespace Dynarmic::Backend::X64 {
+
+namespace {
+
+constexpr size_t initial_host_page_table_capacity = 1024;
+
+size_t HashHostPage(u64 host_address) {
+    return static_cast<size_t>(((host_address >> CodePageProtector::page_bits) * 0x9E3779B97F4A7C15) >> 32);
+}
+
+} // anonymous namespace
+
+CodePageProtector::HostPageTable::HostPageTable(size_t capacity)
+        : capacity(capacity), entries(new std::atomic<u64>[capacity]()) {
+    ASSERT(Common::BitCount(capacity) == 1);
+}
+
+std::atomic<u64>* CodePageProtector::HostPageTable::Find(u64 host_address) const noexcept {
+    for (size_t i = HashHostPage(host_address) & (capacity - 1);; i = (i + 1) & (capacity - 1)) {
+        const u64 entry = entries[i].load(std::memory_order_acquire);
+        if (entry == 0) {
+            return nullptr;
+        }
+        if ((entry & ~(page_size - 1)) == host_address) {
+            return &entries[i];
+        }
+    }
+}
+
+std::atomic<u64>& CodePageProtector::HostPageTable::FindOrInsert(u64 host_address) {
+    for (size_t i = HashHostPage(host_address) & (capacity - 1);; i = (i + 1) & (capacity - 1)) {
+        const u64 entry = entries[i].load(std::memory_order_relaxed);
+        if (entry == 0) {
+            used++;
+            return entries[i];
+        }
+        if ((entry & ~(page_size - 1)) == host_address) {
+            return entries[i];
+        }
+    }
+}
+
+CodePageProtector::CodePageProtector()
+        : write_fault_handler([this](u64 address) { return OnWriteFault(address); }) {}
+
+CodePageProtector::~CodePageProtector() {
+    Reset();
+}
+
+bool CodePageProtector::IsSupported() noexcept {
+    return WriteFaultHandler::IsSupported();
+}
+
+void CodePageProtector::Protect(u64 guest_page, const void* host_page) {
+    const u64 host_address = Common::BitCast<u64>(host_page);
+    ASSERT_MSG(host_address % page_size == 0, "Host memory backing guest code must be page-aligned to detect writes to it");
+
+    std::lock_guard lock{mutex};
+    auto iter = protected_pages.find(host_address);
+    if (iter == protected_pages.end()) {
+        iter = protected_pages.emplace(host_address, std::vector<u64>{}).first;
+        TableWithSpace().FindOrInsert(host_address).store(host_address, std::memory_order_release);
+        WriteFaultHandler::SetWritable(host_address, page_size, false);
+    }
+    std::vector<u64>& guest_pages = iter.value();
+    if (std::find(guest_pages.begin(), guest_pages.end(), guest_page) == guest_pages.end()) {
+        guest_pages.emplace_back(guest_page);
+    }
+}
+
+std::vector<u64> CodePageProtector::TakeWrittenPages() {
+    std::lock_guard lock{mutex};
+    std::vector<u64> result;
+    if (!has_written_pages.exchange(false, std::memory_order_acquire)) {
+        return result;
+    }
+
+    HostPageTable& table = *host_page_table.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < table.capacity; i++) {
+        const u64 entry = table.entries[i].load(std::memory_order_acquire);
+        if (!(entry & written_flag) || (entry & released_flag)) {
+            continue;
+        }
+        table.entries[i].fetch_or(released_flag, std::memory_order_relaxed);
+
+        const auto iter = protected_pages.find(entry & ~(page_size - 1));
+        result.insert(result.end(), iter->second.begin(), iter->second.end());
+        protected_pages.erase(iter);
+    }
+    return result;
+}
+
+void CodePageProtector::Reset() {
+    std::lock_guard lock{mutex};
+    HostPageTable* const table = host_page_table.load(std::memory_order_relaxed);
+    for (const auto& [host_address, guest_pages] : protected_pages) {
+        WriteFaultHandler::SetWritable(host_address, page_size, true);
+        table->Find(host_address)->fetch_or(released_flag, std::memory_order_relaxed);
+    }
+    protected_pages.clear();
+}
+
+CodePageProtector::HostPageTable& CodePageProtector::TableWithSpace() {
+    HostPageTable* const table = host_page_table.load(std::memory_order_relaxed);
+    if (table && (table->used + 1) * 4 <= table->capacity * 3) {
+        return *table;
+    }
+
+    // Released entries are dropped, and the table is grown if protected pages would fill more than half of it.
+    size_t capacity = initial_host_page_table_capacity;
+    while (capacity < protected_pages.size() * 2) {
+        capacity *= 2;
+    }
+    HostPageTable& new_table = *host_page_tables.emplace_back(std::make_unique<HostPageTable>(capacity));
+
+    if (table) {
+        for (size_t i = 0; i < table->capacity; i++) {
+            const u64 entry = table->entries[i].load(std::memory_order_relaxed);
+            if (entry != 0 && !(entry & released_flag)) {
+                new_table.FindOrInsert(entry & ~(page_size - 1)).store(entry & ~moved_flag, std::memory_order_relaxed);
+            }
+        }
+    }
+    host_page_table.store(&new_table, std::memory_order_release);
+
+    if (table) {
+        // A fault handler that finds an entry moved retries with the new table. Writes recorded
+        // in the old table before the move are carried over here.
+        for (size_t i = 0; i < table->capacity; i++) {
+            if (table->entries[i].load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            const u64 entry = table->entries[i].fetch_or(moved_flag, std::memory_order_acq_rel);
+            if ((entry & written_flag) && !(entry & released_flag)) {
+                new_table.Find(entry & ~(page_size - 1))->fetch_or(written_flag, std::memory_order_release);
+            }
+        }
+    }
+    return new_table;
+}
+
+bool CodePageProtector::OnWriteFault(u64 address) {
+    // Called from a signal handler, so this neither locks nor allocates. The guest pages that were
+    // written to are looked up later, by TakeWrittenPages.
+    const u64 host_address = address & ~(page_size - 1);
+    for (HostPageTable* table = host_page_table.load(std::memory_order_acquire); table; table = host_page_table.load(std::memory_order_acquire)) {
+        std::atomic<u64>* const entry = table->Find(host_address);
+        if (!entry) {
+            return false;
+        }
+        if (entry->load(std::memory_order_acquire) & released_flag) {
+            // The page has already been made writable again.
+            return true;
+        }
+
+        WriteFaultHandler::SetWritable(host_address, page_size, true);
+        if (!(entry->fetch_or(written_flag, std::memory_order_acq_rel) & moved_flag)) {
+            has_written_pages.store(true, std::memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace Dynarmic::Backend::X64
@@ -0,0 +1,98 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <tsl/robin_map.h>
+
+#include "backend/x64/exception_handler.h"
+#include "common/common_types.h"
+
+namespace Dynarmic::Backend::X64 {
+
+/**
+ * Detects writes to guest code by making the host pages that back it read-only.
+ * The first write to a protected page makes it writable again and records the guest pages it
+ * backs, to be collected with TakeWrittenPages. The same host page may back several guest
+ * pages, and a guest page may be backed by several host pages (for example when both a
+ * fastmem arena and a page table map it).
+ *
+ * Protected pages are assumed to be readable and writable otherwise, and are made so again when
+ * they are written to or released. The embedder must not change their protection itself.
+ *
+ * Methods are safe to call concurrently. Write faults are handled without locking or allocating:
+ * the handler only consults and updates a preallocated table of atomic entries, and all other
+ * bookkeeping is done by TakeWrittenPages.
+ */
+class CodePageProtector {
+public:
+    static constexpr size_t page_bits = 12;
+    static constexpr u64 page_size = u64(1) << page_bits;
+
+    CodePageProtector();
+    ~CodePageProtector();
+
+    CodePageProtector(const CodePageProtector&) = delete;
+    CodePageProtector& operator=(const CodePageProtector&) = delete;
+
+    static bool IsSupported() noexcept;
+
+    /// Makes `host_page`, which backs the guest page at `guest_page`, read-only until it is written to.
+    void Protect(u64 guest_page, const void* host_page);
+
+    /// Returns true if TakeWrittenPages would return any pages.
+    bool HasWrittenPages() const noexcept {
+        return has_written_pages.load(std::memory_order_acquire);
+    }
+    /// Returns the guest pages written to since the previous call.
+    std::vector<u64> TakeWrittenPages();
+
+    /// Makes all protected pages read-write again, without recording them as written.
+    void Reset();
+
+private:
+    /// Open-addressed hash set of protected host pages. An entry is a page address with the
+    /// state flags below in its low bits. Entries are only removed by replacing the whole table.
+    struct HostPageTable {
+        explicit HostPageTable(size_t capacity);
+
+        std::atomic<u64>* Find(u64 host_address) const noexcept;
+        std::atomic<u64>& FindOrInsert(u64 host_address);
+
+        size_t capacity;
+        size_t used = 0;
+        std::unique_ptr<std::atomic<u64>[]> entries;
+    };
+
+    /// The page has been written to since it was protected.
+    static constexpr u64 written_flag = 1;
+    /// The page is no longer protected. The entry remains so that late faults are still recognised.
+    static constexpr u64 released_flag = 2;
+    /// The entry has been copied to a newer table, which must be consulted instead.
+    static constexpr u64 moved_flag = 4;
+
+    static_assert(std::atomic<u64>::is_always_lock_free);
+
+    bool OnWriteFault(u64 address);
+    HostPageTable& TableWithSpace();
+
+    std::mutex mutex;
+    /// Guest pages backed by each protected host page. Only used with the mutex held.
+    tsl::robin_map<u64, std::vector<u64>> protected_pages;
+    std::atomic<HostPageTable*> host_page_table{nullptr};
+    /// Tables that have been replaced are kept, as a fault handler may still be reading them.
+    std::vector<std::unique_ptr<HostPageTable>> host_page_tables;
+    std::atomic<bool> has_written_pages{false};
+
+    // Declared last so that the fault callback is unregistered before anything it uses is destroyed.
+    WriteFaultHandler write_fault_handler;
+};
+
+} // namespace Dynarmic::Backend::X64
@@ -7,6 +7,7 @@
 
 #include <tsl/robin_set.h>
 
+#include "backend/x64/abi.h"
 #include "backend/x64/block_of_code.h"
 #include "backend/x64/emit_x64.h"
 #include "backend/x64/nzcv_util.h"
@@ -80,7 +81,7 @@ void EmitX64::PushRSBHelper(Xbyak::Reg64 loc_desc_reg, Xbyak::Reg64 index_reg, I
     code.mov(loc_desc_reg, target.Value());
 
     patch_information[target].mov_rcx.emplace_back(code.getCurr());
-    EmitPatchMovRcx(target_code_ptr);
+    EmitPatchMovRcx(target, target_code_ptr);
 
     code.mov(qword[r15 + index_reg * 8 + code.GetJitStateInfo().offsetof_rsb_location_descriptors], loc_desc_reg);
     code.mov(qword[r15 + index_reg * 8 + code.GetJitStateInfo().offsetof_rsb_codeptrs], rcx);
@@ -90,6 +91,21 @@ void EmitX64::PushRSBHelper(Xbyak::Reg64 loc_desc_reg, Xbyak::Reg64 index_reg, I
     code.mov(dword[r15 + code.GetJitStateInfo().offsetof_rsb_ptr], index_reg.cvt32());
 }
 
+EmitX64::FallbackFn EmitX64::WrapFallback(FallbackFn fallback, const std::vector<HostLoc>& live) {
+    if (live.empty()) {
+        return fallback;
+    }
+
+    code.SwitchToFarCode();
+    const auto wrapper = code.getCurr<FallbackFn>();
+    ABI_PushRegistersAndAdjustStack(code, 0, live);
+    code.call(fallback);
+    ABI_PopRegistersAndAdjustStack(code, 0, live);
+    code.ret();
+    code.SwitchToNearCode();
+    return wrapper;
+}
+
 void EmitX64::EmitPushRSB(EmitContext& ctx, IR::Inst* inst) {
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
     ASSERT(args[0].IsImmediate());
@@ -285,8 +301,13 @@ void EmitX64::EmitTerminal(IR::Terminal terminal, IR::LocationDescriptor initial
 }
 
 void EmitX64::Patch(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr) {
+    const auto iter = patch_information.find(target_desc);
+    if (iter == patch_information.end()) {
+        return;
+    }
+
     const CodePtr save_code_ptr = code.getCurr();
-    const PatchInformation& patch_info = patch_information[target_desc];
+    const PatchInformation& patch_info = iter->second;
 
     for (CodePtr location : patch_info.jg) {
         code.SetCodePtr(location);
@@ -300,7 +321,7 @@ void EmitX64::Patch(const IR::LocationDescriptor& target_desc, CodePtr target_co
 
     for (CodePtr location : patch_info.mov_rcx) {
         code.SetCodePtr(location);
-        EmitPatchMovRcx(target_code_ptr);
+        EmitPatchMovRcx(target_desc, target_code_ptr);
     }
 
     code.SetCodePtr(save_code_ptr);
@@ -327,9 +348,7 @@ void EmitX64::InvalidateBasicBlocks(const tsl::robin_set<IR::LocationDescriptor>
             continue;
         }
 
-        if (patch_information.count(descriptor)) {
-            Unpatch(descriptor);
-        }
+        Unpatch(descriptor);
         block_descriptors.erase(it);
     }
 }
@@ -96,6 +96,10 @@ protected:
     Xbyak::Label EmitCond(IR::Cond cond);
     BlockDescriptor RegisterBlock(const IR::LocationDescriptor& location_descriptor, CodePtr entrypoint, size_t size);
     void PushRSBHelper(Xbyak::Reg64 loc_desc_reg, Xbyak::Reg64 index_reg, IR::LocationDescriptor target);
+    /// Memory fallback thunks do not preserve caller-saved registers. This emits (in far code) a callable
+    /// wrapper around `fallback` which preserves only the registers in `live`, or returns `fallback` as-is.
+    using FallbackFn = void(*)();
+    FallbackFn WrapFallback(FallbackFn fallback, const std::vector<HostLoc>& live);
 
     // Terminal instruction emitters
     void EmitTerminal(IR::Terminal terminal, IR::LocationDescriptor initial_location, bool is_single_step);
@@ -115,11 +119,11 @@ protected:
         std::vector<CodePtr> jmp;
         std::vector<CodePtr> mov_rcx;
     };
-    void Patch(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr);
+    virtual void Patch(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr);
     virtual void Unpatch(const IR::LocationDescriptor& target_desc);
     virtual void EmitPatchJg(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr = nullptr) = 0;
     virtual void EmitPatchJmp(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr = nullptr) = 0;
-    virtual void EmitPatchMovRcx(CodePtr target_code_ptr = nullptr) = 0;
+    virtual void EmitPatchMovRcx(const IR::LocationDescriptor& target_desc, CodePtr target_code_ptr = nullptr) = 0;
 
     // State
     BlockOfCode& code;
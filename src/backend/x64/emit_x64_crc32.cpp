@@ -16,6 +16,40 @@ namespace Dynarmic::Backend::X64 {
 using namespace Xbyak::util;
 namespace CRC32 = Common::Crypto::CRC32;
 
+// Byte-at-a-time table lookup, for hosts without the instructions used below.
+static void EmitCRC32Table(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst, RegAlloc::ArgumentInfo& args, const int data_size, const std::array<u32, 256>& table) {
+    const Xbyak::Reg64 crc = ctx.reg_alloc.UseScratchGpr(args[0]);
+    const Xbyak::Reg64 value = ctx.reg_alloc.UseScratchGpr(args[1]);
+    const Xbyak::Reg64 index = ctx.reg_alloc.ScratchGpr();
+    const Xbyak::Reg64 table_ptr = ctx.reg_alloc.ScratchGpr();
+
+    if (data_size < 32) {
+        code.movzx(value.cvt32(), value.changeBit(data_size));
+    } else if (data_size == 32) {
+        code.mov(value.cvt32(), value.cvt32());
+    }
+    code.mov(crc.cvt32(), crc.cvt32());
+    code.xor_(crc, value);
+    code.mov(table_ptr, reinterpret_cast<u64>(table.data()));
+
+    for (int i = 0; i < data_size / CHAR_BIT; i++) {
+        code.movzx(index.cvt32(), crc.cvt8());
+        code.shr(crc, 8);
+        code.mov(index.cvt32(), dword[table_ptr + index * 4]);
+        code.xor_(crc, index);
+    }
+
+    ctx.reg_alloc.DefineValue(inst, crc);
+}
+
+static std::array<u32, 256> MakeCRC32Table(u32 (*compute_crc32)(u32, u64, int)) {
+    std::array<u32, 256> table;
+    for (size_t i = 0; i < table.size(); i++) {
+        table[i] = compute_crc32(0, i, 1);
+    }
+    return table;
+}
+
 static void EmitCRC32Castagnoli(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst, const int data_size) {
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
 
@@ -27,9 +61,8 @@ static void EmitCRC32Castagnoli(BlockOfCode& code, EmitContext& ctx, IR::Inst* i
         return;
     }
 
-    ctx.reg_alloc.HostCall(inst, args[0], args[1], {});
-    code.mov(code.ABI_PARAM3, data_size / CHAR_BIT);
-    code.CallFunction(&CRC32::ComputeCRC32Castagnoli);
+    static const std::array<u32, 256> table = MakeCRC32Table(CRC32::ComputeCRC32Castagnoli);
+    EmitCRC32Table(code, ctx, inst, args, data_size, table);
 }
 
 static void EmitCRC32ISO(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst, const int data_size) {
@@ -108,9 +141,8 @@ static void EmitCRC32ISO(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst, co
         return;
     }
 
-    ctx.reg_alloc.HostCall(inst, args[0], args[1], {});
-    code.mov(code.ABI_PARAM3, data_size / CHAR_BIT);
-    code.CallFunction(&CRC32::ComputeCRC32ISO);
+    static const std::array<u32, 256> table = MakeCRC32Table(CRC32::ComputeCRC32ISO);
+    EmitCRC32Table(code, ctx, inst, args, data_size, table);
 }
 
 void EmitX64::EmitCRC32Castagnoli8(EmitContext& ctx, IR::Inst* inst) {
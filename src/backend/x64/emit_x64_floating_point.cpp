@@ -3,9 +3,11 @@
  * SPDX-License-Identifier: 0BSD
  */
 
+#include <array>
 #include <optional>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <mp/metavalue/lift_value.h>
 #include <mp/traits/integer_of_size.h>
@@ -629,7 +631,8 @@ static void EmitFPMulAdd(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst) {
             code.L(fallback);
 
             code.sub(rsp, 8);
-            ABI_PushCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+            const std::vector<HostLoc> occupied = ctx.reg_alloc.OccupiedCallerSaveRegistersExcept(HostLocXmmIdx(result.getIdx()));
+            ABI_PushRegistersAndAdjustStack(code, 0, occupied);
             code.movq(code.ABI_PARAM1, operand1);
             code.movq(code.ABI_PARAM2, operand2);
             code.movq(code.ABI_PARAM3, operand3);
@@ -645,7 +648,7 @@ static void EmitFPMulAdd(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst) {
             code.CallFunction(&FP::FPMulAdd<FPT>);
 #endif
             code.movq(result, code.ABI_RETURN);
-            ABI_PopCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+            ABI_PopRegistersAndAdjustStack(code, 0, occupied);
             code.add(rsp, 8);
 
             code.jmp(end, code.T_NEAR);
@@ -752,10 +755,109 @@ void EmitX64::EmitFPMulX64(EmitContext& ctx, IR::Inst* inst) {
     EmitFPMulX<64>(code, ctx, inst);
 }
 
-template<size_t fsize>
-static void EmitFPRecipEstimate(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst) {
+// Emits a call to `fn` from far code, placing its result in `result`.
+template<typename FPT>
+static void EmitFPOneArgumentFallback(BlockOfCode& code, EmitContext& ctx, Xbyak::Reg64 result, Xbyak::Xmm operand, FPT (*fn)(FPT, FP::FPCR, FP::FPSR&)) {
+    code.sub(rsp, 8);
+    const std::vector<HostLoc> occupied = ctx.reg_alloc.OccupiedCallerSaveRegistersExcept(HostLocRegIdx(result.getIdx()));
+    ABI_PushRegistersAndAdjustStack(code, 0, occupied);
+    code.movq(code.ABI_PARAM1, operand);
+    code.mov(code.ABI_PARAM2.cvt32(), ctx.FPCR().Value());
+    code.lea(code.ABI_PARAM3, code.ptr[code.r15 + code.GetJitStateInfo().offsetof_fpsr_exc]);
+    code.CallFunction(fn);
+    code.mov(result, code.ABI_RETURN);
+    ABI_PopRegistersAndAdjustStack(code, 0, occupied);
+    code.add(rsp, 8);
+}
+
+// Builds a table of the eight fraction bits of the estimate, indexed by the low bit of the
+// operand's exponent followed by the eight most significant bits of its fraction.
+static std::array<u8, 512> MakeFPEstimateTable(u32 (*estimate)(u32, FP::FPCR, FP::FPSR&)) {
+    std::array<u8, 512> table;
+    for (u32 i = 0; i < table.size(); i++) {
+        const u32 exponent = (i >> 8) == 0 ? 0x80 : 0x7F;
+        const u32 op = (exponent << 23) | ((i & 0xFF) << 15);
+        FP::FPSR fpsr;
+        table[i] = static_cast<u8>(estimate(op, FP::FPCR{}, fpsr) >> 15);
+    }
+    return table;
+}
+
+// The estimates of normal operands that have normal results are computed inline by looking up
+// the fraction of the result in a table. All other operands are handled by the fallback.
+template<size_t fsize, bool is_rsqrt>
+static void EmitFPEstimateLookup(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst) {
     using FPT = mp::unsigned_integer_of_size<fsize>;
+    constexpr size_t mantissa_width = FP::FPInfo<FPT>::explicit_mantissa_width;
+    constexpr u32 exponent_ones = FP::FPInfo<FPT>::exponent_mask >> mantissa_width;
+    constexpr u32 bias = FP::FPInfo<FPT>::exponent_bias;
+    // Largest biased exponent of an operand with a normal result.
+    constexpr u32 max_exponent = is_rsqrt ? exponent_ones - 1 : 2 * bias - 2;
+
+    static const std::array<u8, 512> table = MakeFPEstimateTable(is_rsqrt ? &FP::FPRSqrtEstimate<u32> : &FP::FPRecipEstimate<u32>);
+
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+    const Xbyak::Xmm operand = ctx.reg_alloc.UseXmm(args[0]);
+    const Xbyak::Reg64 result = ctx.reg_alloc.ScratchGpr();
+    const Xbyak::Reg64 value = ctx.reg_alloc.ScratchGpr();
+    const Xbyak::Reg64 estimate = ctx.reg_alloc.ScratchGpr();
+    const Xbyak::Reg64 table_ptr = ctx.reg_alloc.ScratchGpr();
+
+    Xbyak::Label end, fallback;
+
+    if constexpr (fsize == 64) {
+        code.movq(value, operand);
+    } else {
+        code.movd(value.cvt32(), operand);
+        if constexpr (fsize == 16) {
+            code.movzx(value.cvt32(), value.cvt16());
+        }
+    }
+
+    // For reciprocal square root estimates, the sign bit is kept so that negative operands are out of range.
+    code.mov(result, value);
+    code.shr(result, mantissa_width);
+    if constexpr (!is_rsqrt) {
+        code.and_(result.cvt32(), exponent_ones);
+    }
+    code.lea(estimate.cvt32(), ptr[result - 1]);
+    code.cmp(estimate.cvt32(), max_exponent - 1);
+    code.ja(fallback, code.T_NEAR);
+
+    code.mov(estimate, value);
+    code.shr(estimate, mantissa_width - 8);
+    code.and_(estimate.cvt32(), is_rsqrt ? 0x1FF : 0xFF);
+    code.mov(table_ptr, reinterpret_cast<u64>(table.data()));
+    code.movzx(estimate.cvt32(), byte[table_ptr + estimate]);
+
+    code.neg(result.cvt32());
+    if constexpr (is_rsqrt) {
+        code.add(result.cvt32(), 3 * bias - 1);
+        code.shr(result.cvt32(), 1);
+    } else {
+        code.add(result.cvt32(), 2 * bias - 1);
+    }
+    code.shl(result, mantissa_width);
+    code.shl(estimate, mantissa_width - 8);
+    code.or_(result, estimate);
+    if constexpr (!is_rsqrt) {
+        code.shr(value, fsize - 1);
+        code.shl(value, fsize - 1);
+        code.or_(result, value);
+    }
+    code.L(end);
+
+    code.SwitchToFarCode();
+    code.L(fallback);
+    EmitFPOneArgumentFallback<FPT>(code, ctx, result, operand, is_rsqrt ? &FP::FPRSqrtEstimate<FPT> : &FP::FPRecipEstimate<FPT>);
+    code.jmp(end, code.T_NEAR);
+    code.SwitchToNearCode();
+
+    ctx.reg_alloc.DefineValue(inst, result);
+}
 
+template<size_t fsize>
+static void EmitFPRecipEstimate(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst) {
     if constexpr (fsize != 16) {
         if (ctx.HasOptimization(OptimizationFlag::Unsafe_ReducedErrorFP)) {
             auto args = ctx.reg_alloc.GetArgumentInfo(inst);
@@ -775,11 +877,7 @@ static void EmitFPRecipEstimate(BlockOfCode& code, EmitContext& ctx, IR::Inst* i
         }
     }
 
-    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-    ctx.reg_alloc.HostCall(inst, args[0]);
-    code.mov(code.ABI_PARAM2.cvt32(), ctx.FPCR().Value());
-    code.lea(code.ABI_PARAM3, code.ptr[code.r15 + code.GetJitStateInfo().offsetof_fpsr_exc]);
-    code.CallFunction(&FP::FPRecipEstimate<FPT>);
+    EmitFPEstimateLookup<fsize, false>(code, ctx, inst);
 }
 
 void EmitX64::EmitFPRecipEstimate16(EmitContext& ctx, IR::Inst* inst) {
@@ -798,11 +896,59 @@ template <size_t fsize>
 static void EmitFPRecipExponent(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst) {
     using FPT = mp::unsigned_integer_of_size<fsize>;
 
+    constexpr size_t mantissa_width = FP::FPInfo<FPT>::explicit_mantissa_width;
+    constexpr u32 exponent_ones = FP::FPInfo<FPT>::exponent_mask >> mantissa_width;
+    const bool flush_to_zero = fsize == 16 ? ctx.FPCR().FZ16() : ctx.FPCR().FZ();
+
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-    ctx.reg_alloc.HostCall(inst, args[0]);
-    code.mov(code.ABI_PARAM2.cvt32(), ctx.FPCR().Value());
-    code.lea(code.ABI_PARAM3, code.ptr[code.r15 + code.GetJitStateInfo().offsetof_fpsr_exc]);
-    code.CallFunction(&FP::FPRecipExponent<FPT>);
+    const Xbyak::Xmm operand = ctx.reg_alloc.UseXmm(args[0]);
+    const Xbyak::Reg64 result = ctx.reg_alloc.ScratchGpr();
+    const Xbyak::Reg64 value = ctx.reg_alloc.ScratchGpr();
+    const Xbyak::Reg64 exponent = ctx.reg_alloc.ScratchGpr();
+
+    Xbyak::Label end, fallback;
+
+    if constexpr (fsize == 64) {
+        code.movq(value, operand);
+    } else {
+        code.movd(value.cvt32(), operand);
+        if constexpr (fsize == 16) {
+            code.movzx(value.cvt32(), value.cvt16());
+        }
+    }
+
+    code.mov(exponent, value);
+    code.shr(exponent, mantissa_width);
+    code.and_(exponent.cvt32(), exponent_ones);
+
+    // NaNs and infinities are handled by the fallback, as are zeros and denormals when flushing to zero.
+    if (flush_to_zero) {
+        code.lea(result.cvt32(), ptr[exponent - 1]);
+        code.cmp(result.cvt32(), exponent_ones - 1);
+        code.jae(fallback, code.T_NEAR);
+    } else {
+        code.cmp(exponent.cvt32(), exponent_ones);
+        code.je(fallback, code.T_NEAR);
+    }
+
+    // The exponent is inverted, apart from zeros and denormals which produce the largest finite exponent.
+    code.mov(result.cvt32(), exponent.cvt32());
+    code.xor_(result.cvt32(), exponent_ones);
+    code.cmp(exponent.cvt32(), 1);
+    code.sbb(result.cvt32(), 0);
+    code.shl(result, mantissa_width);
+    code.shr(value, fsize - 1);
+    code.shl(value, fsize - 1);
+    code.or_(result, value);
+    code.L(end);
+
+    code.SwitchToFarCode();
+    code.L(fallback);
+    EmitFPOneArgumentFallback<FPT>(code, ctx, result, operand, &FP::FPRecipExponent<FPT>);
+    code.jmp(end, code.T_NEAR);
+    code.SwitchToNearCode();
+
+    ctx.reg_alloc.DefineValue(inst, result);
 }
 
 void EmitX64::EmitFPRecipExponent16(EmitContext& ctx, IR::Inst* inst) {
@@ -855,14 +1001,15 @@ static void EmitFPRecipStepFused(BlockOfCode& code, EmitContext& ctx, IR::Inst*
             code.L(fallback);
 
             code.sub(rsp, 8);
-            ABI_PushCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+            const std::vector<HostLoc> occupied = ctx.reg_alloc.OccupiedCallerSaveRegistersExcept(HostLocXmmIdx(result.getIdx()));
+            ABI_PushRegistersAndAdjustStack(code, 0, occupied);
             code.movq(code.ABI_PARAM1, operand1);
             code.movq(code.ABI_PARAM2, operand2);
             code.mov(code.ABI_PARAM3.cvt32(), ctx.FPCR().Value());
             code.lea(code.ABI_PARAM4, code.ptr[code.r15 + code.GetJitStateInfo().offsetof_fpsr_exc]);
             code.CallFunction(&FP::FPRecipStepFused<FPT>);
             code.movq(result, code.ABI_RETURN);
-            ABI_PopCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+            ABI_PopRegistersAndAdjustStack(code, 0, occupied);
             code.add(rsp, 8);
 
             code.jmp(end, code.T_NEAR);
@@ -904,25 +1051,56 @@ void EmitX64::EmitFPRecipStepFused64(EmitContext& ctx, IR::Inst* inst) {
     EmitFPRecipStepFused<64>(code, ctx, inst);
 }
 
-static void EmitFPRound(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst, size_t fsize) {
-    const auto rounding_mode = static_cast<FP::RoundingMode>(inst->GetArg(1).GetU8());
-    const bool exact = inst->GetArg(2).GetU1();
-    const auto round_imm = ConvertRoundingModeToX64Immediate(rounding_mode);
+static bool CanEmitFPRoundInPlace(BlockOfCode& code, FP::RoundingMode rounding_mode, bool exact) {
+    if (ConvertRoundingModeToX64Immediate(rounding_mode)) {
+        return code.HasSSE41();
+    }
+    return rounding_mode == FP::RoundingMode::ToNearest_TieAwayFromZero && !exact && code.HasSSE42();
+}
 
-    if (fsize != 16 && code.HasSSE41() && round_imm && !exact) {
-        if (fsize == 64) {
-            FPTwoOp<64>(code, ctx, inst, [&](Xbyak::Xmm result) {
-                code.roundsd(result, result, *round_imm);
-            });
-        } else {
-            FPTwoOp<32>(code, ctx, inst, [&](Xbyak::Xmm result) {
-                code.roundss(result, result, *round_imm);
-            });
-        }
+// Rounds `result` to an integral value in place.
+template<size_t fsize>
+static void EmitFPRoundInPlace(BlockOfCode& code, EmitContext& ctx, Xbyak::Xmm result, FP::RoundingMode rounding_mode, bool exact) {
+    using FPT = mp::unsigned_integer_of_size<fsize>;
+
+    if (const auto round_imm = ConvertRoundingModeToX64Immediate(rounding_mode)) {
+        // The precision exception is reported as IXC, which should only be raised when exact.
+        FCODE(rounds)(result, result, static_cast<u8>(*round_imm | (exact ? 0b0000 : 0b1000)));
+        return;
+    }
+
+    if (rounding_mode == FP::RoundingMode::ToNearest_TieAwayFromZero && !exact) {
+        // The integral part is adjusted away from zero when the fractional part is at least one half.
+        // Operands with magnitudes of at least 2^mantissa_width are integral, infinite or NaN. Their fractional
+        // part is taken to be zero, so that no exceptions are raised. Magnitudes are compared as integers
+        // for the same reason. The adjustment takes the sign of the integral part to preserve negative zeros.
+        constexpr u64 integral_limit = FP::FPValue<FPT, false, FP::FPInfo<FPT>::explicit_mantissa_width, 1>();
+        const Xbyak::Xmm tmp = ctx.reg_alloc.ScratchXmm();
 
+        FCODE(rounds)(xmm0, result, 0b1011);
+        code.movaps(tmp, code.MConst(xword, fsize == 32 ? f32_non_sign_mask : f64_non_sign_mask));
+        code.andps(tmp, result);
+        ICODE(pcmpgt)(tmp, code.MConst(xword, integral_limit - 1));
+        code.andnps(tmp, result);
+        FCODE(rounds)(result, tmp, 0b1011);
+        FCODE(subs)(tmp, result);
+        code.andps(tmp, code.MConst(xword, fsize == 32 ? f32_non_sign_mask : f64_non_sign_mask));
+        ICODE(pcmpgt)(tmp, code.MConst(xword, FP::FPValue<FPT, false, -1, 1>() - 1));
+        code.andps(tmp, code.MConst(xword, FP::FPValue<FPT, false, 0, 1>()));
+        code.movaps(result, code.MConst(xword, fsize == 32 ? f32_negative_zero : f64_negative_zero));
+        code.andps(result, xmm0);
+        code.orps(result, tmp);
+        FCODE(adds)(result, xmm0);
         return;
     }
 
+    UNREACHABLE();
+}
+
+static void EmitFPRound(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst, size_t fsize) {
+    const auto rounding_mode = static_cast<FP::RoundingMode>(inst->GetArg(1).GetU8());
+    const bool exact = inst->GetArg(2).GetU1();
+
     using fsize_list = mp::list<mp::lift_value<size_t(16)>,
                                 mp::lift_value<size_t(32)>,
                                 mp::lift_value<size_t(64)>>;
@@ -955,6 +1133,81 @@ static void EmitFPRound(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst, siz
         mp::cartesian_product<fsize_list, rounding_list, exact_list>{}
     );
 
+    // Every half-precision value is exactly representable in single-precision, and so are the integral
+    // values it rounds to. Rounding propagates NaNs in the same manner as ARM, including for half-precision
+    // values, as vcvtph2ps quietens signalling NaNs and raises the invalid operation exception.
+    if (CanEmitFPRoundInPlace(code, rounding_mode, exact) && (fsize != 16 || (code.HasF16C() && !ctx.FPCR().FZ16()))) {
+        auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+        const Xbyak::Xmm result = ctx.reg_alloc.UseScratchXmm(args[0]);
+
+        // When flushing to zero, denormal operands raise the input denormal exception. The host does
+        // not report it, so these operands are rounded by the fallback instead.
+        const bool detect_denormals = fsize != 16 && ctx.FPCR().FZ();
+        Xbyak::Label end, fallback;
+
+        if (detect_denormals) {
+            const Xbyak::Reg64 tmp = ctx.reg_alloc.ScratchGpr();
+            Xbyak::Label not_denormal;
+
+            // Shifting out the sign leaves zero for zeros, and a zero exponent for denormals.
+            if (fsize == 64) {
+                code.movq(tmp, result);
+                code.add(tmp, tmp);
+                code.jz(not_denormal);
+                code.shr(tmp, 53);
+            } else {
+                code.movd(tmp.cvt32(), result);
+                code.add(tmp.cvt32(), tmp.cvt32());
+                code.jz(not_denormal);
+                code.shr(tmp.cvt32(), 24);
+            }
+            code.jz(fallback, code.T_NEAR);
+            code.L(not_denormal);
+        }
+
+        if (fsize == 64) {
+            EmitFPRoundInPlace<64>(code, ctx, result, rounding_mode, exact);
+            if (ctx.FPCR().DN()) {
+                ForceToDefaultNaN<64>(code, result);
+            }
+        } else {
+            if (fsize == 16) {
+                code.vcvtph2ps(result, result);
+            }
+            EmitFPRoundInPlace<32>(code, ctx, result, rounding_mode, exact);
+            if (ctx.FPCR().DN()) {
+                ForceToDefaultNaN<32>(code, result);
+            }
+            if (fsize == 16) {
+                code.vcvtps2ph(result, result, 0b100);
+            }
+        }
+
+        if (detect_denormals) {
+            code.L(end);
+
+            code.SwitchToFarCode();
+            code.L(fallback);
+
+            code.sub(rsp, 8);
+            const std::vector<HostLoc> occupied = ctx.reg_alloc.OccupiedCallerSaveRegistersExcept(HostLocXmmIdx(result.getIdx()));
+            ABI_PushRegistersAndAdjustStack(code, 0, occupied);
+            code.movq(code.ABI_PARAM1, result);
+            code.lea(code.ABI_PARAM2, code.ptr[code.r15 + code.GetJitStateInfo().offsetof_fpsr_exc]);
+            code.mov(code.ABI_PARAM3.cvt32(), ctx.FPCR().Value());
+            code.CallFunction(lut.at(std::make_tuple(fsize, rounding_mode, exact)));
+            code.movq(result, code.ABI_RETURN);
+            ABI_PopRegistersAndAdjustStack(code, 0, occupied);
+            code.add(rsp, 8);
+
+            code.jmp(end, code.T_NEAR);
+            code.SwitchToNearCode();
+        }
+
+        ctx.reg_alloc.DefineValue(inst, result);
+        return;
+    }
+
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
     ctx.reg_alloc.HostCall(inst, args[0]);
     code.lea(code.ABI_PARAM2, code.ptr[code.r15 + code.GetJitStateInfo().offsetof_fpsr_exc]);
@@ -976,8 +1229,6 @@ void EmitX64::EmitFPRoundInt64(EmitContext& ctx, IR::Inst* inst) {
 
 template<size_t fsize>
 static void EmitFPRSqrtEstimate(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst) {
-    using FPT = mp::unsigned_integer_of_size<fsize>;
-
     if constexpr (fsize != 16) {
         if (ctx.HasOptimization(OptimizationFlag::Unsafe_ReducedErrorFP)) {
             auto args = ctx.reg_alloc.GetArgumentInfo(inst);
@@ -997,11 +1248,7 @@ static void EmitFPRSqrtEstimate(BlockOfCode& code, EmitContext& ctx, IR::Inst* i
         }
     }
 
-    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
-    ctx.reg_alloc.HostCall(inst, args[0]);
-    code.mov(code.ABI_PARAM2.cvt32(), ctx.FPCR().Value());
-    code.lea(code.ABI_PARAM3, code.ptr[code.r15 + code.GetJitStateInfo().offsetof_fpsr_exc]);
-    code.CallFunction(&FP::FPRSqrtEstimate<FPT>);
+    EmitFPEstimateLookup<fsize, true>(code, ctx, inst);
 }
 
 void EmitX64::EmitFPRSqrtEstimate16(EmitContext& ctx, IR::Inst* inst) {
@@ -1065,14 +1312,15 @@ static void EmitFPRSqrtStepFused(BlockOfCode& code, EmitContext& ctx, IR::Inst*
             code.L(fallback);
 
             code.sub(rsp, 8);
-            ABI_PushCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+            const std::vector<HostLoc> occupied = ctx.reg_alloc.OccupiedCallerSaveRegistersExcept(HostLocXmmIdx(result.getIdx()));
+            ABI_PushRegistersAndAdjustStack(code, 0, occupied);
             code.movq(code.ABI_PARAM1, operand1);
             code.movq(code.ABI_PARAM2, operand2);
             code.mov(code.ABI_PARAM3.cvt32(), ctx.FPCR().Value());
             code.lea(code.ABI_PARAM4, code.ptr[code.r15 + code.GetJitStateInfo().offsetof_fpsr_exc]);
             code.CallFunction(&FP::FPRSqrtStepFused<FPT>);
             code.movq(result, code.ABI_RETURN);
-            ABI_PopCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+            ABI_PopRegistersAndAdjustStack(code, 0, occupied);
             code.add(rsp, 8);
 
             code.jmp(end, code.T_NEAR);
@@ -1194,7 +1442,9 @@ void EmitX64::EmitFPHalfToDouble(EmitContext& ctx, IR::Inst* inst) {
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
     const auto rounding_mode = static_cast<FP::RoundingMode>(args[1].GetImmediateU8());
 
-    if (code.HasF16C() && !ctx.FPCR().AHP() && !ctx.FPCR().FZ16()) {
+    // Conversions never flush half-precision values to zero, so FPCR.FZ16 does not apply.
+    // vcvtph2ps does not treat half-precision denormals as zero either.
+    if (code.HasF16C() && !ctx.FPCR().AHP()) {
         const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
         const Xbyak::Xmm value = ctx.reg_alloc.UseXmm(args[0]);
 
@@ -1220,7 +1470,7 @@ void EmitX64::EmitFPHalfToSingle(EmitContext& ctx, IR::Inst* inst) {
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
     const auto rounding_mode = static_cast<FP::RoundingMode>(args[1].GetImmediateU8());
 
-    if (code.HasF16C() && !ctx.FPCR().AHP() && !ctx.FPCR().FZ16()) {
+    if (code.HasF16C() && !ctx.FPCR().AHP()) {
         const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
         const Xbyak::Xmm value = ctx.reg_alloc.UseXmm(args[0]);
 
@@ -1267,7 +1517,8 @@ void EmitX64::EmitFPSingleToHalf(EmitContext& ctx, IR::Inst* inst) {
     const auto rounding_mode = static_cast<FP::RoundingMode>(args[1].GetImmediateU8());
     const auto round_imm = ConvertRoundingModeToX64Immediate(rounding_mode);
 
-    if (code.HasF16C() && !ctx.FPCR().AHP() && !ctx.FPCR().FZ16()) {
+    // vcvtps2ph does not flush half-precision results to zero, which matches FPCR.FZ16 not applying to conversions.
+    if (code.HasF16C() && !ctx.FPCR().AHP() && round_imm) {
         const Xbyak::Xmm result = ctx.reg_alloc.UseScratchXmm(args[0]);
 
         if (ctx.FPCR().DN()) {
@@ -1289,9 +1540,38 @@ void EmitX64::EmitFPSingleToHalf(EmitContext& ctx, IR::Inst* inst) {
 void EmitX64::EmitFPDoubleToHalf(EmitContext& ctx, IR::Inst* inst) {
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
     const auto rounding_mode = static_cast<FP::RoundingMode>(args[1].GetImmediateU8());
+    const auto round_imm = ConvertRoundingModeToX64Immediate(rounding_mode);
+
+    // NOTE: Do not naively double-convert here as that is inaccurate.
+    //       To be accurate, the first conversion needs to be "round-to-odd", which x64 doesn't support.
+    //       We emulate it by truncating the single-precision result, then setting its lowest bit if it was inexact.
+    //       This is not done when flushing to zero, as a flushed intermediate result would lose that bit.
+    if (code.HasF16C() && !ctx.FPCR().AHP() && !ctx.FPCR().FZ() && round_imm) {
+        const Xbyak::Xmm value = ctx.reg_alloc.UseXmm(args[0]);
+        const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
+        const Xbyak::Xmm overshoot = ctx.reg_alloc.ScratchXmm();
+        const Xbyak::Xmm inexact = ctx.reg_alloc.ScratchXmm();
+
+        code.cvtsd2ss(result, value);
+        code.cvtss2sd(xmm0, result);
+        code.andps(xmm0, code.MConst(xword, f64_non_sign_mask));
+        code.movaps(inexact, code.MConst(xword, f64_non_sign_mask));
+        code.andps(inexact, value);
+        code.movaps(overshoot, inexact);
+        code.vcmplt_oqsd(overshoot, overshoot, xmm0);
+        code.cmpneqsd(inexact, xmm0);
+        code.paddd(result, overshoot);
+        code.andps(inexact, code.MConst(xword, 1));
+        code.orps(result, inexact);
 
-    // NOTE: Do not double-convert here as that is inaccurate.
-    //       To be accurate, the first conversion would need to be "round-to-odd", which x64 doesn't support.
+        if (ctx.FPCR().DN()) {
+            ForceToDefaultNaN<32>(code, result);
+        }
+        code.vcvtps2ph(result, result, static_cast<u8>(*round_imm));
+
+        ctx.reg_alloc.DefineValue(inst, result);
+        return;
+    }
 
     ctx.reg_alloc.HostCall(inst, args[0]);
     code.mov(code.ABI_PARAM2.cvt32(), ctx.FPCR().Value());
@@ -0,0 +1,346 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#include <array>
+
+#include "backend/x64/block_of_code.h"
+#include "backend/x64/emit_x64.h"
+#include "common/common_types.h"
+#include "frontend/ir/microinstruction.h"
+
+namespace Dynarmic::Backend::X64 {
+
+using namespace Xbyak::util;
+
+// SSE2 has no instruction to move an arbitrary element to a general-purpose register.
+static void ExtractElement(BlockOfCode& code, Xbyak::Reg32 dest, Xbyak::Xmm source, u8 index) {
+    if (index == 0) {
+        code.movd(dest, source);
+        return;
+    }
+    code.pshufd(xmm0, source, index);
+    code.movd(dest, xmm0);
+}
+
+static void InsertElements(BlockOfCode& code, Xbyak::Xmm dest, Xbyak::Xmm tmp, const std::array<Xbyak::Reg32, 4>& elements) {
+    code.movd(dest, elements[0]);
+    code.movd(tmp, elements[1]);
+    code.punpckldq(dest, tmp);
+    code.movd(tmp, elements[2]);
+    code.movd(xmm0, elements[3]);
+    code.punpckldq(tmp, xmm0);
+    code.punpcklqdq(dest, tmp);
+}
+
+static void EmitChoose(BlockOfCode& code, Xbyak::Reg32 result, Xbyak::Reg32 x, Xbyak::Reg32 y, Xbyak::Reg32 z, Xbyak::Reg32) {
+    code.mov(result, y);
+    code.xor_(result, z);
+    code.and_(result, x);
+    code.xor_(result, z);
+}
+
+static void EmitMajority(BlockOfCode& code, Xbyak::Reg32 result, Xbyak::Reg32 x, Xbyak::Reg32 y, Xbyak::Reg32 z, Xbyak::Reg32 tmp) {
+    code.mov(result, x);
+    code.or_(result, y);
+    code.and_(result, z);
+    code.mov(tmp, x);
+    code.and_(tmp, y);
+    code.or_(result, tmp);
+}
+
+static void EmitParity(BlockOfCode& code, Xbyak::Reg32 result, Xbyak::Reg32 x, Xbyak::Reg32 y, Xbyak::Reg32 z, Xbyak::Reg32) {
+    code.mov(result, x);
+    code.xor_(result, y);
+    code.xor_(result, z);
+}
+
+// result = value ror shift1 ^ value ror shift2 ^ value ror shift3
+static void EmitHashSigma(BlockOfCode& code, Xbyak::Reg32 result, Xbyak::Reg32 value, Xbyak::Reg32 tmp, int shift1, int shift2, int shift3) {
+    code.mov(result, value);
+    code.ror(result, shift1);
+    code.mov(tmp, value);
+    code.ror(tmp, shift2);
+    code.xor_(result, tmp);
+    code.ror(tmp, shift3 - shift2);
+    code.xor_(result, tmp);
+}
+
+// result = value ror shift1 ^ value ror shift2 ^ value >> shift3, for each element. value is clobbered.
+static void EmitScheduleSigma(BlockOfCode& code, Xbyak::Xmm result, Xbyak::Xmm value, Xbyak::Xmm tmp, u8 shift1, u8 shift2, u8 shift3) {
+    code.movdqa(result, value);
+    code.psrld(result, shift3);
+    code.movdqa(tmp, value);
+    code.psrld(tmp, shift1);
+    code.pxor(result, tmp);
+    code.movdqa(tmp, value);
+    code.psrld(tmp, shift2);
+    code.pxor(result, tmp);
+    code.movdqa(tmp, value);
+    code.pslld(tmp, 32 - shift1);
+    code.pxor(result, tmp);
+    code.pslld(value, 32 - shift2);
+    code.pxor(result, value);
+}
+
+// Without SHA-NI the rounds are done in general-purpose registers. Elements move between
+// positions by renaming registers rather than by moving values.
+template<typename Function>
+static void EmitSHA1HashUpdateSSE2(RegAlloc::ArgumentInfo args, EmitContext& ctx, BlockOfCode& code, IR::Inst* inst, Function fn) {
+    const Xbyak::Xmm x = ctx.reg_alloc.UseScratchXmm(args[0]);
+    const Xbyak::Xmm y = ctx.reg_alloc.UseXmm(args[1]);
+    const Xbyak::Xmm w = ctx.reg_alloc.UseXmm(args[2]);
+    const Xbyak::Xmm tmp_xmm = ctx.reg_alloc.ScratchXmm();
+
+    std::array<Xbyak::Reg32, 4> a;
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = ctx.reg_alloc.ScratchGpr().cvt32();
+        ExtractElement(code, a[i], x, static_cast<u8>(i));
+    }
+    Xbyak::Reg32 e = ctx.reg_alloc.ScratchGpr().cvt32();
+    const Xbyak::Reg32 tmp1 = ctx.reg_alloc.ScratchGpr().cvt32();
+    const Xbyak::Reg32 tmp2 = ctx.reg_alloc.ScratchGpr().cvt32();
+
+    code.movd(e, y);
+
+    for (size_t i = 0; i < 4; i++) {
+        fn(code, tmp1, a[1], a[2], a[3], tmp2);
+        code.add(e, tmp1);
+        ExtractElement(code, tmp1, w, static_cast<u8>(i));
+        code.add(e, tmp1);
+        code.mov(tmp1, a[0]);
+        code.rol(tmp1, 5);
+        code.add(e, tmp1);
+        code.ror(a[1], 2);
+
+        const Xbyak::Reg32 high = a[3];
+        a = {e, a[0], a[1], a[2]};
+        e = high;
+    }
+
+    InsertElements(code, x, tmp_xmm, a);
+
+    ctx.reg_alloc.DefineValue(inst, x);
+}
+
+static void EmitSHA256HashSSE2(RegAlloc::ArgumentInfo args, EmitContext& ctx, BlockOfCode& code, IR::Inst* inst, bool part1) {
+    const Xbyak::Xmm x = ctx.reg_alloc.UseXmm(args[0]);
+    const Xbyak::Xmm y = ctx.reg_alloc.UseXmm(args[1]);
+    const Xbyak::Xmm w = ctx.reg_alloc.UseXmm(args[2]);
+    const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
+    const Xbyak::Xmm tmp_xmm = ctx.reg_alloc.ScratchXmm();
+
+    std::array<Xbyak::Reg32, 4> a;
+    std::array<Xbyak::Reg32, 4> e;
+    for (size_t i = 0; i < 4; i++) {
+        a[i] = ctx.reg_alloc.ScratchGpr().cvt32();
+        ExtractElement(code, a[i], x, static_cast<u8>(i));
+        e[i] = ctx.reg_alloc.ScratchGpr().cvt32();
+        ExtractElement(code, e[i], y, static_cast<u8>(i));
+    }
+    const Xbyak::Reg32 tmp1 = ctx.reg_alloc.ScratchGpr().cvt32();
+    const Xbyak::Reg32 tmp2 = ctx.reg_alloc.ScratchGpr().cvt32();
+
+    for (size_t i = 0; i < 4; i++) {
+        // h becomes t, and then the new lowest element of x.
+        const Xbyak::Reg32 h = e[3];
+
+        EmitHashSigma(code, tmp1, e[0], tmp2, 6, 11, 25);
+        code.add(h, tmp1);
+        EmitChoose(code, tmp1, e[0], e[1], e[2], tmp2);
+        code.add(h, tmp1);
+        ExtractElement(code, tmp1, w, static_cast<u8>(i));
+        code.add(h, tmp1);
+
+        code.add(a[3], h);
+
+        EmitHashSigma(code, tmp1, a[0], tmp2, 2, 13, 22);
+        code.add(h, tmp1);
+        EmitMajority(code, tmp1, a[0], a[1], a[2], tmp2);
+        code.add(h, tmp1);
+
+        const Xbyak::Reg32 d = a[3];
+        a = {h, a[0], a[1], a[2]};
+        e = {d, e[0], e[1], e[2]};
+    }
+
+    InsertElements(code, result, tmp_xmm, part1 ? a : e);
+
+    ctx.reg_alloc.DefineValue(inst, result);
+}
+
+// ARM stores the SHA1 state with a in the lowest element, and expects the round constant to already
+// be included in w. sha1rnds4 expects the opposite element order, and adds the round constant itself.
+static void EmitSHA1HashUpdate(RegAlloc::ArgumentInfo args, EmitContext& ctx, BlockOfCode& code, IR::Inst* inst, u8 function, u32 round_constant) {
+    const Xbyak::Xmm x = ctx.reg_alloc.UseScratchXmm(args[0]);
+    const Xbyak::Xmm y = ctx.reg_alloc.UseScratchXmm(args[1]);
+    const Xbyak::Xmm w = ctx.reg_alloc.UseScratchXmm(args[2]);
+
+    const u64 k = (u64{round_constant} << 32) | round_constant;
+
+    code.pshufd(x, x, 0b00011011);
+    code.psubd(w, code.MConst(xword, k, k));
+    code.pshufd(w, w, 0b00011011);
+    code.pslldq(y, 12);
+    code.paddd(w, y);
+    code.sha1rnds4(x, w, function);
+    code.pshufd(x, x, 0b00011011);
+
+    ctx.reg_alloc.DefineValue(inst, x);
+}
+
+void EmitX64::EmitSHA1HashUpdateChoose(EmitContext& ctx, IR::Inst* inst) {
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+    if (code.HasSHA()) {
+        EmitSHA1HashUpdate(args, ctx, code, inst, 0, 0x5A827999);
+        return;
+    }
+
+    EmitSHA1HashUpdateSSE2(args, ctx, code, inst, EmitChoose);
+}
+
+void EmitX64::EmitSHA1HashUpdateMajority(EmitContext& ctx, IR::Inst* inst) {
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+    if (code.HasSHA()) {
+        EmitSHA1HashUpdate(args, ctx, code, inst, 2, 0x8F1BBCDC);
+        return;
+    }
+
+    EmitSHA1HashUpdateSSE2(args, ctx, code, inst, EmitMajority);
+}
+
+void EmitX64::EmitSHA1HashUpdateParity(EmitContext& ctx, IR::Inst* inst) {
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+    if (code.HasSHA()) {
+        EmitSHA1HashUpdate(args, ctx, code, inst, 1, 0x6ED9EBA1);
+        return;
+    }
+
+    EmitSHA1HashUpdateSSE2(args, ctx, code, inst, EmitParity);
+}
+
+void EmitX64::EmitSHA256Hash(EmitContext& ctx, IR::Inst* inst) {
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+    const bool part1 = args[3].GetImmediateU1();
+
+    if (code.HasSHA()) {
+        // ARM stores the state as x = [a, b, c, d] and y = [e, f, g, h], lowest element first.
+        // sha256rnds2 expects it as [f, e, b, a] and [h, g, d, c].
+        const Xbyak::Xmm x = ctx.reg_alloc.UseXmm(args[0]);
+        const Xbyak::Xmm y = ctx.reg_alloc.UseXmm(args[1]);
+        const Xbyak::Xmm w = ctx.reg_alloc.UseXmm(args[2]);
+        const Xbyak::Xmm abef = ctx.reg_alloc.ScratchXmm();
+        const Xbyak::Xmm cdgh = ctx.reg_alloc.ScratchXmm();
+
+        code.movdqa(abef, y);
+        code.punpcklqdq(abef, x);
+        code.pshufd(abef, abef, 0b10110001);
+        code.movdqa(cdgh, y);
+        code.punpckhqdq(cdgh, x);
+        code.pshufd(cdgh, cdgh, 0b10110001);
+
+        // Two rounds at a time. Each produces the new [f, e, b, a], and the old one becomes [h, g, d, c].
+        code.movdqa(xmm0, w);
+        code.sha256rnds2(cdgh, abef);
+        code.pshufd(xmm0, w, 0b00001110);
+        code.sha256rnds2(abef, cdgh);
+
+        code.pshufd(abef, abef, 0b10110001);
+        code.pshufd(cdgh, cdgh, 0b10110001);
+        if (part1) {
+            code.punpckhqdq(abef, cdgh);
+        } else {
+            code.punpcklqdq(abef, cdgh);
+        }
+
+        ctx.reg_alloc.DefineValue(inst, abef);
+        return;
+    }
+
+    EmitSHA256HashSSE2(args, ctx, code, inst, part1);
+}
+
+void EmitX64::EmitSHA256MessageSchedule0(EmitContext& ctx, IR::Inst* inst) {
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+    if (code.HasSHA()) {
+        const Xbyak::Xmm x = ctx.reg_alloc.UseScratchXmm(args[0]);
+        const Xbyak::Xmm y = ctx.reg_alloc.UseXmm(args[1]);
+
+        code.sha256msg1(x, y);
+
+        ctx.reg_alloc.DefineValue(inst, x);
+        return;
+    }
+
+    const Xbyak::Xmm x = ctx.reg_alloc.UseScratchXmm(args[0]);
+    const Xbyak::Xmm y = ctx.reg_alloc.UseXmm(args[1]);
+    const Xbyak::Xmm t = ctx.reg_alloc.ScratchXmm();
+    const Xbyak::Xmm sigma = ctx.reg_alloc.ScratchXmm();
+    const Xbyak::Xmm tmp = ctx.reg_alloc.ScratchXmm();
+
+    // t = [x1, x2, x3, y0]
+    code.movdqa(t, x);
+    code.psrldq(t, 4);
+    code.movdqa(tmp, y);
+    code.pslldq(tmp, 12);
+    code.por(t, tmp);
+
+    EmitScheduleSigma(code, sigma, t, tmp, 7, 18, 3);
+    code.paddd(x, sigma);
+
+    ctx.reg_alloc.DefineValue(inst, x);
+}
+
+void EmitX64::EmitSHA256MessageSchedule1(EmitContext& ctx, IR::Inst* inst) {
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+    if (code.HasSHA()) {
+        const Xbyak::Xmm x = ctx.reg_alloc.UseScratchXmm(args[0]);
+        const Xbyak::Xmm y = ctx.reg_alloc.UseXmm(args[1]);
+        const Xbyak::Xmm z = ctx.reg_alloc.UseXmm(args[2]);
+        const Xbyak::Xmm tmp = ctx.reg_alloc.ScratchXmm();
+
+        // sha256msg2 expects W[t-7] to have already been added.
+        code.movdqa(tmp, z);
+        code.palignr(tmp, y, 4);
+        code.paddd(x, tmp);
+        code.sha256msg2(x, z);
+
+        ctx.reg_alloc.DefineValue(inst, x);
+        return;
+    }
+
+    const Xbyak::Xmm x = ctx.reg_alloc.UseScratchXmm(args[0]);
+    const Xbyak::Xmm y = ctx.reg_alloc.UseXmm(args[1]);
+    const Xbyak::Xmm z = ctx.reg_alloc.UseXmm(args[2]);
+    const Xbyak::Xmm t = ctx.reg_alloc.ScratchXmm();
+    const Xbyak::Xmm sigma = ctx.reg_alloc.ScratchXmm();
+    const Xbyak::Xmm tmp = ctx.reg_alloc.ScratchXmm();
+
+    // x += [y1, y2, y3, z0]
+    code.movdqa(t, y);
+    code.psrldq(t, 4);
+    code.movdqa(tmp, z);
+    code.pslldq(tmp, 12);
+    code.por(t, tmp);
+    code.paddd(x, t);
+
+    // The upper half depends upon the lower half of the result. Sigma of the zeroed elements is zero.
+    code.movdqa(t, z);
+    code.psrldq(t, 8);
+    EmitScheduleSigma(code, sigma, t, tmp, 17, 19, 10);
+    code.paddd(x, sigma);
+    code.movdqa(t, x);
+    code.pslldq(t, 8);
+    EmitScheduleSigma(code, sigma, t, tmp, 17, 19, 10);
+    code.paddd(x, sigma);
+
+    ctx.reg_alloc.DefineValue(inst, x);
+}
+
+} // namespace Dynarmic::Backend::X64
@@ -3,6 +3,8 @@
  * SPDX-License-Identifier: 0BSD
  */
 
+#include <array>
+
 #include "backend/x64/block_of_code.h"
 #include "backend/x64/emit_x64.h"
 #include "common/crypto/sm4.h"
@@ -10,11 +12,99 @@
 
 namespace Dynarmic::Backend::X64 {
 
+using namespace Xbyak::util;
+
+namespace {
+
+alignas(16) const std::array<u8, 256> substitution_box = [] {
+    std::array<u8, 256> result;
+    for (size_t i = 0; i < result.size(); i++) {
+        result[i] = Common::Crypto::SM4::AccessSubstitutionBox(static_cast<u8>(i));
+    }
+    return result;
+}();
+
+} // anonymous namespace
+
 void EmitX64::EmitSM4AccessSubstitutionBox(EmitContext& ctx, IR::Inst* inst) {
     auto args = ctx.reg_alloc.GetArgumentInfo(inst);
 
-    ctx.reg_alloc.HostCall(inst, args[0]);
-    code.CallFunction(&Common::Crypto::SM4::AccessSubstitutionBox);
+    const Xbyak::Reg64 index = ctx.reg_alloc.UseScratchGpr(args[0]);
+    const Xbyak::Reg64 table_ptr = ctx.reg_alloc.ScratchGpr();
+
+    code.movzx(index.cvt32(), index.cvt8());
+    code.mov(table_ptr, reinterpret_cast<u64>(substitution_box.data()));
+    code.movzx(index.cvt32(), byte[table_ptr + index]);
+
+    ctx.reg_alloc.DefineValue(inst, index);
+}
+
+void EmitX64::EmitSM4SubstituteBytes(EmitContext& ctx, IR::Inst* inst) {
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+    if (code.HasGFNI()) {
+        // The SM4 S-box is inversion in GF(2^8) mod x^8+x^7+x^6+x^5+x^4+x^2+1 surrounded by affine transforms.
+        // Folding an isomorphism onto the AES field into those transforms lets GFNI compute it directly.
+        const Xbyak::Xmm data = ctx.reg_alloc.UseScratchXmm(args[0]);
+
+        code.gf2p8affineqb(data, code.MConst(xword, 0x4C287DB91A22505D, 0x4C287DB91A22505D), 0x3E);
+        code.gf2p8affineinvqb(data, code.MConst(xword, 0xF3AB34A974A6B589, 0xF3AB34A974A6B589), 0xD3);
+
+        ctx.reg_alloc.DefineValue(inst, data);
+        return;
+    }
+
+    if (code.HasSSSE3()) {
+        // Each row of sixteen table entries is looked up by the low nibble. Subtracting the row offset
+        // and saturating 0x70 into the result sets bit 7 of indices whose high nibble does not match,
+        // which causes pshufb to zero those bytes.
+        const Xbyak::Xmm data = ctx.reg_alloc.UseScratchXmm(args[0]);
+        const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
+        const Xbyak::Xmm index = ctx.reg_alloc.ScratchXmm();
+        const Xbyak::Xmm row = ctx.reg_alloc.ScratchXmm();
+        const Xbyak::Xmm row_offset = ctx.reg_alloc.ScratchXmm();
+        const Xbyak::Xmm select_bias = ctx.reg_alloc.ScratchXmm();
+        const Xbyak::Reg64 table_ptr = ctx.reg_alloc.ScratchGpr();
+
+        code.mov(table_ptr, reinterpret_cast<u64>(substitution_box.data()));
+        code.movdqa(row_offset, code.MConst(xword, 0x1010101010101010, 0x1010101010101010));
+        code.movdqa(select_bias, code.MConst(xword, 0x7070707070707070, 0x7070707070707070));
+        code.pxor(result, result);
+
+        for (size_t i = 0; i < 16; i++) {
+            code.movdqa(index, data);
+            code.paddusb(index, select_bias);
+            code.movdqa(row, xword[table_ptr + i * 16]);
+            code.pshufb(row, index);
+            code.por(result, row);
+            if (i != 15) {
+                code.psubb(data, row_offset);
+            }
+        }
+
+        ctx.reg_alloc.DefineValue(inst, result);
+        return;
+    }
+
+    const Xbyak::Xmm data = ctx.reg_alloc.UseScratchXmm(args[0]);
+    const Xbyak::Reg32 tmp = ctx.reg_alloc.ScratchGpr().cvt32();
+    const Xbyak::Reg32 lower = ctx.reg_alloc.ScratchGpr().cvt32();
+    const Xbyak::Reg64 table_ptr = ctx.reg_alloc.ScratchGpr();
+
+    code.mov(table_ptr, reinterpret_cast<u64>(substitution_box.data()));
+
+    for (int i = 0; i < 8; i++) {
+        code.pextrw(tmp, data, static_cast<u8>(i));
+        code.movzx(lower, tmp.cvt8());
+        code.shr(tmp, 8);
+        code.movzx(lower, byte[table_ptr + lower.cvt64()]);
+        code.movzx(tmp, byte[table_ptr + tmp.cvt64()]);
+        code.shl(tmp, 8);
+        code.or_(tmp, lower);
+        code.pinsrw(data, tmp, static_cast<u8>(i));
+    }
+
+    ctx.reg_alloc.DefineValue(inst, data);
 }
 
 } // namespace Dynarmic::Backend::X64
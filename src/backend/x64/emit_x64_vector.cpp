@@ -4,15 +4,20 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <bitset>
 #include <cstdlib>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <mp/traits/function_info.h>
 
 #include "backend/x64/abi.h"
 #include "backend/x64/block_of_code.h"
 #include "backend/x64/emit_x64.h"
+#include "backend/x64/vector_fallback_counts.h"
 #include "common/assert.h"
 #include "common/bit_util.h"
 #include "common/common_types.h"
@@ -49,6 +54,35 @@ static void EmitAVXVectorOperation(BlockOfCode& code, EmitContext& ctx, IR::Inst
     ctx.reg_alloc.DefineValue(inst, xmm_a);
 }
 
+#ifdef DYNARMIC_COUNT_VECTOR_FALLBACKS
+/// Number of times the C++ fallback of each opcode has run, across all Jits.
+/// Emitted code increments these with locked instructions.
+static std::array<std::atomic<u64>, IR::OpcodeCount> fallback_counts{};
+static_assert(std::atomic<u64>::is_always_lock_free && sizeof(std::atomic<u64>) == sizeof(u64));
+#endif
+
+std::vector<std::pair<IR::Opcode, u64>> GetVectorFallbackCounts() {
+    std::vector<std::pair<IR::Opcode, u64>> result;
+#ifdef DYNARMIC_COUNT_VECTOR_FALLBACKS
+    for (size_t i = 0; i < fallback_counts.size(); i++) {
+        const u64 count = fallback_counts[i].load(std::memory_order_relaxed);
+        if (count != 0) {
+            result.emplace_back(static_cast<IR::Opcode>(i), count);
+        }
+    }
+#endif
+    return result;
+}
+
+/// Counts executions of the fallback for `inst`. Must be emitted after HostCall, as this clobbers rax.
+static void EmitCountFallback([[maybe_unused]] BlockOfCode& code, [[maybe_unused]] IR::Inst* inst) {
+#ifdef DYNARMIC_COUNT_VECTOR_FALLBACKS
+    code.mov(rax, reinterpret_cast<u64>(&fallback_counts[static_cast<size_t>(inst->GetOpcode())]));
+    code.lock();
+    code.inc(qword[rax]);
+#endif
+}
+
 template <typename Lambda>
 static void EmitOneArgumentFallback(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst, Lambda lambda) {
     const auto fn = static_cast<mp::equivalent_function_type<Lambda>*>(lambda);
@@ -59,6 +93,7 @@ static void EmitOneArgumentFallback(BlockOfCode& code, EmitContext& ctx, IR::Ins
     ctx.reg_alloc.EndOfAllocScope();
 
     ctx.reg_alloc.HostCall(nullptr);
+    EmitCountFallback(code, inst);
     code.sub(rsp, stack_space + ABI_SHADOW_SPACE);
     code.lea(code.ABI_PARAM1, ptr[rsp + ABI_SHADOW_SPACE + 0 * 16]);
     code.lea(code.ABI_PARAM2, ptr[rsp + ABI_SHADOW_SPACE + 1 * 16]);
@@ -82,6 +117,7 @@ static void EmitOneArgumentFallbackWithSaturation(BlockOfCode& code, EmitContext
     ctx.reg_alloc.EndOfAllocScope();
 
     ctx.reg_alloc.HostCall(nullptr);
+    EmitCountFallback(code, inst);
     code.sub(rsp, stack_space + ABI_SHADOW_SPACE);
     code.lea(code.ABI_PARAM1, ptr[rsp + ABI_SHADOW_SPACE + 0 * 16]);
     code.lea(code.ABI_PARAM2, ptr[rsp + ABI_SHADOW_SPACE + 1 * 16]);
@@ -108,6 +144,7 @@ static void EmitTwoArgumentFallbackWithSaturation(BlockOfCode& code, EmitContext
     ctx.reg_alloc.EndOfAllocScope();
 
     ctx.reg_alloc.HostCall(nullptr);
+    EmitCountFallback(code, inst);
     code.sub(rsp, stack_space + ABI_SHADOW_SPACE);
     code.lea(code.ABI_PARAM1, ptr[rsp + ABI_SHADOW_SPACE + 0 * 16]);
     code.lea(code.ABI_PARAM2, ptr[rsp + ABI_SHADOW_SPACE + 1 * 16]);
@@ -136,6 +173,7 @@ static void EmitTwoArgumentFallback(BlockOfCode& code, EmitContext& ctx, IR::Ins
     ctx.reg_alloc.EndOfAllocScope();
 
     ctx.reg_alloc.HostCall(nullptr);
+    EmitCountFallback(code, inst);
     code.sub(rsp, stack_space + ABI_SHADOW_SPACE);
     code.lea(code.ABI_PARAM1, ptr[rsp + ABI_SHADOW_SPACE + 0 * 16]);
     code.lea(code.ABI_PARAM2, ptr[rsp + ABI_SHADOW_SPACE + 1 * 16]);
@@ -636,6 +674,38 @@ void EmitX64::EmitVectorArithmeticVShift64(EmitContext& ctx, IR::Inst* inst) {
         return;
     }
 
+    if (code.HasAVX2()) {
+        auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+        const Xbyak::Xmm result = ctx.reg_alloc.UseScratchXmm(args[0]);
+        const Xbyak::Xmm left_shift = ctx.reg_alloc.UseScratchXmm(args[1]);
+        const Xbyak::Xmm right_shift = ctx.reg_alloc.ScratchXmm();
+        const Xbyak::Xmm tmp = ctx.reg_alloc.ScratchXmm();
+        const Xbyak::Xmm sign = ctx.reg_alloc.ScratchXmm();
+
+        code.vmovdqa(tmp, code.MConst(xword, 0x00000000000000FF, 0x00000000000000FF));
+        code.vpxor(right_shift, right_shift, right_shift);
+        code.vpsubq(right_shift, right_shift, left_shift);
+
+        code.vpsllq(xmm0, left_shift, 56);
+
+        code.vpand(right_shift, right_shift, tmp);
+        code.vpand(left_shift, left_shift, tmp);
+
+        // There is no vpsravq prior to AVX-512, so we perform a logical shift of the
+        // one's complement of negative values instead: (x ^ sign) >> n ^ sign.
+        code.vpxor(sign, sign, sign);
+        code.vpcmpgtq(sign, sign, result);
+        code.vpxor(tmp, result, sign);
+        code.vpsrlvq(tmp, tmp, right_shift);
+        code.vpxor(tmp, tmp, sign);
+        code.vpsllvq(result, result, left_shift);
+        code.blendvpd(result, tmp);
+
+        ctx.reg_alloc.DefineValue(inst, result);
+        return;
+    }
+
     EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<s64>& result, const VectorArray<s64>& a, const VectorArray<s64>& b) {
         std::transform(a.begin(), a.end(), b.begin(), result.begin(), VShift<s64>);
     });
@@ -867,7 +937,32 @@ void EmitX64::EmitVectorCountLeadingZeros32(EmitContext& ctx, IR::Inst* inst) {
         return;
     }
 
-    EmitOneArgumentFallback(code, ctx, inst, EmitVectorCountLeadingZeros<u32>);
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+    const Xbyak::Xmm data = ctx.reg_alloc.UseScratchXmm(args[0]);
+    const Xbyak::Xmm tmp = ctx.reg_alloc.ScratchXmm();
+
+    // Smear the highest set bit into all lower bits, then isolate it.
+    // The result is a power of two that can be converted to floating point exactly.
+    for (const u8 shift : {1, 2, 4, 8, 16}) {
+        code.movdqa(tmp, data);
+        code.psrld(tmp, shift);
+        code.por(data, tmp);
+    }
+    code.movdqa(tmp, data);
+    code.psrld(tmp, 1);
+    code.pandn(tmp, data);
+
+    // The biased exponent of 2^n is 127 + n, so the number of leading zeros is 158 - exponent.
+    // Zero has an exponent of zero, which is clamped to 32.
+    code.cvtdq2ps(tmp, tmp);
+    code.pslld(tmp, 1);
+    code.psrld(tmp, 24);
+    code.movdqa(data, code.MConst(xword, 0x0000009E0000009E, 0x0000009E0000009E));
+    code.psubd(data, tmp);
+    code.pminsw(data, code.MConst(xword, 0x0000002000000020, 0x0000002000000020));
+
+    ctx.reg_alloc.DefineValue(inst, data);
 }
 
 void EmitX64::EmitVectorDeinterleaveEven8(EmitContext& ctx, IR::Inst* inst) {
@@ -2416,16 +2511,79 @@ static void PairedMin(VectorArray<T>& result, const VectorArray<T>& x, const Vec
     PairedOperation(result, x, y, [](auto a, auto b) { return std::min(a, b); });
 }
 
+// Separates the even and odd elements of both arguments by widening and narrowing them,
+// then combines the two halves with `fn`. Only valid for 8-bit and 16-bit elements.
+template <typename Function>
+static void EmitVectorPairedMinMaxLowerSizes(size_t esize, bool is_signed, EmitContext& ctx, IR::Inst* inst, BlockOfCode& code, Function fn) {
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+    const Xbyak::Xmm x = ctx.reg_alloc.UseScratchXmm(args[0]);
+    const Xbyak::Xmm y = ctx.reg_alloc.UseScratchXmm(args[1]);
+    const Xbyak::Xmm x_even = ctx.reg_alloc.ScratchXmm();
+    const Xbyak::Xmm y_even = ctx.reg_alloc.ScratchXmm();
+
+    code.movdqa(x_even, x);
+    code.movdqa(y_even, y);
+
+    switch (esize) {
+    case 8:
+        code.psllw(x_even, 8);
+        code.psllw(y_even, 8);
+        for (const auto& reg : {x, y, x_even, y_even}) {
+            if (is_signed) {
+                code.psraw(reg, 8);
+            } else {
+                code.psrlw(reg, 8);
+            }
+        }
+        if (is_signed) {
+            code.packsswb(x_even, y_even);
+            code.packsswb(x, y);
+        } else {
+            code.packuswb(x_even, y_even);
+            code.packuswb(x, y);
+        }
+        break;
+    case 16:
+        code.pslld(x_even, 16);
+        code.pslld(y_even, 16);
+        for (const auto& reg : {x, y, x_even, y_even}) {
+            if (is_signed) {
+                code.psrad(reg, 16);
+            } else {
+                code.psrld(reg, 16);
+            }
+        }
+        if (is_signed) {
+            code.packssdw(x_even, y_even);
+            code.packssdw(x, y);
+        } else {
+            code.packusdw(x_even, y_even);
+            code.packusdw(x, y);
+        }
+        break;
+    default:
+        UNREACHABLE();
+    }
+
+    fn(x, x_even);
+
+    ctx.reg_alloc.DefineValue(inst, x);
+}
+
 void EmitX64::EmitVectorPairedMaxS8(EmitContext& ctx, IR::Inst* inst) {
+    if (code.HasSSE41()) {
+        EmitVectorPairedMinMaxLowerSizes(8, true, ctx, inst, code, [&](const Xbyak::Xmm& a, const Xbyak::Xmm& b) { code.pmaxsb(a, b); });
+        return;
+    }
+
     EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<s8>& result, const VectorArray<s8>& a, const VectorArray<s8>& b) {
         PairedMax(result, a, b);
     });
 }
 
 void EmitX64::EmitVectorPairedMaxS16(EmitContext& ctx, IR::Inst* inst) {
-    EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<s16>& result, const VectorArray<s16>& a, const VectorArray<s16>& b) {
-        PairedMax(result, a, b);
-    });
+    EmitVectorPairedMinMaxLowerSizes(16, true, ctx, inst, code, [&](const Xbyak::Xmm& a, const Xbyak::Xmm& b) { code.pmaxsw(a, b); });
 }
 
 void EmitX64::EmitVectorPairedMaxS32(EmitContext& ctx, IR::Inst* inst) {
@@ -2457,12 +2615,15 @@ void EmitX64::EmitVectorPairedMaxS32(EmitContext& ctx, IR::Inst* inst) {
 }
 
 void EmitX64::EmitVectorPairedMaxU8(EmitContext& ctx, IR::Inst* inst) {
-    EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<u8>& result, const VectorArray<u8>& a, const VectorArray<u8>& b) {
-        PairedMax(result, a, b);
-    });
+    EmitVectorPairedMinMaxLowerSizes(8, false, ctx, inst, code, [&](const Xbyak::Xmm& a, const Xbyak::Xmm& b) { code.pmaxub(a, b); });
 }
 
 void EmitX64::EmitVectorPairedMaxU16(EmitContext& ctx, IR::Inst* inst) {
+    if (code.HasSSE41()) {
+        EmitVectorPairedMinMaxLowerSizes(16, false, ctx, inst, code, [&](const Xbyak::Xmm& a, const Xbyak::Xmm& b) { code.pmaxuw(a, b); });
+        return;
+    }
+
     EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<u16>& result, const VectorArray<u16>& a, const VectorArray<u16>& b) {
         PairedMax(result, a, b);
     });
@@ -2502,15 +2663,18 @@ void EmitX64::EmitVectorPairedMaxU32(EmitContext& ctx, IR::Inst* inst) {
 }
 
 void EmitX64::EmitVectorPairedMinS8(EmitContext& ctx, IR::Inst* inst) {
+    if (code.HasSSE41()) {
+        EmitVectorPairedMinMaxLowerSizes(8, true, ctx, inst, code, [&](const Xbyak::Xmm& a, const Xbyak::Xmm& b) { code.pminsb(a, b); });
+        return;
+    }
+
     EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<s8>& result, const VectorArray<s8>& a, const VectorArray<s8>& b) {
         PairedMin(result, a, b);
     });
 }
 
 void EmitX64::EmitVectorPairedMinS16(EmitContext& ctx, IR::Inst* inst) {
-    EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<s16>& result, const VectorArray<s16>& a, const VectorArray<s16>& b) {
-        PairedMin(result, a, b);
-    });
+    EmitVectorPairedMinMaxLowerSizes(16, true, ctx, inst, code, [&](const Xbyak::Xmm& a, const Xbyak::Xmm& b) { code.pminsw(a, b); });
 }
 
 void EmitX64::EmitVectorPairedMinS32(EmitContext& ctx, IR::Inst* inst) {
@@ -2542,12 +2706,15 @@ void EmitX64::EmitVectorPairedMinS32(EmitContext& ctx, IR::Inst* inst) {
 }
 
 void EmitX64::EmitVectorPairedMinU8(EmitContext& ctx, IR::Inst* inst) {
-    EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<u8>& result, const VectorArray<u8>& a, const VectorArray<u8>& b) {
-        PairedMin(result, a, b);
-    });
+    EmitVectorPairedMinMaxLowerSizes(8, false, ctx, inst, code, [&](const Xbyak::Xmm& a, const Xbyak::Xmm& b) { code.pminub(a, b); });
 }
 
 void EmitX64::EmitVectorPairedMinU16(EmitContext& ctx, IR::Inst* inst) {
+    if (code.HasSSE41()) {
+        EmitVectorPairedMinMaxLowerSizes(16, false, ctx, inst, code, [&](const Xbyak::Xmm& a, const Xbyak::Xmm& b) { code.pminuw(a, b); });
+        return;
+    }
+
     EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<u16>& result, const VectorArray<u16>& a, const VectorArray<u16>& b) {
         PairedMin(result, a, b);
     });
@@ -2948,6 +3115,91 @@ static void RoundingShiftLeft(VectorArray<T>& out, const VectorArray<T>& lhs, co
     }
 }
 
+static void EmitVectorRoundingShiftLeft(size_t esize, bool is_signed, EmitContext& ctx, IR::Inst* inst, BlockOfCode& code) {
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+    const Xbyak::Xmm x = ctx.reg_alloc.UseXmm(args[0]);
+    const Xbyak::Xmm left_shift = ctx.reg_alloc.UseScratchXmm(args[1]);
+    const Xbyak::Xmm right_shift = ctx.reg_alloc.ScratchXmm();
+    const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
+    const Xbyak::Xmm mask = ctx.reg_alloc.ScratchXmm();
+
+    switch (esize) {
+    case 16:
+        code.vmovdqa(mask, code.MConst(xword, 0x00FF00FF00FF00FF, 0x00FF00FF00FF00FF));
+        break;
+    case 32:
+        code.vmovdqa(mask, code.MConst(xword, 0x000000FF000000FF, 0x000000FF000000FF));
+        break;
+    case 64:
+        code.vmovdqa(mask, code.MConst(xword, 0x00000000000000FF, 0x00000000000000FF));
+        break;
+    default:
+        UNREACHABLE();
+    }
+
+    // Only the bottom byte of each shift amount is significant. For a negative shift amount -n,
+    // (~shift & 0xFF) == n - 1. Out of range amounts shift out every bit of the element.
+    code.vpandn(right_shift, left_shift, mask);
+    code.vpand(left_shift, left_shift, mask);
+    code.vpsrlw(mask, mask, 7);
+
+    // result = (x >> (n - 1) >> 1) + ((x >> (n - 1)) & 1) + (x << shift)
+    // Exactly one of the two shifts is in range, unless both produce zero.
+    switch (esize) {
+    case 16:
+        if (is_signed) {
+            code.vpsravw(result, x, right_shift);
+        } else {
+            code.vpsrlvw(result, x, right_shift);
+        }
+        code.vpand(mask, mask, result);
+        if (is_signed) {
+            code.vpsraw(result, result, 1);
+        } else {
+            code.vpsrlw(result, result, 1);
+        }
+        code.vpaddw(result, result, mask);
+        code.vpsllvw(left_shift, x, left_shift);
+        code.vpaddw(result, result, left_shift);
+        break;
+    case 32:
+        if (is_signed) {
+            code.vpsravd(result, x, right_shift);
+        } else {
+            code.vpsrlvd(result, x, right_shift);
+        }
+        code.vpand(mask, mask, result);
+        if (is_signed) {
+            code.vpsrad(result, result, 1);
+        } else {
+            code.vpsrld(result, result, 1);
+        }
+        code.vpaddd(result, result, mask);
+        code.vpsllvd(left_shift, x, left_shift);
+        code.vpaddd(result, result, left_shift);
+        break;
+    case 64:
+        if (is_signed) {
+            code.vpsravq(result, x, right_shift);
+        } else {
+            code.vpsrlvq(result, x, right_shift);
+        }
+        code.vpand(mask, mask, result);
+        if (is_signed) {
+            code.vpsraq(result, result, 1);
+        } else {
+            code.vpsrlq(result, result, 1);
+        }
+        code.vpaddq(result, result, mask);
+        code.vpsllvq(left_shift, x, left_shift);
+        code.vpaddq(result, result, left_shift);
+        break;
+    }
+
+    ctx.reg_alloc.DefineValue(inst, result);
+}
+
 void EmitX64::EmitVectorRoundingShiftLeftS8(EmitContext& ctx, IR::Inst* inst) {
     EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<s8>& result, const VectorArray<s8>& lhs, const VectorArray<s8>& rhs) {
         RoundingShiftLeft(result, lhs, rhs);
@@ -2955,18 +3207,33 @@ void EmitX64::EmitVectorRoundingShiftLeftS8(EmitContext& ctx, IR::Inst* inst) {
 }
 
 void EmitX64::EmitVectorRoundingShiftLeftS16(EmitContext& ctx, IR::Inst* inst) {
+    if (code.HasAVX512_Skylake()) {
+        EmitVectorRoundingShiftLeft(16, true, ctx, inst, code);
+        return;
+    }
+
     EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<s16>& result, const VectorArray<s16>& lhs, const VectorArray<s16>& rhs) {
         RoundingShiftLeft(result, lhs, rhs);
     });
 }
 
 void EmitX64::EmitVectorRoundingShiftLeftS32(EmitContext& ctx, IR::Inst* inst) {
+    if (code.HasAVX2()) {
+        EmitVectorRoundingShiftLeft(32, true, ctx, inst, code);
+        return;
+    }
+
     EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<s32>& result, const VectorArray<s32>& lhs, const VectorArray<s32>& rhs) {
         RoundingShiftLeft(result, lhs, rhs);
     });
 }
 
 void EmitX64::EmitVectorRoundingShiftLeftS64(EmitContext& ctx, IR::Inst* inst) {
+    if (code.HasAVX512_Skylake()) {
+        EmitVectorRoundingShiftLeft(64, true, ctx, inst, code);
+        return;
+    }
+
     EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<s64>& result, const VectorArray<s64>& lhs, const VectorArray<s64>& rhs) {
         RoundingShiftLeft(result, lhs, rhs);
     });
@@ -2979,18 +3246,33 @@ void EmitX64::EmitVectorRoundingShiftLeftU8(EmitContext& ctx, IR::Inst* inst) {
 }
 
 void EmitX64::EmitVectorRoundingShiftLeftU16(EmitContext& ctx, IR::Inst* inst) {
+    if (code.HasAVX512_Skylake()) {
+        EmitVectorRoundingShiftLeft(16, false, ctx, inst, code);
+        return;
+    }
+
     EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<u16>& result, const VectorArray<u16>& lhs, const VectorArray<s16>& rhs) {
         RoundingShiftLeft(result, lhs, rhs);
     });
 }
 
 void EmitX64::EmitVectorRoundingShiftLeftU32(EmitContext& ctx, IR::Inst* inst) {
+    if (code.HasAVX2()) {
+        EmitVectorRoundingShiftLeft(32, false, ctx, inst, code);
+        return;
+    }
+
     EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<u32>& result, const VectorArray<u32>& lhs, const VectorArray<s32>& rhs) {
         RoundingShiftLeft(result, lhs, rhs);
     });
 }
 
 void EmitX64::EmitVectorRoundingShiftLeftU64(EmitContext& ctx, IR::Inst* inst) {
+    if (code.HasAVX2()) {
+        EmitVectorRoundingShiftLeft(64, false, ctx, inst, code);
+        return;
+    }
+
     EmitTwoArgumentFallback(code, ctx, inst, [](VectorArray<u64>& result, const VectorArray<u64>& lhs, const VectorArray<s64>& rhs) {
         RoundingShiftLeft(result, lhs, rhs);
     });
@@ -4285,6 +4567,7 @@ void EmitX64::EmitVectorTableLookup64(EmitContext& ctx, IR::Inst* inst) {
     const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
     ctx.reg_alloc.EndOfAllocScope();
     ctx.reg_alloc.HostCall(nullptr);
+    EmitCountFallback(code, inst);
 
     code.lea(code.ABI_PARAM1, ptr[rsp + ABI_SHADOW_SPACE]);
     code.lea(code.ABI_PARAM2, ptr[rsp + ABI_SHADOW_SPACE + 4 * 8]);
@@ -4415,6 +4698,7 @@ void EmitX64::EmitVectorTableLookup128(EmitContext& ctx, IR::Inst* inst) {
     const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
     ctx.reg_alloc.EndOfAllocScope();
     ctx.reg_alloc.HostCall(nullptr);
+    EmitCountFallback(code, inst);
 
     code.lea(code.ABI_PARAM1, ptr[rsp + ABI_SHADOW_SPACE]);
     code.lea(code.ABI_PARAM2, ptr[rsp + ABI_SHADOW_SPACE + (table_size + 0) * 16]);
@@ -4682,7 +4966,40 @@ void EmitX64::EmitVectorUnsignedMultiply32(EmitContext& ctx, IR::Inst* inst) {
     }
 }
 
+// Looks up each element in a 512-entry table indexed by its top nine bits.
+static void EmitVectorUnsignedEstimateLookup(const std::array<u32, 512>& table, EmitContext& ctx, IR::Inst* inst, BlockOfCode& code) {
+    auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+
+    const Xbyak::Xmm index = ctx.reg_alloc.UseScratchXmm(args[0]);
+    const Xbyak::Xmm mask = ctx.reg_alloc.ScratchXmm();
+    const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
+    const Xbyak::Reg64 table_ptr = ctx.reg_alloc.ScratchGpr();
+
+    code.vpsrld(index, index, 23);
+    code.vpcmpeqd(mask, mask, mask);
+    code.mov(table_ptr, reinterpret_cast<u64>(table.data()));
+    code.vpgatherdd(result, code.ptr[table_ptr + index * 4], mask);
+
+    ctx.reg_alloc.DefineValue(inst, result);
+}
+
 void EmitX64::EmitVectorUnsignedRecipEstimate(EmitContext& ctx, IR::Inst* inst) {
+    if (code.HasAVX2()) {
+        static const std::array<u32, 512> table = [] {
+            std::array<u32, 512> result{};
+            for (u32 i = 0; i < 256; i++) {
+                result[i] = 0xFFFFFFFF;
+            }
+            for (u32 i = 256; i < 512; i++) {
+                result[i] = (0b100000000 | Common::RecipEstimate(i)) << 23;
+            }
+            return result;
+        }();
+
+        EmitVectorUnsignedEstimateLookup(table, ctx, inst, code);
+        return;
+    }
+
     EmitOneArgumentFallback(code, ctx, inst, [](VectorArray<u32>& result, const VectorArray<u32>& a) {
         for (size_t i = 0; i < result.size(); i++) {
             if ((a[i] & 0x80000000) == 0) {
@@ -4699,6 +5016,22 @@ void EmitX64::EmitVectorUnsignedRecipEstimate(EmitContext& ctx, IR::Inst* inst)
 }
 
 void EmitX64::EmitVectorUnsignedRecipSqrtEstimate(EmitContext& ctx, IR::Inst* inst) {
+    if (code.HasAVX2()) {
+        static const std::array<u32, 512> table = [] {
+            std::array<u32, 512> result{};
+            for (u32 i = 0; i < 128; i++) {
+                result[i] = 0xFFFFFFFF;
+            }
+            for (u32 i = 128; i < 512; i++) {
+                result[i] = (0b100000000 | Common::RecipSqrtEstimate(i)) << 23;
+            }
+            return result;
+        }();
+
+        EmitVectorUnsignedEstimateLookup(table, ctx, inst, code);
+        return;
+    }
+
     EmitOneArgumentFallback(code, ctx, inst, [](VectorArray<u32>& result, const VectorArray<u32>& a) {
         for (size_t i = 0; i < result.size(); i++) {
             if ((a[i] & 0xC0000000) == 0) {
@@ -4,10 +4,12 @@
  */
 
 #include <array>
+#include <iterator>
 #include <limits>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <mp/metavalue/lift_value.h>
 #include <mp/traits/function_info.h>
@@ -121,7 +123,8 @@ void HandleNaNs(BlockOfCode& code, EmitContext& ctx, bool fpcr_controlled, std::
     const Xbyak::Xmm result = xmms[0];
 
     code.sub(rsp, 8);
-    ABI_PushCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+    const std::vector<HostLoc> occupied = ctx.reg_alloc.OccupiedCallerSaveRegistersExcept(HostLocXmmIdx(result.getIdx()));
+    ABI_PushRegistersAndAdjustStack(code, 0, occupied);
 
     const size_t stack_space = xmms.size() * 16;
     code.sub(rsp, stack_space + ABI_SHADOW_SPACE);
@@ -135,7 +138,7 @@ void HandleNaNs(BlockOfCode& code, EmitContext& ctx, bool fpcr_controlled, std::
 
     code.movaps(result, xword[rsp + ABI_SHADOW_SPACE + 0 * 16]);
     code.add(rsp, stack_space + ABI_SHADOW_SPACE);
-    ABI_PopCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+    ABI_PopRegistersAndAdjustStack(code, 0, occupied);
     code.add(rsp, 8);
     code.jmp(end, code.T_NEAR);
     code.SwitchToNearCode();
@@ -228,6 +231,37 @@ void DenormalsAreZero(BlockOfCode& code, FP::FPCR fpcr, std::initializer_list<Xb
     }
 }
 
+/// Immediates for vfpclassps/pd.
+namespace FpClass {
+constexpr u8 QNaN = 0x01;
+constexpr u8 PositiveZero = 0x02;
+constexpr u8 NegativeZero = 0x04;
+constexpr u8 PositiveInfinity = 0x08;
+constexpr u8 NegativeInfinity = 0x10;
+constexpr u8 Denormal = 0x20;
+constexpr u8 SNaN = 0x80;
+} // namespace FpClass
+
+/// Replaces each NaN element of `result` with the NaN ARM would have produced, given that the
+/// operation's operands are `operands` in order of priority. Requires AVX-512. Clobbers k1.
+template<size_t fsize>
+void ProcessNaNsAVX512(BlockOfCode& code, const Xbyak::Xmm& result, std::initializer_list<Xbyak::Xmm> operands) {
+    using FPT = mp::unsigned_integer_of_size<fsize>;
+
+    // Lowest priority first, as each step overwrites the elements matched by the steps before it:
+    // generated NaNs, then quiet NaN operands, then signalling NaN operands.
+    FCODE(vcmpp)(k1, result, result, 3); // Unordered
+    FCODE(vmovap)(result | k1, GetNaNVector<fsize>(code));
+    for (auto iter = std::rbegin(operands); iter != std::rend(operands); ++iter) {
+        FCODE(vfpclassp)(k1, *iter, FpClass::QNaN);
+        FCODE(vmovap)(result | k1, *iter);
+    }
+    for (auto iter = std::rbegin(operands); iter != std::rend(operands); ++iter) {
+        FCODE(vfpclassp)(k1, *iter, FpClass::SNaN);
+        FCODE(vorp)(result | k1, *iter, GetVectorOf<fsize, FP::FPInfo<FPT>::mantissa_msb>(code));
+    }
+}
+
 template<typename T>
 struct DefaultIndexer {
     std::tuple<T> operator()(size_t i, const VectorArray<T>& a) {
@@ -366,6 +400,27 @@ void EmitThreeOpVectorOperation(BlockOfCode& code, EmitContext& ctx, IR::Inst* i
         return;
     }
 
+    // The default NaN handler processes NaNs element-wise, which can be done inline.
+    if constexpr (std::is_same_v<Indexer<u32>, DefaultIndexer<u32>>) {
+        if (code.HasAVX512_Skylake() && nan_handler == NaNHandler<fsize, Indexer, 3>::GetDefault()) {
+            const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
+            const Xbyak::Xmm xmm_a = ctx.reg_alloc.UseXmm(args[0]);
+            const Xbyak::Xmm xmm_b = ctx.reg_alloc.UseXmm(args[1]);
+
+            code.movaps(result, xmm_a);
+            if constexpr (std::is_member_function_pointer_v<Function>) {
+                (code.*fn)(result, xmm_b);
+            } else {
+                fn(result, xmm_b);
+            }
+
+            ProcessNaNsAVX512<fsize>(code, result, {xmm_a, xmm_b});
+
+            ctx.reg_alloc.DefineValue(inst, result);
+            return;
+        }
+    }
+
     const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
     const Xbyak::Xmm xmm_a = ctx.reg_alloc.UseXmm(args[0]);
     const Xbyak::Xmm xmm_b = ctx.reg_alloc.UseXmm(args[1]);
@@ -1005,6 +1060,64 @@ void EmitFPVectorMulAdd(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst) {
             return;
         }
 
+        if (code.HasAVX512_Skylake()) {
+            auto args = ctx.reg_alloc.GetArgumentInfo(inst);
+            const bool fpcr_controlled = args[3].GetImmediateU1();
+            const FP::FPCR fpcr = ctx.FPCR(fpcr_controlled);
+
+            const Xbyak::Xmm result = ctx.reg_alloc.ScratchXmm();
+            const Xbyak::Xmm xmm_a = ctx.reg_alloc.UseXmm(args[0]);
+            const Xbyak::Xmm xmm_b = ctx.reg_alloc.UseXmm(args[1]);
+            const Xbyak::Xmm xmm_c = ctx.reg_alloc.UseXmm(args[2]);
+            const Xbyak::Xmm tmp = ctx.reg_alloc.ScratchXmm();
+
+            Xbyak::Label end, fallback;
+
+            MaybeStandardFPSCRValue(code, ctx, fpcr_controlled, [&]{
+                code.movaps(result, xmm_a);
+                FCODE(vfmadd231p)(result, xmm_b, xmm_c);
+
+                if (fpcr.DN()) {
+                    ForceToDefaultNaN<fsize>(code, fpcr, result);
+                } else {
+                    ProcessNaNsAVX512<fsize>(code, result, {xmm_a, xmm_b, xmm_c});
+
+                    // A quiet NaN addend does not propagate when the product is (inf * zero).
+                    const u8 zero = FpClass::PositiveZero | FpClass::NegativeZero | (fpcr.FZ() ? FpClass::Denormal : 0);
+                    const u8 inf = FpClass::PositiveInfinity | FpClass::NegativeInfinity;
+                    FCODE(vfpclassp)(k1, xmm_a, FpClass::QNaN);
+                    FCODE(vfpclassp)(k2 | k1, xmm_b, inf);
+                    FCODE(vfpclassp)(k2 | k2, xmm_c, zero);
+                    FCODE(vfpclassp)(k3 | k1, xmm_b, zero);
+                    FCODE(vfpclassp)(k3 | k3, xmm_c, inf);
+                    code.korw(k1, k2, k3);
+                    FCODE(vmovap)(result | k1, GetNaNVector<fsize>(code));
+                }
+
+                // Results that may have been flushed differently are handled by the fallback.
+                code.movaps(tmp, GetNegativeZeroVector<fsize>(code));
+                code.andnps(tmp, result);
+                FCODE(vcmpp)(k1, tmp, GetSmallestNormalVector<fsize>(code), 0); // Equal, ordered
+                code.kortestw(k1, k1);
+                code.jnz(fallback, code.T_NEAR);
+                code.L(end);
+            });
+
+            code.SwitchToFarCode();
+            code.L(fallback);
+            code.sub(rsp, 8);
+            const std::vector<HostLoc> occupied = ctx.reg_alloc.OccupiedCallerSaveRegistersExcept(HostLocXmmIdx(result.getIdx()));
+            ABI_PushRegistersAndAdjustStack(code, 0, occupied);
+            EmitFourOpFallbackWithoutRegAlloc(code, ctx, result, xmm_a, xmm_b, xmm_c, fallback_fn, fpcr_controlled);
+            ABI_PopRegistersAndAdjustStack(code, 0, occupied);
+            code.add(rsp, 8);
+            code.jmp(end, code.T_NEAR);
+            code.SwitchToNearCode();
+
+            ctx.reg_alloc.DefineValue(inst, result);
+            return;
+        }
+
         if (code.HasFMA() && code.HasAVX()) {
             auto args = ctx.reg_alloc.GetArgumentInfo(inst);
             const bool fpcr_controlled = args[3].GetImmediateU1();
@@ -1032,9 +1145,10 @@ void EmitFPVectorMulAdd(BlockOfCode& code, EmitContext& ctx, IR::Inst* inst) {
             code.SwitchToFarCode();
             code.L(fallback);
             code.sub(rsp, 8);
-            ABI_PushCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+            const std::vector<HostLoc> occupied = ctx.reg_alloc.OccupiedCallerSaveRegistersExcept(HostLocXmmIdx(result.getIdx()));
+            ABI_PushRegistersAndAdjustStack(code, 0, occupied);
             EmitFourOpFallbackWithoutRegAlloc(code, ctx, result, xmm_a, xmm_b, xmm_c, fallback_fn, fpcr_controlled);
-            ABI_PopCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+            ABI_PopRegistersAndAdjustStack(code, 0, occupied);
             code.add(rsp, 8);
             code.jmp(end, code.T_NEAR);
             code.SwitchToNearCode();
@@ -1293,9 +1407,10 @@ static void EmitRecipStepFused(BlockOfCode& code, EmitContext& ctx, IR::Inst* in
             code.SwitchToFarCode();
             code.L(fallback);
             code.sub(rsp, 8);
-            ABI_PushCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+            const std::vector<HostLoc> occupied = ctx.reg_alloc.OccupiedCallerSaveRegistersExcept(HostLocXmmIdx(result.getIdx()));
+            ABI_PushRegistersAndAdjustStack(code, 0, occupied);
             EmitThreeOpFallbackWithoutRegAlloc(code, ctx, result, operand1, operand2, fallback_fn, fpcr_controlled);
-            ABI_PopCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+            ABI_PopRegistersAndAdjustStack(code, 0, occupied);
             code.add(rsp, 8);
             code.jmp(end, code.T_NEAR);
             code.SwitchToNearCode();
@@ -1512,9 +1627,10 @@ static void EmitRSqrtStepFused(BlockOfCode& code, EmitContext& ctx, IR::Inst* in
             code.SwitchToFarCode();
             code.L(fallback);
             code.sub(rsp, 8);
-            ABI_PushCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+            const std::vector<HostLoc> occupied = ctx.reg_alloc.OccupiedCallerSaveRegistersExcept(HostLocXmmIdx(result.getIdx()));
+            ABI_PushRegistersAndAdjustStack(code, 0, occupied);
             EmitThreeOpFallbackWithoutRegAlloc(code, ctx, result, operand1, operand2, fallback_fn, fpcr_controlled);
-            ABI_PopCallerSaveRegistersAndAdjustStackExcept(code, HostLocXmmIdx(result.getIdx()));
+            ABI_PopRegistersAndAdjustStack(code, 0, occupied);
             code.add(rsp, 8);
             code.jmp(end, code.T_NEAR);
             code.SwitchToNearCode();
@@ -34,4 +34,24 @@ private:
     std::unique_ptr<Impl> impl;
 };
 
+/**
+ * Calls a callback with the faulting address on every access violation in the process, before
+ * any other handling. If the callback returns true, the faulting access is retried.
+ * This is used to detect writes to memory that has been made read-only with SetWritable.
+ */
+class WriteFaultHandler final {
+public:
+    explicit WriteFaultHandler(std::function<bool(u64)> cb);
+    ~WriteFaultHandler();
+
+    static bool IsSupported() noexcept;
+    /// Changes the protection of the host pages in [address, address + size) to read-only or read-write.
+    /// Any other protection the pages had is not preserved, so they must be read-write to begin with.
+    static void SetWritable(u64 address, size_t size, bool writable);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
 } // namespace Dynarmic::Backend::X64
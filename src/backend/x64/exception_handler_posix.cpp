@@ -5,13 +5,19 @@
 
 #include "backend/x64/exception_handler.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include <signal.h>
+#include <sys/mman.h>
 #ifdef __APPLE__
 #include <sys/ucontext.h>
 #else
@@ -40,6 +46,9 @@ public:
     void AddCodeBlock(CodeBlockInfo info);
     void RemoveCodeBlock(u64 rip);
 
+    void AddWriteFaultCallback(const std::function<bool(u64)>* cb);
+    void RemoveWriteFaultCallback(const std::function<bool(u64)>* cb);
+
     bool SupportsFastmem() const { return supports_fast_mem; }
 
 private:
@@ -54,6 +63,13 @@ private:
     std::vector<CodeBlockInfo> code_block_infos;
     std::mutex code_block_infos_mutex;
 
+    // Write fault callbacks are called without locking, as locking is not async-signal-safe.
+    // Slots are only written with the mutex held, and a callback is not destroyed while any
+    // signal handler may still be calling it.
+    static constexpr size_t max_write_fault_callbacks = 256;
+    std::array<std::atomic<const std::function<bool(u64)>*>, max_write_fault_callbacks> write_fault_callbacks{};
+    std::atomic<size_t> write_fault_callback_users{0};
+
     struct sigaction old_sa_segv;
     struct sigaction old_sa_bus;
 
@@ -63,7 +79,7 @@ private:
 SigHandler sig_handler;
 
 SigHandler::SigHandler() {
-    constexpr size_t signal_stack_size = std::max(SIGSTKSZ, 2 * 1024 * 1024);
+    const size_t signal_stack_size = std::max<size_t>(SIGSTKSZ, 2 * 1024 * 1024);
 
     signal_stack_memory = std::malloc(signal_stack_size);
 
@@ -117,6 +133,25 @@ void SigHandler::RemoveCodeBlock(u64 rip) {
     code_block_infos.erase(iter);
 }
 
+void SigHandler::AddWriteFaultCallback(const std::function<bool(u64)>* cb) {
+    std::lock_guard<std::mutex> guard(code_block_infos_mutex);
+    const auto iter = std::find(write_fault_callbacks.begin(), write_fault_callbacks.end(), nullptr);
+    ASSERT_MSG(iter != write_fault_callbacks.end(), "Too many write fault handlers");
+    iter->store(cb, std::memory_order_release);
+}
+
+void SigHandler::RemoveWriteFaultCallback(const std::function<bool(u64)>* cb) {
+    {
+        std::lock_guard<std::mutex> guard(code_block_infos_mutex);
+        std::find(write_fault_callbacks.begin(), write_fault_callbacks.end(), cb)->store(nullptr, std::memory_order_seq_cst);
+    }
+
+    // Signal handlers that started before the callback was removed may still be calling it.
+    while (write_fault_callback_users.load(std::memory_order_seq_cst) != 0) {
+        std::this_thread::yield();
+    }
+}
+
 void SigHandler::SigAction(int sig, siginfo_t* info, void* raw_context) {
     ASSERT(sig == SIGSEGV || sig == SIGBUS);
 
@@ -133,6 +168,21 @@ void SigHandler::SigAction(int sig, siginfo_t* info, void* raw_context) {
     #error "Unknown platform"
 #endif
 
+    {
+        // Every callback is called, as more than one may have protected the same page.
+        bool write_fault_handled = false;
+        sig_handler.write_fault_callback_users.fetch_add(1, std::memory_order_seq_cst);
+        for (const auto& slot : sig_handler.write_fault_callbacks) {
+            if (const auto* cb = slot.load(std::memory_order_seq_cst)) {
+                write_fault_handled |= (*cb)(Common::BitCast<u64>(info->si_addr));
+            }
+        }
+        sig_handler.write_fault_callback_users.fetch_sub(1, std::memory_order_seq_cst);
+        if (write_fault_handled) {
+            return;
+        }
+    }
+
     {
         std::lock_guard<std::mutex> guard(sig_handler.code_block_infos_mutex);
 
@@ -206,4 +256,30 @@ void ExceptionHandler::SetFastmemCallback(std::function<FakeCall(u64)> cb) {
     impl->SetCallback(cb);
 }
 
+struct WriteFaultHandler::Impl final {
+    explicit Impl(std::function<bool(u64)> cb_) : cb(std::move(cb_)) {
+        sig_handler.AddWriteFaultCallback(&cb);
+    }
+
+    ~Impl() {
+        sig_handler.RemoveWriteFaultCallback(&cb);
+    }
+
+private:
+    std::function<bool(u64)> cb;
+};
+
+WriteFaultHandler::WriteFaultHandler(std::function<bool(u64)> cb)
+        : impl(std::make_unique<Impl>(std::move(cb))) {}
+
+WriteFaultHandler::~WriteFaultHandler() = default;
+
+bool WriteFaultHandler::IsSupported() noexcept {
+    return sig_handler.SupportsFastmem();
+}
+
+void WriteFaultHandler::SetWritable(u64 address, size_t size, bool writable) {
+    mprotect(Common::BitCast<void*>(address), size, PROT_READ | (writable ? PROT_WRITE : 0));
+}
+
 } // namespace Dynarmic::Backend::X64
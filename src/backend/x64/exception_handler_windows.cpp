@@ -259,4 +259,21 @@ void ExceptionHandler::SetFastmemCallback(std::function<FakeCall(u64)> cb) {
     impl->SetCallback(cb);
 }
 
+struct WriteFaultHandler::Impl final {
+};
+
+WriteFaultHandler::WriteFaultHandler(std::function<bool(u64)>) {
+    // Do nothing
+}
+
+WriteFaultHandler::~WriteFaultHandler() = default;
+
+bool WriteFaultHandler::IsSupported() noexcept {
+    return false;
+}
+
+void WriteFaultHandler::SetWritable(u64, size_t, bool) {
+    // Do nothing
+}
+
 } // namespace Dynarmic::Backend::X64
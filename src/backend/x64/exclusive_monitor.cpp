@@ -3,57 +3,82 @@
  * SPDX-License-Identifier: 0BSD
  */
 
-#include <algorithm>
-
 #include <dynarmic/exclusive_monitor.h>
 #include "common/assert.h"
 
 namespace Dynarmic {
 
 ExclusiveMonitor::ExclusiveMonitor(size_t processor_count) :
-    exclusive_addresses(processor_count, INVALID_EXCLUSIVE_ADDRESS), exclusive_values(processor_count) {
-    Unlock();
-}
+    slots(std::make_unique<ProcessorSlot[]>(processor_count)),
+    granules(std::make_unique<Granule[]>(size_t(1) << GRANULE_TABLE_BITS)),
+    processor_count(processor_count) {}
 
 size_t ExclusiveMonitor::GetProcessorCount() const {
-    return exclusive_addresses.size();
+    return processor_count;
 }
 
-void ExclusiveMonitor::Lock() {
-    while (is_locked.test_and_set(std::memory_order_acquire)) {}
+void ExclusiveMonitor::Lock(Granule& granule) {
+    while (granule.is_locked.exchange(true, std::memory_order_acquire)) {
+        while (granule.is_locked.load(std::memory_order_relaxed)) {}
+    }
 }
 
-void ExclusiveMonitor::Unlock() {
-    is_locked.clear(std::memory_order_release);
+void ExclusiveMonitor::Unlock(Granule& granule) {
+    granule.is_locked.store(false, std::memory_order_release);
 }
 
-bool ExclusiveMonitor::CheckAndClear(size_t processor_id, VAddr address) {
-    const VAddr masked_address = address & RESERVATION_GRANULE_MASK;
-
-    Lock();
-    if (exclusive_addresses[processor_id] != masked_address) {
-        Unlock();
+bool ExclusiveMonitor::CheckAndClear(ProcessorSlot& slot, Granule& granule, VAddr masked_address) {
+    if (slot.address.exchange(INVALID_EXCLUSIVE_ADDRESS, std::memory_order_relaxed) != masked_address) {
         return false;
     }
+    if (slot.generation != granule.generation) {
+        return false;
+    }
+
+    granule.generation++;
+    InvalidateReservations(masked_address);
+    return true;
+}
+
+void ExclusiveMonitor::InvalidateReservations(VAddr masked_address) {
+    // Reservations made through ReadAndMark are invalidated by the granule generation alone.
+    // Only inline reservations, which cannot check the generation, need their slot cleared.
+    if (!has_inline_reservations.load(std::memory_order_acquire)) {
+        return;
+    }
 
-    for (VAddr& other_address : exclusive_addresses) {
-        if (other_address == masked_address) {
-            other_address = INVALID_EXCLUSIVE_ADDRESS;
+    for (size_t i = 0; i < processor_count; i++) {
+        // Only take the cache line for writing if the slot holds this reservation.
+        VAddr expected = slots[i].address.load(std::memory_order_relaxed);
+        if (expected == masked_address) {
+            slots[i].address.compare_exchange_strong(expected, INVALID_EXCLUSIVE_ADDRESS, std::memory_order_relaxed);
         }
     }
-    return true;
+}
+
+std::atomic<VAddr>* ExclusiveMonitor::GetReservationAddress(size_t processor_id) {
+    has_inline_reservations.store(true, std::memory_order_release);
+    return &slots[processor_id].address;
 }
 
 void ExclusiveMonitor::Clear() {
-    Lock();
-    std::fill(exclusive_addresses.begin(), exclusive_addresses.end(), INVALID_EXCLUSIVE_ADDRESS);
-    Unlock();
+    for (size_t i = 0; i < processor_count; i++) {
+        slots[i].address.store(INVALID_EXCLUSIVE_ADDRESS, std::memory_order_relaxed);
+    }
 }
 
 void ExclusiveMonitor::ClearProcessor(size_t processor_id) {
-    Lock();
-    exclusive_addresses[processor_id] = INVALID_EXCLUSIVE_ADDRESS;
-    Unlock();
+    slots[processor_id].address.store(INVALID_EXCLUSIVE_ADDRESS, std::memory_order_relaxed);
+}
+
+void ExclusiveMonitor::ClearAddress(VAddr address) {
+    const VAddr masked_address = address & RESERVATION_GRANULE_MASK;
+    Granule& granule = GetGranule(masked_address);
+
+    Lock(granule);
+    granule.generation++;
+    InvalidateReservations(masked_address);
+    Unlock(granule);
 }
 
 } // namespace Dynarmic
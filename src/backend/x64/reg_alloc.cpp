@@ -4,6 +4,7 @@
  */
 
 #include <algorithm>
+#include <iterator>
 #include <numeric>
 #include <utility>
 
@@ -82,6 +83,10 @@ bool HostLocInfo::IsLastUse() const {
     return is_being_used_count == 0 && current_references == 1 && accumulated_uses + 1 == total_uses;
 }
 
+bool HostLocInfo::IsUsedAfterCurrentInst() const {
+    return accumulated_uses + current_references < total_uses;
+}
+
 void HostLocInfo::ReadLock() {
     ASSERT(!is_scratch);
     is_being_used_count++;
@@ -232,7 +237,7 @@ RegAlloc::RegAlloc(BlockOfCode& code, size_t num_spills, std::function<Xbyak::Ad
 {}
 
 RegAlloc::ArgumentInfo RegAlloc::GetArgumentInfo(IR::Inst* inst) {
-    ArgumentInfo ret = {Argument{*this}, Argument{*this}, Argument{*this}, Argument{*this}};
+    ArgumentInfo ret = {Argument{*this}, Argument{*this}, Argument{*this}, Argument{*this}, Argument{*this}};
     for (size_t i = 0; i < inst->NumArgs(); i++) {
         const IR::Value arg = inst->GetArg(i);
         ret[i].value = arg;
@@ -438,6 +443,22 @@ void RegAlloc::HostCall(IR::Inst* result_def, std::optional<Argument::copyable_r
     }
 }
 
+std::vector<HostLoc> RegAlloc::LiveCallerSaveRegisters() const {
+    std::vector<HostLoc> live;
+    std::copy_if(ABI_ALL_CALLER_SAVE.begin(), ABI_ALL_CALLER_SAVE.end(), std::back_inserter(live), [this](HostLoc loc) {
+        return LocInfo(loc).IsUsedAfterCurrentInst();
+    });
+    return live;
+}
+
+std::vector<HostLoc> RegAlloc::OccupiedCallerSaveRegistersExcept(HostLoc exception) const {
+    std::vector<HostLoc> occupied;
+    std::copy_if(ABI_ALL_CALLER_SAVE.begin(), ABI_ALL_CALLER_SAVE.end(), std::back_inserter(occupied), [&](HostLoc loc) {
+        return loc != exception && !LocInfo(loc).IsEmpty();
+    });
+    return occupied;
+}
+
 void RegAlloc::EndOfAllocScope() {
     for (auto& iter : hostloc_info) {
         iter.ReleaseAll();
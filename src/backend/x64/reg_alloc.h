@@ -30,6 +30,7 @@ public:
     bool IsLocked() const;
     bool IsEmpty() const;
     bool IsLastUse() const;
+    bool IsUsedAfterCurrentInst() const;
 
     void ReadLock();
     void WriteLock();
@@ -125,6 +126,11 @@ public:
                   std::optional<Argument::copyable_reference> arg2 = {},
                   std::optional<Argument::copyable_reference> arg3 = {});
 
+    /// Caller-saved registers holding values that are still required after the current instruction.
+    std::vector<HostLoc> LiveCallerSaveRegisters() const;
+    /// Caller-saved registers that are in use by the current instruction or hold values, other than `exception`.
+    std::vector<HostLoc> OccupiedCallerSaveRegistersExcept(HostLoc exception) const;
+
     // TODO: Values in host flags
 
     void EndOfAllocScope();
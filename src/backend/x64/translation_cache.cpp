@@ -0,0 +1,250 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#include "backend/x64/translation_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+#include "frontend/ir/serialization.h"
+#include "translation_source_hash.h"
+
+namespace Dynarmic::Backend::X64 {
+
+namespace {
+
+constexpr std::array<char, 8> file_magic{'D', 'Y', 'N', 'T', 'C', 'A', 'C', 'H'};
+constexpr u32 file_version = 2;
+constexpr size_t header_size = file_magic.size() + sizeof(u32) + sizeof(u64) + sizeof(u64);
+
+u64 Checksum(const u8* data, size_t size) {
+    u64 hash = 0xCBF29CE484222325;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
+
+template<typename T>
+void Append(std::vector<u8>& buffer, T value) {
+    const size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+template<typename T>
+bool Extract(const std::vector<u8>& buffer, size_t& offset, size_t end, T& value) {
+    if (end - offset < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, buffer.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+std::vector<u8> MakeHeader() {
+    std::vector<u8> header(file_magic.begin(), file_magic.end());
+    Append(header, file_version);
+    Append(header, IR::SerializationFingerprint());
+    Append(header, u64{DYNARMIC_TRANSLATION_SOURCE_HASH});
+    return header;
+}
+
+} // anonymous namespace
+
+TranslationCache::TranslationCache(const std::string& path, u64 config_key, size_t size_limit)
+        : config_key(config_key), size_limit(size_limit) {
+    ReadFile(path);
+}
+
+TranslationCache::~TranslationCache() {
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+void TranslationCache::ReadFile(const std::string& path) {
+    std::vector<u8> contents;
+    if (std::ifstream in{path, std::ios::binary}) {
+        contents.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+    }
+
+    // Records are: u32 size, body, u64 checksum of body.
+    // A body is: u64 location, u64 config key, u32 word count, (u64 vaddr, u32 word) * count, serialized block.
+    const std::vector<u8> header = MakeHeader();
+    size_t valid_size = 0;
+    if (contents.size() >= header_size && std::equal(header.begin(), header.end(), contents.begin())) {
+        size_t offset = header_size;
+        valid_size = offset;
+        while (offset < contents.size()) {
+            u32 body_size = 0;
+            if (!Extract(contents, offset, contents.size(), body_size) || contents.size() - offset < size_t{body_size} + sizeof(u64)) {
+                break;
+            }
+
+            const size_t body_begin = offset;
+            const size_t body_end = body_begin + body_size;
+            u64 checksum = 0;
+            offset = body_end;
+            Extract(contents, offset, contents.size(), checksum);
+            if (checksum != Checksum(contents.data() + body_begin, body_size)) {
+                break;
+            }
+            valid_size = offset;
+
+            size_t body_offset = body_begin;
+            u64 location = 0, key = 0;
+            u32 word_count = 0;
+            Extract(contents, body_offset, body_end, location);
+            Extract(contents, body_offset, body_end, key);
+            if (!Extract(contents, body_offset, body_end, word_count) || key != config_key) {
+                continue;
+            }
+
+            auto entry = std::make_shared<Entry>();
+            bool ok = true;
+            for (u32 i = 0; i < word_count && ok; i++) {
+                u64 vaddr = 0;
+                u32 word = 0;
+                ok = Extract(contents, body_offset, body_end, vaddr) && Extract(contents, body_offset, body_end, word);
+                entry->code.emplace_back(vaddr, word);
+            }
+            if (!ok) {
+                continue;
+            }
+            entry->serialized_block.assign(contents.begin() + body_offset, contents.begin() + body_end);
+            AddEntry(location, std::move(entry));
+        }
+    }
+
+    if (valid_size == contents.size() && valid_size != 0 && valid_size < size_limit) {
+        file = std::fopen(path.c_str(), "ab");
+    } else if (valid_size == 0 || valid_size >= size_limit) {
+        // The file is missing, was written by an incompatible build, or is full.
+        // Entries read from a full file remain usable by this instance.
+        ReplaceFile(path, header.data(), header.size());
+    } else {
+        // The file ends in a partially written record: keep only the intact records.
+        ReplaceFile(path, contents.data(), valid_size);
+    }
+
+    if (file) {
+        // Each record is then appended with a single write, so that records appended
+        // concurrently by other processes do not interleave.
+        std::setvbuf(file, nullptr, _IONBF, 0);
+    }
+}
+
+void TranslationCache::ReplaceFile(const std::string& path, const u8* data, size_t size) {
+    // Other processes may be reading or appending to the file. Replacing it atomically
+    // means they only ever see a complete file; appends to the old file are lost.
+    const std::string temp_path = path + "." + std::to_string(std::random_device{}()) + ".tmp";
+    std::FILE* temp = std::fopen(temp_path.c_str(), "wb");
+    if (!temp) {
+        return;
+    }
+    const bool written = std::fwrite(data, 1, size, temp) == size;
+    if (std::fclose(temp) != 0 || !written) {
+        std::remove(temp_path.c_str());
+        return;
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        // Some hosts do not replace existing files on rename.
+        std::remove(path.c_str());
+        if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+            std::remove(temp_path.c_str());
+            return;
+        }
+    }
+    file = std::fopen(path.c_str(), "ab");
+}
+
+void TranslationCache::AddEntry(u64 location, std::shared_ptr<const Entry> entry) {
+    entries_size += entry->Size();
+    entry_order.emplace_back(location, entry);
+    entries[location].emplace_back(std::move(entry));
+
+    while (entries_size > size_limit && entry_order.size() > 1) {
+        const auto [oldest_location, oldest] = std::move(entry_order.front());
+        entry_order.pop_front();
+        entries_size -= oldest->Size();
+
+        const auto iter = entries.find(oldest_location);
+        auto& candidates = iter.value();
+        candidates.erase(std::find(candidates.begin(), candidates.end(), oldest));
+        if (candidates.empty()) {
+            entries.erase(iter);
+        }
+    }
+}
+
+std::optional<IR::Block> TranslationCache::Load(IR::LocationDescriptor location, const ReadCodeFunction& read_code) const {
+    std::vector<std::shared_ptr<const Entry>> candidates;
+    {
+        std::lock_guard lock{mutex};
+        const auto iter = entries.find(location.Value());
+        if (iter == entries.end()) {
+            return std::nullopt;
+        }
+        candidates = iter->second;
+    }
+
+    // Prefer the most recently stored entry.
+    for (auto iter = candidates.rbegin(); iter != candidates.rend(); ++iter) {
+        const Entry& entry = **iter;
+        const bool code_unchanged = std::all_of(entry.code.begin(), entry.code.end(), [&](const auto& pair) {
+            return read_code(pair.first) == pair.second;
+        });
+        if (!code_unchanged) {
+            continue;
+        }
+        if (auto block = IR::DeserializeBlock(location, entry.serialized_block.data(), entry.serialized_block.size())) {
+            return block;
+        }
+    }
+    return std::nullopt;
+}
+
+void TranslationCache::Store(const IR::Block& block, GuestCode code) {
+    std::sort(code.begin(), code.end());
+    code.erase(std::unique(code.begin(), code.end()), code.end());
+
+    auto entry = std::make_shared<Entry>();
+    entry->code = std::move(code);
+    entry->serialized_block = IR::SerializeBlock(block);
+
+    std::vector<u8> body;
+    Append(body, block.Location().Value());
+    Append(body, config_key);
+    Append(body, static_cast<u32>(entry->code.size()));
+    for (const auto& [vaddr, word] : entry->code) {
+        Append(body, vaddr);
+        Append(body, word);
+    }
+    body.insert(body.end(), entry->serialized_block.begin(), entry->serialized_block.end());
+
+    std::vector<u8> record;
+    Append(record, static_cast<u32>(body.size()));
+    record.insert(record.end(), body.begin(), body.end());
+    Append(record, Checksum(body.data(), body.size()));
+
+    std::lock_guard lock{mutex};
+    AddEntry(block.Location().Value(), std::move(entry));
+    if (!file || std::fseek(file, 0, SEEK_END) != 0) {
+        return;
+    }
+    const long file_size = std::ftell(file);
+    if (file_size < 0 || static_cast<size_t>(file_size) + record.size() > size_limit) {
+        return;
+    }
+    std::fwrite(record.data(), 1, record.size(), file);
+}
+
+} // namespace Dynarmic::Backend::X64
@@ -0,0 +1,82 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tsl/robin_map.h>
+
+#include "common/common_types.h"
+#include "frontend/ir/basic_block.h"
+#include "frontend/ir/location_descriptor.h"
+
+namespace Dynarmic::Backend::X64 {
+
+/**
+ * A persistent cache of optimized IR blocks, backed by a file that is appended to as blocks
+ * are translated. Entries are keyed by location descriptor and a key describing the
+ * translation-relevant configuration, and record every guest instruction word the
+ * translation depended on. An entry is only reused if all of those words are unchanged.
+ *
+ * Several processes may use the same file: each record is appended with a single write, and
+ * the file is only ever replaced as a whole. The file stops growing at `size_limit` bytes, and
+ * is started afresh by the next instance that opens it. Entries held in memory are limited
+ * to about the same size.
+ *
+ * Methods are safe to call concurrently.
+ */
+class TranslationCache {
+public:
+    using ReadCodeFunction = std::function<u32(u64 vaddr)>;
+    using GuestCode = std::vector<std::pair<u64, u32>>;
+
+    TranslationCache(const std::string& path, u64 config_key, size_t size_limit);
+    ~TranslationCache();
+
+    TranslationCache(const TranslationCache&) = delete;
+    TranslationCache& operator=(const TranslationCache&) = delete;
+
+    /// Returns the cached block for `location` if the guest code it was translated from is unchanged.
+    std::optional<IR::Block> Load(IR::LocationDescriptor location, const ReadCodeFunction& read_code) const;
+
+    /// Records `block`, translated from the (address, instruction word) pairs in `code`.
+    void Store(const IR::Block& block, GuestCode code);
+
+private:
+    struct Entry {
+        GuestCode code;
+        std::vector<u8> serialized_block;
+
+        size_t Size() const {
+            return code.size() * sizeof(GuestCode::value_type) + serialized_block.size();
+        }
+    };
+
+    void ReadFile(const std::string& path);
+    void ReplaceFile(const std::string& path, const u8* data, size_t size);
+    void AddEntry(u64 location, std::shared_ptr<const Entry> entry);
+
+    const u64 config_key;
+    const size_t size_limit;
+
+    mutable std::mutex mutex;
+    tsl::robin_map<u64, std::vector<std::shared_ptr<const Entry>>> entries;
+    /// Entries in the order they were added, so that the oldest are discarded first once their
+    /// total size exceeds `size_limit`.
+    std::deque<std::pair<u64, std::shared_ptr<const Entry>>> entry_order;
+    size_t entries_size = 0;
+    std::FILE* file = nullptr;
+};
+
+} // namespace Dynarmic::Backend::X64
@@ -0,0 +1,21 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+#include "frontend/ir/opcodes.h"
+
+namespace Dynarmic::Backend::X64 {
+
+/// Returns the number of times the C++ fallback of each vector opcode has run across all Jits,
+/// for opcodes whose fallback has run at all. Always empty unless built with
+/// DYNARMIC_COUNT_VECTOR_FALLBACKS.
+std::vector<std::pair<IR::Opcode, u64>> GetVectorFallbackCounts();
+
+} // namespace Dynarmic::Backend::X64
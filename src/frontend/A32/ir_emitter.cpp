@@ -250,6 +250,16 @@ IR::U64 IREmitter::ReadMemory64(const IR::U32& vaddr) {
     return current_location.EFlag() ? ByteReverseDual(value) : value;
 }
 
+std::pair<IR::U32, IR::U32> IREmitter::ReadMemoryWordPair(const IR::U32& vaddr) {
+    const auto value = Inst<IR::U64>(Opcode::A32ReadMemoryWide64, vaddr);
+    const auto first = LeastSignificantWord(value);
+    const auto second = MostSignificantWord(value).result;
+    if (current_location.EFlag()) {
+        return std::make_pair(ByteReverseWord(first), ByteReverseWord(second));
+    }
+    return std::make_pair(first, second);
+}
+
 IR::U8 IREmitter::ExclusiveReadMemory8(const IR::U32& vaddr) {
     return Inst<IR::U8>(Opcode::A32ExclusiveReadMemory8, vaddr);
 }
@@ -321,6 +331,14 @@ void IREmitter::WriteMemory64(const IR::U32& vaddr, const IR::U64& value) {
     }
 }
 
+void IREmitter::WriteMemoryWordPair(const IR::U32& vaddr, const IR::U32& first, const IR::U32& second) {
+    if (current_location.EFlag()) {
+        Inst(Opcode::A32WriteMemoryWide64, vaddr, Pack2x32To1x64(ByteReverseWord(first), ByteReverseWord(second)));
+    } else {
+        Inst(Opcode::A32WriteMemoryWide64, vaddr, Pack2x32To1x64(first, second));
+    }
+}
+
 IR::U32 IREmitter::ExclusiveWriteMemory8(const IR::U32& vaddr, const IR::U8& value) {
     return Inst<IR::U32>(Opcode::A32ExclusiveWriteMemory8, vaddr, value);
 }
@@ -81,6 +81,7 @@ public:
     IR::U16 ReadMemory16(const IR::U32& vaddr);
     IR::U32 ReadMemory32(const IR::U32& vaddr);
     IR::U64 ReadMemory64(const IR::U32& vaddr);
+    std::pair<IR::U32, IR::U32> ReadMemoryWordPair(const IR::U32& vaddr);
     IR::U8 ExclusiveReadMemory8(const IR::U32& vaddr);
     IR::U16 ExclusiveReadMemory16(const IR::U32& vaddr);
     IR::U32 ExclusiveReadMemory32(const IR::U32& vaddr);
@@ -90,6 +91,7 @@ public:
     void WriteMemory16(const IR::U32& vaddr, const IR::U16& value);
     void WriteMemory32(const IR::U32& vaddr, const IR::U32& value);
     void WriteMemory64(const IR::U32& vaddr, const IR::U64& value);
+    void WriteMemoryWordPair(const IR::U32& vaddr, const IR::U32& first, const IR::U32& second);
     IR::U32 ExclusiveWriteMemory8(const IR::U32& vaddr, const IR::U8& value);
     IR::U32 ExclusiveWriteMemory16(const IR::U32& vaddr, const IR::U16& value);
     IR::U32 ExclusiveWriteMemory32(const IR::U32& vaddr, const IR::U32& value);
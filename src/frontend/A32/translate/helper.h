@@ -12,6 +12,8 @@ namespace Dynarmic::A32::Helper {
 
 bool LDMHelper(A32::IREmitter& ir, bool W, Reg n, RegList list, IR::U32 start_address, IR::U32 writeback_address);
 bool STMHelper(A32::IREmitter& ir, bool W, Reg n, RegList list, IR::U32 start_address, IR::U32 writeback_address);
+void VLDMHelper(A32::IREmitter& ir, ExtReg d, size_t regs, IR::U32 address);
+void VSTMHelper(A32::IREmitter& ir, ExtReg d, size_t regs, IR::U32 address);
 void PKHHelper(A32::IREmitter& ir, bool tb, Reg d, IR::U32 n, IR::U32 shifted);
 void SSAT16Helper(A32::IREmitter& ir, Reg d, Reg n, size_t saturate_to);
 void SBFXHelper(A32::IREmitter& ir, Reg d, Reg n, u32 lsbit, u32 width_num);
@@ -5,21 +5,39 @@
 
 #include "frontend/A32/translate/helper.h"
 
+#include <utility>
+#include <vector>
+
 namespace Dynarmic::A32::Helper {
 
 bool LDMHelper(A32::IREmitter& ir, bool W, Reg n, RegList list, IR::U32 start_address, IR::U32 writeback_address) {
+    // Words are loaded in pairs, each pair with a single access.
+    std::vector<IR::U32> words;
     auto address = start_address;
+    for (size_t remaining = Common::BitCount(list); remaining > 0;) {
+        if (remaining >= 2) {
+            const auto [first, second] = ir.ReadMemoryWordPair(address);
+            words.push_back(first);
+            words.push_back(second);
+            address = ir.Add(address, ir.Imm32(8));
+            remaining -= 2;
+        } else {
+            words.push_back(ir.ReadMemory32(address));
+            remaining -= 1;
+        }
+    }
+
+    size_t word = 0;
     for (size_t i = 0; i <= 14; i++) {
         if (Common::Bit(i, list)) {
-            ir.SetRegister(static_cast<Reg>(i), ir.ReadMemory32(address));
-            address = ir.Add(address, ir.Imm32(4));
+            ir.SetRegister(static_cast<Reg>(i), words[word++]);
         }
     }
     if (W && !Common::Bit(RegNumber(n), list)) {
         ir.SetRegister(n, writeback_address);
     }
     if (Common::Bit<15>(list)) {
-        ir.LoadWritePC(ir.ReadMemory32(address));
+        ir.LoadWritePC(words[word]);
         if (n == Reg::R13) {
             ir.SetTerm(IR::Term::PopRSBHint{});
         } else {
@@ -31,22 +49,86 @@ bool LDMHelper(A32::IREmitter& ir, bool W, Reg n, RegList list, IR::U32 start_ad
 }
 
 bool STMHelper(A32::IREmitter& ir, bool W, Reg n, RegList list, IR::U32 start_address, IR::U32 writeback_address) {
-    auto address = start_address;
+    std::vector<IR::U32> words;
     for (size_t i = 0; i <= 14; i++) {
         if (Common::Bit(i, list)) {
-            ir.WriteMemory32(address, ir.GetRegister(static_cast<Reg>(i)));
-            address = ir.Add(address, ir.Imm32(4));
+            words.push_back(ir.GetRegister(static_cast<Reg>(i)));
+        }
+    }
+    if (Common::Bit<15>(list)) {
+        words.push_back(ir.Imm32(ir.PC()));
+    }
+
+    // Words are stored in pairs, each pair with a single access.
+    auto address = start_address;
+    for (size_t word = 0; word < words.size();) {
+        if (words.size() - word >= 2) {
+            ir.WriteMemoryWordPair(address, words[word], words[word + 1]);
+            address = ir.Add(address, ir.Imm32(8));
+            word += 2;
+        } else {
+            ir.WriteMemory32(address, words[word]);
+            word += 1;
         }
     }
     if (W) {
         ir.SetRegister(n, writeback_address);
     }
-    if (Common::Bit<15>(list)) {
-        ir.WriteMemory32(address, ir.Imm32(ir.PC()));
-    }
     return true;
 }
 
+void VLDMHelper(A32::IREmitter& ir, ExtReg d, size_t regs, IR::U32 address) {
+    if (IsDoubleExtReg(d)) {
+        for (size_t i = 0; i < regs; i++) {
+            auto [lo, hi] = ir.ReadMemoryWordPair(address);
+            if (ir.current_location.EFlag()) {
+                std::swap(lo, hi);
+            }
+            ir.SetExtendedRegister(d + i, ir.Pack2x32To1x64(lo, hi));
+            address = ir.Add(address, ir.Imm32(8));
+        }
+        return;
+    }
+
+    // Single registers are loaded in pairs, each pair with a single access.
+    for (size_t i = 0; i < regs; i += 2) {
+        if (regs - i >= 2) {
+            const auto [first, second] = ir.ReadMemoryWordPair(address);
+            ir.SetExtendedRegister(d + i, first);
+            ir.SetExtendedRegister(d + i + 1, second);
+            address = ir.Add(address, ir.Imm32(8));
+        } else {
+            ir.SetExtendedRegister(d + i, ir.ReadMemory32(address));
+        }
+    }
+}
+
+void VSTMHelper(A32::IREmitter& ir, ExtReg d, size_t regs, IR::U32 address) {
+    if (IsDoubleExtReg(d)) {
+        for (size_t i = 0; i < regs; i++) {
+            const auto value = ir.GetExtendedRegister(d + i);
+            auto lo = ir.LeastSignificantWord(value);
+            auto hi = ir.MostSignificantWord(value).result;
+            if (ir.current_location.EFlag()) {
+                std::swap(lo, hi);
+            }
+            ir.WriteMemoryWordPair(address, lo, hi);
+            address = ir.Add(address, ir.Imm32(8));
+        }
+        return;
+    }
+
+    // Single registers are stored in pairs, each pair with a single access.
+    for (size_t i = 0; i < regs; i += 2) {
+        if (regs - i >= 2) {
+            ir.WriteMemoryWordPair(address, ir.GetExtendedRegister(d + i), ir.GetExtendedRegister(d + i + 1));
+            address = ir.Add(address, ir.Imm32(8));
+        } else {
+            ir.WriteMemory32(address, ir.GetExtendedRegister(d + i));
+        }
+    }
+}
+
 void PKHHelper(A32::IREmitter& ir, bool tb, Reg d, IR::U32 n, IR::U32 shifted) {
     const auto lower_used = tb ? shifted : n;
     const auto upper_used = tb ? n : shifted;
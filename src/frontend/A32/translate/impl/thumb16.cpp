@@ -1072,17 +1072,9 @@ bool ThumbTranslatorVisitor::thumb16_STMIA(Reg n, RegList reg_list) {
         return UnpredictableInstruction();
     }
 
-    auto address = ir.GetRegister(n);
-    for (size_t i = 0; i < 8; i++) {
-        if (Common::Bit(i, reg_list)) {
-            const auto Ri = ir.GetRegister(static_cast<Reg>(i));
-            ir.WriteMemory32(address, Ri);
-            address = ir.Add(address, ir.Imm32(4));
-        }
-    }
-
-    ir.SetRegister(n, address);
-    return true;
+    const auto address = ir.GetRegister(n);
+    const auto final_address = ir.Add(address, ir.Imm32(static_cast<u32>(4 * Common::BitCount(reg_list))));
+    return Helper::STMHelper(ir, true, n, reg_list, address, final_address);
 }
 
 // LDM <Rn>!, <reg_list>
@@ -1094,21 +1086,9 @@ bool ThumbTranslatorVisitor::thumb16_LDMIA(Reg n, RegList reg_list) {
         return UnpredictableInstruction();
     }
 
-    const bool write_back = !Common::Bit(static_cast<size_t>(n), reg_list);
-    auto address = ir.GetRegister(n);
-
-    for (size_t i = 0; i < 8; i++) {
-        if (Common::Bit(i, reg_list)) {
-            const auto data = ir.ReadMemory32(address);
-            ir.SetRegister(static_cast<Reg>(i), data);
-            address = ir.Add(address, ir.Imm32(4));
-        }
-    }
-
-    if (write_back) {
-        ir.SetRegister(n, address);
-    }
-    return true;
+    const auto address = ir.GetRegister(n);
+    const auto final_address = ir.Add(address, ir.Imm32(static_cast<u32>(4 * Common::BitCount(reg_list))));
+    return Helper::LDMHelper(ir, true, n, reg_list, address, final_address);
 }
 
 // CB{N}Z <Rn>, <label>
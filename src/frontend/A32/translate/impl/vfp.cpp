@@ -1676,22 +1676,7 @@ bool ArmTranslatorVisitor::vfp_VPOP(Cond cond, bool D, size_t Vd, bool sz, Imm<8
     auto address = ir.GetRegister(Reg::SP);
     ir.SetRegister(Reg::SP, ir.Add(address, ir.Imm32(imm32)));
 
-    for (size_t i = 0; i < regs; ++i) {
-        if (sz) {
-            auto lo = ir.ReadMemory32(address);
-            address = ir.Add(address, ir.Imm32(4));
-            auto hi = ir.ReadMemory32(address);
-            address = ir.Add(address, ir.Imm32(4));
-            if (ir.current_location.EFlag()) {
-                std::swap(lo, hi);
-            }
-            ir.SetExtendedRegister(d + i, ir.Pack2x32To1x64(lo, hi));
-        } else {
-            const auto res = ir.ReadMemory32(address);
-            ir.SetExtendedRegister(d + i, res);
-            address = ir.Add(address, ir.Imm32(4));
-        }
-    }
+    Helper::VLDMHelper(ir, d, regs, address);
 
     return true;
 }
@@ -1717,22 +1702,7 @@ bool ThumbTranslatorVisitor::vfp_VPOP(bool D, size_t Vd, bool sz, Imm<8> imm8) {
     auto address = ir.GetRegister(Reg::SP);
     ir.SetRegister(Reg::SP, ir.Add(address, ir.Imm32(imm32)));
 
-    for (size_t i = 0; i < regs; ++i) {
-        if (sz) {
-            auto lo = ir.ReadMemory32(address);
-            address = ir.Add(address, ir.Imm32(4));
-            auto hi = ir.ReadMemory32(address);
-            address = ir.Add(address, ir.Imm32(4));
-            if (ir.current_location.EFlag()) {
-                std::swap(lo, hi);
-            }
-            ir.SetExtendedRegister(d + i, ir.Pack2x32To1x64(lo, hi));
-        } else {
-            const auto res = ir.ReadMemory32(address);
-            ir.SetExtendedRegister(d + i, res);
-            address = ir.Add(address, ir.Imm32(4));
-        }
-    }
+    Helper::VLDMHelper(ir, d, regs, address);
 
     return true;
 }
@@ -1758,21 +1728,7 @@ bool ArmTranslatorVisitor::vfp_VPUSH(Cond cond, bool D, size_t Vd, bool sz, Imm<
     auto address = ir.Sub(ir.GetRegister(Reg::SP), ir.Imm32(imm32));
     ir.SetRegister(Reg::SP, address);
 
-    for (size_t i = 0; i < regs; ++i) {
-        if (sz) {
-            const auto reg_d = ir.GetExtendedRegister(d + i);
-            auto lo = ir.LeastSignificantWord(reg_d);
-            auto hi = ir.MostSignificantWord(reg_d).result;
-            if (ir.current_location.EFlag()) std::swap(lo, hi);
-            ir.WriteMemory32(address, lo);
-            address = ir.Add(address, ir.Imm32(4));
-            ir.WriteMemory32(address, hi);
-            address = ir.Add(address, ir.Imm32(4));
-        } else {
-            ir.WriteMemory32(address, ir.GetExtendedRegister(d + i));
-            address = ir.Add(address, ir.Imm32(4));
-        }
-    }
+    Helper::VSTMHelper(ir, d, regs, address);
 
     return true;
 }
@@ -1798,21 +1754,7 @@ bool ThumbTranslatorVisitor::vfp_VPUSH(bool D, size_t Vd, bool sz, Imm<8> imm8)
     auto address = ir.Sub(ir.GetRegister(Reg::SP), ir.Imm32(imm32));
     ir.SetRegister(Reg::SP, address);
 
-    for (size_t i = 0; i < regs; ++i) {
-        if (sz) {
-            const auto reg_d = ir.GetExtendedRegister(d + i);
-            auto lo = ir.LeastSignificantWord(reg_d);
-            auto hi = ir.MostSignificantWord(reg_d).result;
-            if (ir.current_location.EFlag()) std::swap(lo, hi);
-            ir.WriteMemory32(address, lo);
-            address = ir.Add(address, ir.Imm32(4));
-            ir.WriteMemory32(address, hi);
-            address = ir.Add(address, ir.Imm32(4));
-        } else {
-            ir.WriteMemory32(address, ir.GetExtendedRegister(d + i));
-            address = ir.Add(address, ir.Imm32(4));
-        }
-    }
+    Helper::VSTMHelper(ir, d, regs, address);
 
     return true;
 }
@@ -1829,16 +1771,7 @@ bool ArmTranslatorVisitor::vfp_VLDR(Cond cond, bool U, bool D, Reg n, size_t Vd,
     const auto base = n == Reg::PC ? ir.Imm32(ir.AlignPC(4)) : ir.GetRegister(n);
     const auto address = U ? ir.Add(base, ir.Imm32(imm32)) : ir.Sub(base, ir.Imm32(imm32));
 
-    if (sz) {
-        auto lo = ir.ReadMemory32(address);
-        auto hi = ir.ReadMemory32(ir.Add(address, ir.Imm32(4)));
-        if (ir.current_location.EFlag()) {
-            std::swap(lo, hi);
-        }
-        ir.SetExtendedRegister(d, ir.Pack2x32To1x64(lo, hi));
-    } else {
-        ir.SetExtendedRegister(d, ir.ReadMemory32(address));
-    }
+    Helper::VLDMHelper(ir, d, 1, address);
 
     return true;
 }
@@ -1855,16 +1788,7 @@ bool ThumbTranslatorVisitor::vfp_VLDR(bool U, bool D, Reg n, size_t Vd, bool sz,
     const auto base = n == Reg::PC ? ir.Imm32(ir.AlignPC(4)) : ir.GetRegister(n);
     const auto address = U ? ir.Add(base, ir.Imm32(imm32)) : ir.Sub(base, ir.Imm32(imm32));
 
-    if (sz) {
-        auto lo = ir.ReadMemory32(address);
-        auto hi = ir.ReadMemory32(ir.Add(address, ir.Imm32(4)));
-        if (ir.current_location.EFlag()) {
-            std::swap(lo, hi);
-        }
-        ir.SetExtendedRegister(d, ir.Pack2x32To1x64(lo, hi));
-    } else {
-        ir.SetExtendedRegister(d, ir.ReadMemory32(address));
-    }
+    Helper::VLDMHelper(ir, d, 1, address);
 
     return true;
 }
@@ -1880,18 +1804,7 @@ bool ArmTranslatorVisitor::vfp_VSTR(Cond cond, bool U, bool D, Reg n, size_t Vd,
     const auto d = ToExtReg(sz, Vd, D);
     const auto base = n == Reg::PC ? ir.Imm32(ir.AlignPC(4)) : ir.GetRegister(n);
     const auto address = U ? ir.Add(base, ir.Imm32(imm32)) : ir.Sub(base, ir.Imm32(imm32));
-    if (sz) {
-        const auto reg_d = ir.GetExtendedRegister(d);
-        auto lo = ir.LeastSignificantWord(reg_d);
-        auto hi = ir.MostSignificantWord(reg_d).result;
-        if (ir.current_location.EFlag()) {
-            std::swap(lo, hi);
-        }
-        ir.WriteMemory32(address, lo);
-        ir.WriteMemory32(ir.Add(address, ir.Imm32(4)), hi);
-    } else {
-        ir.WriteMemory32(address, ir.GetExtendedRegister(d));
-    }
+    Helper::VSTMHelper(ir, d, 1, address);
 
     return true;
 }
@@ -1911,18 +1824,7 @@ bool ThumbTranslatorVisitor::vfp_VSTR(bool U, bool D, Reg n, size_t Vd, bool sz,
     const auto d = ToExtReg(sz, Vd, D);
     const auto base = n == Reg::PC ? ir.Imm32(ir.AlignPC(4)) : ir.GetRegister(n);
     const auto address = U ? ir.Add(base, ir.Imm32(imm32)) : ir.Sub(base, ir.Imm32(imm32));
-    if (sz) {
-        const auto reg_d = ir.GetExtendedRegister(d);
-        auto lo = ir.LeastSignificantWord(reg_d);
-        auto hi = ir.MostSignificantWord(reg_d).result;
-        if (ir.current_location.EFlag()) {
-            std::swap(lo, hi);
-        }
-        ir.WriteMemory32(address, lo);
-        ir.WriteMemory32(ir.Add(address, ir.Imm32(4)), hi);
-    } else {
-        ir.WriteMemory32(address, ir.GetExtendedRegister(d));
-    }
+    Helper::VSTMHelper(ir, d, 1, address);
 
     return true;
 }
@@ -1961,20 +1863,7 @@ bool ArmTranslatorVisitor::vfp_VSTM_a1(Cond cond, bool p, bool u, bool D, bool w
     if (w) {
         ir.SetRegister(n, u ? IR::U32(ir.Add(address, ir.Imm32(imm32))) : address);
     }
-    for (size_t i = 0; i < regs; i++) {
-        const auto value = ir.GetExtendedRegister(d + i);
-        auto word1 = ir.LeastSignificantWord(value);
-        auto word2 = ir.MostSignificantWord(value).result;
-
-        if (ir.current_location.EFlag()) {
-            std::swap(word1, word2);
-        }
-
-        ir.WriteMemory32(address, word1);
-        address = ir.Add(address, ir.Imm32(4));
-        ir.WriteMemory32(address, word2);
-        address = ir.Add(address, ir.Imm32(4));
-    }
+    Helper::VSTMHelper(ir, d, regs, address);
 
     return true;
 }
@@ -2012,20 +1901,7 @@ bool ThumbTranslatorVisitor::vfp_VSTM_a1(bool p, bool u, bool D, bool w, Reg n,
     if (w) {
         ir.SetRegister(n, u ? IR::U32(ir.Add(address, ir.Imm32(imm32))) : address);
     }
-    for (size_t i = 0; i < regs; i++) {
-        const auto value = ir.GetExtendedRegister(d + i);
-        auto word1 = ir.LeastSignificantWord(value);
-        auto word2 = ir.MostSignificantWord(value).result;
-
-        if (ir.current_location.EFlag()) {
-            std::swap(word1, word2);
-        }
-
-        ir.WriteMemory32(address, word1);
-        address = ir.Add(address, ir.Imm32(4));
-        ir.WriteMemory32(address, word2);
-        address = ir.Add(address, ir.Imm32(4));
-    }
+    Helper::VSTMHelper(ir, d, regs, address);
 
     return true;
 }
@@ -2064,11 +1940,7 @@ bool ArmTranslatorVisitor::vfp_VSTM_a2(Cond cond, bool p, bool u, bool D, bool w
     if (w) {
         ir.SetRegister(n, u ? IR::U32(ir.Add(address, ir.Imm32(imm32))) : address);
     }
-    for (size_t i = 0; i < regs; i++) {
-        const auto word = ir.GetExtendedRegister(d + i);
-        ir.WriteMemory32(address, word);
-        address = ir.Add(address, ir.Imm32(4));
-    }
+    Helper::VSTMHelper(ir, d, regs, address);
 
     return true;
 }
@@ -2106,11 +1978,7 @@ bool ThumbTranslatorVisitor::vfp_VSTM_a2(bool p, bool u, bool D, bool w, Reg n,
     if (w) {
         ir.SetRegister(n, u ? IR::U32(ir.Add(address, ir.Imm32(imm32))) : address);
     }
-    for (size_t i = 0; i < regs; i++) {
-        const auto word = ir.GetExtendedRegister(d + i);
-        ir.WriteMemory32(address, word);
-        address = ir.Add(address, ir.Imm32(4));
-    }
+    Helper::VSTMHelper(ir, d, regs, address);
 
     return true;
 }
@@ -2149,18 +2017,7 @@ bool ArmTranslatorVisitor::vfp_VLDM_a1(Cond cond, bool p, bool u, bool D, bool w
     if (w) {
         ir.SetRegister(n, u ? IR::U32(ir.Add(address, ir.Imm32(imm32))) : address);
     }
-    for (size_t i = 0; i < regs; i++) {
-        auto word1 = ir.ReadMemory32(address);
-        address = ir.Add(address, ir.Imm32(4));
-        auto word2 = ir.ReadMemory32(address);
-        address = ir.Add(address, ir.Imm32(4));
-
-        if (ir.current_location.EFlag()) {
-            std::swap(word1, word2);
-        }
-
-        ir.SetExtendedRegister(d + i, ir.Pack2x32To1x64(word1, word2));
-    }
+    Helper::VLDMHelper(ir, d, regs, address);
 
     return true;
 }
@@ -2198,18 +2055,7 @@ bool ThumbTranslatorVisitor::vfp_VLDM_a1(bool p, bool u, bool D, bool w, Reg n,
     if (w) {
         ir.SetRegister(n, u ? IR::U32(ir.Add(address, ir.Imm32(imm32))) : address);
     }
-    for (size_t i = 0; i < regs; i++) {
-        auto word1 = ir.ReadMemory32(address);
-        address = ir.Add(address, ir.Imm32(4));
-        auto word2 = ir.ReadMemory32(address);
-        address = ir.Add(address, ir.Imm32(4));
-
-        if (ir.current_location.EFlag()) {
-            std::swap(word1, word2);
-        }
-
-        ir.SetExtendedRegister(d + i, ir.Pack2x32To1x64(word1, word2));
-    }
+    Helper::VLDMHelper(ir, d, regs, address);
 
     return true;
 }
@@ -2248,11 +2094,7 @@ bool ArmTranslatorVisitor::vfp_VLDM_a2(Cond cond, bool p, bool u, bool D, bool w
     if (w) {
         ir.SetRegister(n, u ? IR::U32(ir.Add(address, ir.Imm32(imm32))) : address);
     }
-    for (size_t i = 0; i < regs; i++) {
-        const auto word = ir.ReadMemory32(address);
-        address = ir.Add(address, ir.Imm32(4));
-        ir.SetExtendedRegister(d + i, word);
-    }
+    Helper::VLDMHelper(ir, d, regs, address);
 
     return true;
 }
@@ -2290,11 +2132,7 @@ bool ThumbTranslatorVisitor::vfp_VLDM_a2(bool p, bool u, bool D, bool w, Reg n,
     if (w) {
         ir.SetRegister(n, u ? IR::U32(ir.Add(address, ir.Imm32(imm32))) : address);
     }
-    for (size_t i = 0; i < regs; i++) {
-        const auto word = ir.ReadMemory32(address);
-        address = ir.Add(address, ir.Imm32(4));
-        ir.SetExtendedRegister(d + i, word);
-    }
+    Helper::VLDMHelper(ir, d, regs, address);
 
     return true;
 }
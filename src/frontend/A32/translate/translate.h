@@ -34,6 +34,12 @@ struct TranslationOptions {
     /// If this is false, we treat the instruction as a NOP.
     /// If this is true, we emit an ExceptionRaised instruction.
     bool hook_hint_instructions = true;
+
+    /// This tells the translator to continue translating at the target of unconditional
+    /// direct branches instead of ending the block, so that optimization passes and
+    /// register allocation can operate across the branch. Only applies to ARM code.
+    /// Conditional branches and branches back into the block being translated still end it.
+    bool follow_direct_branches = false;
 };
 
 enum class ConditionalState {
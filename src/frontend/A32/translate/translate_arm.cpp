@@ -4,7 +4,9 @@
  */
 
 #include <algorithm>
+#include <optional>
 
+#include <boost/variant/get.hpp>
 #include <dynarmic/A32/config.h>
 
 #include "frontend/A32/decoder/arm.h"
@@ -29,12 +31,48 @@ static bool CondCanContinue(ConditionalState cond_state, const A32::IREmitter& i
     return std::all_of(ir.block.begin(), ir.block.end(), [](const IR::Inst& inst) { return !inst.WritesToCPSR(); });
 }
 
+/// Blocks are not extended by following branches once they reach this many instructions.
+constexpr size_t max_branch_following_block_size = 128;
+
+/// Only unconditional terminals are followed; If and CheckBit terminals end the block.
+static std::optional<LocationDescriptor> DirectBranchTarget(const IR::Terminal& terminal) {
+    if (const auto term = boost::get<IR::Term::LinkBlock>(&terminal)) {
+        return LocationDescriptor{term->next};
+    }
+    if (const auto term = boost::get<IR::Term::LinkBlockFast>(&terminal)) {
+        return LocationDescriptor{term->next};
+    }
+    return std::nullopt;
+}
+
 IR::Block TranslateArm(LocationDescriptor descriptor, const MemoryReadCodeFuncType& memory_read_code, const TranslationOptions& options) {
     const bool single_step = descriptor.SingleStepping();
 
     IR::Block block{descriptor};
     ArmTranslatorVisitor visitor{block, descriptor, options};
 
+    // Start of the contiguous range of guest code currently being translated,
+    // if a branch has been followed.
+    std::optional<LocationDescriptor> range_begin;
+    const auto is_translated = [&](u32 pc) {
+        const u32 current_begin = range_begin ? range_begin->PC() : descriptor.PC();
+        if (pc >= current_begin && pc < visitor.ir.current_location.PC()) {
+            return true;
+        }
+        if (!range_begin) {
+            return false;
+        }
+        if (pc >= descriptor.PC() && pc < LocationDescriptor{block.EndLocation()}.PC()) {
+            return true;
+        }
+        for (const auto& [begin, end] : block.FollowedRanges()) {
+            if (pc >= LocationDescriptor{begin}.PC() && pc < LocationDescriptor{end}.PC()) {
+                return true;
+            }
+        }
+        return false;
+    };
+
     bool should_continue = true;
     do {
         const u32 arm_pc = visitor.ir.current_location.PC();
@@ -56,6 +94,22 @@ IR::Block TranslateArm(LocationDescriptor descriptor, const MemoryReadCodeFuncTy
 
         visitor.ir.current_location = visitor.ir.current_location.AdvancePC(4);
         block.CycleCount()++;
+
+        if (!should_continue && options.follow_direct_branches && visitor.cond_state == ConditionalState::None && !single_step && block.CycleCount() < max_branch_following_block_size) {
+            const auto target = DirectBranchTarget(block.GetTerminal());
+            const auto is_same_state = [&] { return target->SetPC(visitor.ir.current_location.PC()) == visitor.ir.current_location; };
+            if (target && is_same_state() && !is_translated(target->PC())) {
+                if (range_begin) {
+                    block.AddFollowedRange(*range_begin, visitor.ir.current_location);
+                } else {
+                    block.SetEndLocation(visitor.ir.current_location);
+                }
+                block.ReplaceTerminal(IR::Term::Invalid{});
+                range_begin = *target;
+                visitor.ir.current_location = *target;
+                should_continue = true;
+            }
+        }
     } while (should_continue && CondCanContinue(visitor.cond_state, visitor.ir) && !single_step);
 
     if (visitor.cond_state == ConditionalState::Translating || visitor.cond_state == ConditionalState::Trailing || single_step) {
@@ -70,7 +124,11 @@ IR::Block TranslateArm(LocationDescriptor descriptor, const MemoryReadCodeFuncTy
 
     ASSERT_MSG(block.HasTerminal(), "Terminal has not been set");
 
-    block.SetEndLocation(visitor.ir.current_location);
+    if (range_begin) {
+        block.AddFollowedRange(*range_begin, visitor.ir.current_location);
+    } else {
+        block.SetEndLocation(visitor.ir.current_location);
+    }
 
     return block;
 }
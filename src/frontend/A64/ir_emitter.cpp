@@ -184,6 +184,62 @@ IR::U32 IREmitter::ExclusiveWriteMemory128(const IR::U64& vaddr, const IR::U128&
     return Inst<IR::U32>(Opcode::A64ExclusiveWriteMemory128, vaddr, value);
 }
 
+IR::U64 IREmitter::ReadMemoryWide64(const IR::U64& vaddr, size_t esize) {
+    return Inst<IR::U64>(Opcode::A64ReadMemoryWide64, vaddr, Imm8(static_cast<u8>(esize)));
+}
+
+IR::U128 IREmitter::ReadMemoryWide128(const IR::U64& vaddr, size_t esize) {
+    return Inst<IR::U128>(Opcode::A64ReadMemoryWide128, vaddr, Imm8(static_cast<u8>(esize)));
+}
+
+void IREmitter::WriteMemoryWide64(const IR::U64& vaddr, const IR::U64& value, size_t esize) {
+    Inst(Opcode::A64WriteMemoryWide64, vaddr, value, Imm8(static_cast<u8>(esize)));
+}
+
+void IREmitter::WriteMemoryWide128(const IR::U64& vaddr, const IR::U128& value, size_t esize) {
+    Inst(Opcode::A64WriteMemoryWide128, vaddr, value, Imm8(static_cast<u8>(esize)));
+}
+
+IR::U64 IREmitter::LookupPage(const IR::U64& vaddr) {
+    return Inst<IR::U64>(Opcode::A64LookupPage, vaddr);
+}
+
+IR::U8 IREmitter::AtomicCompareAndSwap8(const IR::U64& vaddr, const IR::U8& expected, const IR::U8& desired) {
+    return Inst<IR::U8>(Opcode::A64AtomicCompareAndSwap8, vaddr, expected, desired);
+}
+
+IR::U16 IREmitter::AtomicCompareAndSwap16(const IR::U64& vaddr, const IR::U16& expected, const IR::U16& desired) {
+    return Inst<IR::U16>(Opcode::A64AtomicCompareAndSwap16, vaddr, expected, desired);
+}
+
+IR::U32 IREmitter::AtomicCompareAndSwap32(const IR::U64& vaddr, const IR::U32& expected, const IR::U32& desired) {
+    return Inst<IR::U32>(Opcode::A64AtomicCompareAndSwap32, vaddr, expected, desired);
+}
+
+IR::U64 IREmitter::AtomicCompareAndSwap64(const IR::U64& vaddr, const IR::U64& expected, const IR::U64& desired) {
+    return Inst<IR::U64>(Opcode::A64AtomicCompareAndSwap64, vaddr, expected, desired);
+}
+
+IR::U128 IREmitter::AtomicCompareAndSwap128(const IR::U64& vaddr, const IR::U128& expected, const IR::U128& desired) {
+    return Inst<IR::U128>(Opcode::A64AtomicCompareAndSwap128, vaddr, expected, desired);
+}
+
+IR::U8 IREmitter::AtomicReadModifyWrite8(const IR::U64& vaddr, const IR::U8& value, IR::AtomicOp op) {
+    return Inst<IR::U8>(Opcode::A64AtomicReadModifyWrite8, vaddr, value, Imm8(static_cast<u8>(op)));
+}
+
+IR::U16 IREmitter::AtomicReadModifyWrite16(const IR::U64& vaddr, const IR::U16& value, IR::AtomicOp op) {
+    return Inst<IR::U16>(Opcode::A64AtomicReadModifyWrite16, vaddr, value, Imm8(static_cast<u8>(op)));
+}
+
+IR::U32 IREmitter::AtomicReadModifyWrite32(const IR::U64& vaddr, const IR::U32& value, IR::AtomicOp op) {
+    return Inst<IR::U32>(Opcode::A64AtomicReadModifyWrite32, vaddr, value, Imm8(static_cast<u8>(op)));
+}
+
+IR::U64 IREmitter::AtomicReadModifyWrite64(const IR::U64& vaddr, const IR::U64& value, IR::AtomicOp op) {
+    return Inst<IR::U64>(Opcode::A64AtomicReadModifyWrite64, vaddr, value, Imm8(static_cast<u8>(op)));
+}
+
 IR::U32 IREmitter::GetW(Reg reg) {
     if (reg == Reg::ZR)
         return Imm32(0);
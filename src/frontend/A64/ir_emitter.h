@@ -12,6 +12,7 @@
 #include "common/common_types.h"
 #include "frontend/A64/location_descriptor.h"
 #include "frontend/A64/types.h"
+#include "frontend/ir/atomic_op.h"
 #include "frontend/ir/ir_emitter.h"
 #include "frontend/ir/value.h"
 
@@ -75,6 +76,20 @@ public:
     IR::U32 ExclusiveWriteMemory32(const IR::U64& vaddr, const IR::U32& value);
     IR::U32 ExclusiveWriteMemory64(const IR::U64& vaddr, const IR::U64& value);
     IR::U32 ExclusiveWriteMemory128(const IR::U64& vaddr, const IR::U128& value);
+    IR::U64 ReadMemoryWide64(const IR::U64& vaddr, size_t esize);
+    IR::U128 ReadMemoryWide128(const IR::U64& vaddr, size_t esize);
+    void WriteMemoryWide64(const IR::U64& vaddr, const IR::U64& value, size_t esize);
+    void WriteMemoryWide128(const IR::U64& vaddr, const IR::U128& value, size_t esize);
+    IR::U64 LookupPage(const IR::U64& vaddr);
+    IR::U8 AtomicCompareAndSwap8(const IR::U64& vaddr, const IR::U8& expected, const IR::U8& desired);
+    IR::U16 AtomicCompareAndSwap16(const IR::U64& vaddr, const IR::U16& expected, const IR::U16& desired);
+    IR::U32 AtomicCompareAndSwap32(const IR::U64& vaddr, const IR::U32& expected, const IR::U32& desired);
+    IR::U64 AtomicCompareAndSwap64(const IR::U64& vaddr, const IR::U64& expected, const IR::U64& desired);
+    IR::U128 AtomicCompareAndSwap128(const IR::U64& vaddr, const IR::U128& expected, const IR::U128& desired);
+    IR::U8 AtomicReadModifyWrite8(const IR::U64& vaddr, const IR::U8& value, IR::AtomicOp op);
+    IR::U16 AtomicReadModifyWrite16(const IR::U64& vaddr, const IR::U16& value, IR::AtomicOp op);
+    IR::U32 AtomicReadModifyWrite32(const IR::U64& vaddr, const IR::U32& value, IR::AtomicOp op);
+    IR::U64 AtomicReadModifyWrite64(const IR::U64& vaddr, const IR::U64& value, IR::AtomicOp op);
 
     IR::U32 GetW(Reg source_reg);
     IR::U64 GetX(Reg source_reg);
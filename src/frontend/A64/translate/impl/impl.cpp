@@ -289,6 +289,38 @@ IR::U32 TranslatorVisitor::ExclusiveMem(IR::U64 address, size_t bytesize, IR::Ac
     }
 }
 
+IR::UAny TranslatorVisitor::AtomicMem(IR::U64 address, size_t bytesize, IR::AccType /*acctype*/, IR::UAny value, IR::AtomicOp op) {
+    switch (bytesize) {
+    case 1:
+        return ir.AtomicReadModifyWrite8(address, value, op);
+    case 2:
+        return ir.AtomicReadModifyWrite16(address, value, op);
+    case 4:
+        return ir.AtomicReadModifyWrite32(address, value, op);
+    case 8:
+        return ir.AtomicReadModifyWrite64(address, value, op);
+    default:
+        ASSERT_FALSE("Invalid bytesize parameter {}", bytesize);
+    }
+}
+
+IR::UAnyU128 TranslatorVisitor::CompareAndSwapMem(IR::U64 address, size_t bytesize, IR::AccType /*acctype*/, IR::UAnyU128 expected, IR::UAnyU128 desired) {
+    switch (bytesize) {
+    case 1:
+        return ir.AtomicCompareAndSwap8(address, expected, desired);
+    case 2:
+        return ir.AtomicCompareAndSwap16(address, expected, desired);
+    case 4:
+        return ir.AtomicCompareAndSwap32(address, expected, desired);
+    case 8:
+        return ir.AtomicCompareAndSwap64(address, expected, desired);
+    case 16:
+        return ir.AtomicCompareAndSwap128(address, expected, desired);
+    default:
+        ASSERT_FALSE("Invalid bytesize parameter {}", bytesize);
+    }
+}
+
 IR::U32U64 TranslatorVisitor::SignExtend(IR::UAny value, size_t to_size) {
     switch (to_size) {
     case 32:
@@ -58,6 +58,8 @@ struct TranslatorVisitor final {
     void Mem(IR::U64 address, size_t size, IR::AccType acctype, IR::UAnyU128 value);
     IR::UAnyU128 ExclusiveMem(IR::U64 address, size_t size, IR::AccType acctype);
     IR::U32 ExclusiveMem(IR::U64 address, size_t size, IR::AccType acctype, IR::UAnyU128 value);
+    IR::UAny AtomicMem(IR::U64 address, size_t size, IR::AccType acctype, IR::UAny value, IR::AtomicOp op);
+    IR::UAnyU128 CompareAndSwapMem(IR::U64 address, size_t size, IR::AccType acctype, IR::UAnyU128 expected, IR::UAnyU128 desired);
 
     IR::U32U64 SignExtend(IR::UAny value, size_t to_size);
     IR::U32U64 ZeroExtend(IR::UAny value, size_t to_size);
@@ -312,16 +314,16 @@ struct TranslatorVisitor final {
     bool LDUMINH(bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
     bool SWPH(bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
     bool LDAPRH(Reg Rn, Reg Rt);
-    bool LDADD(bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
-    bool LDCLR(bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
-    bool LDEOR(bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
-    bool LDSET(bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
-    bool LDSMAX(bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
-    bool LDSMIN(bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
-    bool LDUMAX(bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
-    bool LDUMIN(bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
-    bool SWP(bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
-    bool LDAPR(Reg Rn, Reg Rt);
+    bool LDADD(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
+    bool LDCLR(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
+    bool LDEOR(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
+    bool LDSET(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
+    bool LDSMAX(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
+    bool LDSMIN(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
+    bool LDUMAX(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
+    bool LDUMIN(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
+    bool SWP(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt);
+    bool LDAPR(bool sz, Reg Rn, Reg Rt);
 
     // Loads and stores - Load/Store register (register offset)
     bool STRx_reg(Imm<2> size, Imm<1> opc_1, Reg Rm, Imm<3> option, bool S, Reg Rn, Reg Rt);
@@ -0,0 +1,166 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#include "frontend/A64/translate/impl/impl.h"
+
+namespace Dynarmic::A64 {
+
+static bool AtomicMemoryOperation(TranslatorVisitor& v, size_t datasize, bool A, bool R, Reg Rs, Reg Rn, Reg Rt, IR::AtomicOp op) {
+    const auto acctype = A || R ? IR::AccType::ORDEREDRW : IR::AccType::ATOMIC;
+    const size_t regsize = datasize == 64 ? 64 : 32;
+    const size_t dbytes = datasize / 8;
+
+    IR::U64 address;
+    if (Rn == Reg::SP) {
+        // TODO: Check SP Alignment
+        address = v.SP(64);
+    } else {
+        address = v.X(64, Rn);
+    }
+
+    const IR::UAny value = v.X(datasize, Rs);
+    const IR::UAny data = v.AtomicMem(address, dbytes, acctype, value, op);
+    v.X(regsize, Rt, v.ZeroExtend(data, regsize));
+    return true;
+}
+
+static bool LoadAcquirePCOrdered(TranslatorVisitor& v, size_t datasize, Reg Rn, Reg Rt) {
+    const size_t regsize = datasize == 64 ? 64 : 32;
+    const size_t dbytes = datasize / 8;
+
+    IR::U64 address;
+    if (Rn == Reg::SP) {
+        // TODO: Check SP Alignment
+        address = v.SP(64);
+    } else {
+        address = v.X(64, Rn);
+    }
+
+    const IR::UAny data = v.Mem(address, dbytes, IR::AccType::ORDERED);
+    v.X(regsize, Rt, v.ZeroExtend(data, regsize));
+    return true;
+}
+
+bool TranslatorVisitor::LDADDB(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 8, A, R, Rs, Rn, Rt, IR::AtomicOp::Add);
+}
+
+bool TranslatorVisitor::LDCLRB(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 8, A, R, Rs, Rn, Rt, IR::AtomicOp::Clear);
+}
+
+bool TranslatorVisitor::LDEORB(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 8, A, R, Rs, Rn, Rt, IR::AtomicOp::Eor);
+}
+
+bool TranslatorVisitor::LDSETB(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 8, A, R, Rs, Rn, Rt, IR::AtomicOp::Set);
+}
+
+bool TranslatorVisitor::LDSMAXB(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 8, A, R, Rs, Rn, Rt, IR::AtomicOp::SignedMax);
+}
+
+bool TranslatorVisitor::LDSMINB(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 8, A, R, Rs, Rn, Rt, IR::AtomicOp::SignedMin);
+}
+
+bool TranslatorVisitor::LDUMAXB(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 8, A, R, Rs, Rn, Rt, IR::AtomicOp::UnsignedMax);
+}
+
+bool TranslatorVisitor::LDUMINB(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 8, A, R, Rs, Rn, Rt, IR::AtomicOp::UnsignedMin);
+}
+
+bool TranslatorVisitor::SWPB(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 8, A, R, Rs, Rn, Rt, IR::AtomicOp::Swap);
+}
+
+bool TranslatorVisitor::LDAPRB(Reg Rn, Reg Rt) {
+    return LoadAcquirePCOrdered(*this, 8, Rn, Rt);
+}
+
+bool TranslatorVisitor::LDADDH(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 16, A, R, Rs, Rn, Rt, IR::AtomicOp::Add);
+}
+
+bool TranslatorVisitor::LDCLRH(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 16, A, R, Rs, Rn, Rt, IR::AtomicOp::Clear);
+}
+
+bool TranslatorVisitor::LDEORH(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 16, A, R, Rs, Rn, Rt, IR::AtomicOp::Eor);
+}
+
+bool TranslatorVisitor::LDSETH(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 16, A, R, Rs, Rn, Rt, IR::AtomicOp::Set);
+}
+
+bool TranslatorVisitor::LDSMAXH(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 16, A, R, Rs, Rn, Rt, IR::AtomicOp::SignedMax);
+}
+
+bool TranslatorVisitor::LDSMINH(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 16, A, R, Rs, Rn, Rt, IR::AtomicOp::SignedMin);
+}
+
+bool TranslatorVisitor::LDUMAXH(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 16, A, R, Rs, Rn, Rt, IR::AtomicOp::UnsignedMax);
+}
+
+bool TranslatorVisitor::LDUMINH(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 16, A, R, Rs, Rn, Rt, IR::AtomicOp::UnsignedMin);
+}
+
+bool TranslatorVisitor::SWPH(bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, 16, A, R, Rs, Rn, Rt, IR::AtomicOp::Swap);
+}
+
+bool TranslatorVisitor::LDAPRH(Reg Rn, Reg Rt) {
+    return LoadAcquirePCOrdered(*this, 16, Rn, Rt);
+}
+
+bool TranslatorVisitor::LDADD(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, sz ? 64 : 32, A, R, Rs, Rn, Rt, IR::AtomicOp::Add);
+}
+
+bool TranslatorVisitor::LDCLR(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, sz ? 64 : 32, A, R, Rs, Rn, Rt, IR::AtomicOp::Clear);
+}
+
+bool TranslatorVisitor::LDEOR(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, sz ? 64 : 32, A, R, Rs, Rn, Rt, IR::AtomicOp::Eor);
+}
+
+bool TranslatorVisitor::LDSET(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, sz ? 64 : 32, A, R, Rs, Rn, Rt, IR::AtomicOp::Set);
+}
+
+bool TranslatorVisitor::LDSMAX(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, sz ? 64 : 32, A, R, Rs, Rn, Rt, IR::AtomicOp::SignedMax);
+}
+
+bool TranslatorVisitor::LDSMIN(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, sz ? 64 : 32, A, R, Rs, Rn, Rt, IR::AtomicOp::SignedMin);
+}
+
+bool TranslatorVisitor::LDUMAX(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, sz ? 64 : 32, A, R, Rs, Rn, Rt, IR::AtomicOp::UnsignedMax);
+}
+
+bool TranslatorVisitor::LDUMIN(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, sz ? 64 : 32, A, R, Rs, Rn, Rt, IR::AtomicOp::UnsignedMin);
+}
+
+bool TranslatorVisitor::SWP(bool sz, bool A, bool R, Reg Rs, Reg Rn, Reg Rt) {
+    return AtomicMemoryOperation(*this, sz ? 64 : 32, A, R, Rs, Rn, Rt, IR::AtomicOp::Swap);
+}
+
+bool TranslatorVisitor::LDAPR(bool sz, Reg Rn, Reg Rt) {
+    return LoadAcquirePCOrdered(*this, sz ? 64 : 32, Rn, Rt);
+}
+
+} // namespace Dynarmic::A64
@@ -4,6 +4,7 @@
  */
 
 #include <optional>
+#include <vector>
 
 #include "frontend/A64/translate/impl/impl.h"
 
@@ -62,36 +63,124 @@ static bool SharedDecodeAndOperation(TranslatorVisitor& v, bool wback, IR::MemOp
         address = v.X(64, Rn);
     }
 
-    IR::U64 offs = v.ir.Imm64(0);
-    if (selem == 1) {
-        for (size_t r = 0; r < rpt; r++) {
-            const Vec tt = static_cast<Vec>((VecNumber(Vt) + r) % 32);
-            if (memop == IR::MemOp::LOAD) {
-                const IR::UAnyU128 vec = v.Mem(v.ir.Add(address, offs), ebytes * elements, IR::AccType::VEC);
-                v.V_scalar(datasize, tt, vec);
+    const size_t dbytes = datasize / 8;
+    const size_t total_bytes = dbytes * rpt * selem;
+    const size_t chunk_count = (total_bytes + 15) / 16;
+    const size_t elements_per_chunk = 16 / ebytes;
+    const auto reg = [&](size_t i) { return static_cast<Vec>((VecNumber(Vt) + i) % 32); };
+    const auto chunk_address_of = [&](size_t c) -> IR::U64 { return c == 0 ? address : IR::U64{v.ir.Add(address, v.ir.Imm64(c * 16))}; };
+
+    // The architectural accesses are of whole registers for LD1/ST1 and of single elements otherwise.
+    const size_t access_size = selem == 1 ? datasize : esize;
+
+    // The whole structure is transferred as contiguous 128-bit chunks (and a final 64-bit chunk),
+    // which are then (de)interleaved into registers.
+    std::vector<IR::U128> chunks(chunk_count);
+
+    if (memop == IR::MemOp::LOAD) {
+        for (size_t c = 0; c < chunk_count; c++) {
+            const IR::U64 chunk_address = chunk_address_of(c);
+            if (total_bytes - c * 16 >= 16) {
+                chunks[c] = access_size == 128 ? v.ir.ReadMemory128(chunk_address) : v.ir.ReadMemoryWide128(chunk_address, access_size);
             } else {
-                const IR::UAnyU128 vec = v.V_scalar(datasize, tt);
-                v.Mem(v.ir.Add(address, offs), ebytes * elements, IR::AccType::VEC, vec);
+                const IR::U64 data = access_size == 64 ? v.ir.ReadMemory64(chunk_address) : v.ir.ReadMemoryWide64(chunk_address, access_size);
+                chunks[c] = v.ir.ZeroExtendToQuad(data);
             }
-            offs = v.ir.Add(offs, v.ir.Imm64(ebytes * elements));
         }
-    } else {
-        for (size_t e = 0; e < elements; e++) {
+
+        std::vector<IR::U128> regs(rpt * selem);
+        if (selem == 1) {
+            for (size_t r = 0; r < rpt; r++) {
+                regs[r] = Q ? chunks[r] : v.ir.ZeroExtendToQuad(v.ir.VectorGetElement(64, chunks[r / 2], r % 2));
+            }
+        } else if (selem == 2) {
+            const IR::U128 hi = Q ? chunks[1] : chunks[0];
+            regs[0] = v.ir.VectorDeinterleaveEven(esize, chunks[0], hi);
+            regs[1] = v.ir.VectorDeinterleaveOdd(esize, chunks[0], hi);
+        } else if (selem == 4) {
+            const IR::U128 even_lo = v.ir.VectorDeinterleaveEven(esize, chunks[0], chunks[1]);
+            const IR::U128 odd_lo = v.ir.VectorDeinterleaveOdd(esize, chunks[0], chunks[1]);
+            const IR::U128 even_hi = Q ? v.ir.VectorDeinterleaveEven(esize, chunks[2], chunks[3]) : even_lo;
+            const IR::U128 odd_hi = Q ? v.ir.VectorDeinterleaveOdd(esize, chunks[2], chunks[3]) : odd_lo;
+            regs[0] = v.ir.VectorDeinterleaveEven(esize, even_lo, even_hi);
+            regs[1] = v.ir.VectorDeinterleaveEven(esize, odd_lo, odd_hi);
+            regs[2] = v.ir.VectorDeinterleaveOdd(esize, even_lo, even_hi);
+            regs[3] = v.ir.VectorDeinterleaveOdd(esize, odd_lo, odd_hi);
+        } else {
             for (size_t s = 0; s < selem; s++) {
-                const Vec tt = static_cast<Vec>((VecNumber(Vt) + s) % 32);
-                if (memop == IR::MemOp::LOAD) {
-                    const IR::UAny elem = v.Mem(v.ir.Add(address, offs), ebytes, IR::AccType::VEC);
-                    const IR::U128 vec = v.ir.VectorSetElement(esize, v.V(datasize, tt), e, elem);
-                    v.V(datasize, tt, vec);
+                regs[s] = v.ir.ZeroVector();
+                for (size_t e = 0; e < elements; e++) {
+                    const size_t i = e * selem + s;
+                    const IR::UAny elem = v.ir.VectorGetElement(esize, chunks[i / elements_per_chunk], i % elements_per_chunk);
+                    regs[s] = v.ir.VectorSetElement(esize, regs[s], e, elem);
+                }
+            }
+        }
+
+        for (size_t r = 0; r < regs.size(); r++) {
+            v.V(datasize, reg(r), regs[r]);
+        }
+    } else {
+        std::vector<IR::U128> regs(rpt * selem);
+        for (size_t r = 0; r < regs.size(); r++) {
+            regs[r] = v.V(128, reg(r));
+        }
+
+        if (selem == 1) {
+            for (size_t c = 0; c < chunk_count; c++) {
+                const bool has_pair = 2 * c + 1 < rpt;
+                chunks[c] = Q ? regs[c] : has_pair ? v.ir.VectorInterleaveLower(64, regs[2 * c], regs[2 * c + 1]) : regs[2 * c];
+            }
+        } else if (selem == 2) {
+            chunks[0] = v.ir.VectorInterleaveLower(esize, regs[0], regs[1]);
+            if (Q) {
+                chunks[1] = v.ir.VectorInterleaveUpper(esize, regs[0], regs[1]);
+            }
+        } else if (selem == 4) {
+            const IR::U128 lo_02 = v.ir.VectorInterleaveLower(esize, regs[0], regs[2]);
+            const IR::U128 lo_13 = v.ir.VectorInterleaveLower(esize, regs[1], regs[3]);
+            chunks[0] = v.ir.VectorInterleaveLower(esize, lo_02, lo_13);
+            chunks[1] = v.ir.VectorInterleaveUpper(esize, lo_02, lo_13);
+            if (Q) {
+                const IR::U128 hi_02 = v.ir.VectorInterleaveUpper(esize, regs[0], regs[2]);
+                const IR::U128 hi_13 = v.ir.VectorInterleaveUpper(esize, regs[1], regs[3]);
+                chunks[2] = v.ir.VectorInterleaveLower(esize, hi_02, hi_13);
+                chunks[3] = v.ir.VectorInterleaveUpper(esize, hi_02, hi_13);
+            }
+        } else {
+            for (size_t c = 0; c < chunk_count; c++) {
+                chunks[c] = v.ir.ZeroVector();
+            }
+            for (size_t e = 0; e < elements; e++) {
+                for (size_t s = 0; s < selem; s++) {
+                    const size_t i = e * selem + s;
+                    const IR::UAny elem = v.ir.VectorGetElement(esize, regs[s], e);
+                    chunks[i / elements_per_chunk] = v.ir.VectorSetElement(esize, chunks[i / elements_per_chunk], i % elements_per_chunk, elem);
+                }
+            }
+        }
+
+        for (size_t c = 0; c < chunk_count; c++) {
+            const IR::U64 chunk_address = chunk_address_of(c);
+            if (total_bytes - c * 16 >= 16) {
+                if (access_size == 128) {
+                    v.ir.WriteMemory128(chunk_address, chunks[c]);
+                } else {
+                    v.ir.WriteMemoryWide128(chunk_address, chunks[c], access_size);
+                }
+            } else {
+                const IR::U64 data{v.ir.VectorGetElement(64, chunks[c], 0)};
+                if (access_size == 64) {
+                    v.ir.WriteMemory64(chunk_address, data);
                 } else {
-                    const IR::UAny elem = v.ir.VectorGetElement(esize, v.V(datasize, tt), e);
-                    v.Mem(v.ir.Add(address, offs), ebytes, IR::AccType::VEC, elem);
+                    v.ir.WriteMemoryWide64(chunk_address, data, access_size);
                 }
-                offs = v.ir.Add(offs, v.ir.Imm64(ebytes));
             }
         }
     }
 
+    IR::U64 offs = v.ir.Imm64(total_bytes);
+
     if (wback) {
         if (*Rm != Reg::SP) {
             offs = v.X(64, *Rm);
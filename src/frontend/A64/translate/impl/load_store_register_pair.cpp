@@ -41,18 +41,27 @@ bool TranslatorVisitor::STP_LDP_gen(Imm<2> opc, bool not_postindex, bool wback,
         address = ir.Add(address, ir.Imm64(offset));
     }
 
-    const size_t dbytes = datasize / 8;
+    // Both registers are transferred with a single wide access.
     switch (memop) {
     case IR::MemOp::STORE: {
-        const IR::U32U64 data1 = X(datasize, Rt);
-        const IR::U32U64 data2 = X(datasize, Rt2);
-        Mem(address, dbytes, IR::AccType::NORMAL, data1);
-        Mem(ir.Add(address, ir.Imm64(dbytes)), dbytes, IR::AccType::NORMAL, data2);
+        if (datasize == 32) {
+            ir.WriteMemoryWide64(address, ir.Pack2x32To1x64(X(32, Rt), X(32, Rt2)), datasize);
+        } else {
+            ir.WriteMemoryWide128(address, ir.Pack2x64To1x128(X(64, Rt), X(64, Rt2)), datasize);
+        }
         break;
     }
     case IR::MemOp::LOAD: {
-        const IR::U32U64 data1 = Mem(address, dbytes, IR::AccType::NORMAL);
-        const IR::U32U64 data2 = Mem(ir.Add(address, ir.Imm64(dbytes)), dbytes, IR::AccType::NORMAL);
+        IR::U32U64 data1, data2;
+        if (datasize == 32) {
+            const IR::U64 data = ir.ReadMemoryWide64(address, datasize);
+            data1 = ir.LeastSignificantWord(data);
+            data2 = ir.MostSignificantWord(data).result;
+        } else {
+            const IR::U128 data = ir.ReadMemoryWide128(address, datasize);
+            data1 = IR::U64{ir.VectorGetElement(64, data, 0)};
+            data2 = IR::U64{ir.VectorGetElement(64, data, 1)};
+        }
         if (signed_) {
             X(64, Rt, SignExtend(data1, 64));
             X(64, Rt2, SignExtend(data2, 64));
@@ -109,24 +118,34 @@ bool TranslatorVisitor::STP_LDP_fpsimd(Imm<2> opc, bool not_postindex, bool wbac
         address = ir.Add(address, ir.Imm64(offset));
     }
 
+    // Pairs of S and D registers are transferred with a single wide access.
     switch (memop) {
     case IR::MemOp::STORE: {
-        IR::UAnyU128 data1 = V(datasize, Vt);
-        IR::UAnyU128 data2 = V(datasize, Vt2);
-        if (datasize != 128) {
-            data1 = ir.VectorGetElement(datasize, data1, 0);
-            data2 = ir.VectorGetElement(datasize, data2, 0);
+        if (datasize == 32) {
+            const IR::U32 data1{ir.VectorGetElement(32, V(32, Vt), 0)};
+            const IR::U32 data2{ir.VectorGetElement(32, V(32, Vt2), 0)};
+            ir.WriteMemoryWide64(address, ir.Pack2x32To1x64(data1, data2), datasize);
+        } else if (datasize == 64) {
+            ir.WriteMemoryWide128(address, ir.VectorInterleaveLower(64, V(128, Vt), V(128, Vt2)), datasize);
+        } else {
+            Mem(address, dbytes, IR::AccType::VEC, V(128, Vt));
+            Mem(ir.Add(address, ir.Imm64(dbytes)), dbytes, IR::AccType::VEC, V(128, Vt2));
         }
-        Mem(address, dbytes, IR::AccType::VEC, data1);
-        Mem(ir.Add(address, ir.Imm64(dbytes)), dbytes, IR::AccType::VEC, data2);
         break;
     }
     case IR::MemOp::LOAD: {
-        IR::UAnyU128 data1 = Mem(address, dbytes, IR::AccType::VEC);
-        IR::UAnyU128 data2 = Mem(ir.Add(address, ir.Imm64(dbytes)), dbytes, IR::AccType::VEC);
-        if (datasize != 128) {
-            data1 = ir.ZeroExtendToQuad(data1);
-            data2 = ir.ZeroExtendToQuad(data2);
+        IR::U128 data1, data2;
+        if (datasize == 32) {
+            const IR::U64 data = ir.ReadMemoryWide64(address, datasize);
+            data1 = ir.ZeroExtendToQuad(ir.LeastSignificantWord(data));
+            data2 = ir.ZeroExtendToQuad(ir.MostSignificantWord(data).result);
+        } else if (datasize == 64) {
+            const IR::U128 data = ir.ReadMemoryWide128(address, datasize);
+            data1 = data;
+            data2 = ir.ZeroExtendToQuad(ir.VectorGetElement(64, data, 1));
+        } else {
+            data1 = Mem(address, dbytes, IR::AccType::VEC);
+            data2 = Mem(ir.Add(address, ir.Imm64(dbytes)), dbytes, IR::AccType::VEC);
         }
         V(datasize, Vt, data1);
         V(datasize, Vt2, data2);
@@ -3,6 +3,10 @@
  * SPDX-License-Identifier: 0BSD
  */
 
+#include <optional>
+
+#include <boost/variant/get.hpp>
+
 #include "frontend/A64/decoder/a64.h"
 #include "frontend/A64/location_descriptor.h"
 #include "frontend/A64/translate/impl/impl.h"
@@ -12,12 +16,52 @@
 
 namespace Dynarmic::A64 {
 
+namespace {
+
+/// Blocks are not extended by following branches once they reach this many instructions.
+constexpr size_t max_branch_following_block_size = 128;
+
+/// Only unconditional terminals are followed; If and CheckBit terminals end the block.
+std::optional<LocationDescriptor> DirectBranchTarget(const IR::Terminal& terminal) {
+    if (const auto term = boost::get<IR::Term::LinkBlock>(&terminal)) {
+        return LocationDescriptor{term->next};
+    }
+    if (const auto term = boost::get<IR::Term::LinkBlockFast>(&terminal)) {
+        return LocationDescriptor{term->next};
+    }
+    return std::nullopt;
+}
+
+} // anonymous namespace
+
 IR::Block Translate(LocationDescriptor descriptor, MemoryReadCodeFuncType memory_read_code, TranslationOptions options) {
     const bool single_step = descriptor.SingleStepping();
 
     IR::Block block{descriptor};
     TranslatorVisitor visitor{block, descriptor, std::move(options)};
 
+    // Start of the contiguous range of guest code currently being translated,
+    // if a branch has been followed.
+    std::optional<LocationDescriptor> range_begin;
+    const auto is_translated = [&](u64 pc) {
+        const u64 current_begin = range_begin ? range_begin->PC() : descriptor.PC();
+        if (pc >= current_begin && pc < visitor.ir.current_location->PC()) {
+            return true;
+        }
+        if (!range_begin) {
+            return false;
+        }
+        if (pc >= descriptor.PC() && pc < LocationDescriptor{block.EndLocation()}.PC()) {
+            return true;
+        }
+        for (const auto& [begin, end] : block.FollowedRanges()) {
+            if (pc >= LocationDescriptor{begin}.PC() && pc < LocationDescriptor{end}.PC()) {
+                return true;
+            }
+        }
+        return false;
+    };
+
     bool should_continue = true;
     do {
         const u64 pc = visitor.ir.current_location->PC();
@@ -31,6 +75,22 @@ IR::Block Translate(LocationDescriptor descriptor, MemoryReadCodeFuncType memory
 
         visitor.ir.current_location = visitor.ir.current_location->AdvancePC(4);
         block.CycleCount()++;
+
+        if (!should_continue && options.follow_direct_branches && !single_step && block.CycleCount() < max_branch_following_block_size) {
+            const auto target = DirectBranchTarget(block.GetTerminal());
+            const auto is_same_state = [&] { return target->SetPC(visitor.ir.current_location->PC()) == *visitor.ir.current_location; };
+            if (target && is_same_state() && !is_translated(target->PC())) {
+                if (range_begin) {
+                    block.AddFollowedRange(*range_begin, *visitor.ir.current_location);
+                } else {
+                    block.SetEndLocation(*visitor.ir.current_location);
+                }
+                block.ReplaceTerminal(IR::Term::Invalid{});
+                range_begin = *target;
+                visitor.ir.current_location = *target;
+                should_continue = true;
+            }
+        }
     } while (should_continue && !single_step);
 
     if (single_step && should_continue) {
@@ -39,7 +99,11 @@ IR::Block Translate(LocationDescriptor descriptor, MemoryReadCodeFuncType memory
 
     ASSERT_MSG(block.HasTerminal(), "Terminal has not been set");
 
-    block.SetEndLocation(*visitor.ir.current_location);
+    if (range_begin) {
+        block.AddFollowedRange(*range_begin, *visitor.ir.current_location);
+    } else {
+        block.SetEndLocation(*visitor.ir.current_location);
+    }
 
     return block;
 }
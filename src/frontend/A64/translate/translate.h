@@ -30,6 +30,12 @@ struct TranslationOptions {
     /// to avoid writting certain unnecessary code only needed for cycle timers.
     bool wall_clock_cntpct = false;
 
+    /// This tells the translator to continue translating at the target of unconditional
+    /// direct branches instead of ending the block, so that optimization passes and
+    /// register allocation can operate across the branch.
+    /// Conditional branches and branches back into the block being translated still end it.
+    bool follow_direct_branches = false;
+
     /// This changes what IR we emit when we translate a hint instruction.
     /// If this is false, we treat the instruction as a NOP.
     /// If this is true, we emit an ExceptionRaised instruction.
@@ -0,0 +1,15 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#pragma once
+
+namespace Dynarmic::IR {
+
+/// Operation performed by an atomic read-modify-write memory access.
+enum class AtomicOp {
+    Add, Clear, Eor, Set, SignedMax, SignedMin, UnsignedMax, UnsignedMin, Swap,
+};
+
+} // namespace Dynarmic::IR
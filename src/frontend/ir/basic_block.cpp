@@ -59,6 +59,14 @@ void Block::SetEndLocation(const LocationDescriptor& descriptor) {
     end_location = descriptor;
 }
 
+void Block::AddFollowedRange(const LocationDescriptor& begin, const LocationDescriptor& end) {
+    followed_ranges.emplace_back(begin, end);
+}
+
+const std::vector<std::pair<LocationDescriptor, LocationDescriptor>>& Block::FollowedRanges() const {
+    return followed_ranges;
+}
+
 Cond Block::GetCondition() const {
     return cond;
 }
@@ -9,6 +9,8 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common/common_types.h"
 #include "common/intrusive_list.h"
@@ -102,6 +104,12 @@ public:
     /// Sets the end location for this basic block.
     void SetEndLocation(const LocationDescriptor& descriptor);
 
+    /// Adds a guest code range [begin, end) this block was translated from in addition to
+    /// [Location(), EndLocation()). This occurs when translation follows a direct branch.
+    void AddFollowedRange(const LocationDescriptor& begin, const LocationDescriptor& end);
+    /// Gets the guest code ranges this block was translated from in addition to [Location(), EndLocation()).
+    const std::vector<std::pair<LocationDescriptor, LocationDescriptor>>& FollowedRanges() const;
+
     /// Gets the condition required to pass in order to execute this block.
     Cond GetCondition() const;
     /// Sets the condition required to pass in order to execute this block.
@@ -143,6 +151,8 @@ private:
     LocationDescriptor location;
     /// Description of the end location of this block
     LocationDescriptor end_location;
+    /// Further [begin, end) ranges of guest code included in this block by following branches
+    std::vector<std::pair<LocationDescriptor, LocationDescriptor>> followed_ranges;
     /// Conditional to pass in order to execute this block
     Cond cond;
     /// Block to execute next if `cond` did not pass.
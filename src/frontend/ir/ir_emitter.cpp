@@ -904,10 +904,38 @@ U128 IREmitter::AESMixColumns(const U128& a) {
     return Inst<U128>(Opcode::AESMixColumns, a);
 }
 
+U128 IREmitter::SHA1HashUpdateChoose(const U128& x, const U128& y, const U128& w) {
+    return Inst<U128>(Opcode::SHA1HashUpdateChoose, x, y, w);
+}
+
+U128 IREmitter::SHA1HashUpdateMajority(const U128& x, const U128& y, const U128& w) {
+    return Inst<U128>(Opcode::SHA1HashUpdateMajority, x, y, w);
+}
+
+U128 IREmitter::SHA1HashUpdateParity(const U128& x, const U128& y, const U128& w) {
+    return Inst<U128>(Opcode::SHA1HashUpdateParity, x, y, w);
+}
+
+U128 IREmitter::SHA256Hash(const U128& x, const U128& y, const U128& w, bool part1) {
+    return Inst<U128>(Opcode::SHA256Hash, x, y, w, Imm1(part1));
+}
+
+U128 IREmitter::SHA256MessageSchedule0(const U128& x, const U128& y) {
+    return Inst<U128>(Opcode::SHA256MessageSchedule0, x, y);
+}
+
+U128 IREmitter::SHA256MessageSchedule1(const U128& x, const U128& y, const U128& z) {
+    return Inst<U128>(Opcode::SHA256MessageSchedule1, x, y, z);
+}
+
 U8 IREmitter::SM4AccessSubstitutionBox(const U8& a) {
     return Inst<U8>(Opcode::SM4AccessSubstitutionBox, a);
 }
 
+U128 IREmitter::SM4SubstituteBytes(const U128& a) {
+    return Inst<U128>(Opcode::SM4SubstituteBytes, a);
+}
+
 UAny IREmitter::VectorGetElement(size_t esize, const U128& a, size_t index) {
     ASSERT_MSG(esize * index < 128, "Invalid index");
     switch (esize) {
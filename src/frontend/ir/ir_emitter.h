@@ -220,7 +220,15 @@ public:
     U128 AESInverseMixColumns(const U128& a);
     U128 AESMixColumns(const U128& a);
 
+    U128 SHA1HashUpdateChoose(const U128& x, const U128& y, const U128& w);
+    U128 SHA1HashUpdateMajority(const U128& x, const U128& y, const U128& w);
+    U128 SHA1HashUpdateParity(const U128& x, const U128& y, const U128& w);
+    U128 SHA256Hash(const U128& x, const U128& y, const U128& w, bool part1);
+    U128 SHA256MessageSchedule0(const U128& x, const U128& y);
+    U128 SHA256MessageSchedule1(const U128& x, const U128& y, const U128& z);
+
     U8 SM4AccessSubstitutionBox(const U8& a);
+    U128 SM4SubstituteBytes(const U128& a);
 
     UAny VectorGetElement(size_t esize, const U128& a, size_t index);
     U128 VectorSetElement(size_t esize, const U128& a, size_t index, const UAny& elem);
@@ -65,11 +65,21 @@ bool Inst::IsSharedMemoryRead() const {
     case Opcode::A32ReadMemory16:
     case Opcode::A32ReadMemory32:
     case Opcode::A32ReadMemory64:
+    case Opcode::A32ReadMemoryWide64:
     case Opcode::A64ReadMemory8:
     case Opcode::A64ReadMemory16:
     case Opcode::A64ReadMemory32:
     case Opcode::A64ReadMemory64:
     case Opcode::A64ReadMemory128:
+    case Opcode::A64ReadMemoryInPage8:
+    case Opcode::A64ReadMemoryInPage16:
+    case Opcode::A64ReadMemoryInPage32:
+    case Opcode::A64ReadMemoryInPage64:
+    case Opcode::A64ReadMemoryInPage128:
+    case Opcode::A64ReadMemoryWide64:
+    case Opcode::A64ReadMemoryWide128:
+    case Opcode::A64ReadMemoryWideInPage64:
+    case Opcode::A64ReadMemoryWideInPage128:
         return true;
 
     default:
@@ -83,11 +93,21 @@ bool Inst::IsSharedMemoryWrite() const {
     case Opcode::A32WriteMemory16:
     case Opcode::A32WriteMemory32:
     case Opcode::A32WriteMemory64:
+    case Opcode::A32WriteMemoryWide64:
     case Opcode::A64WriteMemory8:
     case Opcode::A64WriteMemory16:
     case Opcode::A64WriteMemory32:
     case Opcode::A64WriteMemory64:
     case Opcode::A64WriteMemory128:
+    case Opcode::A64WriteMemoryInPage8:
+    case Opcode::A64WriteMemoryInPage16:
+    case Opcode::A64WriteMemoryInPage32:
+    case Opcode::A64WriteMemoryInPage64:
+    case Opcode::A64WriteMemoryInPage128:
+    case Opcode::A64WriteMemoryWide64:
+    case Opcode::A64WriteMemoryWide128:
+    case Opcode::A64WriteMemoryWideInPage64:
+    case Opcode::A64WriteMemoryWideInPage128:
         return true;
 
     default:
@@ -135,12 +155,30 @@ bool Inst::IsExclusiveMemoryWrite() const {
     }
 }
 
+bool Inst::IsAtomicMemoryOperation() const {
+    switch (op) {
+    case Opcode::A64AtomicCompareAndSwap8:
+    case Opcode::A64AtomicCompareAndSwap16:
+    case Opcode::A64AtomicCompareAndSwap32:
+    case Opcode::A64AtomicCompareAndSwap64:
+    case Opcode::A64AtomicCompareAndSwap128:
+    case Opcode::A64AtomicReadModifyWrite8:
+    case Opcode::A64AtomicReadModifyWrite16:
+    case Opcode::A64AtomicReadModifyWrite32:
+    case Opcode::A64AtomicReadModifyWrite64:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
 bool Inst::IsMemoryRead() const {
-    return IsSharedMemoryRead() || IsExclusiveMemoryRead();
+    return IsSharedMemoryRead() || IsExclusiveMemoryRead() || IsAtomicMemoryOperation();
 }
 
 bool Inst::IsMemoryWrite() const {
-    return IsSharedMemoryWrite() || IsExclusiveMemoryWrite();
+    return IsSharedMemoryWrite() || IsExclusiveMemoryWrite() || IsAtomicMemoryOperation();
 }
 
 bool Inst::IsMemoryReadOrWrite() const {
@@ -16,7 +16,7 @@ namespace Dynarmic::IR {
 enum class Opcode;
 enum class Type;
 
-constexpr size_t max_arg_count = 4;
+constexpr size_t max_arg_count = 5;
 
 /**
  * A representation of a microinstruction. A single ARM/Thumb instruction may be
@@ -48,6 +48,8 @@ public:
     bool IsExclusiveMemoryRead() const;
     /// Determines whether or not this instruction performs an atomic memory write.
     bool IsExclusiveMemoryWrite() const;
+    /// Determines whether or not this instruction performs an atomic read-modify-write memory operation.
+    bool IsAtomicMemoryOperation() const;
 
     /// Determines whether or not this instruction performs any kind of memory read.
     bool IsMemoryRead() const;
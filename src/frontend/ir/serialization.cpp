@@ -0,0 +1,398 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#include "frontend/ir/serialization.h"
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+
+#include <tsl/robin_map.h>
+
+#include "common/assert.h"
+#include "common/variant_util.h"
+#include "frontend/A32/types.h"
+#include "frontend/A64/types.h"
+#include "frontend/ir/cond.h"
+#include "frontend/ir/microinstruction.h"
+#include "frontend/ir/opcodes.h"
+#include "frontend/ir/terminal.h"
+#include "frontend/ir/type.h"
+#include "frontend/ir/value.h"
+
+namespace Dynarmic::IR {
+
+namespace {
+
+/// Incremented whenever the encoding of blocks changes other than through the opcode table.
+constexpr u64 format_version = 1;
+
+constexpr size_t max_terminal_depth = 16;
+
+enum class TerminalTag : u8 {
+    Invalid,
+    Interpret,
+    ReturnToDispatch,
+    LinkBlock,
+    LinkBlockFast,
+    PopRSBHint,
+    FastDispatchHint,
+    If,
+    CheckBit,
+    CheckHalt,
+};
+
+class Writer {
+public:
+    template<typename T>
+    void Write(T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const size_t offset = data.size();
+        data.resize(offset + sizeof(T));
+        std::memcpy(data.data() + offset, &value, sizeof(T));
+    }
+
+    std::vector<u8> data;
+};
+
+class Reader {
+public:
+    Reader(const u8* data, size_t size) : current(data), end(data + size) {}
+
+    template<typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        if (static_cast<size_t>(end - current) < sizeof(T)) {
+            failed = true;
+            return value;
+        }
+        std::memcpy(&value, current, sizeof(T));
+        current += sizeof(T);
+        return value;
+    }
+
+    bool Failed() const { return failed; }
+    bool AtEnd() const { return current == end; }
+
+private:
+    const u8* current;
+    const u8* end;
+    bool failed = false;
+};
+
+void WriteTerminal(Writer& w, const Terminal& terminal) {
+    Common::VisitVariant<void>(terminal, [&w](const auto& term) {
+        using T = std::decay_t<decltype(term)>;
+        if constexpr (std::is_same_v<T, Term::Invalid>) {
+            w.Write(TerminalTag::Invalid);
+        } else if constexpr (std::is_same_v<T, Term::Interpret>) {
+            w.Write(TerminalTag::Interpret);
+            w.Write(term.next.Value());
+            w.Write(static_cast<u64>(term.num_instructions));
+        } else if constexpr (std::is_same_v<T, Term::ReturnToDispatch>) {
+            w.Write(TerminalTag::ReturnToDispatch);
+        } else if constexpr (std::is_same_v<T, Term::LinkBlock>) {
+            w.Write(TerminalTag::LinkBlock);
+            w.Write(term.next.Value());
+        } else if constexpr (std::is_same_v<T, Term::LinkBlockFast>) {
+            w.Write(TerminalTag::LinkBlockFast);
+            w.Write(term.next.Value());
+        } else if constexpr (std::is_same_v<T, Term::PopRSBHint>) {
+            w.Write(TerminalTag::PopRSBHint);
+        } else if constexpr (std::is_same_v<T, Term::FastDispatchHint>) {
+            w.Write(TerminalTag::FastDispatchHint);
+        } else if constexpr (std::is_same_v<T, Term::If>) {
+            w.Write(TerminalTag::If);
+            w.Write(term.if_);
+            WriteTerminal(w, term.then_);
+            WriteTerminal(w, term.else_);
+        } else if constexpr (std::is_same_v<T, Term::CheckBit>) {
+            w.Write(TerminalTag::CheckBit);
+            WriteTerminal(w, term.then_);
+            WriteTerminal(w, term.else_);
+        } else if constexpr (std::is_same_v<T, Term::CheckHalt>) {
+            w.Write(TerminalTag::CheckHalt);
+            WriteTerminal(w, term.else_);
+        }
+    });
+}
+
+std::optional<Terminal> ReadTerminal(Reader& r, size_t depth) {
+    if (depth > max_terminal_depth) {
+        return std::nullopt;
+    }
+
+    const auto read_subterminal = [&](Terminal& result) {
+        auto term = ReadTerminal(r, depth + 1);
+        if (!term) {
+            return false;
+        }
+        result = std::move(*term);
+        return true;
+    };
+
+    switch (r.Read<TerminalTag>()) {
+    case TerminalTag::Invalid:
+        return Term::Invalid{};
+    case TerminalTag::Interpret: {
+        Term::Interpret term{LocationDescriptor{r.Read<u64>()}};
+        term.num_instructions = static_cast<size_t>(r.Read<u64>());
+        return term;
+    }
+    case TerminalTag::ReturnToDispatch:
+        return Term::ReturnToDispatch{};
+    case TerminalTag::LinkBlock:
+        return Term::LinkBlock{LocationDescriptor{r.Read<u64>()}};
+    case TerminalTag::LinkBlockFast:
+        return Term::LinkBlockFast{LocationDescriptor{r.Read<u64>()}};
+    case TerminalTag::PopRSBHint:
+        return Term::PopRSBHint{};
+    case TerminalTag::FastDispatchHint:
+        return Term::FastDispatchHint{};
+    case TerminalTag::If: {
+        const Cond cond = r.Read<Cond>();
+        Terminal then_ = Term::Invalid{};
+        Terminal else_ = Term::Invalid{};
+        if (!read_subterminal(then_) || !read_subterminal(else_)) {
+            return std::nullopt;
+        }
+        return Term::If{cond, std::move(then_), std::move(else_)};
+    }
+    case TerminalTag::CheckBit: {
+        Terminal then_ = Term::Invalid{};
+        Terminal else_ = Term::Invalid{};
+        if (!read_subterminal(then_) || !read_subterminal(else_)) {
+            return std::nullopt;
+        }
+        return Term::CheckBit{std::move(then_), std::move(else_)};
+    }
+    case TerminalTag::CheckHalt: {
+        Terminal else_ = Term::Invalid{};
+        if (!read_subterminal(else_)) {
+            return std::nullopt;
+        }
+        return Term::CheckHalt{std::move(else_)};
+    }
+    }
+    return std::nullopt;
+}
+
+void WriteValue(Writer& w, const Value& value, const tsl::robin_map<const Inst*, u32>& inst_indices) {
+    if (value.IsIdentity() || !value.IsImmediate()) {
+        w.Write(Type::Opaque);
+        w.Write(inst_indices.at(value.GetInst()));
+        return;
+    }
+
+    const Type type = value.GetType();
+    w.Write(type);
+    switch (type) {
+    case Type::Void:
+        break;
+    case Type::A32Reg:
+        w.Write(static_cast<u32>(value.GetA32RegRef()));
+        break;
+    case Type::A32ExtReg:
+        w.Write(static_cast<u32>(value.GetA32ExtRegRef()));
+        break;
+    case Type::A64Reg:
+        w.Write(static_cast<u32>(value.GetA64RegRef()));
+        break;
+    case Type::A64Vec:
+        w.Write(static_cast<u32>(value.GetA64VecRef()));
+        break;
+    case Type::U1:
+    case Type::U8:
+    case Type::U16:
+    case Type::U32:
+    case Type::U64:
+        w.Write(value.GetImmediateAsU64());
+        break;
+    case Type::CoprocInfo:
+        w.Write(value.GetCoprocInfo());
+        break;
+    case Type::Cond:
+        w.Write(value.GetCond());
+        break;
+    default:
+        ASSERT_FALSE("Unserializable immediate of type {}", type);
+    }
+}
+
+std::optional<Value> ReadValue(Reader& r, const std::vector<Inst*>& insts) {
+    switch (r.Read<Type>()) {
+    case Type::Void:
+        return Value{};
+    case Type::Opaque: {
+        const u32 index = r.Read<u32>();
+        if (index >= insts.size()) {
+            return std::nullopt;
+        }
+        return Value{insts[index]};
+    }
+    case Type::A32Reg:
+        return Value{static_cast<A32::Reg>(r.Read<u32>())};
+    case Type::A32ExtReg:
+        return Value{static_cast<A32::ExtReg>(r.Read<u32>())};
+    case Type::A64Reg:
+        return Value{static_cast<A64::Reg>(r.Read<u32>())};
+    case Type::A64Vec:
+        return Value{static_cast<A64::Vec>(r.Read<u32>())};
+    case Type::U1:
+        return Value{r.Read<u64>() != 0};
+    case Type::U8:
+        return Value{static_cast<u8>(r.Read<u64>())};
+    case Type::U16:
+        return Value{static_cast<u16>(r.Read<u64>())};
+    case Type::U32:
+        return Value{static_cast<u32>(r.Read<u64>())};
+    case Type::U64:
+        return Value{r.Read<u64>()};
+    case Type::CoprocInfo:
+        return Value{r.Read<Value::CoprocessorInfo>()};
+    case Type::Cond:
+        return Value{r.Read<Cond>()};
+    default:
+        return std::nullopt;
+    }
+}
+
+void AppendInst(Block& block, Opcode op, const std::array<Value, max_arg_count>& args) {
+    switch (GetNumArgsOf(op)) {
+    case 0:
+        block.AppendNewInst(op, {});
+        break;
+    case 1:
+        block.AppendNewInst(op, {args[0]});
+        break;
+    case 2:
+        block.AppendNewInst(op, {args[0], args[1]});
+        break;
+    case 3:
+        block.AppendNewInst(op, {args[0], args[1], args[2]});
+        break;
+    case 4:
+        block.AppendNewInst(op, {args[0], args[1], args[2], args[3]});
+        break;
+    case 5:
+        block.AppendNewInst(op, {args[0], args[1], args[2], args[3], args[4]});
+        break;
+    default:
+        UNREACHABLE();
+    }
+}
+
+} // anonymous namespace
+
+std::vector<u8> SerializeBlock(const Block& block) {
+    Writer w;
+
+    w.Write(block.EndLocation().Value());
+    w.Write(static_cast<u64>(block.CycleCount()));
+    w.Write(block.GetCondition());
+    w.Write(static_cast<u8>(block.HasConditionFailedLocation()));
+    if (block.HasConditionFailedLocation()) {
+        w.Write(block.ConditionFailedLocation().Value());
+        w.Write(static_cast<u64>(block.ConditionFailedCycleCount()));
+    }
+
+    w.Write(static_cast<u32>(block.FollowedRanges().size()));
+    for (const auto& [begin, end] : block.FollowedRanges()) {
+        w.Write(begin.Value());
+        w.Write(end.Value());
+    }
+
+    tsl::robin_map<const Inst*, u32> inst_indices;
+    w.Write(static_cast<u32>(block.size()));
+    for (const auto& inst : block) {
+        w.Write(static_cast<u16>(inst.GetOpcode()));
+        for (size_t i = 0; i < inst.NumArgs(); i++) {
+            WriteValue(w, inst.GetArg(i), inst_indices);
+        }
+        inst_indices.emplace(&inst, static_cast<u32>(inst_indices.size()));
+    }
+
+    WriteTerminal(w, block.GetTerminal());
+
+    return std::move(w.data);
+}
+
+std::optional<Block> DeserializeBlock(const LocationDescriptor& location, const u8* data, size_t size) {
+    Reader r{data, size};
+    Block block{location};
+
+    block.SetEndLocation(LocationDescriptor{r.Read<u64>()});
+    block.CycleCount() = static_cast<size_t>(r.Read<u64>());
+    block.SetCondition(r.Read<Cond>());
+    if (r.Read<u8>() != 0) {
+        block.SetConditionFailedLocation(LocationDescriptor{r.Read<u64>()});
+        block.ConditionFailedCycleCount() = static_cast<size_t>(r.Read<u64>());
+    }
+
+    const u32 followed_range_count = r.Read<u32>();
+    for (u32 i = 0; i < followed_range_count && !r.Failed(); i++) {
+        const LocationDescriptor begin{r.Read<u64>()};
+        const LocationDescriptor end{r.Read<u64>()};
+        block.AddFollowedRange(begin, end);
+    }
+
+    const u32 inst_count = r.Read<u32>();
+    std::vector<Inst*> insts;
+    for (u32 i = 0; i < inst_count && !r.Failed(); i++) {
+        const u16 raw_op = r.Read<u16>();
+        if (raw_op >= OpcodeCount) {
+            return std::nullopt;
+        }
+        const Opcode op = static_cast<Opcode>(raw_op);
+
+        std::array<Value, max_arg_count> args;
+        for (size_t arg_index = 0; arg_index < GetNumArgsOf(op); arg_index++) {
+            const auto value = ReadValue(r, insts);
+            if (!value || r.Failed() || !AreTypesCompatible(value->GetType(), GetArgTypeOf(op, arg_index))) {
+                return std::nullopt;
+            }
+            args[arg_index] = *value;
+        }
+
+        AppendInst(block, op, args);
+        insts.emplace_back(&block.back());
+    }
+
+    auto terminal = ReadTerminal(r, 0);
+    if (!terminal || r.Failed() || !r.AtEnd()) {
+        return std::nullopt;
+    }
+    block.SetTerminal(std::move(*terminal));
+
+    return block;
+}
+
+u64 SerializationFingerprint() {
+    // FNV-1a over the format version and the opcode table: opcode numbering and signatures determine the encoding.
+    u64 hash = 0xCBF29CE484222325;
+    const auto mix = [&hash](u64 value) {
+        for (size_t i = 0; i < sizeof(value); i++) {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= 0x100000001B3;
+        }
+    };
+
+    mix(format_version);
+
+    for (size_t i = 0; i < OpcodeCount; i++) {
+        const Opcode op = static_cast<Opcode>(i);
+        for (const char c : GetNameOf(op)) {
+            mix(static_cast<u8>(c));
+        }
+        mix(static_cast<u64>(GetTypeOf(op)));
+        for (size_t arg_index = 0; arg_index < GetNumArgsOf(op); arg_index++) {
+            mix(static_cast<u64>(GetArgTypeOf(op, arg_index)));
+        }
+    }
+    return hash;
+}
+
+} // namespace Dynarmic::IR
@@ -0,0 +1,33 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "common/common_types.h"
+#include "frontend/ir/basic_block.h"
+#include "frontend/ir/location_descriptor.h"
+
+namespace Dynarmic::IR {
+
+/**
+ * Serializes a block: its instructions, terminal, condition, cycle counts and followed ranges.
+ * The encoding is specific to this build of dynarmic, see SerializationFingerprint.
+ */
+std::vector<u8> SerializeBlock(const Block& block);
+
+/**
+ * Reconstructs a block at `location` that was serialized with SerializeBlock.
+ * @returns std::nullopt if the data is malformed.
+ */
+std::optional<Block> DeserializeBlock(const LocationDescriptor& location, const u8* data, size_t size);
+
+/// A value that changes whenever the encoding or the opcode table changes, and thus the meaning of serialized blocks.
+u64 SerializationFingerprint();
+
+} // namespace Dynarmic::IR
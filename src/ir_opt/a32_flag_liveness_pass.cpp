@@ -0,0 +1,171 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/iterator_util.h"
+#include "common/variant_util.h"
+#include "frontend/ir/basic_block.h"
+#include "frontend/ir/microinstruction.h"
+#include "frontend/ir/opcodes.h"
+#include "frontend/ir/terminal.h"
+#include "ir_opt/passes.h"
+
+namespace Dynarmic::Optimization {
+
+namespace {
+
+/// Number of instructions at the start of a following block that are examined for writes to flags.
+constexpr size_t max_lookahead_instructions = 8;
+
+constexpr u32 n_flag = 1 << 0;
+constexpr u32 z_flag = 1 << 1;
+constexpr u32 c_flag = 1 << 2;
+constexpr u32 v_flag = 1 << 3;
+constexpr u32 all_flags = n_flag | z_flag | c_flag | v_flag;
+
+u32 FlagsWritten(const IR::Inst& inst) {
+    switch (inst.GetOpcode()) {
+    case IR::Opcode::A32SetNFlag:
+        return n_flag;
+    case IR::Opcode::A32SetZFlag:
+        return z_flag;
+    case IR::Opcode::A32SetCFlag:
+        return c_flag;
+    case IR::Opcode::A32SetVFlag:
+        return v_flag;
+    case IR::Opcode::A32SetCpsr:
+    case IR::Opcode::A32SetCpsrNZCV:
+    case IR::Opcode::A32SetCpsrNZCVQ:
+        return all_flags;
+    default:
+        return 0;
+    }
+}
+
+/// Flags read by an instruction. Instructions that call out to the user may inspect all of them.
+u32 FlagsObserved(const IR::Inst& inst) {
+    switch (inst.GetOpcode()) {
+    case IR::Opcode::A32GetNFlag:
+        return n_flag;
+    case IR::Opcode::A32GetZFlag:
+        return z_flag;
+    case IR::Opcode::A32GetCFlag:
+        return c_flag;
+    case IR::Opcode::A32GetVFlag:
+        return v_flag;
+    case IR::Opcode::A32GetGEFlags:
+        return 0;
+    default:
+        if (inst.ReadsFromCPSR() || inst.CausesCPUException() || inst.IsBarrier() || inst.IsCoprocessorInstruction()) {
+            return all_flags;
+        }
+        return 0;
+    }
+}
+
+/// Writes to flags that can be removed when the flags they write are dead.
+/// The remaining writes also write other parts of the CPSR.
+bool IsRemovableWrite(const IR::Inst& inst) {
+    return inst.GetOpcode() != IR::Opcode::A32SetCpsr
+        && inst.GetOpcode() != IR::Opcode::A32SetCpsrNZCVQ;
+}
+
+/// Determines which flags the code at `location` may observe before writing them. The guest code
+/// this relies upon is added to the followed ranges of `block`, so that `block` is invalidated with it.
+u32 LiveFlagsAt(IR::Block& block, IR::LocationDescriptor location, const TranslateInstructionFunc& translate_instruction) {
+    const IR::LocationDescriptor begin = location;
+    std::optional<IR::LocationDescriptor> end;
+    u32 written = 0;
+    u32 live = 0;
+    for (size_t i = 0; i < max_lookahead_instructions && (written | live) != all_flags; i++) {
+        const IR::Block step = translate_instruction(location);
+        if (step.GetCondition() != IR::Cond::AL) {
+            break;
+        }
+
+        for (const auto& inst : step) {
+            live |= FlagsObserved(inst) & ~written;
+            const u32 newly_written = FlagsWritten(inst) & ~(written | live);
+            if (newly_written != 0) {
+                written |= newly_written;
+                end = step.EndLocation();
+            }
+        }
+
+        const IR::Terminal terminal = step.GetTerminal();
+        const auto next = boost::get<IR::Term::LinkBlock>(&terminal);
+        if (!next || next->next != step.EndLocation()) {
+            break;
+        }
+        location = next->next;
+    }
+
+    if (end) {
+        block.AddFollowedRange(begin, *end);
+    }
+    return all_flags & ~written;
+}
+
+/// Determines which flags may be observed after `terminal` is taken.
+u32 LiveFlagsOut(IR::Block& block, const IR::Terminal& terminal, const TranslateInstructionFunc& translate_instruction) {
+    return Common::VisitVariant<u32>(terminal, [&](const auto& term) {
+        using T = std::decay_t<decltype(term)>;
+        if constexpr (std::is_same_v<T, IR::Term::LinkBlock> || std::is_same_v<T, IR::Term::LinkBlockFast>) {
+            return translate_instruction ? LiveFlagsAt(block, term.next, translate_instruction) : all_flags;
+        } else if constexpr (std::is_same_v<T, IR::Term::If>) {
+            if (term.if_ != IR::Cond::AL && term.if_ != IR::Cond::NV) {
+                return all_flags;
+            }
+            return LiveFlagsOut(block, term.then_, translate_instruction);
+        } else if constexpr (std::is_same_v<T, IR::Term::CheckBit>) {
+            return LiveFlagsOut(block, term.then_, translate_instruction)
+                 | LiveFlagsOut(block, term.else_, translate_instruction);
+        } else {
+            // Either the following code is not known, or execution may return to the user.
+            return all_flags;
+        }
+    });
+}
+
+} // anonymous namespace
+
+void A32FlagLivenessPass(IR::Block& block, const TranslateInstructionFunc& translate_instruction) {
+    // The following code is only examined if a write to flags reaches the end of the block.
+    std::optional<u32> live_out;
+    const auto get_live_out = [&] {
+        if (!live_out) {
+            live_out = LiveFlagsOut(block, block.GetTerminal(), translate_instruction);
+        }
+        return *live_out;
+    };
+
+    // We iterate over the instructions in reverse order, tracking which flags at the current
+    // instruction are observed later in the block, and which reach the end of the block.
+    u32 observed = 0;
+    u32 reaches_end = all_flags;
+    std::vector<IR::Inst*> dead_writes;
+    for (auto& inst : Common::Reverse(block)) {
+        if (const u32 written = FlagsWritten(inst)) {
+            const u32 live = observed | ((reaches_end & written) != 0 ? reaches_end & get_live_out() : 0);
+            if ((live & written) == 0 && IsRemovableWrite(inst)) {
+                dead_writes.push_back(&inst);
+            }
+            observed &= ~written;
+            reaches_end &= ~written;
+        }
+        observed |= FlagsObserved(inst);
+    }
+
+    for (IR::Inst* inst : dead_writes) {
+        inst->Invalidate();
+        block.Instructions().erase(IR::Block::iterator{*inst});
+    }
+}
+
+} // namespace Dynarmic::Optimization
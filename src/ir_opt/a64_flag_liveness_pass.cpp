@@ -0,0 +1,123 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/iterator_util.h"
+#include "common/variant_util.h"
+#include "frontend/ir/basic_block.h"
+#include "frontend/ir/microinstruction.h"
+#include "frontend/ir/opcodes.h"
+#include "frontend/ir/terminal.h"
+#include "ir_opt/passes.h"
+
+namespace Dynarmic::Optimization {
+
+namespace {
+
+/// Number of instructions at the start of a following block that are examined for a write to NZCV.
+constexpr size_t max_lookahead_instructions = 8;
+
+bool WritesNZCV(const IR::Inst& inst) {
+    return inst.GetOpcode() == IR::Opcode::A64SetNZCV
+        || inst.GetOpcode() == IR::Opcode::A64SetNZCVRaw;
+}
+
+/// Instructions that read NZCV, or that call out to the user, who may inspect it.
+bool MayObserveNZCV(const IR::Inst& inst) {
+    return inst.ReadsFromCPSR()
+        || inst.CausesCPUException()
+        || inst.IsBarrier()
+        || inst.IsCoprocessorInstruction()
+        || inst.GetOpcode() == IR::Opcode::A64DataCacheOperationRaised
+        || inst.GetOpcode() == IR::Opcode::A64InstructionCacheOperationRaised;
+}
+
+/// Determines if the code at `location` writes NZCV before anything observes it. The guest code
+/// this relies upon is added to the followed ranges of `block`, so that `block` is invalidated with it.
+bool OverwritesNZCV(IR::Block& block, IR::LocationDescriptor location, const TranslateInstructionFunc& translate_instruction) {
+    const IR::LocationDescriptor begin = location;
+    for (size_t i = 0; i < max_lookahead_instructions; i++) {
+        const IR::Block step = translate_instruction(location);
+        for (const auto& inst : step) {
+            if (MayObserveNZCV(inst)) {
+                return false;
+            }
+            if (WritesNZCV(inst)) {
+                block.AddFollowedRange(begin, step.EndLocation());
+                return true;
+            }
+        }
+
+        const IR::Terminal terminal = step.GetTerminal();
+        const auto next = boost::get<IR::Term::LinkBlock>(&terminal);
+        if (!next || next->next != step.EndLocation()) {
+            return false;
+        }
+        location = next->next;
+    }
+    return false;
+}
+
+/// Determines if NZCV may be observed after `terminal` is taken.
+bool IsNZCVLiveOut(IR::Block& block, const IR::Terminal& terminal, const TranslateInstructionFunc& translate_instruction) {
+    return Common::VisitVariant<bool>(terminal, [&](const auto& term) {
+        using T = std::decay_t<decltype(term)>;
+        if constexpr (std::is_same_v<T, IR::Term::LinkBlock> || std::is_same_v<T, IR::Term::LinkBlockFast>) {
+            return !translate_instruction || !OverwritesNZCV(block, term.next, translate_instruction);
+        } else if constexpr (std::is_same_v<T, IR::Term::If>) {
+            if (term.if_ != IR::Cond::AL && term.if_ != IR::Cond::NV) {
+                return true;
+            }
+            return IsNZCVLiveOut(block, term.then_, translate_instruction);
+        } else if constexpr (std::is_same_v<T, IR::Term::CheckBit>) {
+            return IsNZCVLiveOut(block, term.then_, translate_instruction)
+                || IsNZCVLiveOut(block, term.else_, translate_instruction);
+        } else {
+            // Either the following code is not known, or execution may return to the user.
+            return true;
+        }
+    });
+}
+
+} // anonymous namespace
+
+void A64FlagLivenessPass(IR::Block& block, const TranslateInstructionFunc& translate_instruction) {
+    // The following code is only examined if a write to NZCV reaches the end of the block.
+    std::optional<bool> live_out;
+    const auto is_live_out = [&] {
+        if (!live_out) {
+            live_out = IsNZCVLiveOut(block, block.GetTerminal(), translate_instruction);
+        }
+        return *live_out;
+    };
+
+    // We iterate over the instructions in reverse order, tracking whether the value of NZCV at
+    // the current instruction is observed later in the block, or reaches the end of the block.
+    bool observed = false;
+    bool reaches_end = true;
+    std::vector<IR::Inst*> dead_writes;
+    for (auto& inst : Common::Reverse(block)) {
+        if (WritesNZCV(inst)) {
+            if (!observed && (!reaches_end || !is_live_out())) {
+                dead_writes.push_back(&inst);
+            }
+            observed = false;
+            reaches_end = false;
+        } else if (MayObserveNZCV(inst)) {
+            observed = true;
+        }
+    }
+
+    for (IR::Inst* inst : dead_writes) {
+        inst->Invalidate();
+        block.Instructions().erase(IR::Block::iterator{*inst});
+    }
+}
+
+} // namespace Dynarmic::Optimization
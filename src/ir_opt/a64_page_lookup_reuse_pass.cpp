@@ -0,0 +1,183 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+#include "frontend/A64/ir_emitter.h"
+#include "frontend/ir/basic_block.h"
+#include "frontend/ir/microinstruction.h"
+#include "frontend/ir/opcodes.h"
+#include "frontend/ir/value.h"
+#include "ir_opt/passes.h"
+
+namespace Dynarmic::Optimization {
+
+namespace {
+
+constexpr s64 page_size = 4096;
+
+struct Access {
+    IR::Inst* inst;
+    s64 offset;
+    size_t order;
+};
+
+std::optional<IR::Opcode> InPageOpcode(IR::Opcode op) {
+    switch (op) {
+    case IR::Opcode::A64ReadMemory8:
+        return IR::Opcode::A64ReadMemoryInPage8;
+    case IR::Opcode::A64ReadMemory16:
+        return IR::Opcode::A64ReadMemoryInPage16;
+    case IR::Opcode::A64ReadMemory32:
+        return IR::Opcode::A64ReadMemoryInPage32;
+    case IR::Opcode::A64ReadMemory64:
+        return IR::Opcode::A64ReadMemoryInPage64;
+    case IR::Opcode::A64ReadMemory128:
+        return IR::Opcode::A64ReadMemoryInPage128;
+    case IR::Opcode::A64WriteMemory8:
+        return IR::Opcode::A64WriteMemoryInPage8;
+    case IR::Opcode::A64WriteMemory16:
+        return IR::Opcode::A64WriteMemoryInPage16;
+    case IR::Opcode::A64WriteMemory32:
+        return IR::Opcode::A64WriteMemoryInPage32;
+    case IR::Opcode::A64WriteMemory64:
+        return IR::Opcode::A64WriteMemoryInPage64;
+    case IR::Opcode::A64WriteMemory128:
+        return IR::Opcode::A64WriteMemoryInPage128;
+    case IR::Opcode::A64ReadMemoryWide64:
+        return IR::Opcode::A64ReadMemoryWideInPage64;
+    case IR::Opcode::A64ReadMemoryWide128:
+        return IR::Opcode::A64ReadMemoryWideInPage128;
+    case IR::Opcode::A64WriteMemoryWide64:
+        return IR::Opcode::A64WriteMemoryWideInPage64;
+    case IR::Opcode::A64WriteMemoryWide128:
+        return IR::Opcode::A64WriteMemoryWideInPage128;
+    default:
+        return std::nullopt;
+    }
+}
+
+/// Instructions that call out to the user, after which the mapping of guest pages may differ.
+bool MayChangePageMapping(const IR::Inst& inst) {
+    return inst.CausesCPUException()
+        || inst.IsBarrier()
+        || inst.IsCoprocessorInstruction()
+        || inst.GetOpcode() == IR::Opcode::A64DataCacheOperationRaised
+        || inst.GetOpcode() == IR::Opcode::A64InstructionCacheOperationRaised;
+}
+
+/// Splits an address into a base value and a constant offset less than a page in magnitude.
+std::pair<IR::Inst*, s64> DecomposeAddress(IR::Value vaddr) {
+    s64 offset = 0;
+    while (!vaddr.IsImmediate()) {
+        IR::Inst* const inst = vaddr.GetInstRecursive();
+        const IR::Opcode op = inst->GetOpcode();
+        const bool is_add = op == IR::Opcode::Add64 && inst->GetArg(2).IsImmediate() && !inst->GetArg(2).GetU1();
+        const bool is_sub = op == IR::Opcode::Sub64 && inst->GetArg(2).IsImmediate() && inst->GetArg(2).GetU1();
+        if ((!is_add && !is_sub) || !inst->GetArg(1).IsImmediate()) {
+            return {inst, offset};
+        }
+
+        const s64 imm = static_cast<s64>(inst->GetArg(1).GetU64());
+        const s64 new_offset = is_add ? offset + imm : offset - imm;
+        if (imm <= -page_size || imm >= page_size || new_offset <= -page_size || new_offset >= page_size) {
+            return {inst, offset};
+        }
+        offset = new_offset;
+        vaddr = inst->GetArg(0);
+    }
+    return {nullptr, 0};
+}
+
+/// Makes the accesses in `group`, which are within a page of each other, share one page lookup.
+void RewriteGroup(IR::Block& block, IR::Inst* base, const std::vector<Access>& group) {
+    const s64 min_offset = std::min_element(group.begin(), group.end(), [](const auto& a, const auto& b) { return a.offset < b.offset; })->offset;
+    const Access& first = *std::min_element(group.begin(), group.end(), [](const auto& a, const auto& b) { return a.order < b.order; });
+
+    A64::IREmitter ir{block};
+    ir.SetInsertionPoint(first.inst);
+    IR::U64 lookup_vaddr{IR::Value{base}};
+    if (min_offset != 0) {
+        lookup_vaddr = ir.Add(lookup_vaddr, ir.Imm64(static_cast<u64>(min_offset)));
+    }
+    const IR::U64 page = ir.LookupPage(lookup_vaddr);
+
+    for (const Access& access : group) {
+        IR::Inst* const inst = access.inst;
+        const IR::Opcode op = *InPageOpcode(inst->GetOpcode());
+        const IR::Value delta = ir.Imm16(static_cast<u16>(access.offset - min_offset));
+        const IR::Block::iterator position{*inst};
+        // Wide accesses keep their element size as the last argument.
+        if (inst->IsSharedMemoryRead()) {
+            const auto new_inst = inst->NumArgs() > 1
+                                ? block.PrependNewInst(position, op, {inst->GetArg(0), page, delta, inst->GetArg(1)})
+                                : block.PrependNewInst(position, op, {inst->GetArg(0), page, delta});
+            inst->ReplaceUsesWith(IR::Value{&*new_inst});
+        } else {
+            if (inst->NumArgs() > 2) {
+                block.PrependNewInst(position, op, {inst->GetArg(0), inst->GetArg(1), page, delta, inst->GetArg(2)});
+            } else {
+                block.PrependNewInst(position, op, {inst->GetArg(0), inst->GetArg(1), page, delta});
+            }
+            inst->Invalidate();
+        }
+    }
+}
+
+} // anonymous namespace
+
+void A64PageLookupReusePass(IR::Block& block) {
+    // Accesses are grouped by base value, in order of first appearance.
+    std::vector<std::pair<IR::Inst*, std::vector<Access>>> accesses;
+    size_t order = 0;
+
+    const auto flush = [&] {
+        for (auto& [base, list] : accesses) {
+            std::stable_sort(list.begin(), list.end(), [](const auto& a, const auto& b) { return a.offset < b.offset; });
+
+            auto group_begin = list.begin();
+            while (group_begin != list.end()) {
+                const auto group_end = std::find_if(group_begin, list.end(), [&](const auto& access) {
+                    return access.offset - group_begin->offset >= page_size;
+                });
+                if (std::distance(group_begin, group_end) >= 2) {
+                    RewriteGroup(block, base, std::vector<Access>(group_begin, group_end));
+                }
+                group_begin = group_end;
+            }
+        }
+        accesses.clear();
+    };
+
+    for (auto& inst : block) {
+        if (MayChangePageMapping(inst)) {
+            flush();
+            continue;
+        }
+        if (!InPageOpcode(inst.GetOpcode())) {
+            continue;
+        }
+
+        const auto [base, offset] = DecomposeAddress(inst.GetArg(0));
+        if (!base) {
+            continue;
+        }
+
+        const auto iter = std::find_if(accesses.begin(), accesses.end(), [base = base](const auto& entry) { return entry.first == base; });
+        const Access access{&inst, offset, order++};
+        if (iter == accesses.end()) {
+            accesses.emplace_back(base, std::vector<Access>{access});
+        } else {
+            iter->second.push_back(access);
+        }
+    }
+    flush();
+}
+
+} // namespace Dynarmic::Optimization
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <functional>
+
 namespace Dynarmic::A32 {
 struct UserCallbacks;
 }
@@ -16,15 +18,22 @@ struct UserConfig;
 
 namespace Dynarmic::IR {
 class Block;
+class LocationDescriptor;
 }
 
 namespace Dynarmic::Optimization {
 
+/// Translates the single guest instruction at the given location into a block of its own.
+using TranslateInstructionFunc = std::function<IR::Block(IR::LocationDescriptor)>;
+
 void A32ConstantMemoryReads(IR::Block& block, A32::UserCallbacks* cb);
+void A32FlagLivenessPass(IR::Block& block, const TranslateInstructionFunc& translate_instruction);
 void A32GetSetElimination(IR::Block& block);
 void A64CallbackConfigPass(IR::Block& block, const A64::UserConfig& conf);
+void A64FlagLivenessPass(IR::Block& block, const TranslateInstructionFunc& translate_instruction);
 void A64GetSetElimination(IR::Block& block);
 void A64MergeInterpretBlocksPass(IR::Block& block, A64::UserCallbacks* cb);
+void A64PageLookupReusePass(IR::Block& block);
 void ConstantPropagation(IR::Block& block);
 void DeadCodeElimination(IR::Block& block);
 void IdentityRemovalPass(IR::Block& block);
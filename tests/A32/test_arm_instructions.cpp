@@ -3,6 +3,10 @@
  * SPDX-License-Identifier: 0BSD
  */
 
+#include <array>
+#include <cstring>
+#include <memory>
+
 #include <catch.hpp>
 #include <dynarmic/A32/a32.h>
 #include <dynarmic/exclusive_monitor.h>
@@ -75,6 +79,110 @@ TEST_CASE("arm: LDREX", "[arm][A32]") {
     monitor = nullptr;
 }
 
+TEST_CASE("arm: LDREX/STREX inline with page table", "[arm][A32]") {
+    ExclusiveMonitor exclusive_monitor{2};
+
+    alignas(4096) static std::array<u8, 4096> page{};
+    const auto page_table = std::make_unique<std::array<u8*, A32::UserConfig::NUM_PAGE_TABLE_ENTRIES>>();
+    (*page_table)[0] = page.data();
+
+    ArmTestEnv test_env0;
+    ArmTestEnv test_env1;
+    const auto make_config = [&](ArmTestEnv* test_env, size_t processor_id) {
+        A32::UserConfig config = GetUserConfig(test_env);
+        config.page_table = page_table.get();
+        config.inline_exclusive_access = true;
+        config.global_monitor = &exclusive_monitor;
+        config.processor_id = processor_id;
+        return config;
+    };
+    A32::Jit jit0{make_config(&test_env0, 0)};
+    A32::Jit jit1{make_config(&test_env1, 1)};
+    for (ArmTestEnv* test_env : {&test_env0, &test_env1}) {
+        test_env->code_mem = {
+                0xe1943f9f, // ldrex r3, [r4]
+                0xe1841f99, // strex r1, sb, [r4]
+                0xeafffffe, // b #0
+        };
+    }
+
+    const auto read = [&](size_t offset) {
+        u32 value;
+        std::memcpy(&value, page.data() + offset, sizeof(u32));
+        return value;
+    };
+    const auto write = [&](size_t offset, u32 value) {
+        std::memcpy(page.data() + offset, &value, sizeof(u32));
+    };
+    const auto start = [](A32::Jit& jit, u32 address, u32 value) {
+        jit.Regs()[1] = 0xFFFFFFFF;
+        jit.Regs()[4] = address;
+        jit.Regs()[9] = value;
+        jit.Regs()[15] = 0; // PC = 0
+        jit.SetCpsr(0x000001d0); // User-mode
+    };
+
+    SECTION("Successful store") {
+        write(0x100, 0x12345678);
+        start(jit0, 0x100, 0xcafebabe);
+        jit0.Step();
+        jit0.Step();
+
+        REQUIRE(jit0.Regs()[3] == 0x12345678);
+        REQUIRE(jit0.Regs()[1] == 0);
+        REQUIRE(read(0x100) == 0xcafebabe);
+    }
+
+    SECTION("Store to another address in the same word fails") {
+        write(0x100, 0x12345678);
+        write(0x104, 0x9abcdef0);
+        start(jit0, 0x100, 0xcafebabe);
+        jit0.Step();
+        jit0.Regs()[4] = 0x104;
+        jit0.Step();
+
+        REQUIRE(jit0.Regs()[1] == 1);
+        REQUIRE(read(0x104) == 0x9abcdef0);
+    }
+
+    SECTION("Exclusive store from another processor clears the reservation") {
+        // The other processor writes back the same value, so only the monitor can detect the store.
+        write(0x100, 0x12345678);
+        start(jit0, 0x100, 0xcafebabe);
+        start(jit1, 0x100, 0x12345678);
+        jit0.Step();
+        jit1.Step();
+        jit1.Step();
+        jit0.Step();
+
+        REQUIRE(jit1.Regs()[1] == 0);
+        REQUIRE(jit0.Regs()[1] == 1);
+        REQUIRE(read(0x100) == 0x12345678);
+    }
+
+    SECTION("ClearAddress clears the reservation") {
+        write(0x100, 0x12345678);
+        start(jit0, 0x100, 0xcafebabe);
+        jit0.Step();
+        exclusive_monitor.ClearAddress(0x100);
+        jit0.Step();
+
+        REQUIRE(jit0.Regs()[1] == 1);
+        REQUIRE(read(0x100) == 0x12345678);
+    }
+
+    SECTION("ClearAddress of an unrelated address keeps the reservation") {
+        write(0x100, 0x12345678);
+        start(jit0, 0x100, 0xcafebabe);
+        jit0.Step();
+        exclusive_monitor.ClearAddress(0x200);
+        jit0.Step();
+
+        REQUIRE(jit0.Regs()[1] == 0);
+        REQUIRE(read(0x100) == 0xcafebabe);
+    }
+}
+
 TEST_CASE("arm: VMOV (2xcore to f64)", "[arm][A32]") {
     ArmTestEnv test_env;
     A32::Jit jit{GetUserConfig(&test_env)};
@@ -325,6 +433,58 @@ TEST_CASE("arm: Test InvalidateCacheRange", "[arm][A32]") {
     REQUIRE(jit.Cpsr() == 0x000001d0);
 }
 
+TEST_CASE("arm: Flag writes overwritten by the following block", "[arm][A32]") {
+    ArmTestEnv test_env;
+    A32::UserConfig config = GetUserConfig(&test_env);
+    config.optimizations |= OptimizationFlag::Unsafe_ElideExitFlags;
+    config.unsafe_optimizations = true;
+    A32::Jit jit{config};
+    test_env.code_mem = {
+        0xe0510001, // subs r0, r1, r1
+        0xea000000, // b +#4
+        0xe320f000, // nop
+        0xe1b04002, // movs r4, r2
+        0x23a05001, // movcs r5, #1
+        0xeafffffe, // b +#0 (infinite loop)
+    };
+
+    jit.Regs() = {};
+    jit.Regs()[2] = 5;
+    jit.SetCpsr(0x000001d0); // User-mode
+
+    // MOVS overwrites N and Z, so only the writes to C and V by SUBS remain.
+    test_env.ticks_left = 2;
+    jit.Run();
+
+    REQUIRE(jit.Regs()[15] == 0x0000000c);
+    REQUIRE(jit.Cpsr() == 0x200001d0);
+
+    test_env.ticks_left = 3;
+    jit.Run();
+
+    REQUIRE(jit.Regs()[4] == 5);
+    REQUIRE(jit.Regs()[5] == 1);
+    REQUIRE(jit.Cpsr() == 0x200001d0);
+
+    // The block ending in B depends on the code following it.
+    test_env.code_mem[3] = 0x03a04001; // moveq r4, #1
+    jit.InvalidateCacheRange(12, 4);
+
+    jit.Regs()[15] = 0;
+    jit.SetCpsr(0x000001d0);
+
+    test_env.ticks_left = 2;
+    jit.Run();
+
+    REQUIRE(jit.Regs()[15] == 0x0000000c);
+    REQUIRE(jit.Cpsr() == 0x600001d0);
+
+    test_env.ticks_left = 3;
+    jit.Run();
+
+    REQUIRE(jit.Regs()[4] == 1);
+}
+
 TEST_CASE("arm: Step blx", "[arm]") {
     ArmTestEnv test_env;
     A32::UserConfig config = GetUserConfig(&test_env);
@@ -920,3 +1080,117 @@ TEST_CASE("arm: VMOV (f32 to core)", "[arm][A32]") {
     REQUIRE(jit.Regs()[15] == 4);
     REQUIRE(jit.Cpsr() == 0x000001d0);
 }
+
+TEST_CASE("arm: LDM/STM and VLDM/VSTM with page table", "[arm][A32]") {
+    ArmTestEnv test_env;
+
+    alignas(4096) static std::array<u8, 4096> page0{};
+    alignas(4096) static std::array<u8, 4096> page1{};
+    for (size_t i = 0; i < page0.size(); i++) {
+        page0[i] = static_cast<u8>(i * 5 + 3);
+    }
+    page1.fill(0);
+    const auto page_table = std::make_unique<std::array<u8*, A32::UserConfig::NUM_PAGE_TABLE_ENTRIES>>();
+    (*page_table)[0] = page0.data();
+    (*page_table)[1] = page1.data();
+
+    A32::UserConfig config = GetUserConfig(&test_env);
+    config.page_table = page_table.get();
+    config.detect_misaligned_access_via_page_table = 8 | 16 | 32 | 64;
+    Dynarmic::A32::Jit jit{config};
+    test_env.code_mem = {
+            0xe92d4ff0, // push {r4-r11, lr}
+            0xe89d000f, // ldm sp, {r0-r3}
+            0xec9c0b04, // vldmia r12, {d0-d1}
+            0xec9c2a03, // vldmia r12, {s4-s6}
+            0xe28ccc01, // add r12, r12, #0x100
+            0xec8c2a03, // vstmia r12, {s4-s6}
+            0xe28cc010, // add r12, r12, #16
+            0xec8c0b04, // vstmia r12, {d0-d1}
+            0xeafffffe, // b #0
+    };
+
+    for (size_t i = 4; i <= 11; i++) {
+        jit.Regs()[i] = static_cast<u32>(0x11111111 * (i - 3));
+    }
+    jit.Regs()[12] = 0x100;
+    jit.Regs()[13] = 0x1010;
+    jit.Regs()[14] = 0xabcdef01;
+    jit.Regs()[15] = 0; // PC = 0
+    jit.SetCpsr(0x000001d0); // User-mode
+
+    test_env.ticks_left = 9;
+    jit.Run();
+
+    const auto read = [](const std::array<u8, 4096>& page, size_t offset) {
+        u32 value;
+        std::memcpy(&value, page.data() + offset, sizeof(u32));
+        return value;
+    };
+
+    // Pairs of words are only word-aligned, and the pair at 0xffc straddles a page boundary.
+    // Each word is still written to its page.
+    REQUIRE(jit.Regs()[13] == 0xfec);
+    REQUIRE(read(page0, 0xfec) == 0x11111111);
+    REQUIRE(read(page0, 0xff8) == 0x44444444);
+    REQUIRE(read(page0, 0xffc) == 0x55555555);
+    REQUIRE(read(page1, 0x0) == 0x66666666);
+    REQUIRE(read(page1, 0x4) == 0x77777777);
+    REQUIRE(read(page1, 0xc) == 0xabcdef01);
+    REQUIRE(test_env.modified_memory.empty());
+
+    REQUIRE(jit.Regs()[0] == 0x11111111);
+    REQUIRE(jit.Regs()[3] == 0x44444444);
+    REQUIRE(jit.ExtRegs()[0] == read(page0, 0x100));
+    REQUIRE(jit.ExtRegs()[3] == read(page0, 0x10c));
+    REQUIRE(jit.ExtRegs()[4] == read(page0, 0x100));
+    REQUIRE(jit.ExtRegs()[6] == read(page0, 0x108));
+    REQUIRE(std::memcmp(page0.data() + 0x200, page0.data() + 0x100, 12) == 0);
+    REQUIRE(std::memcmp(page0.data() + 0x210, page0.data() + 0x100, 16) == 0);
+}
+
+TEST_CASE("arm: LDM/STM and VLDM/VSTM use word callbacks", "[arm][A32]") {
+    struct WordAccessTestEnv final : public ArmTestEnv {
+        size_t doubleword_accesses = 0;
+
+        std::uint64_t MemoryRead64(u32 vaddr) override {
+            doubleword_accesses++;
+            return ArmTestEnv::MemoryRead64(vaddr);
+        }
+        void MemoryWrite64(u32 vaddr, std::uint64_t value) override {
+            doubleword_accesses++;
+            ArmTestEnv::MemoryWrite64(vaddr, value);
+        }
+    };
+
+    WordAccessTestEnv test_env;
+    A32::UserConfig config = GetUserConfig(&test_env);
+    Dynarmic::A32::Jit jit{config};
+    test_env.code_mem = {
+            0xe92d4ff0, // push {r4-r11, lr}
+            0xe89d000f, // ldm sp, {r0-r3}
+            0xec9d0b04, // vldmia sp, {d0-d1}
+            0xec8c0b04, // vstmia r12, {d0-d1}
+            0xeafffffe, // b #0
+    };
+
+    for (size_t i = 4; i <= 11; i++) {
+        jit.Regs()[i] = static_cast<u32>(0x11111111 * (i - 3));
+    }
+    jit.Regs()[12] = 0x100;
+    jit.Regs()[13] = 0x1010;
+    jit.Regs()[14] = 0xabcdef01;
+    jit.Regs()[15] = 0; // PC = 0
+    jit.SetCpsr(0x000001d0); // User-mode
+
+    test_env.ticks_left = 5;
+    jit.Run();
+
+    REQUIRE(test_env.doubleword_accesses == 0);
+    REQUIRE(jit.Regs()[0] == 0x11111111);
+    REQUIRE(jit.Regs()[3] == 0x44444444);
+    REQUIRE(jit.ExtRegs()[0] == 0x11111111);
+    REQUIRE(jit.ExtRegs()[3] == 0x44444444);
+    REQUIRE(test_env.MemoryRead32(0x100) == 0x11111111);
+    REQUIRE(test_env.MemoryRead32(0x10c) == 0x44444444);
+}
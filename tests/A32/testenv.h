@@ -17,7 +17,7 @@
 #include "common/common_types.h"
 
 template <typename InstructionType_, u32 infinite_loop>
-class A32TestEnv final : public Dynarmic::A32::UserCallbacks {
+class A32TestEnv : public Dynarmic::A32::UserCallbacks {
 public:
     using InstructionType = InstructionType_;
     using RegisterArray = std::array<u32, 16>;
@@ -3,11 +3,42 @@
  * SPDX-License-Identifier: 0BSD
  */
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
 #include <catch.hpp>
+#include <fmt/format.h>
 
 #include <dynarmic/exclusive_monitor.h>
 
+#include "common/fp/fpcr.h"
 #include "common/fp/fpsr.h"
+#include "common/fp/op.h"
+#include "common/fp/rounding_mode.h"
+#include "common/scope_exit.h"
+#include "frontend/A64/location_descriptor.h"
+#include "frontend/A64/translate/translate.h"
+#include "frontend/ir/basic_block.h"
+#include "frontend/ir/opcodes.h"
+#include "ir_opt/passes.h"
+#include "rand_int.h"
+#include "sha_reference.h"
 #include "testenv.h"
 
 using namespace Dynarmic;
@@ -279,6 +310,217 @@ TEST_CASE("A64: FABD", "[a64]") {
     REQUIRE(jit.GetVector(22) == Vector{0x56d3f0857fc90e2b, 0x6e4b0a4144873176});
 }
 
+TEST_CASE("A64: SHA1 and SHA256 hash updates", "[a64]") {
+    // Without SHA-NI these are computed in general-purpose registers.
+    for (const HostFeature disabled_host_features : {no_host_features, HostFeature::SHA}) {
+        A64TestEnv env;
+        A64::UserConfig conf{&env};
+        conf.disabled_host_features = disabled_host_features;
+        A64::Jit jit{conf};
+
+        env.code_mem.emplace_back(0x5e030040); // SHA1C Q0, S2, V3.4S
+        env.code_mem.emplace_back(0x5e032044); // SHA1M Q4, S2, V3.4S
+        env.code_mem.emplace_back(0x5e031045); // SHA1P Q5, S2, V3.4S
+        env.code_mem.emplace_back(0x5e034046); // SHA256H Q6, Q2, V3.4S
+        env.code_mem.emplace_back(0x5e035047); // SHA256H2 Q7, Q2, V3.4S
+        env.code_mem.emplace_back(0x5e282848); // SHA256SU0 V8.4S, V2.4S
+        env.code_mem.emplace_back(0x5e036049); // SHA256SU1 V9.4S, V2.4S, V3.4S
+        env.code_mem.emplace_back(0x14000000); // B .
+
+        jit.SetPC(0);
+        for (const size_t i : {0, 4, 5, 6, 7, 8, 9}) {
+            jit.SetVector(i, {0x0123456789abcdef, 0xfedcba9876543210});
+        }
+        jit.SetVector(2, {0x1122334455667788, 0x99aabbccddeeff00});
+        jit.SetVector(3, {0x0f1e2d3c4b5a6978, 0x8796a5b4c3d2e1f0});
+
+        env.ticks_left = 8;
+        jit.Run();
+
+        REQUIRE(jit.GetVector(0) == Vector{0xe2d3724d07b7b843, 0x7545d662e9d0c319});
+        REQUIRE(jit.GetVector(4) == Vector{0xfe2d10256fad6d1e, 0x5323b44098077655});
+        REQUIRE(jit.GetVector(5) == Vector{0x07e1b36b0402bf33, 0x17f99b38529feca1});
+        REQUIRE(jit.GetVector(6) == Vector{0xe40743a41e039098, 0x055916e8b3824c43});
+        REQUIRE(jit.GetVector(7) == Vector{0x73e4785802b5490f, 0x318ac4dd8f0f990e});
+        REQUIRE(jit.GetVector(8) == Vector{0x23c5791aa92bbc5d, 0x86c0d1df76d443a1});
+        REQUIRE(jit.GetVector(9) == Vector{0x655f7af7c7c48e5e, 0x9c732deae6d43815});
+    }
+}
+
+TEST_CASE("A64: SHA1 and SHA256 hash updates match the reference implementation", "[a64]") {
+
+    const auto to_state = [](Vector v) {
+        return SHA::State{static_cast<u32>(v[0]), static_cast<u32>(v[0] >> 32), static_cast<u32>(v[1]), static_cast<u32>(v[1] >> 32)};
+    };
+
+    for (const HostFeature disabled_host_features : {no_host_features, HostFeature::SHA}) {
+        A64TestEnv env;
+        A64::UserConfig conf{&env};
+        conf.disabled_host_features = disabled_host_features;
+        A64::Jit jit{conf};
+
+        env.code_mem.emplace_back(0x5e030040); // SHA1C Q0, S2, V3.4S
+        env.code_mem.emplace_back(0x5e032044); // SHA1M Q4, S2, V3.4S
+        env.code_mem.emplace_back(0x5e031045); // SHA1P Q5, S2, V3.4S
+        env.code_mem.emplace_back(0x5e034046); // SHA256H Q6, Q2, V3.4S
+        env.code_mem.emplace_back(0x5e035047); // SHA256H2 Q7, Q2, V3.4S
+        env.code_mem.emplace_back(0x5e282848); // SHA256SU0 V8.4S, V2.4S
+        env.code_mem.emplace_back(0x5e036049); // SHA256SU1 V9.4S, V2.4S, V3.4S
+        env.code_mem.emplace_back(0x14000000); // B .
+
+        for (size_t iteration = 0; iteration < 50; iteration++) {
+            const Vector d{RandInt<u64>(0, ~u64(0)), RandInt<u64>(0, ~u64(0))};
+            const Vector n{RandInt<u64>(0, ~u64(0)), RandInt<u64>(0, ~u64(0))};
+            const Vector m{RandInt<u64>(0, ~u64(0)), RandInt<u64>(0, ~u64(0))};
+
+            jit.SetPC(0);
+            for (const size_t i : {0, 4, 5, 6, 7, 8, 9}) {
+                jit.SetVector(i, d);
+            }
+            jit.SetVector(2, n);
+            jit.SetVector(3, m);
+
+            env.ticks_left = 8;
+            jit.Run();
+
+            SHA::State expected;
+            SHA::SHA1HashUpdateChoose(expected, to_state(d), to_state(n), to_state(m));
+            REQUIRE(to_state(jit.GetVector(0)) == expected);
+            SHA::SHA1HashUpdateMajority(expected, to_state(d), to_state(n), to_state(m));
+            REQUIRE(to_state(jit.GetVector(4)) == expected);
+            SHA::SHA1HashUpdateParity(expected, to_state(d), to_state(n), to_state(m));
+            REQUIRE(to_state(jit.GetVector(5)) == expected);
+            SHA::SHA256HashPart1(expected, to_state(d), to_state(n), to_state(m));
+            REQUIRE(to_state(jit.GetVector(6)) == expected);
+            SHA::SHA256HashPart2(expected, to_state(n), to_state(d), to_state(m));
+            REQUIRE(to_state(jit.GetVector(7)) == expected);
+            SHA::SHA256MessageSchedule0(expected, to_state(d), to_state(n));
+            REQUIRE(to_state(jit.GetVector(8)) == expected);
+            SHA::SHA256MessageSchedule1(expected, to_state(d), to_state(n), to_state(m));
+            REQUIRE(to_state(jit.GetVector(9)) == expected);
+        }
+    }
+}
+
+TEST_CASE("A64: CRC32 and CRC32C", "[a64]") {
+    // Without SSE4.2 and PCLMULQDQ both are computed by table lookup.
+    for (const HostFeature disabled_host_features : {no_host_features, HostFeature::SSE42 | HostFeature::PCLMULQDQ}) {
+        A64TestEnv env;
+        A64::UserConfig conf{&env};
+        conf.disabled_host_features = disabled_host_features;
+        A64::Jit jit{conf};
+
+        env.code_mem.emplace_back(0x1ac24020); // CRC32B W0, W1, W2
+        env.code_mem.emplace_back(0x1ac24423); // CRC32H W3, W1, W2
+        env.code_mem.emplace_back(0x1ac24824); // CRC32W W4, W1, W2
+        env.code_mem.emplace_back(0x9ac24c25); // CRC32X W5, W1, X2
+        env.code_mem.emplace_back(0x1ac25026); // CRC32CB W6, W1, W2
+        env.code_mem.emplace_back(0x1ac25427); // CRC32CH W7, W1, W2
+        env.code_mem.emplace_back(0x1ac25828); // CRC32CW W8, W1, W2
+        env.code_mem.emplace_back(0x9ac25c29); // CRC32CX W9, W1, X2
+        env.code_mem.emplace_back(0x14000000); // B .
+
+        jit.SetPC(0);
+        jit.SetRegister(1, 0xdeadbeef);
+        jit.SetRegister(2, 0x0123456789abcd5a);
+
+        env.ticks_left = 9;
+        jit.Run();
+
+        REQUIRE(jit.GetRegister(0) == 0xbbd5eabd);
+        REQUIRE(jit.GetRegister(3) == 0x50bea4d6);
+        REQUIRE(jit.GetRegister(4) == 0xdf4e0b70);
+        REQUIRE(jit.GetRegister(5) == 0x06f225d5);
+        REQUIRE(jit.GetRegister(6) == 0x873acb6b);
+        REQUIRE(jit.GetRegister(7) == 0x846d6885);
+        REQUIRE(jit.GetRegister(8) == 0x9a0bdefc);
+        REQUIRE(jit.GetRegister(9) == 0xefe61134);
+    }
+}
+
+TEST_CASE("A64: SM4E and SM4EKEY", "[a64]") {
+    // Without GFNI the S-box is looked up with pshufb, and without SSSE3 with general-purpose registers.
+    for (const HostFeature disabled_host_features : {no_host_features, HostFeature::GFNI, HostFeature::GFNI | HostFeature::SSSE3}) {
+        A64TestEnv env;
+        A64::UserConfig conf{&env};
+        conf.disabled_host_features = disabled_host_features;
+        A64::Jit jit{conf};
+
+        env.code_mem.emplace_back(0xcec08440); // SM4E V0.4S, V2.4S
+        env.code_mem.emplace_back(0xce63c841); // SM4EKEY V1.4S, V2.4S, V3.4S
+        env.code_mem.emplace_back(0x14000000); // B .
+
+        jit.SetPC(0);
+        jit.SetVector(0, {0x0123456789abcdef, 0xfedcba9876543210});
+        jit.SetVector(2, {0x1122334455667788, 0x99aabbccddeeff00});
+        jit.SetVector(3, {0x0f1e2d3c4b5a6978, 0x8796a5b4c3d2e1f0});
+
+        env.ticks_left = 3;
+        jit.Run();
+
+        REQUIRE(jit.GetVector(0) == Vector{0x66ae43c79862770c, 0x8e05b19e53a55619});
+        REQUIRE(jit.GetVector(1) == Vector{0x4223e3fdffd34bdd, 0xf1e07c2a685bfc23});
+    }
+}
+
+TEST_CASE("A64: CRC32 and SM4 agree across host features", "[a64]") {
+    const std::array<HostFeature, 3> feature_sets{
+        no_host_features,
+        HostFeature::GFNI | HostFeature::PCLMULQDQ,
+        HostFeature::GFNI | HostFeature::SSSE3 | HostFeature::SSE42 | HostFeature::PCLMULQDQ,
+    };
+
+    std::vector<std::unique_ptr<A64TestEnv>> envs;
+    std::vector<std::unique_ptr<A64::Jit>> jits;
+    for (const HostFeature disabled_host_features : feature_sets) {
+        auto& env = envs.emplace_back(std::make_unique<A64TestEnv>());
+        A64::UserConfig conf{env.get()};
+        conf.disabled_host_features = disabled_host_features;
+        jits.emplace_back(std::make_unique<A64::Jit>(conf));
+
+        env->code_mem.emplace_back(0x1ac24020); // CRC32B W0, W1, W2
+        env->code_mem.emplace_back(0x1ac24423); // CRC32H W3, W1, W2
+        env->code_mem.emplace_back(0x1ac24824); // CRC32W W4, W1, W2
+        env->code_mem.emplace_back(0x9ac24c25); // CRC32X W5, W1, X2
+        env->code_mem.emplace_back(0x1ac25026); // CRC32CB W6, W1, W2
+        env->code_mem.emplace_back(0x1ac25427); // CRC32CH W7, W1, W2
+        env->code_mem.emplace_back(0x1ac25828); // CRC32CW W8, W1, W2
+        env->code_mem.emplace_back(0x9ac25c29); // CRC32CX W9, W1, X2
+        env->code_mem.emplace_back(0xcec08440); // SM4E V0.4S, V2.4S
+        env->code_mem.emplace_back(0xce63c841); // SM4EKEY V1.4S, V2.4S, V3.4S
+        env->code_mem.emplace_back(0x14000000); // B .
+    }
+
+    for (size_t iteration = 0; iteration < 100; iteration++) {
+        const u64 crc = RandInt<u64>(0, ~u64(0));
+        const u64 value = RandInt<u64>(0, ~u64(0));
+        const Vector v0{RandInt<u64>(0, ~u64(0)), RandInt<u64>(0, ~u64(0))};
+        const Vector v2{RandInt<u64>(0, ~u64(0)), RandInt<u64>(0, ~u64(0))};
+        const Vector v3{RandInt<u64>(0, ~u64(0)), RandInt<u64>(0, ~u64(0))};
+
+        for (size_t i = 0; i < jits.size(); i++) {
+            A64::Jit& jit = *jits[i];
+            jit.SetPC(0);
+            jit.SetRegister(1, crc);
+            jit.SetRegister(2, value);
+            jit.SetVector(0, v0);
+            jit.SetVector(2, v2);
+            jit.SetVector(3, v3);
+
+            envs[i]->ticks_left = 11;
+            jit.Run();
+        }
+
+        for (size_t i = 1; i < jits.size(); i++) {
+            for (const size_t reg : {0, 3, 4, 5, 6, 7, 8, 9}) {
+                REQUIRE(jits[i]->GetRegister(reg) == jits[0]->GetRegister(reg));
+            }
+            REQUIRE(jits[i]->GetVector(0) == jits[0]->GetVector(0));
+            REQUIRE(jits[i]->GetVector(1) == jits[0]->GetVector(1));
+        }
+    }
+}
+
 TEST_CASE("A64: 128-bit exclusive read/write", "[a64]") {
     A64TestEnv env;
     ExclusiveMonitor monitor{1};
@@ -450,6 +692,52 @@ TEST_CASE("A64: FMADD (0x80800000)", "[a64]") {
     REQUIRE(jit.GetVector(25) == Vector{0x80000000, 0});
 }
 
+TEST_CASE("A64: Vector floating point NaN propagation", "[a64]") {
+    A64TestEnv env;
+    A64::Jit jit{A64::UserConfig{&env}};
+
+    env.code_mem.emplace_back(0x4e22d420); // FADD.4S V0, V1, V2
+    env.code_mem.emplace_back(0x4e22f423); // FMAX.4S V3, V1, V2
+    env.code_mem.emplace_back(0x4e22cc24); // FMLA.4S V4, V1, V2
+    env.code_mem.emplace_back(0x4e27ccc5); // FMLA.4S V5, V6, V7
+    env.code_mem.emplace_back(0x6e6afd28); // FDIV.2D V8, V9, V10
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    // Signalling NaNs take priority over quiet NaNs, then operands are taken in order.
+    // A quiet NaN addend to (inf * zero) produces the default NaN.
+
+    jit.SetPC(0);
+    jit.SetVector(1, {0x3f8000007fc00001, 0x7f8000007f800001});
+    jit.SetVector(2, {0x7fc000037f800002, 0xff8000007fc00004});
+    jit.SetVector(4, {0x7fc000067fc00005, 0x7fc000073f800000});
+    jit.SetVector(5, {0x7fc000087fc00008, 0x7fc000087fc00008});
+    jit.SetVector(6, {0x000000007f800000, 0x7f80000040000000});
+    jit.SetVector(7, {0xff80000000000000, 0x0000000140400000});
+    jit.SetVector(9, {0x0000000000000000, 0x7ff8000000000001});
+    jit.SetVector(10, {0x0000000000000000, 0x7ff0000000000002});
+    jit.SetFpcr(0);
+
+    env.ticks_left = 6;
+    jit.Run();
+
+    REQUIRE(jit.GetVector(0) == Vector{0x7fc000037fc00002, 0x7fc000007fc00001});
+    REQUIRE(jit.GetVector(3) == Vector{0x7fc000037fc00002, 0x7f8000007fc00001});
+    REQUIRE(jit.GetVector(4) == Vector{0x7fc000067fc00002, 0x7fc000077fc00001});
+    REQUIRE(jit.GetVector(5) == Vector{0x7fc000007fc00000, 0x7fc000087fc00008});
+    REQUIRE(jit.GetVector(8) == Vector{0x7ff8000000000000, 0x7ff8000000000002});
+
+    // With FZ, denormals are treated as zero for the purposes of the above.
+
+    jit.SetPC(12);
+    jit.SetVector(5, {0x7fc000087fc00008, 0x7fc000087fc00008});
+    jit.SetFpcr(0x01000000);
+
+    env.ticks_left = 3;
+    jit.Run();
+
+    REQUIRE(jit.GetVector(5) == Vector{0x7fc000007fc00000, 0x7fc000007fc00008});
+}
+
 TEST_CASE("A64: FNEG failed to zero upper", "[a64]") {
     A64TestEnv env;
     A64::Jit jit{A64::UserConfig{&env}};
@@ -491,6 +779,177 @@ TEST_CASE("A64: FRSQRTS", "[a64]") {
     REQUIRE(jit.GetVector(13) == Vector{0xff7fffff, 0});
 }
 
+TEST_CASE("A64: FRECPE/FRSQRTE/FRECPX/FRINT/FCVT (scalar)", "[a64]") {
+    A64TestEnv env;
+    A64::Jit jit{A64::UserConfig{&env}};
+
+    env.code_mem.emplace_back(0x5ea1d820); // FRECPE S0, S1
+    env.code_mem.emplace_back(0x5ee1d862); // FRECPE D2, D3
+    env.code_mem.emplace_back(0x5ef9d8a4); // FRECPE H4, H5
+    env.code_mem.emplace_back(0x7ea1d826); // FRSQRTE S6, S1
+    env.code_mem.emplace_back(0x7ee1d867); // FRSQRTE D7, D3
+    env.code_mem.emplace_back(0x7ef9d8a8); // FRSQRTE H8, H5
+    env.code_mem.emplace_back(0x5ea1f829); // FRECPX S9, S1
+    env.code_mem.emplace_back(0x5ee1f86a); // FRECPX D10, D3
+    env.code_mem.emplace_back(0x5ef9f8ab); // FRECPX H11, H5
+    env.code_mem.emplace_back(0x1e26402c); // FRINTA S12, S1
+    env.code_mem.emplace_back(0x1e66406d); // FRINTA D13, D3
+    env.code_mem.emplace_back(0x1ee640ae); // FRINTA H14, H5
+    env.code_mem.emplace_back(0x1e27402f); // FRINTX S15, S1
+    env.code_mem.emplace_back(0x1e674070); // FRINTX D16, D3
+    env.code_mem.emplace_back(0x1ee740b1); // FRINTX H17, H5
+    env.code_mem.emplace_back(0x1e24c032); // FRINTP S18, S1
+    env.code_mem.emplace_back(0x1e654073); // FRINTM D19, D3
+    env.code_mem.emplace_back(0x1ee5c0b4); // FRINTZ H20, H5
+    env.code_mem.emplace_back(0x1e23c035); // FCVT H21, S1
+    env.code_mem.emplace_back(0x1e63c076); // FCVT H22, D3
+    env.code_mem.emplace_back(0x1ee240b7); // FCVT S23, H5
+    env.code_mem.emplace_back(0x1ee2c0b8); // FCVT D24, H5
+    env.code_mem.emplace_back(0x1e244039); // FRINTN S25, S1
+    env.code_mem.emplace_back(0x1ee440ba); // FRINTN H26, H5
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    const std::vector<u32> inputs32 {
+        0x00000000, 0x80000000, 0x00000001, 0x807fffff, 0x00800000, 0x80800001, 0x3f000000, 0xbf000000,
+        0x3fc00000, 0xc0200000, 0x40400000, 0xbf7fffff, 0x3effffff, 0x4b000001, 0xcb7fffff, 0x7e800000,
+        0x7e7fffff, 0x7f000000, 0xfeffffff, 0x7f7fffff, 0x00400000, 0x3e4ccccd, 0x477fefff, 0x33800001,
+        0x387fc000, 0x7f800000, 0xff800000, 0x7fc01234, 0xff801234, 0x12345678, 0x9abcdef0, 0x40490fdb,
+    };
+    const std::vector<u64> inputs64 {
+        0x0000000000000000, 0x8000000000000000, 0x0000000000000001, 0x800fffffffffffff,
+        0x0010000000000000, 0x8010000000000001, 0x3fe0000000000000, 0xbfe0000000000000,
+        0x3ff8000000000000, 0xc004000000000000, 0x4330000000000001, 0x3fdfffffffffffff,
+        0x7fcfffffffffffff, 0x7fd0000000000000, 0xffefffffffffffff, 0x0008000000000000,
+        0x40effc0000000001, 0x40effbffffffffff, 0x3f10000000000001, 0x3e70000000000000,
+        0x36a0000000000001, 0x47efffffe0000001, 0x3ff0000010000000, 0xbff0000008000001,
+        0x7ff0000000000000, 0xfff0000000000000, 0x7ff8000000001234, 0xfff0000000001234,
+        0x123456789abcdef0, 0x9abcdef012345678, 0x400921fb54442d18, 0xc1e0000000200001,
+    };
+    const std::vector<u16> inputs16 {
+        0x0000, 0x8000, 0x0001, 0x83ff, 0x0400, 0x8401, 0x3800, 0xb800,
+        0x3e00, 0xc100, 0x4200, 0xbbff, 0x37ff, 0x6401, 0xe7ff, 0x7800,
+        0x77ff, 0x7bff, 0xfbff, 0x0200, 0x3266, 0x1234, 0x9abc, 0x4248,
+        0x5bff, 0x7c00, 0xfc00, 0x7e12, 0xfc12, 0x6bff, 0x3c01, 0xbc00,
+    };
+
+    // FPCR.FZ16, FZ, DN and RMode.
+    for (const u32 fpcr_value : {0x00000000, 0x00080000, 0x01000000, 0x02000000, 0x00400000, 0x00800000, 0x00c00000, 0x03c80000}) {
+        const FP::FPCR fpcr{fpcr_value};
+        const FP::RoundingMode rmode = fpcr.RMode();
+
+        for (size_t i = 0; i < inputs32.size(); i++) {
+            const u32 s = inputs32[i];
+            const u64 d = inputs64[i];
+            const u16 h = inputs16[i];
+
+            FP::FPSR fpsr;
+            const std::vector<std::pair<size_t, u64>> expected {
+                {0, FP::FPRecipEstimate<u32>(s, fpcr, fpsr)},
+                {2, FP::FPRecipEstimate<u64>(d, fpcr, fpsr)},
+                {4, FP::FPRecipEstimate<u16>(h, fpcr, fpsr)},
+                {6, FP::FPRSqrtEstimate<u32>(s, fpcr, fpsr)},
+                {7, FP::FPRSqrtEstimate<u64>(d, fpcr, fpsr)},
+                {8, FP::FPRSqrtEstimate<u16>(h, fpcr, fpsr)},
+                {9, FP::FPRecipExponent<u32>(s, fpcr, fpsr)},
+                {10, FP::FPRecipExponent<u64>(d, fpcr, fpsr)},
+                {11, FP::FPRecipExponent<u16>(h, fpcr, fpsr)},
+                {12, FP::FPRoundInt<u32>(s, fpcr, FP::RoundingMode::ToNearest_TieAwayFromZero, false, fpsr)},
+                {13, FP::FPRoundInt<u64>(d, fpcr, FP::RoundingMode::ToNearest_TieAwayFromZero, false, fpsr)},
+                {14, FP::FPRoundInt<u16>(h, fpcr, FP::RoundingMode::ToNearest_TieAwayFromZero, false, fpsr)},
+                {15, FP::FPRoundInt<u32>(s, fpcr, rmode, true, fpsr)},
+                {16, FP::FPRoundInt<u64>(d, fpcr, rmode, true, fpsr)},
+                {17, FP::FPRoundInt<u16>(h, fpcr, rmode, true, fpsr)},
+                {18, FP::FPRoundInt<u32>(s, fpcr, FP::RoundingMode::TowardsPlusInfinity, false, fpsr)},
+                {19, FP::FPRoundInt<u64>(d, fpcr, FP::RoundingMode::TowardsMinusInfinity, false, fpsr)},
+                {20, FP::FPRoundInt<u16>(h, fpcr, FP::RoundingMode::TowardsZero, false, fpsr)},
+                {21, FP::FPConvert<u16, u32>(s, fpcr, rmode, fpsr)},
+                {22, FP::FPConvert<u16, u64>(d, fpcr, rmode, fpsr)},
+                {23, FP::FPConvert<u32, u16>(h, fpcr, rmode, fpsr)},
+                {24, FP::FPConvert<u64, u16>(h, fpcr, rmode, fpsr)},
+                {25, FP::FPRoundInt<u32>(s, fpcr, FP::RoundingMode::ToNearest_TieEven, false, fpsr)},
+                {26, FP::FPRoundInt<u16>(h, fpcr, FP::RoundingMode::ToNearest_TieEven, false, fpsr)},
+            };
+
+            jit.SetPC(0);
+            jit.SetFpcr(fpcr_value);
+            jit.SetFpsr(0);
+            jit.SetVector(1, {s, 0});
+            jit.SetVector(3, {d, 0});
+            jit.SetVector(5, {h, 0});
+
+            env.ticks_left = env.code_mem.size();
+            jit.Run();
+
+            INFO("FPCR " << std::hex << fpcr_value << " inputs " << s << " " << d << " " << h);
+            for (const auto& [reg, value] : expected) {
+                INFO("V" << std::dec << reg);
+                REQUIRE(jit.GetVector(reg) == Vector{value, 0});
+            }
+            REQUIRE(jit.GetFpsr() == fpsr.Value());
+        }
+    }
+}
+
+TEST_CASE("A64: FRINT reports input denormal exceptions when flushing to zero", "[a64]") {
+    A64TestEnv env;
+    A64::Jit jit{A64::UserConfig{&env}};
+
+    env.code_mem.emplace_back(0x1e274020); // FRINTX S0, S1
+    env.code_mem.emplace_back(0x1e674062); // FRINTX D2, D3
+    env.code_mem.emplace_back(0x1e264024); // FRINTA S4, S1
+    env.code_mem.emplace_back(0x1e64c065); // FRINTP D5, D3
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    for (const auto& [s, d, expected_fpsr] : {std::tuple<u32, u64, u32>{0x807fffff, 0x0000000000000001, 0x80},
+                                              std::tuple<u32, u64, u32>{0x3fc00000, 0xc004000000000000, 0x10},
+                                              std::tuple<u32, u64, u32>{0x80000000, 0x0000000000000000, 0x00}}) {
+        jit.SetPC(0);
+        jit.SetFpcr(0x01000000);
+        jit.SetFpsr(0);
+        jit.SetVector(1, {s, 0});
+        jit.SetVector(3, {d, 0});
+
+        env.ticks_left = env.code_mem.size();
+        jit.Run();
+
+        FP::FPSR fpsr;
+        const FP::FPCR fpcr{0x01000000};
+        INFO("inputs " << std::hex << s << " " << d);
+        REQUIRE(jit.GetVector(0) == Vector{FP::FPRoundInt<u32>(s, fpcr, FP::RoundingMode::ToNearest_TieEven, true, fpsr), 0});
+        REQUIRE(jit.GetVector(2) == Vector{FP::FPRoundInt<u64>(d, fpcr, FP::RoundingMode::ToNearest_TieEven, true, fpsr), 0});
+        REQUIRE(jit.GetVector(4) == Vector{FP::FPRoundInt<u32>(s, fpcr, FP::RoundingMode::ToNearest_TieAwayFromZero, false, fpsr), 0});
+        REQUIRE(jit.GetVector(5) == Vector{FP::FPRoundInt<u64>(d, fpcr, FP::RoundingMode::TowardsPlusInfinity, false, fpsr), 0});
+        REQUIRE(fpsr.Value() == expected_fpsr);
+        REQUIRE(jit.GetFpsr() == expected_fpsr);
+    }
+}
+
+TEST_CASE("A64: FCVT (double to half) only signals invalid operation for signalling NaNs", "[a64]") {
+    A64TestEnv env;
+    A64::Jit jit{A64::UserConfig{&env}};
+
+    env.code_mem.emplace_back(0x1e63c076); // FCVT H22, D3
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    for (const auto& [d, expected_fpsr] : {std::tuple<u64, u32>{0x7ff8000000001234, 0x00},
+                                           std::tuple<u64, u32>{0xfff8000000000000, 0x00},
+                                           std::tuple<u64, u32>{0x7ff0000000001234, 0x01}}) {
+        jit.SetPC(0);
+        jit.SetFpcr(0);
+        jit.SetFpsr(0);
+        jit.SetVector(3, {d, 0});
+
+        env.ticks_left = env.code_mem.size();
+        jit.Run();
+
+        FP::FPSR fpsr;
+        INFO("input " << std::hex << d);
+        REQUIRE(jit.GetVector(22) == Vector{FP::FPConvert<u16, u64>(d, FP::FPCR{0}, FP::RoundingMode::ToNearest_TieEven, fpsr), 0});
+        REQUIRE(fpsr.Value() == expected_fpsr);
+        REQUIRE(jit.GetFpsr() == expected_fpsr);
+    }
+}
+
 TEST_CASE("A64: SQDMULH.8H (saturate)", "[a64]") {
     A64TestEnv env;
     A64::Jit jit{A64::UserConfig{&env}};
@@ -533,6 +992,95 @@ TEST_CASE("A64: SQDMULH.4S (saturate)", "[a64]") {
     REQUIRE(FP::FPSR{jit.GetFpsr()}.QC() == true);
 }
 
+TEST_CASE("A64: SRSHL/URSHL", "[a64]") {
+    A64TestEnv env;
+    A64::Jit jit{A64::UserConfig{&env}};
+
+    env.code_mem.emplace_back(0x4ea25420); // SRSHL.4S V0, V1, V2
+    env.code_mem.emplace_back(0x6ea25423); // URSHL.4S V3, V1, V2
+    env.code_mem.emplace_back(0x4ee55424); // SRSHL.2D V4, V1, V5
+    env.code_mem.emplace_back(0x6ee55426); // URSHL.2D V6, V1, V5
+    env.code_mem.emplace_back(0x4e625427); // SRSHL.8H V7, V1, V2
+    env.code_mem.emplace_back(0x6e625428); // URSHL.8H V8, V1, V2
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    // Shift amounts are the bottom byte of each element, and include out of range values
+
+    jit.SetPC(0);
+    jit.SetVector(1, {0x8000000112345678, 0xFFFFFFF07FFFFFFF});
+    jit.SetVector(2, {0x000000E0FFFFFFFC, 0x1234568000000003});
+    jit.SetVector(5, {0x00000000000000C1, 0x0000000000000004});
+
+    env.ticks_left = 7;
+    jit.Run();
+
+    REQUIRE(jit.GetVector(0) == Vector{0x0000000001234568, 0x00000000fffffff8});
+    REQUIRE(jit.GetVector(3) == Vector{0x0000000101234568, 0x00000000fffffff8});
+    REQUIRE(jit.GetVector(4) == Vector{0xffffffffffffffff, 0xffffff07fffffff0});
+    REQUIRE(jit.GetVector(6) == Vector{0x0000000000000001, 0xffffff07fffffff0});
+    REQUIRE(jit.GetVector(7) == Vector{0x80000000091a0568, 0x000000007ffffff8});
+    REQUIRE(jit.GetVector(8) == Vector{0x80000000091a0568, 0x000000007ffffff8});
+}
+
+TEST_CASE("A64: SMAXP/UMAXP/SMINP/UMINP (8-bit and 16-bit)", "[a64]") {
+    A64TestEnv env;
+    A64::Jit jit{A64::UserConfig{&env}};
+
+    env.code_mem.emplace_back(0x4e22a420); // SMAXP.16B V0, V1, V2
+    env.code_mem.emplace_back(0x6e62ac23); // UMINP.8H V3, V1, V2
+    env.code_mem.emplace_back(0x6e22a424); // UMAXP.16B V4, V1, V2
+    env.code_mem.emplace_back(0x4e62ac25); // SMINP.8H V5, V1, V2
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetPC(0);
+    jit.SetVector(1, {0x8000000112345678, 0xFFFFFFF07FFFFFFF});
+    jit.SetVector(2, {0x000000E0FFFFFFFC, 0x1234568000000003});
+
+    env.ticks_left = 5;
+    jit.Run();
+
+    REQUIRE(jit.GetVector(0) == Vector{0xffff7fff00013478, 0x345600030000ffff});
+    REQUIRE(jit.GetVector(3) == Vector{0xfff07fff00011234, 0x123400000000fffc});
+    REQUIRE(jit.GetVector(4) == Vector{0xffffffff80013478, 0x3480000300e0ffff});
+    REQUIRE(jit.GetVector(5) == Vector{0xfff0ffff80001234, 0x123400000000fffc});
+}
+
+TEST_CASE("A64: CLZ.4S", "[a64]") {
+    A64TestEnv env;
+    A64::Jit jit{A64::UserConfig{&env}};
+
+    env.code_mem.emplace_back(0x6ea04820); // CLZ.4S V0, V1
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    // 0x01FFFFFF would round up to the next power of two if converted to floating point directly
+
+    jit.SetPC(0);
+    jit.SetVector(1, {0x0000000080000000, 0x01FFFFFF00000001});
+
+    env.ticks_left = 2;
+    jit.Run();
+
+    REQUIRE(jit.GetVector(0) == Vector{0x0000002000000000, 0x000000070000001f});
+}
+
+TEST_CASE("A64: URECPE/URSQRTE", "[a64]") {
+    A64TestEnv env;
+    A64::Jit jit{A64::UserConfig{&env}};
+
+    env.code_mem.emplace_back(0x4ea1c820); // URECPE.4S V0, V1
+    env.code_mem.emplace_back(0x6ea1c822); // URSQRTE.4S V2, V1
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetPC(0);
+    jit.SetVector(1, {0x800000007FFFFFFF, 0x3FFFFFFFC0000000});
+
+    env.ticks_left = 3;
+    jit.Run();
+
+    REQUIRE(jit.GetVector(0) == Vector{0xff800000ffffffff, 0xffffffffaa800000});
+    REQUIRE(jit.GetVector(2) == Vector{0xb4800000b5000000, 0xffffffff93800000});
+}
+
 TEST_CASE("A64: This is an infinite loop if fast dispatch is enabled", "[a64]") {
     A64TestEnv env;
     A64::UserConfig conf{&env};
@@ -669,30 +1217,1300 @@ TEST_CASE("A64: IC", "[a64]") {
     REQUIRE(jit.GetPC() == 4);
 }
 
-TEST_CASE("A64: Cache Maintenance Instructions", "[a64]") {
-    class CacheMaintenanceTestEnv final : public A64TestEnv {
-        void InstructionCacheOperationRaised(A64::InstructionCacheOperation op, VAddr value) override {
-            REQUIRE(op == A64::InstructionCacheOperation::InvalidateByVAToPoU);
-            REQUIRE(value == 0xcafed00d);
-        }
-        void DataCacheOperationRaised(A64::DataCacheOperation op, VAddr value) override {
-            REQUIRE(op == A64::DataCacheOperation::InvalidateByVAToPoC);
-            REQUIRE(value == 0xcafebabe);
-        }
-    };
-
-    CacheMaintenanceTestEnv env;
+TEST_CASE("A64: Invalidating a followed branch target", "[a64]") {
+    A64TestEnv env;
     A64::UserConfig conf{&env};
-    conf.hook_data_cache_operations = true;
+    conf.optimizations |= OptimizationFlag::Unsafe_BranchFollowing;
+    conf.unsafe_optimizations = true;
     A64::Jit jit{conf};
 
-    jit.SetRegister(0, 0xcafed00d);
-    jit.SetRegister(1, 0xcafebabe);
+    env.code_mem.emplace_back(0xd2800020); // MOV X0, #1
+    env.code_mem.emplace_back(0x14000003); // B +12
+    env.code_mem.emplace_back(0xd503201f); // NOP
+    env.code_mem.emplace_back(0xd503201f); // NOP
+    env.code_mem.emplace_back(0x91000800); // ADD X0, X0, #2
+    env.code_mem.emplace_back(0x14000000); // B .
 
-    env.code_mem.emplace_back(0xd50b7520); // ic ivau, x0
-    env.code_mem.emplace_back(0xd5087621); // dc ivac, x1
+    jit.SetPC(0);
+    env.ticks_left = 4;
+    jit.Run();
+
+    REQUIRE(jit.GetRegister(0) == 3);
+    REQUIRE(jit.GetPC() == 20);
+
+    env.code_mem[4] = 0x91001000; // ADD X0, X0, #4
+    jit.InvalidateCacheRange(16, 4);
+
+    jit.SetPC(0);
+    env.ticks_left = 4;
+    jit.Run();
+
+    REQUIRE(jit.GetRegister(0) == 5);
+    REQUIRE(jit.GetPC() == 20);
+}
+
+TEST_CASE("A64: NZCV writes overwritten by the following block", "[a64]") {
+    A64TestEnv env;
+    A64::UserConfig conf{&env};
+    conf.optimizations |= OptimizationFlag::Unsafe_ElideExitFlags;
+    conf.unsafe_optimizations = true;
+    A64::Jit jit{conf};
+
+    env.code_mem.emplace_back(0xeb010020); // SUBS X0, X1, X1
+    env.code_mem.emplace_back(0x14000002); // B +8
+    env.code_mem.emplace_back(0xd503201f); // NOP
+    env.code_mem.emplace_back(0xeb03005f); // CMP X2, X3
+    env.code_mem.emplace_back(0x9a9f57e4); // CSET X4, MI
     env.code_mem.emplace_back(0x14000000); // B .
 
+    jit.SetRegister(2, 1);
+    jit.SetRegister(3, 2);
+
+    // The write to NZCV by SUBS is elided, which is visible when returning before CMP.
+    jit.SetPC(0);
+    env.ticks_left = 2;
+    jit.Run();
+
+    REQUIRE(jit.GetPC() == 12);
+    REQUIRE(jit.GetPstate() == 0);
+
+    env.ticks_left = 3;
+    jit.Run();
+
+    REQUIRE(jit.GetRegister(4) == 1);
+    REQUIRE(jit.GetPstate() == 0x80000000);
+
+    // The block ending in B depends on the code following it.
+    env.code_mem[3] = 0x9a9f17e5; // CSET X5, EQ
+    jit.InvalidateCacheRange(12, 4);
+
+    jit.SetPC(0);
+    jit.SetPstate(0);
+    env.ticks_left = 2;
+    jit.Run();
+
+    REQUIRE(jit.GetPC() == 12);
+    REQUIRE(jit.GetPstate() == 0x60000000);
+
     env.ticks_left = 3;
     jit.Run();
+
+    REQUIRE(jit.GetRegister(5) == 1);
+}
+
+TEST_CASE("A64: Tiered compilation", "[a64]") {
+    A64TestEnv env;
+    A64::UserConfig conf{&env};
+    conf.tiered_compilation_threshold = 10;
+    A64::Jit jit{conf};
+
+    env.code_mem.emplace_back(0x91000400); // ADD X0, X0, #1
+    env.code_mem.emplace_back(0x8b000021); // ADD X1, X1, X0
+    env.code_mem.emplace_back(0xf101901f); // CMP X0, #100
+    env.code_mem.emplace_back(0x54ffffa1); // B.NE -12
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetPC(0);
+    env.ticks_left = 1000;
+    jit.Run();
+
+    REQUIRE(jit.GetRegister(0) == 100);
+    REQUIRE(jit.GetRegister(1) == 5050);
+    REQUIRE(jit.GetPC() == 16);
+}
+
+TEST_CASE("A64: Tiered compilation recompiles hot blocks", "[a64]") {
+    A64TestEnv env;
+    A64::UserConfig conf{&env};
+    conf.tiered_compilation_threshold = 10;
+    A64::Jit jit{conf};
+
+    // The loop body is reached through RET, and therefore through the fast dispatch table.
+    env.code_mem.emplace_back(0x91000400); // ADD X0, X0, #1
+    env.code_mem.emplace_back(0xf1000421); // SUBS X1, X1, #1
+    env.code_mem.emplace_back(0x54000040); // B.EQ +8
+    env.code_mem.emplace_back(0xd65f03c0); // RET
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetRegister(1, 1);
+    jit.SetRegister(30, 0);
+    jit.SetPC(0);
+    env.ticks_left = 10;
+    jit.Run();
+
+    REQUIRE(jit.GetRegister(0) == 1);
+    REQUIRE(jit.GetPC() == 16);
+
+    // This is not invalidated, so only a recompilation of the block observes it.
+    env.code_mem[0] = 0x91000800; // ADD X0, X0, #2
+
+    jit.SetRegister(1, 100);
+    jit.SetPC(0);
+    env.ticks_left = 1000;
+    jit.Run();
+
+    // Eight more executions of the tier-0 code reach the threshold. The other 92 run recompiled code.
+    REQUIRE(jit.GetRegister(0) == 1 + 8 + 92 * 2);
+    REQUIRE(jit.GetPC() == 16);
+}
+
+TEST_CASE("A64: Evicting the oldest code region", "[a64]") {
+    A64TestEnv env;
+    A64::UserConfig conf{&env};
+    conf.code_cache_size = 32 * 1024 * 1024;
+    conf.far_code_offset = 16 * 1024 * 1024;
+    // Blocks stay at tier zero, so the counters of evicted blocks are reused by later ones.
+    conf.tiered_compilation_threshold = GENERATE(0, 20000);
+    A64::Jit jit{conf};
+
+    const auto branch_to = [&](u64 target) {
+        const s64 offset = static_cast<s64>(target - env.code_mem.size() * 4);
+        return static_cast<u32>(0x14000000 | ((offset / 4) & 0x3FFFFFF));
+    };
+    const auto run = [&](u64 pc) {
+        jit.SetPC(pc);
+        env.ticks_left = 1;
+        jit.Run();
+    };
+
+    // These are compiled first, and are therefore in the first region evicted.
+    env.code_mem.emplace_back(0x91000400); // ADD X0, X0, #1
+    env.code_mem.emplace_back(0x14000000); // B .
+    env.code_mem.emplace_back(0x91000442); // ADD X2, X2, #1
+    env.code_mem.emplace_back(0x14000000); // B .
+    run(0);
+    run(8);
+    REQUIRE(jit.GetRegister(0) == 1);
+    REQUIRE(jit.GetRegister(2) == 1);
+
+    // This is not invalidated, so only a recompilation of the blocks observes it.
+    env.code_mem[0] = 0x91000800; // ADD X0, X0, #2
+    env.code_mem[2] = 0x91000842; // ADD X2, X2, #2
+
+    u64 linking_block = 0;
+    for (size_t i = 0;; i++) {
+        REQUIRE(i < 10000);
+
+        linking_block = env.code_mem.size() * 4;
+        env.code_mem.emplace_back(0x91000421); // ADD X1, X1, #1
+        env.code_mem.emplace_back(branch_to(0));
+        run(linking_block);
+
+        const u64 filler = env.code_mem.size() * 4;
+        for (size_t j = 0; j < 1000; j++) {
+            env.code_mem.emplace_back(0x4e22cc20); // FMLA V0.4S, V1.4S, V2.4S
+        }
+        env.code_mem.emplace_back(0x14000000); // B .
+        run(filler);
+
+        // Code outside code_mem is B . at every address, so this compiles a new block that is
+        // likely to be the one that finds the region full.
+        run(0x80000000 + i * 4);
+
+        const u64 previous_x2 = jit.GetRegister(2);
+        run(8);
+        if (jit.GetRegister(2) != previous_x2 + 1) {
+            REQUIRE(jit.GetRegister(2) == previous_x2 + 2);
+            break;
+        }
+    }
+
+    // The last linking block was compiled after the first region had filled, and survives.
+    env.code_mem[linking_block / 4] = 0x91000821; // ADD X1, X1, #2
+
+    const u64 previous_x1 = jit.GetRegister(1);
+    jit.SetRegister(0, 0);
+    jit.SetPC(linking_block);
+    env.ticks_left = 4;
+    jit.Run();
+
+    // Its link to the evicted block was undone, so it reaches the recompiled block rather than
+    // whatever code has since been placed at the old address.
+    REQUIRE(jit.GetRegister(0) == 2);
+    REQUIRE(jit.GetRegister(1) == previous_x1 + 1);
+    REQUIRE(jit.GetPC() == 4);
+}
+
+TEST_CASE("A64: Background translation", "[a64]") {
+    A64TestEnv env;
+    A64::UserConfig conf{&env};
+    conf.background_translation_threads = 2;
+    A64::Jit jit{conf};
+
+    env.code_mem.emplace_back(0x91000400); // ADD X0, X0, #1
+    env.code_mem.emplace_back(0xb4000061); // CBZ X1, +12
+    env.code_mem.emplace_back(0x91000442); // ADD X2, X2, #1
+    env.code_mem.emplace_back(0x14000002); // B +8
+    env.code_mem.emplace_back(0x91000463); // ADD X3, X3, #1
+    env.code_mem.emplace_back(0xf101901f); // CMP X0, #100
+    env.code_mem.emplace_back(0x54ffff41); // B.NE -24
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetPC(0);
+    env.ticks_left = 2000;
+    jit.Run();
+
+    REQUIRE(jit.GetRegister(0) == 100);
+    REQUIRE(jit.GetRegister(2) == 0);
+    REQUIRE(jit.GetRegister(3) == 100);
+    REQUIRE(jit.GetPC() == 28);
+
+    // Translations made before the invalidation must not be used afterwards.
+    // Invalidation waits for background translations in flight, so no worker reads code_mem while it is modified.
+    jit.InvalidateCacheRange(16, 4);
+    env.code_mem[4] = 0x91000863; // ADD X3, X3, #2
+
+    jit.SetRegister(0, 0);
+    jit.SetRegister(3, 0);
+    jit.SetPC(0);
+    env.ticks_left = 2000;
+    jit.Run();
+
+    REQUIRE(jit.GetRegister(0) == 100);
+    REQUIRE(jit.GetRegister(3) == 200);
+}
+
+TEST_CASE("A64: Persistent translation cache", "[a64]") {
+    const std::string path = (std::filesystem::temp_directory_path() / "dynarmic_test_translation_cache.bin").string();
+    std::remove(path.c_str());
+    SCOPE_EXIT { std::remove(path.c_str()); };
+
+    const auto file_size = [&path] {
+        return static_cast<size_t>(std::ifstream{path, std::ios::binary | std::ios::ate}.tellg());
+    };
+
+    A64TestEnv env;
+    env.code_mem.emplace_back(0x91000400); // ADD X0, X0, #1
+    env.code_mem.emplace_back(0xf101901f); // CMP X0, #100
+    env.code_mem.emplace_back(0x54ffffc1); // B.NE -8
+    env.code_mem.emplace_back(0x91000421); // ADD X1, X1, #1
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    const auto run = [&env, &path](size_t size_limit = 64 * 1024 * 1024) {
+        A64::UserConfig conf{&env};
+        conf.translation_cache_path = path;
+        conf.translation_cache_size_limit = size_limit;
+        A64::Jit jit{conf};
+        jit.SetPC(0);
+        env.ticks_left = 1000;
+        jit.Run();
+        return std::make_tuple(jit.GetRegister(0), jit.GetRegister(1), jit.GetPC());
+    };
+
+    REQUIRE(run() == std::make_tuple(100, 1, 16));
+    const size_t populated_size = file_size();
+
+    // A warm start compiles the same blocks from the cache, adding nothing to it.
+    REQUIRE(run() == std::make_tuple(100, 1, 16));
+    REQUIRE(file_size() == populated_size);
+
+    // Cached blocks whose guest code has changed are not used.
+    env.code_mem[3] = 0x91000821; // ADD X1, X1, #2
+    REQUIRE(run() == std::make_tuple(100, 2, 16));
+    REQUIRE(file_size() > populated_size);
+
+    // A full file is started afresh, and then does not grow beyond the limit.
+    REQUIRE(run(populated_size) == std::make_tuple(100, 2, 16));
+    REQUIRE(file_size() <= populated_size);
+    env.code_mem[3] = 0x91000c21; // ADD X1, X1, #3
+    REQUIRE(run(populated_size) == std::make_tuple(100, 3, 16));
+    REQUIRE(file_size() <= populated_size);
+}
+
+TEST_CASE("A64: Shared code cache", "[a64]") {
+    class CountingTestEnv final : public A64TestEnv {
+    public:
+        size_t code_reads = 0;
+
+        std::uint32_t MemoryReadCode(u64 vaddr) override {
+            code_reads++;
+            return A64TestEnv::MemoryReadCode(vaddr);
+        }
+    };
+
+    constexpr size_t core_count = 4;
+    constexpr u64 counter_address = 0x1000;
+
+    // Guest code is only read through the callbacks the cache was constructed with.
+    CountingTestEnv code_env;
+    code_env.code_mem.emplace_back(0xd53bd042); // MRS X2, TPIDR_EL0
+    code_env.code_mem.emplace_back(0x94000004); // BL +16
+    code_env.code_mem.emplace_back(0xf1000463); // SUBS X3, X3, #1
+    code_env.code_mem.emplace_back(0x54ffffc1); // B.NE -8
+    code_env.code_mem.emplace_back(0x14000000); // B .
+    code_env.code_mem.emplace_back(0xf9400001); // LDR X1, [X0]
+    code_env.code_mem.emplace_back(0x8b020021); // ADD X1, X1, X2
+    code_env.code_mem.emplace_back(0xf9000001); // STR X1, [X0]
+    code_env.code_mem.emplace_back(0xd65f03c0); // RET
+
+    std::array<u64, core_count> tpidr{};
+    A64::UserConfig cache_conf{&code_env};
+    cache_conf.tpidr_el0 = &tpidr[0];
+    cache_conf.tiered_compilation_threshold = 10;
+    A64::SharedCodeCache cache{cache_conf};
+
+    std::array<CountingTestEnv, core_count> envs;
+    std::deque<A64::Jit> jits;
+    for (size_t i = 0; i < core_count; i++) {
+        A64::UserConfig conf = cache_conf;
+        conf.callbacks = &envs[i];
+        conf.processor_id = i;
+        conf.tpidr_el0 = &tpidr[i];
+        conf.shared_code_cache = &cache;
+        jits.emplace_back(conf);
+        tpidr[i] = i + 1;
+    }
+
+    const auto run = [&](size_t i) {
+        envs[i].MemoryWrite64(counter_address, 0);
+        jits[i].SetRegister(0, counter_address);
+        jits[i].SetRegister(3, 1000);
+        jits[i].SetPC(0);
+        envs[i].ticks_left = 100000;
+        jits[i].Run();
+    };
+
+    // Code compiled for one Jit is used by the others, with their own callbacks and TPIDR_EL0.
+    run(0);
+    const size_t code_reads = code_env.code_reads;
+    REQUIRE(code_reads > 0);
+    run(1);
+    REQUIRE(code_env.code_reads == code_reads);
+    REQUIRE(envs[0].MemoryRead64(counter_address) == 1000);
+    REQUIRE(envs[1].MemoryRead64(counter_address) == 2000);
+    REQUIRE(envs[0].code_reads == 0);
+    REQUIRE(envs[1].code_reads == 0);
+
+    // Invalidation through any Jit applies to all of them.
+    code_env.code_mem[6] = 0xcb020021; // SUB X1, X1, X2
+    jits[0].InvalidateCacheRange(24, 4);
+
+    // Concurrent execution, including invalidation requested while other Jits are executing.
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < core_count; i++) {
+        threads.emplace_back([&, i] {
+            if (i == 0) {
+                jits[i].ClearCache();
+            }
+            run(i);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < core_count; i++) {
+        INFO("core " << i);
+        REQUIRE(jits[i].GetPC() == 16);
+        REQUIRE(jits[i].GetRegister(3) == 0);
+        REQUIRE(envs[i].MemoryRead64(counter_address) == static_cast<u64>(-1000 * static_cast<s64>(i + 1)));
+    }
+}
+
+TEST_CASE("A64: Cache Maintenance Instructions", "[a64]") {
+    class CacheMaintenanceTestEnv final : public A64TestEnv {
+        void InstructionCacheOperationRaised(A64::InstructionCacheOperation op, VAddr value) override {
+            REQUIRE(op == A64::InstructionCacheOperation::InvalidateByVAToPoU);
+            REQUIRE(value == 0xcafed00d);
+        }
+        void DataCacheOperationRaised(A64::DataCacheOperation op, VAddr value) override {
+            REQUIRE(op == A64::DataCacheOperation::InvalidateByVAToPoC);
+            REQUIRE(value == 0xcafebabe);
+        }
+    };
+
+    CacheMaintenanceTestEnv env;
+    A64::UserConfig conf{&env};
+    conf.hook_data_cache_operations = true;
+    A64::Jit jit{conf};
+
+    jit.SetRegister(0, 0xcafed00d);
+    jit.SetRegister(1, 0xcafebabe);
+
+    env.code_mem.emplace_back(0xd50b7520); // ic ivau, x0
+    env.code_mem.emplace_back(0xd5087621); // dc ivac, x1
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    env.ticks_left = 3;
+    jit.Run();
+}
+
+TEST_CASE("A64: Fastmem", "[a64]") {
+    A64TestEnv env;
+
+    alignas(4096) static std::array<u8, 4096> backing_memory{};
+    backing_memory.fill(0);
+
+    A64::UserConfig conf{&env};
+    conf.fastmem_pointer = backing_memory.data();
+    conf.fastmem_address_space_bits = 12;
+    conf.silently_mirror_fastmem = true;
+    A64::Jit jit{conf};
+
+    env.code_mem.emplace_back(0xf9000001); // STR X1, [X0]
+    env.code_mem.emplace_back(0xf9400402); // LDR X2, [X0, #8]
+    env.code_mem.emplace_back(0x3dc00000); // LDR Q0, [X0]
+    env.code_mem.emplace_back(0x3d800400); // STR Q0, [X0, #16]
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetRegister(0, 0x1234'5000'0100);
+    jit.SetRegister(1, 0x0123'4567'89ab'cdef);
+    jit.SetPC(0);
+
+    backing_memory[0x108] = 0x42;
+
+    env.ticks_left = 5;
+    jit.Run();
+
+    REQUIRE(jit.GetRegister(2) == 0x42);
+    REQUIRE(jit.GetVector(0) == Vector{0x0123'4567'89ab'cdef, 0x42});
+    REQUIRE(backing_memory[0x110] == 0xef);
+    REQUIRE(backing_memory[0x118] == 0x42);
+    REQUIRE(env.modified_memory.empty());
+}
+
+#ifndef _WIN32
+TEST_CASE("A64: Fastmem faults recompile without fastmem", "[a64]") {
+    // The second page of the arena is inaccessible, so fastmem accesses to it fault.
+    u8* const arena = static_cast<u8*>(mmap(nullptr, 0x2000, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    REQUIRE(arena != MAP_FAILED);
+    SCOPE_EXIT { munmap(arena, 0x2000); };
+    REQUIRE(mprotect(arena, 0x1000, PROT_READ | PROT_WRITE) == 0);
+    std::memset(arena, 0xaa, 0x1000);
+
+    const bool recompile = GENERATE(true, false);
+
+    A64TestEnv env;
+    A64::UserConfig conf{&env};
+    conf.fastmem_pointer = arena;
+    conf.fastmem_address_space_bits = 13;
+    conf.silently_mirror_fastmem = true;
+    conf.recompile_on_fastmem_failure = recompile;
+    A64::Jit jit{conf};
+
+    env.code_mem.emplace_back(0xf9400001); // LDR X1, [X0]
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    const auto run = [&](u64 vaddr) {
+        jit.SetPC(0);
+        jit.SetRegister(0, vaddr);
+        env.ticks_left = 2;
+        jit.Run();
+        return jit.GetRegister(1);
+    };
+
+    // The faulting access is completed by the MemoryRead64 callback.
+    REQUIRE(run(0x1000) == 0x0706050403020100);
+
+    if (recompile) {
+        // The block has been recompiled to use the callback for this access.
+        REQUIRE(run(0x0010) == 0x1716151413121110);
+    } else {
+        REQUIRE(run(0x0010) == 0xaaaaaaaaaaaaaaaa);
+        REQUIRE(run(0x1008) == 0x0f0e0d0c0b0a0908);
+    }
+}
+#endif
+
+TEST_CASE("A64: Page table fallbacks preserve live registers", "[a64]") {
+    A64TestEnv env;
+
+    alignas(4096) static std::array<u8, 4096> backing_memory{};
+    for (size_t i = 0; i < backing_memory.size(); i++) {
+        backing_memory[i] = static_cast<u8>(i * 3);
+    }
+    std::array<void*, 256> page_table{};
+    page_table[0] = backing_memory.data();
+
+    A64::UserConfig conf{&env};
+    conf.page_table = page_table.data();
+    conf.page_table_address_space_bits = 20;
+    A64::Jit jit{conf};
+
+    // Keep more values live across the fallback accesses to [X5] than there are callee-saved registers.
+    env.code_mem.emplace_back(0xa9400801); // LDP X1, X2, [X0]
+    env.code_mem.emplace_back(0xa9411003); // LDP X3, X4, [X0, #16]
+    env.code_mem.emplace_back(0xa9421c06); // LDP X6, X7, [X0, #32]
+    env.code_mem.emplace_back(0xa9432408); // LDP X8, X9, [X0, #48]
+    env.code_mem.emplace_back(0xa9442c0a); // LDP X10, X11, [X0, #64]
+    env.code_mem.emplace_back(0x3dc00001); // LDR Q1, [X0]
+    env.code_mem.emplace_back(0xf94000ac); // LDR X12, [X5]
+    env.code_mem.emplace_back(0xf90004a1); // STR X1, [X5, #8]
+    env.code_mem.emplace_back(0x8b02002d); // ADD X13, X1, X2
+    env.code_mem.emplace_back(0x8b04006e); // ADD X14, X3, X4
+    env.code_mem.emplace_back(0x8b0700cf); // ADD X15, X6, X7
+    env.code_mem.emplace_back(0x8b090110); // ADD X16, X8, X9
+    env.code_mem.emplace_back(0x8b0b0151); // ADD X17, X10, X11
+    env.code_mem.emplace_back(0x4ee18422); // ADD V2.2D, V1.2D, V1.2D
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetRegister(0, 0x100);
+    jit.SetRegister(5, 0x2000);
+    jit.SetPC(0);
+
+    env.ticks_left = 15;
+    jit.Run();
+
+    const auto read = [](size_t offset) {
+        u64 value;
+        std::memcpy(&value, backing_memory.data() + 0x100 + offset, sizeof(u64));
+        return value;
+    };
+
+    REQUIRE(jit.GetRegister(12) == 0x0706050403020100);
+    REQUIRE(env.MemoryRead64(0x2008) == read(0));
+    REQUIRE(jit.GetRegister(13) == read(0) + read(8));
+    REQUIRE(jit.GetRegister(14) == read(16) + read(24));
+    REQUIRE(jit.GetRegister(15) == read(32) + read(40));
+    REQUIRE(jit.GetRegister(16) == read(48) + read(56));
+    REQUIRE(jit.GetRegister(17) == read(64) + read(72));
+    REQUIRE(jit.GetVector(2) == Vector{read(0) * 2, read(8) * 2});
+}
+
+TEST_CASE("A64: Software TLB", "[a64]") {
+    struct TLBTestEnv final : public A64TestEnv {
+        void* TranslatePage(u64 vaddr) override {
+            translate_count++;
+            return vaddr == mapped_vaddr ? mapped_host : nullptr;
+        }
+
+        u64 mapped_vaddr = 0;
+        void* mapped_host = nullptr;
+        size_t translate_count = 0;
+    };
+    TLBTestEnv env;
+
+    alignas(4096) static std::array<u8, 4096> first_page{};
+    alignas(4096) static std::array<u8, 4096> second_page{};
+    first_page.fill(0x11);
+    second_page.fill(0x22);
+
+    constexpr u64 page = 0x0000'7fff'1234'5000;
+    env.mapped_vaddr = page;
+    env.mapped_host = first_page.data();
+
+    A64::UserConfig conf{&env};
+    conf.tlb_entry_count = 256;
+    A64::Jit jit{conf};
+
+    env.code_mem.emplace_back(0xf9400001); // LDR X1, [X0]
+    env.code_mem.emplace_back(0xf9000402); // STR X2, [X0, #8]
+    env.code_mem.emplace_back(0xf9400083); // LDR X3, [X4]
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    const auto run = [&] {
+        jit.SetRegister(0, page + 0x100);
+        jit.SetRegister(2, 0x0123'4567'89ab'cdef);
+        jit.SetRegister(4, 0x2000);
+        jit.SetPC(0);
+        env.ticks_left = 4;
+        jit.Run();
+    };
+
+    run();
+
+    u64 stored;
+    std::memcpy(&stored, first_page.data() + 0x108, sizeof(u64));
+    REQUIRE(jit.GetRegister(1) == 0x1111'1111'1111'1111);
+    REQUIRE(stored == 0x0123'4567'89ab'cdef);
+    REQUIRE(jit.GetRegister(3) == 0x0706050403020100);
+    REQUIRE(env.modified_memory.empty());
+    // One refill for the mapped page, which the store then hits, and one for the unmapped page.
+    REQUIRE(env.translate_count == 2);
+
+    // Entries stay valid until they are invalidated.
+    env.mapped_host = second_page.data();
+    run();
+    REQUIRE(jit.GetRegister(1) == 0x1111'1111'1111'1111);
+    REQUIRE(env.translate_count == 3);
+
+    jit.InvalidateTLB(page + 0xff0, 0x20);
+    run();
+    std::memcpy(&stored, second_page.data() + 0x108, sizeof(u64));
+    REQUIRE(jit.GetRegister(1) == 0x2222'2222'2222'2222);
+    REQUIRE(stored == 0x0123'4567'89ab'cdef);
+    REQUIRE(env.translate_count == 5);
+}
+
+TEST_CASE("A64: Multi-level page table", "[a64]") {
+    A64TestEnv env;
+
+    alignas(4096) static std::array<u8, 4096> page{};
+    page.fill(0x33);
+    std::vector<u8> huge_page(2 * 1024 * 1024);
+    std::array<void*, 512> top_level{};
+    std::array<void*, 512> middle_level_a{};
+    std::array<void*, 512> middle_level_b{};
+    std::array<void*, 512> bottom_level{};
+
+    const auto index = [](u64 vaddr, size_t shift) { return (vaddr >> shift) & 511; };
+    constexpr u64 page_vaddr = 0x7f'1234'5000;
+    constexpr u64 huge_page_vaddr = 0x40'0020'0000;
+    top_level[index(page_vaddr, 30)] = middle_level_a.data();
+    middle_level_a[index(page_vaddr, 21)] = bottom_level.data();
+    bottom_level[index(page_vaddr, 12)] = page.data();
+    top_level[index(huge_page_vaddr, 30)] = middle_level_b.data();
+    middle_level_b[index(huge_page_vaddr, 21)] = reinterpret_cast<void*>(reinterpret_cast<u64>(huge_page.data()) | 1);
+
+    A64::UserConfig conf{&env};
+    conf.page_table = top_level.data();
+    conf.page_table_address_space_bits = 39;
+    conf.page_table_levels = 3;
+    conf.page_table_huge_pages = true;
+    conf.silently_mirror_page_table = false;
+    A64::Jit jit{conf};
+
+    env.code_mem.emplace_back(0xf9400001); // LDR X1, [X0]
+    env.code_mem.emplace_back(0xf9000062); // STR X2, [X3]
+    env.code_mem.emplace_back(0xf94000a4); // LDR X4, [X5]
+    env.code_mem.emplace_back(0xf94000e6); // LDR X6, [X7]
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetRegister(0, page_vaddr + 0x100);
+    jit.SetRegister(2, 0x0123'4567'89ab'cdef);
+    jit.SetRegister(3, huge_page_vaddr + 0x1f'f008);
+    jit.SetRegister(5, 0x7f'1240'0000);                 // Null middle level entry
+    jit.SetRegister(7, 0x80'0000'0000 | page_vaddr);    // Outside of the address space
+    jit.SetPC(0);
+
+    env.ticks_left = 5;
+    jit.Run();
+
+    u64 stored;
+    std::memcpy(&stored, huge_page.data() + 0x1f'f008, sizeof(u64));
+    REQUIRE(jit.GetRegister(1) == 0x3333'3333'3333'3333);
+    REQUIRE(stored == 0x0123'4567'89ab'cdef);
+    REQUIRE(jit.GetRegister(4) == 0x0706050403020100);
+    REQUIRE(jit.GetRegister(6) == 0x0706050403020100);
+    REQUIRE(env.modified_memory.empty());
+}
+
+TEST_CASE("A64: Page lookup reuse", "[a64]") {
+    A64TestEnv env;
+
+    alignas(4096) static std::array<u8, 4096> page0{};
+    alignas(4096) static std::array<u8, 4096> page1{};
+    alignas(4096) static std::array<u8, 4096> page3{};
+    page0.fill(0x11);
+    page1.fill(0x22);
+    page3.fill(0x44);
+    std::array<void*, 256> page_table{};
+    page_table[0] = page0.data();
+    page_table[1] = page1.data();
+    page_table[3] = page3.data();
+
+    A64::UserConfig conf{&env};
+    conf.page_table = page_table.data();
+    conf.page_table_address_space_bits = 20;
+    conf.optimizations |= OptimizationFlag::Unsafe_PageLookupReuse;
+    conf.unsafe_optimizations = true;
+    A64::Jit jit{conf};
+
+    // Accesses off the same base that are on different pages, or whose page has no host memory.
+    env.code_mem.emplace_back(0xf9400001); // LDR X1, [X0]
+    env.code_mem.emplace_back(0xf9400402); // LDR X2, [X0, #8]
+    env.code_mem.emplace_back(0xf9000801); // STR X1, [X0, #16]
+    env.code_mem.emplace_back(0xf9400083); // LDR X3, [X4]
+    env.code_mem.emplace_back(0xf9400885); // LDR X5, [X4, #16]
+    env.code_mem.emplace_back(0xa9401d06); // LDP X6, X7, [X8]
+    env.code_mem.emplace_back(0xf9400909); // LDR X9, [X8, #16]
+    env.code_mem.emplace_back(0x297f4410); // LDP W16, W17, [X0, #-8]
+    env.code_mem.emplace_back(0xf85e016a); // LDUR X10, [X11, #-32]
+    env.code_mem.emplace_back(0xf940016c); // LDR X12, [X11]
+    env.code_mem.emplace_back(0xf94001ae); // LDR X14, [X13]
+    env.code_mem.emplace_back(0xf94005af); // LDR X15, [X13, #8]
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetRegister(0, 0x0ff8);
+    jit.SetRegister(4, 0x1ff8);
+    jit.SetRegister(8, 0x2100);
+    jit.SetRegister(11, 0x1010);
+    jit.SetRegister(13, 0x2ff8);
+    jit.SetPC(0);
+
+    env.ticks_left = 13;
+    jit.Run();
+
+    u64 stored;
+    std::memcpy(&stored, page1.data() + 0x008, sizeof(u64));
+    REQUIRE(jit.GetRegister(1) == 0x1111'1111'1111'1111);
+    REQUIRE(jit.GetRegister(2) == 0x2222'2222'2222'2222);
+    REQUIRE(stored == 0x1111'1111'1111'1111);
+    REQUIRE(jit.GetRegister(3) == 0x2222'2222'2222'2222);
+    REQUIRE(jit.GetRegister(5) == 0x0f0e0d0c0b0a0908);
+    REQUIRE(jit.GetRegister(6) == 0x0706050403020100);
+    REQUIRE(jit.GetRegister(7) == 0x0f0e0d0c0b0a0908);
+    REQUIRE(jit.GetRegister(9) == 0x1716151413121110);
+    REQUIRE(jit.GetRegister(16) == 0x1111'1111);
+    REQUIRE(jit.GetRegister(17) == 0x1111'1111);
+    REQUIRE(jit.GetRegister(10) == 0x1111'1111'1111'1111);
+    REQUIRE(jit.GetRegister(12) == 0x2222'2222'2222'2222);
+    REQUIRE(jit.GetRegister(14) == 0xfffefdfcfbfaf9f8);
+    REQUIRE(jit.GetRegister(15) == 0x4444'4444'4444'4444);
+    REQUIRE(env.modified_memory.empty());
+
+    // Accesses off each of X0, X4, X8, X11 and X13 share one lookup, including pairs.
+    IR::Block block = A64::Translate(A64::LocationDescriptor{0, {}}, [&env](u64 vaddr) { return env.MemoryReadCode(vaddr); }, {});
+    Optimization::A64GetSetElimination(block);
+    Optimization::DeadCodeElimination(block);
+    Optimization::A64PageLookupReusePass(block);
+
+    const auto count = [&block](IR::Opcode op) {
+        return std::count_if(block.begin(), block.end(), [op](const IR::Inst& inst) { return inst.GetOpcode() == op; });
+    };
+    REQUIRE(count(IR::Opcode::A64LookupPage) == 5);
+    REQUIRE(count(IR::Opcode::A64ReadMemoryInPage64) == 9);
+    REQUIRE(count(IR::Opcode::A64WriteMemoryInPage64) == 1);
+    REQUIRE(count(IR::Opcode::A64ReadMemoryWideInPage64) == 1);
+    REQUIRE(count(IR::Opcode::A64ReadMemoryWideInPage128) == 1);
+    REQUIRE(count(IR::Opcode::A64ReadMemory64) == 0);
+    REQUIRE(count(IR::Opcode::A64WriteMemory64) == 0);
+    REQUIRE(count(IR::Opcode::A64ReadMemoryWide64) == 0);
+    REQUIRE(count(IR::Opcode::A64ReadMemoryWide128) == 0);
+}
+
+static void SetupLSEAtomicsTest(A64TestEnv& env, A64::Jit& jit, u64 base) {
+    env.code_mem.emplace_back(0xf8210002); // LDADD X1, X2, [X0]
+    env.code_mem.emplace_back(0xc8a57c06); // CAS X5, X6, [X0]
+    env.code_mem.emplace_back(0xc8e7fc08); // CASAL X7, X8, [X0]
+    env.code_mem.emplace_back(0x3829616a); // LDUMAXB W9, W10, [X11]
+    env.code_mem.emplace_back(0x38ac416d); // LDSMAXAB W12, W13, [X11]
+    env.code_mem.emplace_back(0x786e120f); // LDCLRLH W14, W15, [X16]
+    env.code_mem.emplace_back(0xb8318212); // SWP W17, W18, [X16]
+    env.code_mem.emplace_back(0x48347f16); // CASP X20, X21, X22, X23, [X24]
+    env.code_mem.emplace_back(0xf839501a); // LDSMIN X25, X26, [X0]
+    env.code_mem.emplace_back(0xb8fb221c); // LDEORAL W27, W28, [X16]
+    env.code_mem.emplace_back(0xf8233304); // LDSET X3, X4, [X24]
+    env.code_mem.emplace_back(0x783d717e); // LDUMINH W29, W30, [X11]
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetRegister(0, base + 0x000);
+    jit.SetRegister(11, base + 0x100);
+    jit.SetRegister(16, base + 0x200);
+    jit.SetRegister(24, base + 0x300);
+
+    jit.SetRegister(1, 5);
+    jit.SetRegister(5, 0x15);
+    jit.SetRegister(6, 0x1234);
+    jit.SetRegister(7, 0x99);
+    jit.SetRegister(8, 0xffff);
+    jit.SetRegister(9, 0x7f);
+    jit.SetRegister(10, 0xffff'ffff'ffff'ffff);
+    jit.SetRegister(12, 0x7f);
+    jit.SetRegister(13, 0xffff'ffff'ffff'ffff);
+    jit.SetRegister(14, 0xf0);
+    jit.SetRegister(17, 0x1234'5678);
+    jit.SetRegister(20, 1);
+    jit.SetRegister(21, 2);
+    jit.SetRegister(22, 3);
+    jit.SetRegister(23, 4);
+    jit.SetRegister(25, 0xffff'ffff'ffff'ffff);
+    jit.SetRegister(27, 0xffff'0000);
+    jit.SetRegister(3, 0xf0);
+    jit.SetRegister(29, 0x1000);
+    jit.SetRegister(30, 0xffff'ffff'ffff'ffff);
+    jit.SetPC(0);
+
+    env.ticks_left = 13;
+}
+
+static void CheckLSEAtomicsTestRegisters(A64::Jit& jit) {
+    REQUIRE(jit.GetRegister(2) == 0x10);
+    REQUIRE(jit.GetRegister(5) == 0x15);
+    REQUIRE(jit.GetRegister(7) == 0x1234);
+    REQUIRE(jit.GetRegister(10) == 0x80);
+    REQUIRE(jit.GetRegister(13) == 0x80);
+    REQUIRE(jit.GetRegister(15) == 0xffff);
+    REQUIRE(jit.GetRegister(18) == 0xff0f);
+    REQUIRE(jit.GetRegister(20) == 1);
+    REQUIRE(jit.GetRegister(21) == 2);
+    REQUIRE(jit.GetRegister(26) == 0x1234);
+    REQUIRE(jit.GetRegister(28) == 0x1234'5678);
+    REQUIRE(jit.GetRegister(4) == 3);
+    REQUIRE(jit.GetRegister(30) == 0x407f);
+}
+
+TEST_CASE("A64: Wide memory accesses", "[a64]") {
+    A64TestEnv env;
+
+    alignas(4096) static std::array<u8, 4096> page0{};
+    alignas(4096) static std::array<u8, 4096> page1{};
+    for (size_t i = 0; i < page0.size(); i++) {
+        page0[i] = static_cast<u8>(i * 7 + 1);
+    }
+    page1.fill(0x44);
+    std::array<void*, 256> page_table{};
+    page_table[0] = page0.data();
+    page_table[1] = page1.data();
+
+    A64::UserConfig conf{&env};
+    conf.page_table = page_table.data();
+    conf.page_table_address_space_bits = 20;
+    A64::Jit jit{conf};
+
+    env.code_mem.emplace_back(0xa9400801); // LDP X1, X2, [X0]
+    env.code_mem.emplace_back(0x29411003); // LDP W3, W4, [X0, #8]
+    env.code_mem.emplace_back(0x69421805); // LDPSW X5, X6, [X0, #16]
+    env.code_mem.emplace_back(0x2d436418); // LDP S24, S25, [X0, #24]
+    env.code_mem.emplace_back(0x6d422809); // LDP D9, D10, [X0, #32]
+    env.code_mem.emplace_back(0x0c406140); // LD1 {V0.8B, V1.8B, V2.8B}, [X10]
+    env.code_mem.emplace_back(0x0c408143); // LD2 {V3.8B, V4.8B}, [X10]
+    env.code_mem.emplace_back(0x4c404545); // LD3 {V5.8H, V6.8H, V7.8H}, [X10]
+    env.code_mem.emplace_back(0x4cdf0150); // LD4 {V16.16B, V17.16B, V18.16B, V19.16B}, [X10], #64
+    env.code_mem.emplace_back(0x4c000170); // ST4 {V16.16B, V17.16B, V18.16B, V19.16B}, [X11]
+    env.code_mem.emplace_back(0x4c004585); // ST3 {V5.8H, V6.8H, V7.8H}, [X12]
+    env.code_mem.emplace_back(0x0c0081a3); // ST2 {V3.8B, V4.8B}, [X13]
+    env.code_mem.emplace_back(0x0c0061c0); // ST1 {V0.8B, V1.8B, V2.8B}, [X14]
+    env.code_mem.emplace_back(0xa90009e1); // STP X1, X2, [X15]
+    env.code_mem.emplace_back(0x290211e3); // STP W3, W4, [X15, #16]
+    env.code_mem.emplace_back(0x6d01a9e9); // STP D9, D10, [X15, #24]
+    env.code_mem.emplace_back(0xa94056d4); // LDP X20, X21, [X22]
+    env.code_mem.emplace_back(0xa9000ac1); // STP X1, X2, [X22]
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetRegister(0, 0x100);
+    jit.SetRegister(10, 0x200);
+    jit.SetRegister(11, 0x400);
+    jit.SetRegister(12, 0x500);
+    jit.SetRegister(13, 0x600);
+    jit.SetRegister(14, 0x700);
+    jit.SetRegister(15, 0x800);
+    jit.SetRegister(22, 0xff8); // Straddles the boundary between two non-contiguous host pages
+    jit.SetPC(0);
+
+    env.ticks_left = 19;
+    jit.Run();
+
+    const auto read = [](size_t offset, size_t size) {
+        u64 value = 0;
+        std::memcpy(&value, page0.data() + offset, size);
+        return value;
+    };
+    const auto structure_register = [&](size_t selem, size_t ebytes, size_t elements, size_t s) {
+        Vector result{};
+        for (size_t e = 0; e < elements; e++) {
+            result[e * ebytes / 8] |= read(0x200 + (e * selem + s) * ebytes, ebytes) << (e * ebytes % 8 * 8);
+        }
+        return result;
+    };
+    const auto same_bytes = [](size_t offset_a, size_t offset_b, size_t size) {
+        return std::memcmp(page0.data() + offset_a, page0.data() + offset_b, size) == 0;
+    };
+
+    REQUIRE(jit.GetRegister(1) == read(0x100, 8));
+    REQUIRE(jit.GetRegister(2) == read(0x108, 8));
+    REQUIRE(jit.GetRegister(3) == read(0x108, 4));
+    REQUIRE(jit.GetRegister(4) == read(0x10c, 4));
+    REQUIRE(jit.GetRegister(5) == static_cast<u64>(static_cast<s32>(read(0x110, 4))));
+    REQUIRE(jit.GetRegister(6) == static_cast<u64>(static_cast<s32>(read(0x114, 4))));
+    REQUIRE(jit.GetVector(24) == Vector{read(0x118, 4), 0});
+    REQUIRE(jit.GetVector(25) == Vector{read(0x11c, 4), 0});
+    REQUIRE(jit.GetVector(9) == Vector{read(0x120, 8), 0});
+    REQUIRE(jit.GetVector(10) == Vector{read(0x128, 8), 0});
+
+    for (size_t r = 0; r < 3; r++) {
+        REQUIRE(jit.GetVector(r) == Vector{read(0x200 + r * 8, 8), 0});
+    }
+    for (size_t s = 0; s < 2; s++) {
+        REQUIRE(jit.GetVector(3 + s) == structure_register(2, 1, 8, s));
+    }
+    for (size_t s = 0; s < 3; s++) {
+        REQUIRE(jit.GetVector(5 + s) == structure_register(3, 2, 8, s));
+    }
+    for (size_t s = 0; s < 4; s++) {
+        REQUIRE(jit.GetVector(16 + s) == structure_register(4, 1, 16, s));
+    }
+    REQUIRE(jit.GetRegister(10) == 0x240);
+
+    REQUIRE(same_bytes(0x400, 0x200, 64));
+    REQUIRE(same_bytes(0x500, 0x200, 48));
+    REQUIRE(same_bytes(0x600, 0x200, 16));
+    REQUIRE(same_bytes(0x700, 0x200, 24));
+    REQUIRE(same_bytes(0x800, 0x100, 16));
+    REQUIRE(same_bytes(0x810, 0x108, 8));
+    REQUIRE(same_bytes(0x818, 0x120, 16));
+
+    // Accesses straddling a page boundary access each register on its own page.
+    REQUIRE(jit.GetRegister(20) == 0xfaf3ece5ded7d0c9);
+    REQUIRE(jit.GetRegister(21) == 0x4444444444444444);
+    REQUIRE(env.modified_memory.empty());
+    REQUIRE(same_bytes(0xff8, 0x100, 8));
+    REQUIRE(std::memcmp(page1.data(), page0.data() + 0x108, 8) == 0);
+}
+
+namespace {
+
+/// Records the memory callbacks made, as (address, size in bits).
+class RecordingTestEnv final : public A64TestEnv {
+public:
+    std::vector<std::pair<u64, size_t>> accesses;
+
+    std::uint8_t MemoryRead8(u64 vaddr) override { return static_cast<u8>(Read(vaddr, 8)); }
+    std::uint16_t MemoryRead16(u64 vaddr) override { return static_cast<u16>(Read(vaddr, 16)); }
+    std::uint32_t MemoryRead32(u64 vaddr) override { return static_cast<u32>(Read(vaddr, 32)); }
+    std::uint64_t MemoryRead64(u64 vaddr) override { return Read(vaddr, 64); }
+    Vector MemoryRead128(u64 vaddr) override {
+        accesses.emplace_back(vaddr, 128);
+        return {Load(vaddr, 8), Load(vaddr + 8, 8)};
+    }
+
+    void MemoryWrite8(u64 vaddr, std::uint8_t value) override { Write(vaddr, value, 8); }
+    void MemoryWrite16(u64 vaddr, std::uint16_t value) override { Write(vaddr, value, 16); }
+    void MemoryWrite32(u64 vaddr, std::uint32_t value) override { Write(vaddr, value, 32); }
+    void MemoryWrite64(u64 vaddr, std::uint64_t value) override { Write(vaddr, value, 64); }
+    void MemoryWrite128(u64 vaddr, Vector value) override {
+        accesses.emplace_back(vaddr, 128);
+        Store(vaddr, value[0], 8);
+        Store(vaddr + 8, value[1], 8);
+    }
+
+private:
+    u64 Load(u64 vaddr, size_t bytes) {
+        u64 value = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            value |= u64(A64TestEnv::MemoryRead8(vaddr + i)) << (i * 8);
+        }
+        return value;
+    }
+    void Store(u64 vaddr, u64 value, size_t bytes) {
+        for (size_t i = 0; i < bytes; i++) {
+            A64TestEnv::MemoryWrite8(vaddr + i, static_cast<u8>(value >> (i * 8)));
+        }
+    }
+    u64 Read(u64 vaddr, size_t bitsize) {
+        accesses.emplace_back(vaddr, bitsize);
+        return Load(vaddr, bitsize / 8);
+    }
+    void Write(u64 vaddr, u64 value, size_t bitsize) {
+        accesses.emplace_back(vaddr, bitsize);
+        Store(vaddr, value, bitsize / 8);
+    }
+};
+
+} // anonymous namespace
+
+TEST_CASE("A64: Wide memory accesses use per-register callbacks", "[a64]") {
+    // Without page_table or fastmem, the callbacks see the same accesses as without wide accesses.
+    RecordingTestEnv env;
+    A64::Jit jit{A64::UserConfig{&env}};
+
+    env.code_mem.emplace_back(0xa9400801); // LDP X1, X2, [X0]
+    env.code_mem.emplace_back(0x29401003); // LDP W3, W4, [X0]
+    env.code_mem.emplace_back(0xa90008a1); // STP X1, X2, [X5]
+    env.code_mem.emplace_back(0x0c408000); // LD2 {V0.8B, V1.8B}, [X0]
+    env.code_mem.emplace_back(0x0c40ac02); // LD1 {V2.1D, V3.1D}, [X0]
+    env.code_mem.emplace_back(0x0c00aca2); // ST1 {V2.1D, V3.1D}, [X5]
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetRegister(0, 0x100);
+    jit.SetRegister(5, 0x200);
+    jit.SetPC(0);
+
+    env.ticks_left = 6;
+    jit.Run();
+
+    std::vector<std::pair<u64, size_t>> expected{
+        {0x100, 64}, {0x108, 64},
+        {0x100, 32}, {0x104, 32},
+        {0x200, 64}, {0x208, 64},
+    };
+    for (u64 i = 0; i < 16; i++) {
+        expected.emplace_back(0x100 + i, 8);
+    }
+    expected.insert(expected.end(), {{0x100, 64}, {0x108, 64}, {0x200, 64}, {0x208, 64}});
+
+    REQUIRE(env.accesses == expected);
+    REQUIRE(jit.GetRegister(1) == 0x0706050403020100);
+    REQUIRE(jit.GetRegister(2) == 0x0f0e0d0c0b0a0908);
+    REQUIRE(jit.GetRegister(3) == 0x03020100);
+    REQUIRE(jit.GetRegister(4) == 0x07060504);
+    REQUIRE(jit.GetVector(0) == Vector{0x0e0c0a0806040200, 0});
+    REQUIRE(jit.GetVector(1) == Vector{0x0f0d0b0907050301, 0});
+    REQUIRE(jit.GetVector(3) == Vector{0x0f0e0d0c0b0a0908, 0});
+    REQUIRE(env.modified_memory.size() == 16);
+}
+
+TEST_CASE("A64: Wide memory accesses detect misalignment per register", "[a64]") {
+    alignas(4096) static std::array<u8, 4096> page0{};
+    alignas(4096) static std::array<u8, 4096> page1{};
+    page0.fill(0x11);
+    page1.fill(0x22);
+    std::array<void*, 256> page_table{};
+    page_table[0] = page0.data();
+    page_table[1] = page1.data();
+
+    RecordingTestEnv env;
+    A64::UserConfig conf{&env};
+    conf.page_table = page_table.data();
+    conf.page_table_address_space_bits = 20;
+    conf.detect_misaligned_access_via_page_table = 8 | 16 | 32 | 64 | 128;
+    A64::Jit jit{conf};
+
+    env.code_mem.emplace_back(0xa9400801); // LDP X1, X2, [X0]
+    env.code_mem.emplace_back(0xa94010c3); // LDP X3, X4, [X6]
+    env.code_mem.emplace_back(0x29402127); // LDP W7, W8, [X9]
+    env.code_mem.emplace_back(0xa90008c1); // STP X1, X2, [X6]
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetRegister(0, 0x108); // Aligned to the register size only
+    jit.SetRegister(6, 0xff8); // Straddles the boundary between two non-contiguous host pages
+    jit.SetRegister(9, 0x102); // Misaligned
+    jit.SetPC(0);
+
+    env.ticks_left = 4;
+    jit.Run();
+
+    REQUIRE(env.accesses == std::vector<std::pair<u64, size_t>>{{0x102, 32}, {0x106, 32}});
+    REQUIRE(jit.GetRegister(1) == 0x1111111111111111);
+    REQUIRE(jit.GetRegister(2) == 0x1111111111111111);
+    REQUIRE(jit.GetRegister(3) == 0x1111111111111111);
+    REQUIRE(jit.GetRegister(4) == 0x2222222222222222);
+    REQUIRE(jit.GetRegister(7) == 0x05040302);
+    REQUIRE(jit.GetRegister(8) == 0x09080706);
+
+    u64 stored;
+    std::memcpy(&stored, page1.data(), sizeof(stored));
+    REQUIRE(stored == 0x1111111111111111);
+    REQUIRE(env.modified_memory.empty());
+}
+
+TEST_CASE("A64: LSE atomics", "[a64]") {
+    A64TestEnv env;
+    A64::Jit jit{A64::UserConfig{&env}};
+
+    SetupLSEAtomicsTest(env, jit, 0x10000);
+
+    env.MemoryWrite64(0x10000, 0x10);
+    env.MemoryWrite16(0x10100, 0x4080);
+    env.MemoryWrite32(0x10200, 0xffff);
+    env.MemoryWrite128(0x10300, {1, 2});
+
+    jit.Run();
+
+    CheckLSEAtomicsTestRegisters(jit);
+    REQUIRE(env.MemoryRead64(0x10000) == 0xffff'ffff'ffff'ffff);
+    REQUIRE(env.MemoryRead16(0x10100) == 0x1000);
+    REQUIRE(env.MemoryRead32(0x10200) == 0xedcb'5678);
+    REQUIRE(env.MemoryRead128(0x10300) == Vector{0xf3, 4});
+}
+
+TEST_CASE("A64: LSE atomics (fastmem)", "[a64]") {
+    A64TestEnv env;
+
+    alignas(4096) static std::array<u8, 4096> backing_memory{};
+    backing_memory.fill(0);
+
+    A64::UserConfig conf{&env};
+    conf.fastmem_pointer = backing_memory.data();
+    conf.fastmem_address_space_bits = 12;
+    conf.silently_mirror_fastmem = true;
+    A64::Jit jit{conf};
+
+    SetupLSEAtomicsTest(env, jit, 0x1234'5000'0000);
+
+    const auto read = [&](size_t offset, auto value) {
+        std::memcpy(&value, backing_memory.data() + offset, sizeof(value));
+        return value;
+    };
+    const auto write = [&](size_t offset, auto value) {
+        std::memcpy(backing_memory.data() + offset, &value, sizeof(value));
+    };
+
+    write(0x000, u64(0x10));
+    write(0x100, u16(0x4080));
+    write(0x200, u32(0xffff));
+    write(0x300, Vector{1, 2});
+
+    jit.Run();
+
+    CheckLSEAtomicsTestRegisters(jit);
+    REQUIRE(read(0x000, u64{}) == 0xffff'ffff'ffff'ffff);
+    REQUIRE(read(0x100, u16{}) == 0x1000);
+    REQUIRE(read(0x200, u32{}) == 0xedcb'5678);
+    REQUIRE(read(0x300, Vector{}) == Vector{0xf3, 4});
+    REQUIRE(env.modified_memory.empty());
+}
+
+TEST_CASE("A64: Self-modifying code detection", "[a64]") {
+    alignas(4096) static std::array<u8, 4096> backing_memory{};
+    backing_memory.fill(0);
+
+    class CodeInMemoryEnv final : public A64TestEnv {
+    public:
+        std::uint32_t MemoryReadCode(u64 vaddr) override {
+            u32 instruction;
+            std::memcpy(&instruction, backing_memory.data() + vaddr, sizeof(u32));
+            return instruction;
+        }
+    } env;
+
+    std::array<void*, 256> page_table{};
+    page_table[0] = backing_memory.data();
+
+    A64::UserConfig conf{&env};
+    conf.page_table = page_table.data();
+    conf.page_table_address_space_bits = 20;
+    conf.detect_self_modifying_code = true;
+    A64::Jit jit{conf};
+
+    const auto write_code = [](u64 vaddr, u32 instruction) {
+        std::memcpy(backing_memory.data() + vaddr, &instruction, sizeof(u32));
+    };
+    write_code(0x0, 0xb9000041); // STR W1, [X2]
+    write_code(0x4, 0xd5033fdf); // ISB
+    write_code(0x8, 0xd2800020); // MOV X0, #1
+    write_code(0xc, 0x14000000); // B .
+
+    jit.SetPC(0x8);
+    env.ticks_left = 2;
+    jit.Run();
+    REQUIRE(jit.GetRegister(0) == 1);
+
+    // Written by the guest
+    jit.SetRegister(1, 0xd2800040); // MOV X0, #2
+    jit.SetRegister(2, 0x8);
+    jit.SetPC(0x0);
+    env.ticks_left = 4;
+    jit.Run();
+    REQUIRE(jit.GetRegister(0) == 2);
+
+    // Written by the host
+    write_code(0x8, 0xd2800060); // MOV X0, #3
+    jit.SetPC(0x8);
+    env.ticks_left = 2;
+    jit.Run();
+    REQUIRE(jit.GetRegister(0) == 3);
+
+    REQUIRE(env.modified_memory.empty());
+}
+
+TEST_CASE("A64: Self-modifying code detection on many pages", "[a64]") {
+    constexpr size_t page_count = 1024;
+    alignas(4096) static std::array<u8, page_count * 4096> backing_memory{};
+    backing_memory.fill(0);
+
+    class CodeInMemoryEnv final : public A64TestEnv {
+    public:
+        std::uint32_t MemoryReadCode(u64 vaddr) override {
+            u32 instruction;
+            std::memcpy(&instruction, backing_memory.data() + vaddr, sizeof(u32));
+            return instruction;
+        }
+    } env;
+
+    std::array<void*, page_count> page_table{};
+    for (size_t page = 0; page < page_count; page++) {
+        page_table[page] = backing_memory.data() + page * 4096;
+    }
+
+    A64::UserConfig conf{&env};
+    conf.page_table = page_table.data();
+    conf.page_table_address_space_bits = 22;
+    conf.detect_self_modifying_code = true;
+    A64::Jit jit{conf};
+
+    const auto write_code = [](u64 vaddr, u32 instruction) {
+        std::memcpy(backing_memory.data() + vaddr, &instruction, sizeof(u32));
+    };
+    const auto run = [&](size_t page) {
+        jit.SetPC(page * 4096);
+        env.ticks_left = 2;
+        jit.Run();
+        return jit.GetRegister(0);
+    };
+
+    // Protecting this many pages replaces the table of protected pages while some are protected.
+    for (size_t page = 0; page < page_count; page++) {
+        write_code(page * 4096 + 0, 0xd2800000 | static_cast<u32>(page << 5)); // MOV X0, #page
+        write_code(page * 4096 + 4, 0x14000000); // B .
+        REQUIRE(run(page) == page);
+    }
+
+    write_code(0, 0xd2a00020); // MOV X0, #0x10000
+    write_code((page_count - 1) * 4096, 0xd2a00040); // MOV X0, #0x20000
+    REQUIRE(run(0) == 0x10000);
+    REQUIRE(run(page_count - 1) == 0x20000);
+    REQUIRE(run(1) == 1);
+
+    REQUIRE(env.modified_memory.empty());
+}
+
+TEST_CASE("A64: Inline exclusive access", "[a64]") {
+    A64TestEnv env;
+
+    alignas(4096) static std::array<u8, 4096> backing_memory{};
+    backing_memory.fill(0);
+    std::array<void*, 256> page_table{};
+    page_table[0] = backing_memory.data();
+
+    A64::UserConfig conf{&env};
+    conf.page_table = page_table.data();
+    conf.page_table_address_space_bits = 20;
+    conf.inline_exclusive_access = true;
+    A64::Jit jit{conf};
+
+    env.code_mem.emplace_back(0xc85f7c01); // LDXR X1, [X0]
+    env.code_mem.emplace_back(0x91000421); // ADD X1, X1, #1
+    env.code_mem.emplace_back(0xc8027c01); // STXR W2, X1, [X0]
+    env.code_mem.emplace_back(0xc8037c01); // STXR W3, X1, [X0]
+    env.code_mem.emplace_back(0xc87f1404); // LDXP X4, X5, [X0]
+    env.code_mem.emplace_back(0xc8261005); // STXP W6, X5, X4, [X0]
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    jit.SetRegister(0, 0x100);
+    jit.SetRegister(2, 0xff);
+    jit.SetRegister(3, 0xff);
+    jit.SetRegister(6, 0xff);
+    jit.SetPC(0);
+
+    const u64 initial_value = 41;
+    const u64 second_value = 7;
+    std::memcpy(backing_memory.data() + 0x100, &initial_value, sizeof(u64));
+    std::memcpy(backing_memory.data() + 0x108, &second_value, sizeof(u64));
+
+    env.ticks_left = 7;
+    jit.Run();
+
+    u64 first, second;
+    std::memcpy(&first, backing_memory.data() + 0x100, sizeof(u64));
+    std::memcpy(&second, backing_memory.data() + 0x108, sizeof(u64));
+
+    REQUIRE(jit.GetRegister(1) == 42);
+    REQUIRE(jit.GetRegister(2) == 0);
+    REQUIRE(jit.GetRegister(3) == 1);
+    REQUIRE(jit.GetRegister(4) == 42);
+    REQUIRE(jit.GetRegister(5) == 7);
+    REQUIRE(jit.GetRegister(6) == 0);
+    REQUIRE(first == 7);
+    REQUIRE(second == 42);
+    REQUIRE(env.modified_memory.empty());
+}
+
+TEST_CASE("A64: Jit construction benchmark", "[.][a64][benchmark]") {
+    constexpr size_t iterations = 200;
+
+    A64TestEnv env;
+    env.code_mem.emplace_back(0xf9400001); // LDR X1, [X0]
+    env.code_mem.emplace_back(0xf9000401); // STR X1, [X0, #8]
+    env.code_mem.emplace_back(0x14000000); // B .
+
+    std::array<void*, 256> page_table{};
+
+    A64::UserConfig conf{&env};
+    conf.page_table = page_table.data();
+    conf.page_table_address_space_bits = 20;
+
+    // Short-lived Jits that each run a single block with memory accesses.
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        A64::Jit jit{conf};
+        jit.SetRegister(0, 0x100);
+        jit.SetPC(0);
+        env.ticks_left = 2;
+        jit.Run();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    fmt::print("{:.0f} us per Jit constructed, run and destroyed\n", seconds / iterations * 1e6);
 }
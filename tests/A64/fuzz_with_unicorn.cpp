@@ -75,6 +75,11 @@ static u32 GenRandomInst(u64 pc, bool is_last_inst) {
             "STLLR",
             // Unimplemented in QEMU
             "LDLAR",
+            // ARMv8.1 atomics, unimplemented in QEMU
+            "CASP", "CASB", "CASH", "CAS",
+            "LDADDB", "LDCLRB", "LDEORB", "LDSETB", "LDSMAXB", "LDSMINB", "LDUMAXB", "LDUMINB", "SWPB", "LDAPRB",
+            "LDADDH", "LDCLRH", "LDEORH", "LDSETH", "LDSMAXH", "LDSMINH", "LDUMAXH", "LDUMINH", "SWPH", "LDAPRH",
+            "LDADD", "LDCLR", "LDEOR", "LDSET", "LDSMAX", "LDSMIN", "LDUMAX", "LDUMIN", "SWP", "LDAPR",
             // Dynarmic and QEMU currently differ on how the exclusive monitor's address range works.
             "STXR", "STLXR", "STXP", "STLXP", "LDXR", "LDAXR", "LDXP", "LDAXP",
             // Behaviour differs from QEMU
@@ -0,0 +1,121 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#include "A64/sha_reference.h"
+#include "common/bit_util.h"
+#include "common/common_types.h"
+
+using namespace Dynarmic;
+
+namespace SHA {
+
+namespace {
+
+u32 Choose(u32 x, u32 y, u32 z) {
+    return ((y ^ z) & x) ^ z;
+}
+
+u32 Majority(u32 x, u32 y, u32 z) {
+    return (x & y) | ((x | y) & z);
+}
+
+u32 Parity(u32 x, u32 y, u32 z) {
+    return x ^ y ^ z;
+}
+
+u32 HashSigma0(u32 x) {
+    return Common::RotateRight(x, 2) ^ Common::RotateRight(x, 13) ^ Common::RotateRight(x, 22);
+}
+
+u32 HashSigma1(u32 x) {
+    return Common::RotateRight(x, 6) ^ Common::RotateRight(x, 11) ^ Common::RotateRight(x, 25);
+}
+
+u32 ScheduleSigma0(u32 x) {
+    return Common::RotateRight(x, 7) ^ Common::RotateRight(x, 18) ^ (x >> 3);
+}
+
+u32 ScheduleSigma1(u32 x) {
+    return Common::RotateRight(x, 17) ^ Common::RotateRight(x, 19) ^ (x >> 10);
+}
+
+template<typename Function>
+void SHA1HashUpdate(State& out_state, const State& x, const State& y, const State& w, Function fn) {
+    State a = x;
+    u32 e = y[0];
+
+    for (size_t i = 0; i < 4; i++) {
+        const u32 t = fn(a[1], a[2], a[3]);
+        e += Common::RotateRight(a[0], 27) + t + w[i];
+
+        // Move each element to the left once, with e entering at the bottom.
+        const u32 high = a[3];
+        a = {e, a[0], Common::RotateRight(a[1], 2), a[2]};
+        e = high;
+    }
+
+    out_state = a;
+}
+
+void SHA256Hash(State& out_state, const State& x_in, const State& y_in, const State& w, bool part1) {
+    State x = x_in;
+    State y = y_in;
+
+    for (size_t i = 0; i < 4; i++) {
+        const u32 choice = Choose(y[0], y[1], y[2]);
+        const u32 majority = Majority(x[0], x[1], x[2]);
+        const u32 t = y[3] + HashSigma1(y[0]) + choice + w[i];
+
+        const u32 new_low_x = t + HashSigma0(x[0]) + majority;
+        const u32 new_low_y = t + x[3];
+
+        x = {new_low_x, x[0], x[1], x[2]};
+        y = {new_low_y, y[0], y[1], y[2]};
+    }
+
+    out_state = part1 ? x : y;
+}
+
+} // anonymous namespace
+
+void SHA1HashUpdateChoose(State& out_state, const State& x, const State& y, const State& w) {
+    SHA1HashUpdate(out_state, x, y, w, Choose);
+}
+
+void SHA1HashUpdateMajority(State& out_state, const State& x, const State& y, const State& w) {
+    SHA1HashUpdate(out_state, x, y, w, Majority);
+}
+
+void SHA1HashUpdateParity(State& out_state, const State& x, const State& y, const State& w) {
+    SHA1HashUpdate(out_state, x, y, w, Parity);
+}
+
+void SHA256HashPart1(State& out_state, const State& x, const State& y, const State& w) {
+    SHA256Hash(out_state, x, y, w, true);
+}
+
+void SHA256HashPart2(State& out_state, const State& x, const State& y, const State& w) {
+    SHA256Hash(out_state, x, y, w, false);
+}
+
+void SHA256MessageSchedule0(State& out_state, const State& x, const State& y) {
+    const State t{x[1], x[2], x[3], y[0]};
+
+    for (size_t i = 0; i < 4; i++) {
+        out_state[i] = x[i] + ScheduleSigma0(t[i]);
+    }
+}
+
+void SHA256MessageSchedule1(State& out_state, const State& x, const State& y, const State& z) {
+    const State t{y[1], y[2], y[3], z[0]};
+
+    // The upper half depends upon the lower half of the result.
+    out_state[0] = x[0] + t[0] + ScheduleSigma1(z[2]);
+    out_state[1] = x[1] + t[1] + ScheduleSigma1(z[3]);
+    out_state[2] = x[2] + t[2] + ScheduleSigma1(out_state[0]);
+    out_state[3] = x[3] + t[3] + ScheduleSigma1(out_state[1]);
+}
+
+} // namespace SHA
@@ -0,0 +1,27 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#pragma once
+
+#include <array>
+#include "common/common_types.h"
+
+namespace SHA {
+
+using State = std::array<u32, 4>;
+
+// Four rounds of SHA1 using the given function. Only the lowest element of y is used.
+void SHA1HashUpdateChoose(State& out_state, const State& x, const State& y, const State& w);
+void SHA1HashUpdateMajority(State& out_state, const State& x, const State& y, const State& w);
+void SHA1HashUpdateParity(State& out_state, const State& x, const State& y, const State& w);
+
+// Four rounds of SHA256. Part 1 produces the updated x, part 2 produces the updated y.
+void SHA256HashPart1(State& out_state, const State& x, const State& y, const State& w);
+void SHA256HashPart2(State& out_state, const State& x, const State& y, const State& w);
+
+void SHA256MessageSchedule0(State& out_state, const State& x, const State& y);
+void SHA256MessageSchedule1(State& out_state, const State& x, const State& y, const State& z);
+
+} // namespace SHA
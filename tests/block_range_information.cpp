@@ -0,0 +1,88 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#include <chrono>
+
+#include <boost/icl/interval_set.hpp>
+#include <catch.hpp>
+#include <fmt/format.h>
+
+#include "backend/x64/block_range_information.h"
+#include "common/common_types.h"
+#include "frontend/ir/location_descriptor.h"
+
+using namespace Dynarmic;
+using Backend::X64::BlockRangeInformation;
+
+namespace {
+
+boost::icl::discrete_interval<u64> Range(u64 first, u64 last) {
+    return boost::icl::discrete_interval<u64>::closed(first, last);
+}
+
+boost::icl::interval_set<u64> Ranges(u64 first, u64 last) {
+    boost::icl::interval_set<u64> ranges;
+    ranges.add(Range(first, last));
+    return ranges;
+}
+
+} // anonymous namespace
+
+TEST_CASE("BlockRangeInformation: Invalidation", "[block_range_information]") {
+    BlockRangeInformation<u64> block_ranges;
+    const IR::LocationDescriptor a{0x1000}, b{0x2ff0}, c{0x5000};
+    block_ranges.AddRange(Range(0x1000, 0x100f), a);
+    block_ranges.AddRange(Range(0x2ff0, 0x300f), b); // Straddles a page boundary
+    block_ranges.AddRange(Range(0x5000, 0x5003), c);
+    block_ranges.AddRange(Range(0x1008, 0x100b), c); // Followed branch into another page
+
+    REQUIRE(block_ranges.InvalidateRanges(Ranges(0x1010, 0x2fef)).empty());
+    REQUIRE(block_ranges.InvalidateRanges(Ranges(0x3008, 0x3008)) == tsl::robin_set<IR::LocationDescriptor>{b});
+    // Removed blocks are no longer found.
+    REQUIRE(block_ranges.InvalidateRanges(Ranges(0x2000, 0x3fff)).empty());
+    REQUIRE(block_ranges.InvalidateRanges(Ranges(0x1008, 0x1008)) == tsl::robin_set<IR::LocationDescriptor>{a, c});
+    REQUIRE(block_ranges.InvalidateRanges(Ranges(0, ~u64(0))).empty());
+
+    // Blocks can be re-added after removal, and invalidated by large ranges.
+    block_ranges.AddRange(Range(0x2ff0, 0x300f), b);
+    block_ranges.AddRange(Range(0xffff'ffff'ffff'fff0, 0xffff'ffff'ffff'ffff), a);
+    REQUIRE(block_ranges.InvalidateRanges(Ranges(0, ~u64(0))) == tsl::robin_set<IR::LocationDescriptor>{a, b});
+
+    block_ranges.AddRange(Range(0x1000, 0x100f), a);
+    block_ranges.ClearCache();
+    REQUIRE(block_ranges.InvalidateRanges(Ranges(0, ~u64(0))).empty());
+}
+
+TEST_CASE("BlockRangeInformation: Invalidation benchmark", "[.][block_range_information][benchmark]") {
+    constexpr size_t block_count = 131072;
+    constexpr size_t iterations = 1'000'000;
+
+    // Blocks of 16 to 64 bytes, packed into consecutive guest memory.
+    BlockRangeInformation<u64> block_ranges;
+    std::vector<u64> block_starts;
+    u64 pc = 0x10000;
+    for (size_t i = 0; i < block_count; i++) {
+        const u64 size = 16 + (i * 7919 % 13) * 4;
+        block_ranges.AddRange(Range(pc, pc + size - 1), IR::LocationDescriptor{pc});
+        block_starts.emplace_back(pc);
+        pc += size;
+    }
+
+    // Each iteration invalidates a single instruction, then recompiles the block that contained it.
+    size_t invalidated = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        const u64 block_start = block_starts[i * 40503 % block_count];
+        for (const auto& location : block_ranges.InvalidateRanges(Ranges(block_start + 4, block_start + 7))) {
+            block_ranges.AddRange(Range(location.Value(), location.Value() + 15), location);
+            invalidated++;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    fmt::print("{} blocks: {:.0f} ns per invalidation of a small range, {} blocks invalidated\n",
+               block_count, seconds / iterations * 1e9, invalidated);
+}
@@ -0,0 +1,191 @@
+/* This file is part of the dynarmic project.
+ * Copyright (c) 2020 MerryMage
+ * SPDX-License-Identifier: 0BSD
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+#include <fmt/format.h>
+
+#include <dynarmic/exclusive_monitor.h>
+
+namespace {
+
+using u64 = std::uint64_t;
+
+/// Emulates an LDXR/ADD/STXR retry loop on each of thread_count processors.
+/// Each processor increments the counter at addresses[processor_id] iterations times.
+/// Returns the total number of failed exclusive stores.
+u64 RunIncrementLoops(Dynarmic::ExclusiveMonitor& monitor, std::vector<std::atomic<u64>>& memory, const std::vector<size_t>& addresses, size_t iterations) {
+    std::atomic<u64> failures{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> threads;
+    for (size_t processor_id = 0; processor_id < monitor.GetProcessorCount(); processor_id++) {
+        threads.emplace_back([&, processor_id] {
+            const size_t index = addresses[processor_id];
+            const Dynarmic::VAddr vaddr = index * sizeof(u64);
+            u64 local_failures = 0;
+
+            while (!go.load()) {}
+
+            for (size_t i = 0; i < iterations; i++) {
+                while (true) {
+                    const u64 value = monitor.ReadAndMark<u64>(processor_id, vaddr, [&] {
+                        return memory[index].load();
+                    });
+                    const bool success = monitor.DoExclusiveOperation<u64>(processor_id, vaddr, [&](u64 expected) {
+                        return memory[index].compare_exchange_strong(expected, value + 1);
+                    });
+                    if (success) {
+                        break;
+                    }
+                    local_failures++;
+                }
+            }
+
+            failures += local_failures;
+        });
+    }
+
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return failures;
+}
+
+} // anonymous namespace
+
+TEST_CASE("ExclusiveMonitor: Basic reservation semantics", "[exclusive_monitor]") {
+    Dynarmic::ExclusiveMonitor monitor{2};
+    u64 memory = 0;
+
+    const auto read = [&] { return memory; };
+    const auto write = [&](u64 new_value) {
+        return [&memory, new_value](u64 expected) {
+            if (memory != expected) {
+                return false;
+            }
+            memory = new_value;
+            return true;
+        };
+    };
+
+    // No reservation
+    REQUIRE(!monitor.DoExclusiveOperation<u64>(0, 0x1000, write(1)));
+
+    // Reservation for a different address
+    monitor.ReadAndMark<u64>(0, 0x1000, read);
+    REQUIRE(!monitor.DoExclusiveOperation<u64>(0, 0x2000, write(1)));
+
+    // Reservation is consumed by an exclusive store
+    monitor.ReadAndMark<u64>(0, 0x1000, read);
+    REQUIRE(monitor.DoExclusiveOperation<u64>(0, 0x1000, write(1)));
+    REQUIRE(memory == 1);
+    REQUIRE(!monitor.DoExclusiveOperation<u64>(0, 0x1000, write(2)));
+
+    // Another processor's exclusive store clears our reservation
+    monitor.ReadAndMark<u64>(0, 0x1000, read);
+    monitor.ReadAndMark<u64>(1, 0x1000, read);
+    REQUIRE(monitor.DoExclusiveOperation<u64>(1, 0x1000, write(3)));
+    REQUIRE(!monitor.DoExclusiveOperation<u64>(0, 0x1000, write(4)));
+    REQUIRE(memory == 3);
+
+    // Explicit clears
+    monitor.ReadAndMark<u64>(0, 0x1000, read);
+    monitor.ClearProcessor(0);
+    REQUIRE(!monitor.DoExclusiveOperation<u64>(0, 0x1000, write(5)));
+
+    monitor.ReadAndMark<u64>(1, 0x1000, read);
+    monitor.ClearAddress(0x1000);
+    REQUIRE(!monitor.DoExclusiveOperation<u64>(1, 0x1000, write(5)));
+
+    monitor.ReadAndMark<u64>(0, 0x1000, read);
+    monitor.ReadAndMark<u64>(1, 0x1000, read);
+    monitor.Clear();
+    REQUIRE(!monitor.DoExclusiveOperation<u64>(0, 0x1000, write(5)));
+    REQUIRE(!monitor.DoExclusiveOperation<u64>(1, 0x1000, write(5)));
+    REQUIRE(memory == 3);
+}
+
+TEST_CASE("ExclusiveMonitor: Inline reservations", "[exclusive_monitor]") {
+    Dynarmic::ExclusiveMonitor monitor{3};
+    u64 memory = 0;
+
+    const auto read = [&] { return memory; };
+    const auto write = [&](u64 expected) {
+        if (memory != expected) {
+            return false;
+        }
+        memory++;
+        return true;
+    };
+
+    // Processor 0 holds reservations inline, as the JIT does with inline_exclusive_access.
+    std::atomic<Dynarmic::VAddr>& reservation = *monitor.GetReservationAddress(0);
+
+    // Another processor's exclusive store clears a matching inline reservation
+    reservation.store(0x1000);
+    monitor.ReadAndMark<u64>(1, 0x1000, read);
+    REQUIRE(monitor.DoExclusiveOperation<u64>(1, 0x1000, write));
+    REQUIRE(reservation.load() == Dynarmic::ExclusiveMonitor::INVALID_EXCLUSIVE_ADDRESS);
+
+    // but not one for a different address
+    reservation.store(0x2000);
+    monitor.ReadAndMark<u64>(1, 0x1000, read);
+    REQUIRE(monitor.DoExclusiveOperation<u64>(1, 0x1000, write));
+    REQUIRE(reservation.load() == 0x2000);
+
+    monitor.ClearAddress(0x2000);
+    REQUIRE(reservation.load() == Dynarmic::ExclusiveMonitor::INVALID_EXCLUSIVE_ADDRESS);
+
+    // Reservations made through ReadAndMark still only depend upon the granule generation
+    monitor.ReadAndMark<u64>(2, 0x1000, read);
+    monitor.ReadAndMark<u64>(1, 0x1000, read);
+    REQUIRE(monitor.DoExclusiveOperation<u64>(1, 0x1000, write));
+    REQUIRE(!monitor.DoExclusiveOperation<u64>(2, 0x1000, write));
+    REQUIRE(memory == 3);
+}
+
+TEST_CASE("ExclusiveMonitor: Concurrent increments", "[exclusive_monitor]") {
+    constexpr size_t processor_count = 4;
+    constexpr size_t iterations = 10000;
+
+    Dynarmic::ExclusiveMonitor monitor{processor_count};
+    std::vector<std::atomic<u64>> memory(processor_count);
+    const std::vector<size_t> shared_addresses(processor_count, 0);
+
+    RunIncrementLoops(monitor, memory, shared_addresses, iterations);
+
+    REQUIRE(memory[0].load() == processor_count * iterations);
+}
+
+TEST_CASE("ExclusiveMonitor: Contention benchmark", "[.][exclusive_monitor][benchmark]") {
+    const size_t processor_count = std::max<size_t>(8, std::thread::hardware_concurrency());
+    constexpr size_t iterations = 1'000'000;
+
+    for (const bool shared : {false, true}) {
+        Dynarmic::ExclusiveMonitor monitor{processor_count};
+        // Space private counters a cache line apart so that only the monitor can cause contention.
+        std::vector<std::atomic<u64>> memory(processor_count * 8);
+        std::vector<size_t> addresses(processor_count);
+        for (size_t i = 0; i < processor_count; i++) {
+            addresses[i] = shared ? 0 : i * 8;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const u64 failures = RunIncrementLoops(monitor, memory, addresses, iterations);
+        const auto end = std::chrono::steady_clock::now();
+
+        const double seconds = std::chrono::duration<double>(end - start).count();
+        const double total_ops = static_cast<double>(processor_count * iterations);
+        fmt::print("{} processors, {} addresses: {:.2f} Mop/s, {} failed exclusive stores\n",
+                   processor_count, shared ? "shared" : "unrelated", total_ops / seconds / 1e6, failures);
+    }
+}
@@ -15,6 +15,7 @@
 #include <dynarmic/A32/a32.h>
 #include <dynarmic/A32/disassembler.h>
 
+#include "backend/x64/vector_fallback_counts.h"
 #include "common/common_types.h"
 #include "common/llvm_disassemble.h"
 #include "frontend/A32/decoder/arm.h"
@@ -28,6 +29,7 @@
 #include "frontend/A64/translate/impl/impl.h"
 #include "frontend/A64/translate/translate.h"
 #include "frontend/ir/basic_block.h"
+#include "frontend/ir/opcodes.h"
 #include "ir_opt/passes.h"
 
 #include <fmt/format.h>
@@ -298,6 +300,11 @@ int main(int argc, char** argv) {
             fmt::print("Executing a64 code not currently supported\n");
             return 1;
         }
+
+        // Only counted in builds with DYNARMIC_COUNT_VECTOR_FALLBACKS.
+        for (const auto& [opcode, count] : Backend::X64::GetVectorFallbackCounts()) {
+            fmt::print("Fallback for {} ran {} times\n", IR::GetNameOf(opcode), count);
+        }
     }
 
     return 0;